@@ -57,6 +57,7 @@ enum_displacement_methods = (
 
 enum_bvh_layouts = (
     ('BVH2', "BVH2", "", 1),
+    ('BVH8', "BVH8", "", 2),
     ('EMBREE', "Embree", "", 4),
 )
 
@@ -280,6 +281,13 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         default=1,
         update=update_render_passes,
     )
+    denoising_threads: IntProperty(
+        name="Denoising Threads",
+        description="Number of CPU threads that denoise finished tiles with OpenImageDenoise while other "
+        "tiles are still rendering, 0 for automatic",
+        min=0, max=1024,
+        default=0,
+    )
     preview_denoiser: EnumProperty(
         name="Viewport Denoiser",
         description="Denoise the image after each preview update with the selected denoiser",
@@ -407,6 +415,13 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         default=0.0,
         precision=4,
     )
+    use_guiding: BoolProperty(
+        name="Path Guiding",
+        description="Learn the distribution of indirect light during progressive rendering and use it to guide diffuse bounces. "
+        "Only supported for path tracing on the CPU",
+        default=False,
+    )
+
     adaptive_min_samples: IntProperty(
         name="Adaptive Min Samples",
         description="Minimum AA samples for adaptive sampling, to discover noisy features before stopping sampling. Zero for automatic setting based on number of AA samples",
@@ -550,6 +565,13 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         min=1.0, soft_max=25.0,
         default=4.0,
     )
+    use_shared_subdivision: BoolProperty(
+        name="Share Subdivision",
+        description="Share the subdivided geometry of instances that have about the same size on screen, "
+        "and reuse it in later frames. Reduces memory usage and synchronization time for scenes with "
+        "many instances, at the cost of dicing them from a representative object",
+        default=True,
+    )
 
     film_exposure: FloatProperty(
         name="Exposure",
@@ -275,6 +275,11 @@ class CYCLES_RENDER_PT_sampling_denoising(CyclesButtonsPanel, Panel):
 
         sub.prop(cscene, "denoiser", text="")
 
+        if cscene.denoiser == 'OPENIMAGEDENOISE':
+            sub = heading.row(align=True)
+            sub.active = cscene.use_denoising
+            sub.prop(cscene, "denoising_threads", text="Threads")
+
         layout.separator()
 
         heading = layout.column(align=False, heading="Viewport")
@@ -315,6 +320,10 @@ class CYCLES_RENDER_PT_sampling_advanced(CyclesButtonsPanel, Panel):
 
         layout.prop(cscene, "use_square_samples")
 
+        col = layout.column(align=True)
+        col.active = use_cpu(context) and cscene.progressive == 'PATH'
+        col.prop(cscene, "use_guiding")
+
         layout.separator()
 
         col = layout.column(align=True)
@@ -417,6 +426,7 @@ class CYCLES_RENDER_PT_subdivision(CyclesButtonsPanel, Panel):
         col.prop(cscene, "max_subdivisions")
 
         col.prop(cscene, "dicing_camera")
+        col.prop(cscene, "use_shared_subdivision")
 
 
 class CYCLES_RENDER_PT_hair(CyclesButtonsPanel, Panel):
@@ -15,10 +15,12 @@
  * limitations under the License.
  */
 
+#include "render/bake.h"
 #include "render/curves.h"
 #include "render/hair.h"
 #include "render/mesh.h"
 #include "render/object.h"
+#include "render/tessellation_cache.h"
 #include "render/volume.h"
 
 #include "blender/blender_sync.h"
@@ -70,6 +72,40 @@ array<Node *> BlenderSync::find_used_shaders(BL::Object &b_ob)
   return used_shaders;
 }
 
+GeometryKey BlenderSync::shared_subdivision_key(BL::Object &b_ob, const GeometryKey &key)
+{
+  if (!scene->params.use_shared_subdivision || scene->bake_manager->get_baking() ||
+      b_ob.type() != BL::Object::type_MESH || b_ob.modifiers.length() != 1) {
+    return key;
+  }
+
+  /* Materials linked to the object rather than the mesh differ between objects using the
+   * same mesh, and the shared geometry only has the shaders of the first one synced. */
+  if (!view_layer.material_override) {
+    for (BL::MaterialSlot &b_slot : b_ob.material_slots) {
+      if (b_slot.link() == BL::MaterialSlot::link_OBJECT) {
+        return key;
+      }
+    }
+  }
+
+  const Mesh::SubdivisionType subdivision_type = object_subdivision_type(
+      b_ob, preview, experimental);
+  if (subdivision_type == Mesh::SUBDIVISION_NONE) {
+    return key;
+  }
+
+  /* The dicing camera is synced before objects, so this is the same bucket as in the
+   * tessellation cache key. */
+  const int dicing_bucket = tessellation_dicing_bucket(get_transform(b_ob.matrix_world()),
+                                                       scene->dicing_camera);
+
+  return GeometryKey(b_ob.data().ptr.data,
+                     key.geometry_type,
+                     dicing_bucket,
+                     object_subdivision_settings(b_ob, subdivision_type));
+}
+
 Geometry *BlenderSync::sync_geometry(BL::Depsgraph &b_depsgraph,
                                      BL::Object &b_ob,
                                      BL::Object &b_ob_instance,
@@ -83,6 +119,12 @@ Geometry *BlenderSync::sync_geometry(BL::Depsgraph &b_depsgraph,
   Geometry::Type geom_type = determine_geom_type(b_ob, use_particle_hair);
   GeometryKey key(b_key_id.ptr.data, geom_type);
 
+  /* Objects whose only modifier is adaptive subdivision share the geometry with other
+   * objects using the same mesh, as long as they have about the same size on screen. */
+  if (geom_type == Geometry::MESH && b_key_id.ptr.data != b_ob_data.ptr.data) {
+    key = shared_subdivision_key(b_ob, key);
+  }
+
   /* Find shader indices. */
   array<Node *> used_shaders = find_used_shaders(b_ob);
 
@@ -239,13 +239,23 @@ struct ObjectKey {
 /* Geometry Key
  *
  * We export separate geometry for a mesh and its particle hair, so key needs to
- * distinguish between them. */
+ * distinguish between them. Objects sharing adaptive subdivision of the same
+ * mesh are further distinguished by their dicing bucket and settings. */
 
 struct GeometryKey {
   void *id;
   Geometry::Type geometry_type;
-
-  GeometryKey(void *id, Geometry::Type geometry_type) : id(id), geometry_type(geometry_type)
+  int dicing_bucket;
+  uint64_t subd_settings;
+
+  GeometryKey(void *id,
+              Geometry::Type geometry_type,
+              int dicing_bucket = 0,
+              uint64_t subd_settings = 0)
+      : id(id),
+        geometry_type(geometry_type),
+        dicing_bucket(dicing_bucket),
+        subd_settings(subd_settings)
   {
   }
 
@@ -258,6 +268,14 @@ struct GeometryKey {
       if (geometry_type < k.geometry_type) {
         return true;
       }
+      else if (geometry_type == k.geometry_type) {
+        if (dicing_bucket < k.dicing_bucket) {
+          return true;
+        }
+        else if (dicing_bucket == k.dicing_bucket) {
+          return subd_settings < k.subd_settings;
+        }
+      }
     }
 
     return false;
@@ -799,14 +799,16 @@ void BlenderSession::synchronize(BL::Depsgraph &b_depsgraph_)
   b_depsgraph = b_depsgraph_;
 
   BL::Object b_camera_override(b_engine.camera_override());
-  sync->sync_data(
-      b_render, b_depsgraph, b_v3d, b_camera_override, width, height, &python_thread_state);
 
+  /* Camera first, shared subdivision of objects depends on the dicing camera. */
   if (b_rv3d)
     sync->sync_view(b_v3d, b_rv3d, width, height);
   else
     sync->sync_camera(b_render, b_camera_override, width, height, "");
 
+  sync->sync_data(
+      b_render, b_depsgraph, b_v3d, b_camera_override, width, height, &python_thread_state);
+
   /* get buffer parameters */
   BufferParams buffer_params = BlenderSync::get_buffer_params(
       b_v3d, b_rv3d, scene->camera, width, height, session_params.denoising.use);
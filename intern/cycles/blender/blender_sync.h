@@ -173,6 +173,7 @@ class BlenderSync {
       BL::RenderSettings &b_render, BL::Object &b_ob, int width, int height, float motion_time);
 
   /* Geometry */
+  GeometryKey shared_subdivision_key(BL::Object &b_ob, const GeometryKey &key);
   Geometry *sync_geometry(BL::Depsgraph &b_depsgrpah,
                           BL::Object &b_ob,
                           BL::Object &b_ob_instance,
@@ -594,6 +594,19 @@ static inline Mesh::SubdivisionType object_subdivision_type(BL::Object &b_ob,
   return Mesh::SUBDIVISION_NONE;
 }
 
+/* Object and modifier settings that change the result of adaptive subdivision,
+ * packed so objects sharing a mesh can only share its subdivision when they match. */
+static inline uint64_t object_subdivision_settings(BL::Object &b_ob,
+                                                   Mesh::SubdivisionType subdivision_type)
+{
+  PointerRNA cobj = RNA_pointer_get(&b_ob.ptr, "cycles");
+  BL::SubsurfModifier subsurf(b_ob.modifiers[b_ob.modifiers.length() - 1]);
+  const float dicing_rate = RNA_float_get(&cobj, "dicing_rate");
+
+  return ((uint64_t)__float_as_uint(dicing_rate) << 32) | ((uint64_t)subsurf.uv_smooth() << 8) |
+         (uint64_t)subdivision_type;
+}
+
 static inline uint object_ray_visibility(BL::Object &b_ob)
 {
   PointerRNA cvisibility = RNA_pointer_get(&b_ob.ptr, "cycles_visibility");
@@ -659,38 +659,8 @@ void BVH2::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
     }
 
     if (bvh->pack.nodes.size()) {
-      int4 *bvh_nodes = &bvh->pack.nodes[0];
-      size_t bvh_nodes_size = bvh->pack.nodes.size();
-
-      for (size_t i = 0, j = 0; i < bvh_nodes_size; j++) {
-        size_t nsize, nsize_bbox;
-        if (bvh_nodes[i].x & PATH_RAY_NODE_UNALIGNED) {
-          nsize = BVH_UNALIGNED_NODE_SIZE;
-          nsize_bbox = 0;
-        }
-        else {
-          nsize = BVH_NODE_SIZE;
-          nsize_bbox = 0;
-        }
-
-        memcpy(pack_nodes + pack_nodes_offset, bvh_nodes + i, nsize_bbox * sizeof(int4));
-
-        /* Modify offsets into arrays */
-        int4 data = bvh_nodes[i + nsize_bbox];
-        data.z += (data.z < 0) ? -noffset_leaf : noffset;
-        data.w += (data.w < 0) ? -noffset_leaf : noffset;
-        pack_nodes[pack_nodes_offset + nsize_bbox] = data;
-
-        /* Usually this copies nothing, but we better
-         * be prepared for possible node size extension.
-         */
-        memcpy(&pack_nodes[pack_nodes_offset + nsize_bbox + 1],
-               &bvh_nodes[i + nsize_bbox + 1],
-               sizeof(int4) * (nsize - (nsize_bbox + 1)));
-
-        pack_nodes_offset += nsize;
-        i += nsize;
-      }
+      pack_instance_nodes(bvh, pack_nodes + pack_nodes_offset, noffset, noffset_leaf);
+      pack_nodes_offset += bvh->pack.nodes.size();
     }
 
     nodes_offset += bvh->pack.nodes.size();
@@ -699,4 +669,41 @@ void BVH2::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
   }
 }
 
+void BVH2::pack_instance_nodes(const BVH2 *bvh, int4 *pack_nodes, int noffset, int noffset_leaf)
+{
+  const int4 *bvh_nodes = &bvh->pack.nodes[0];
+  const size_t bvh_nodes_size = bvh->pack.nodes.size();
+  size_t pack_nodes_offset = 0;
+
+  for (size_t i = 0, j = 0; i < bvh_nodes_size; j++) {
+    size_t nsize, nsize_bbox;
+    if (bvh_nodes[i].x & PATH_RAY_NODE_UNALIGNED) {
+      nsize = BVH_UNALIGNED_NODE_SIZE;
+      nsize_bbox = 0;
+    }
+    else {
+      nsize = BVH_NODE_SIZE;
+      nsize_bbox = 0;
+    }
+
+    memcpy(pack_nodes + pack_nodes_offset, bvh_nodes + i, nsize_bbox * sizeof(int4));
+
+    /* Modify offsets into arrays */
+    int4 data = bvh_nodes[i + nsize_bbox];
+    data.z += (data.z < 0) ? -noffset_leaf : noffset;
+    data.w += (data.w < 0) ? -noffset_leaf : noffset;
+    pack_nodes[pack_nodes_offset + nsize_bbox] = data;
+
+    /* Usually this copies nothing, but we better
+     * be prepared for possible node size extension.
+     */
+    memcpy(&pack_nodes[pack_nodes_offset + nsize_bbox + 1],
+           &bvh_nodes[i + nsize_bbox + 1],
+           sizeof(int4) * (nsize - (nsize_bbox + 1)));
+
+    pack_nodes_offset += nsize;
+    i += nsize;
+  }
+}
+
 CCL_NAMESPACE_END
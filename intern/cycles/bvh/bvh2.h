@@ -61,7 +61,7 @@ class BVH2 : public BVH {
   virtual BVHNode *widen_children_nodes(const BVHNode *root);
 
   /* pack */
-  void pack_nodes(const BVHNode *root);
+  virtual void pack_nodes(const BVHNode *root);
 
   void pack_leaf(const BVHStackEntry &e, const LeafNode *leaf);
   void pack_inner(const BVHStackEntry &e, const BVHStackEntry &e0, const BVHStackEntry &e1);
@@ -92,7 +92,7 @@ class BVH2 : public BVH {
 
   /* refit */
   void refit_nodes();
-  void refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility);
+  virtual void refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility);
 
   /* Refit range of primitives. */
   void refit_primitives(int start, int end, BoundBox &bbox, uint &visibility);
@@ -103,6 +103,11 @@ class BVH2 : public BVH {
 
   /* merge instance BVH's */
   void pack_instances(size_t nodes_size, size_t leaf_nodes_size);
+  /* Copy inner nodes of an instance BVH, offsetting child indices. */
+  virtual void pack_instance_nodes(const BVH2 *bvh,
+                                   int4 *pack_nodes,
+                                   int noffset,
+                                   int noffset_leaf);
 };
 
 CCL_NAMESPACE_END
@@ -0,0 +1,307 @@
+/*
+ * Copyright 2021, Blender Foundation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bvh/bvh8.h"
+
+#include "bvh/bvh_node.h"
+
+#include "util/util_math.h"
+
+CCL_NAMESPACE_BEGIN
+
+BVH8::BVH8(const BVHParams &params_,
+           const vector<Geometry *> &geometry_,
+           const vector<Object *> &objects_)
+    : BVH2(params_, geometry_, objects_)
+{
+  /* Oriented bounds for hair don't fit in the compressed node layout. */
+  params.use_unaligned_nodes = false;
+}
+
+/* Building process. */
+
+/* Merge binary nodes into nodes with up to 8 children, by repeatedly opening
+ * the inner child with the largest surface area. */
+static BVHNode *bvh8_merge_children_recursively(const BVHNode *node)
+{
+  if (node->is_leaf()) {
+    return new LeafNode(*reinterpret_cast<const LeafNode *>(node));
+  }
+
+  const BVHNode *children[BVH_ONODE_NUM_CHILDREN];
+  int num_children = node->num_children();
+  for (int i = 0; i < num_children; i++) {
+    children[i] = node->get_child(i);
+  }
+
+  while (num_children < BVH_ONODE_NUM_CHILDREN) {
+    int best_child = -1;
+    float best_area = -FLT_MAX;
+    for (int i = 0; i < num_children; i++) {
+      const BVHNode *child = children[i];
+      if (child->is_leaf() ||
+          num_children + child->num_children() - 1 > BVH_ONODE_NUM_CHILDREN) {
+        continue;
+      }
+      const float area = child->bounds.safe_area();
+      if (area > best_area) {
+        best_child = i;
+        best_area = area;
+      }
+    }
+
+    if (best_child == -1) {
+      break;
+    }
+
+    const BVHNode *child = children[best_child];
+    children[best_child] = child->get_child(0);
+    for (int i = 1; i < child->num_children(); i++) {
+      children[num_children++] = child->get_child(i);
+    }
+  }
+
+  BVHNode *new_children[BVH_ONODE_NUM_CHILDREN];
+  for (int i = 0; i < num_children; i++) {
+    new_children[i] = bvh8_merge_children_recursively(children[i]);
+  }
+
+  return new InnerNode(node->bounds, new_children, num_children);
+}
+
+BVHNode *BVH8::widen_children_nodes(const BVHNode *root)
+{
+  if (root == NULL) {
+    return NULL;
+  }
+  if (root->is_leaf()) {
+    return const_cast<BVHNode *>(root);
+  }
+  return bvh8_merge_children_recursively(root);
+}
+
+/* Pack */
+
+/* Power of two steps keep the dequantized bounds exact, so they stay
+ * conservative regardless of how the kernel evaluates them. */
+static float bvh8_quantization_step(float origin, float max, float extent)
+{
+  int exponent;
+  frexpf(extent / 255.0f, &exponent);
+  float step = ldexpf(1.0f, exponent);
+  while (origin + 255.0f * step < max) {
+    step *= 2.0f;
+  }
+  return step;
+}
+
+void BVH8::pack_node(int idx,
+                     const BoundBox *bounds,
+                     const int *child,
+                     const uint *visibility,
+                     const int num)
+{
+  assert(idx + BVH_ONODE_SIZE <= pack.nodes.size());
+  assert(num <= BVH_ONODE_NUM_CHILDREN);
+
+  BoundBox node_bounds = BoundBox::empty;
+  for (int i = 0; i < num; i++) {
+    if (bounds[i].valid()) {
+      node_bounds.grow(bounds[i]);
+    }
+  }
+
+  float3 origin = make_float3(0.0f, 0.0f, 0.0f);
+  float3 step = make_float3(1.0f, 1.0f, 1.0f);
+  if (node_bounds.valid()) {
+    const float3 extent = node_bounds.size();
+    origin = node_bounds.min;
+    for (int axis = 0; axis < 3; axis++) {
+      step[axis] = bvh8_quantization_step(origin[axis], node_bounds.max[axis], extent[axis]);
+    }
+  }
+
+  int4 data[BVH_ONODE_SIZE];
+  memset(data, 0, sizeof(data));
+
+  data[0] = make_int4(
+      __float_as_int(origin.x), __float_as_int(origin.y), __float_as_int(origin.z), num);
+  data[1] = make_int4(__float_as_int(step.x), __float_as_int(step.y), __float_as_int(step.z), 0);
+
+  uchar *quantized = (uchar *)&data[2];
+  int *child_data = (int *)&data[5];
+  uint *visibility_data = (uint *)&data[7];
+
+  for (int i = 0; i < num; i++) {
+    assert(child[i] < 0 || child[i] < pack.nodes.size());
+    child_data[i] = child[i];
+
+    /* Children without geometry are never traversed. */
+    if (!bounds[i].valid()) {
+      continue;
+    }
+    visibility_data[i] = visibility[i] & ~PATH_RAY_NODE_UNALIGNED;
+
+    for (int axis = 0; axis < 3; axis++) {
+      const float lo = bounds[i].min[axis];
+      const float hi = bounds[i].max[axis];
+
+      int qlo = clamp((int)floorf((lo - origin[axis]) / step[axis]), 0, 255);
+      while (qlo > 0 && origin[axis] + step[axis] * qlo > lo) {
+        qlo--;
+      }
+      int qhi = clamp((int)ceilf((hi - origin[axis]) / step[axis]), 0, 255);
+      while (qhi < 255 && origin[axis] + step[axis] * qhi < hi) {
+        qhi++;
+      }
+
+      quantized[axis * 16 + i] = (uchar)qlo;
+      quantized[axis * 16 + 8 + i] = (uchar)qhi;
+    }
+  }
+
+  memcpy(&pack.nodes[idx], data, sizeof(int4) * BVH_ONODE_SIZE);
+}
+
+void BVH8::pack_inner(const BVHStackEntry &e, const BVHStackEntry *en, int num)
+{
+  BoundBox bounds[BVH_ONODE_NUM_CHILDREN];
+  int child[BVH_ONODE_NUM_CHILDREN];
+  uint visibility[BVH_ONODE_NUM_CHILDREN];
+
+  for (int i = 0; i < num; i++) {
+    bounds[i] = en[i].node->bounds;
+    child[i] = en[i].encodeIdx();
+    visibility[i] = en[i].node->visibility;
+  }
+
+  pack_node(e.idx, bounds, child, visibility, num);
+}
+
+void BVH8::pack_nodes(const BVHNode *root)
+{
+  const size_t num_nodes = root->getSubtreeSize(BVH_STAT_NODE_COUNT);
+  const size_t num_leaf_nodes = root->getSubtreeSize(BVH_STAT_LEAF_COUNT);
+  assert(num_leaf_nodes <= num_nodes);
+  const size_t num_inner_nodes = num_nodes - num_leaf_nodes;
+  const size_t node_size = num_inner_nodes * BVH_ONODE_SIZE;
+  /* Resize arrays */
+  pack.nodes.clear();
+  pack.leaf_nodes.clear();
+  /* For top level BVH, first merge existing BVH's so we know the offsets. */
+  if (params.top_level) {
+    pack_instances(node_size, num_leaf_nodes * BVH_NODE_LEAF_SIZE);
+  }
+  else {
+    pack.nodes.resize(node_size);
+    pack.leaf_nodes.resize(num_leaf_nodes * BVH_NODE_LEAF_SIZE);
+  }
+
+  int nextNodeIdx = 0, nextLeafNodeIdx = 0;
+
+  vector<BVHStackEntry> stack;
+  stack.reserve(BVHParams::MAX_DEPTH * BVH_ONODE_NUM_CHILDREN);
+  if (root->is_leaf()) {
+    stack.push_back(BVHStackEntry(root, nextLeafNodeIdx++));
+  }
+  else {
+    stack.push_back(BVHStackEntry(root, nextNodeIdx));
+    nextNodeIdx += BVH_ONODE_SIZE;
+  }
+
+  while (stack.size()) {
+    BVHStackEntry e = stack.back();
+    stack.pop_back();
+
+    if (e.node->is_leaf()) {
+      /* leaf node */
+      const LeafNode *leaf = reinterpret_cast<const LeafNode *>(e.node);
+      pack_leaf(e, leaf);
+    }
+    else {
+      /* inner node */
+      const int num = e.node->num_children();
+      BVHStackEntry en[BVH_ONODE_NUM_CHILDREN];
+      for (int i = 0; i < num; ++i) {
+        const BVHNode *child = e.node->get_child(i);
+        if (child->is_leaf()) {
+          en[i] = BVHStackEntry(child, nextLeafNodeIdx++);
+        }
+        else {
+          en[i] = BVHStackEntry(child, nextNodeIdx);
+          nextNodeIdx += BVH_ONODE_SIZE;
+        }
+        stack.push_back(en[i]);
+      }
+
+      pack_inner(e, en, num);
+    }
+  }
+  assert(node_size == nextNodeIdx);
+  /* root index to start traversal at, to handle case of single leaf node */
+  pack.root_index = (root->is_leaf()) ? -1 : 0;
+}
+
+/* Refitting */
+
+void BVH8::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
+{
+  if (leaf) {
+    BVH2::refit_node(idx, leaf, bbox, visibility);
+    return;
+  }
+
+  assert(idx + BVH_ONODE_SIZE <= pack.nodes.size());
+
+  const int4 *data = &pack.nodes[idx];
+  const int num = data[0].w;
+  int child[BVH_ONODE_NUM_CHILDREN];
+  memcpy(child, &data[5], sizeof(child));
+
+  /* refit inner node, set bbox from children */
+  BoundBox child_bbox[BVH_ONODE_NUM_CHILDREN];
+  uint child_visibility[BVH_ONODE_NUM_CHILDREN];
+  for (int i = 0; i < num; i++) {
+    const int c = child[i];
+    child_bbox[i] = BoundBox::empty;
+    child_visibility[i] = 0;
+    refit_node((c < 0) ? -c - 1 : c, (c < 0), child_bbox[i], child_visibility[i]);
+
+    bbox.grow(child_bbox[i]);
+    visibility |= child_visibility[i];
+  }
+
+  pack_node(idx, child_bbox, child, child_visibility, num);
+}
+
+/* Pack Instances */
+
+void BVH8::pack_instance_nodes(const BVH2 *bvh, int4 *pack_nodes, int noffset, int noffset_leaf)
+{
+  const size_t bvh_nodes_size = bvh->pack.nodes.size();
+  memcpy(pack_nodes, &bvh->pack.nodes[0], sizeof(int4) * bvh_nodes_size);
+
+  /* Modify offsets into arrays */
+  for (size_t i = 0; i < bvh_nodes_size; i += BVH_ONODE_SIZE) {
+    const int num = pack_nodes[i].w;
+    int *child = (int *)&pack_nodes[i + 5];
+    for (int k = 0; k < num; k++) {
+      child[k] += (child[k] < 0) ? -noffset_leaf : noffset;
+    }
+  }
+}
+
+CCL_NAMESPACE_END
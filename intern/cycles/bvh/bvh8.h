@@ -0,0 +1,77 @@
+/*
+ * Copyright 2021, Blender Foundation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __BVH8_H__
+#define __BVH8_H__
+
+#include "bvh/bvh2.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Number of int4 rows of a packed 8-wide inner node:
+ *
+ * 0: origin of the quantization grid, number of children
+ * 1: power of two step of the quantization grid
+ * 2-4: quantized lower and upper child bounds for X, Y and Z, 8 bytes each
+ * 5-6: child node indices
+ * 7-8: child visibility flags
+ */
+#define BVH_ONODE_SIZE 9
+#define BVH_ONODE_NUM_CHILDREN 8
+
+/* BVH8
+ *
+ * BVH with up to eight children per inner node. The child bounds are stored
+ * quantized to 8 bits relative to the parent bounds, so a node takes less
+ * memory than the binary nodes it replaces. Leaf nodes and primitives use the
+ * same packing as BVH2.
+ *
+ * Only aligned nodes are supported, hair is bounded by regular boxes.
+ */
+class BVH8 : public BVH2 {
+ protected:
+  /* constructor */
+  friend class BVH;
+  BVH8(const BVHParams &params,
+       const vector<Geometry *> &geometry,
+       const vector<Object *> &objects);
+
+  /* Building process. */
+  BVHNode *widen_children_nodes(const BVHNode *root) override;
+
+  /* pack */
+  void pack_nodes(const BVHNode *root) override;
+
+  void pack_inner(const BVHStackEntry &e, const BVHStackEntry *en, int num);
+  void pack_node(int idx,
+                 const BoundBox *bounds,
+                 const int *child,
+                 const uint *visibility,
+                 const int num);
+
+  /* refit */
+  void refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility) override;
+
+  /* merge instance BVH's */
+  void pack_instance_nodes(const BVH2 *bvh,
+                           int4 *pack_nodes,
+                           int noffset,
+                           int noffset_leaf) override;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __BVH8_H__ */
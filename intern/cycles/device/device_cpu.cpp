@@ -31,6 +31,7 @@
 #include "device/device.h"
 #include "device/device_denoising.h"
 #include "device/device_intern.h"
+#include "device/device_path_guiding.h"
 #include "device/device_split_kernel.h"
 
 // clang-format off
@@ -187,8 +188,13 @@ class CPUDevice : public Device {
 #ifdef WITH_OPENIMAGEDENOISE
   oidn::DeviceRef oidn_device;
   oidn::FilterRef oidn_filter;
+  int oidn_num_threads = 0;
+#endif
+  /* Denoises finished tiles with OpenImageDenoise while the task pool renders. */
+  thread *denoise_thread = NULL;
+#ifdef __PATH_GUIDING__
+  PathGuidingField path_guiding;
 #endif
-  thread_spin_lock oidn_task_lock;
 #ifdef WITH_EMBREE
   RTCScene embree_scene = NULL;
   RTCDevice embree_device;
@@ -312,6 +318,11 @@ class CPUDevice : public Device {
 #ifdef WITH_OSL
     kernel_globals.osl = &osl_globals;
 #endif
+#ifdef __PATH_GUIDING__
+    kernel_globals.path_guiding = NULL;
+    kernel_globals.path_guiding_cdf = NULL;
+    kernel_globals.path_guiding_record = false;
+#endif
 #ifdef WITH_EMBREE
     embree_device = rtcNewDevice("verbose=0");
 #endif
@@ -356,6 +367,7 @@ class CPUDevice : public Device {
     rtcReleaseDevice(embree_device);
 #endif
     task_pool.cancel();
+    denoise_thread_join();
     texture_info.free();
   }
 
@@ -367,6 +379,12 @@ class CPUDevice : public Device {
   virtual BVHLayoutMask get_bvh_layout_mask() const override
   {
     BVHLayoutMask bvh_layout_mask = BVH_LAYOUT_BVH2;
+#ifdef WITH_CYCLES_OPTIMIZED_KERNEL_AVX2
+    /* 8-wide nodes are only traversed by the AVX2 kernel. */
+    if (DebugFlags().cpu.has_avx2() && system_cpu_support_avx2()) {
+      bvh_layout_mask |= BVH_LAYOUT_BVH8;
+    }
+#endif
 #ifdef WITH_EMBREE
     bvh_layout_mask |= BVH_LAYOUT_EMBREE;
 #endif /* WITH_EMBREE */
@@ -482,6 +500,12 @@ class CPUDevice : public Device {
       KernelData *const data = (KernelData *)host;
       data->bvh.scene = embree_scene;
     }
+#endif
+#ifdef __PATH_GUIDING__
+    if (strcmp(name, "__data") == 0) {
+      /* Scene changed, training data no longer matches it. */
+      path_guiding.reset();
+    }
 #endif
     kernel_const_copy(&kernel_globals, name, host, size);
   }
@@ -946,6 +970,14 @@ class CPUDevice : public Device {
     int start_sample = tile.start_sample;
     int end_sample = tile.start_sample + tile.num_samples;
 
+#ifdef __PATH_GUIDING__
+    /* The sampling distributions are only rebuilt in between render tasks. When this
+     * task renders the last samples of the tile nothing would use the training data,
+     * so skip recording it. */
+    kg->path_guiding_record = (kg->path_guiding != NULL) &&
+                              (end_sample < kernel_data.integrator.aa_samples);
+#endif
+
     /* Needed for Embree. */
     SIMD_SET_FLUSH_TO_ZERO;
 
@@ -1022,10 +1054,23 @@ class CPUDevice : public Device {
     static thread_mutex mutex;
     thread_scoped_lock lock(mutex);
 
+    /* Tiles denoised during rendering use a limited number of threads, full buffers all. */
+    const int num_threads = (task.type == DeviceTask::RENDER) ? denoise_num_threads(task) : 0;
+    if (oidn_device && oidn_num_threads != num_threads) {
+      oidn_filter = oidn::FilterRef();
+      oidn_device = oidn::DeviceRef();
+    }
+
     /* Create device and filter, cached for reuse. */
     if (!oidn_device) {
       oidn_device = oidn::newDevice();
+      if (num_threads > 0) {
+        oidn_device.set("numThreads", num_threads);
+        /* Don't pin threads, the render threads are running as well. */
+        oidn_device.set("setAffinity", false);
+      }
       oidn_device.commit();
+      oidn_num_threads = num_threads;
     }
     if (!oidn_filter) {
       oidn_filter = oidn_device.newFilter("RT");
@@ -1276,20 +1321,8 @@ class CPUDevice : public Device {
     /* NLM denoiser. */
     DenoisingTask *denoising = NULL;
 
-    /* OpenImageDenoise: we can only denoise with one thread at a time, so to
-     * avoid waiting with mutex locks in the denoiser, we let only a single
-     * thread acquire denoising tiles. */
-    uint tile_types = task.tile_types;
-    bool hold_denoise_lock = false;
-    if ((tile_types & RenderTile::DENOISE) && task.denoising.type == DENOISER_OPENIMAGEDENOISE) {
-      if (!oidn_task_lock.try_lock()) {
-        tile_types &= ~RenderTile::DENOISE;
-        hold_denoise_lock = true;
-      }
-    }
-
     RenderTile tile;
-    while (task.acquire_tile(this, tile, tile_types)) {
+    while (task.acquire_tile(this, tile, task.tile_types)) {
       if (tile.task == RenderTile::PATH_TRACE) {
         if (use_split_kernel) {
           device_only_memory<uchar> void_buffer(this, "void_buffer");
@@ -1324,10 +1357,6 @@ class CPUDevice : public Device {
       }
     }
 
-    if (hold_denoise_lock) {
-      oidn_task_lock.unlock();
-    }
-
     profiler.remove_state(&kg->profiler);
 
     thread_kernel_globals_free((KernelGlobals *)kgbuffer.device_pointer);
@@ -1337,6 +1366,41 @@ class CPUDevice : public Device {
     delete denoising;
   }
 
+  /* Denoise tiles with OpenImageDenoise as soon as they and their neighbors finished
+   * rendering, overlapping with the rendering of the remaining tiles. */
+  void thread_denoise_tiles(DeviceTask &task)
+  {
+    RenderTile tile;
+    while (task.acquire_tile(this, tile, RenderTile::DENOISE)) {
+      denoise_openimagedenoise(task, tile);
+      task.update_progress(&tile, tile.w * tile.h);
+
+      task.release_tile(tile);
+
+      if (task.get_cancel() && task.need_finish_queue == false) {
+        break;
+      }
+    }
+  }
+
+  int denoise_num_threads(const DeviceTask &task) const
+  {
+    if (task.denoising.num_threads > 0) {
+      return task.denoising.num_threads;
+    }
+    /* Keeps up with rendering for typical tile sizes, while most threads keep path tracing. */
+    return max(1, info.cpu_threads / 8);
+  }
+
+  void denoise_thread_join()
+  {
+    if (denoise_thread) {
+      denoise_thread->join();
+      delete denoise_thread;
+      denoise_thread = NULL;
+    }
+  }
+
   void thread_denoise(DeviceTask &task)
   {
     RenderTile tile;
@@ -1438,8 +1502,30 @@ class CPUDevice : public Device {
     /* Load texture info. */
     load_texture_info();
 
+#ifdef __PATH_GUIDING__
+    if (task.type == DeviceTask::RENDER) {
+      update_path_guiding();
+    }
+#endif
+
     /* split task into smaller ones */
     list<DeviceTask> tasks;
+    int num_render_threads = info.cpu_threads;
+
+    if (task.type == DeviceTask::RENDER && (task.tile_types & RenderTile::DENOISE) &&
+        task.denoising.type == DENOISER_OPENIMAGEDENOISE) {
+      /* Denoise tiles on a dedicated thread with a few OpenImageDenoise threads, instead of
+       * interleaving them with rendering and running the denoiser on all threads. */
+      denoise_thread_join();
+
+      DeviceTask denoise_task = task;
+      denoise_thread = new thread([this, denoise_task]() mutable {
+        thread_denoise_tiles(denoise_task);
+      });
+
+      task.tile_types &= ~RenderTile::DENOISE;
+      num_render_threads = max(1, info.cpu_threads - denoise_num_threads(task));
+    }
 
     if (task.type == DeviceTask::DENOISE_BUFFER &&
         task.denoising.type == DENOISER_OPENIMAGEDENOISE) {
@@ -1449,8 +1535,11 @@ class CPUDevice : public Device {
     else if (task.type == DeviceTask::SHADER) {
       task.split(tasks, info.cpu_threads, 256);
     }
+    else if (task.type == DeviceTask::RENDER && task.tile_types == 0) {
+      /* Only denoising tiles, handled by the denoise thread. */
+    }
     else {
-      task.split(tasks, info.cpu_threads);
+      task.split(tasks, num_render_threads);
     }
 
     foreach (DeviceTask &task, tasks) {
@@ -1464,6 +1553,7 @@ class CPUDevice : public Device {
   virtual void task_wait() override
   {
     task_pool.wait_work();
+    denoise_thread_join();
   }
 
   virtual void task_cancel() override
@@ -1472,6 +1562,21 @@ class CPUDevice : public Device {
   }
 
  protected:
+#ifdef __PATH_GUIDING__
+  void update_path_guiding()
+  {
+    /* Render tasks are added after the previous pass finished, so no kernel is
+     * accumulating training data while the sampling distributions are rebuilt. */
+    if (kernel_globals.__data.integrator.use_guiding) {
+      kernel_globals.path_guiding = path_guiding.get_kernel_data();
+      path_guiding.update();
+    }
+    else {
+      kernel_globals.path_guiding = NULL;
+    }
+  }
+#endif
+
   inline KernelGlobals thread_kernel_globals_init()
   {
     KernelGlobals kg = kernel_globals;
@@ -1625,7 +1730,9 @@ int2 CPUSplitKernel::split_kernel_global_size(device_memory & /*kg*/,
                                               device_memory & /*data*/,
                                               DeviceTask & /*task*/)
 {
-  return make_int2(1, 1);
+  /* Each thread keeps a batch of paths in flight, so that after intersection they can be
+   * sorted by shader and evaluated together. The batch fits in one shader sort block. */
+  return make_int2(32, 32);
 }
 
 uint64_t CPUSplitKernel::state_buffer_size(device_memory &kernel_globals,
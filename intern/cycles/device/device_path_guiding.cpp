@@ -0,0 +1,122 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "device/device_path_guiding.h"
+
+#include "util/util_logging.h"
+#include "util/util_tbb.h"
+
+CCL_NAMESPACE_BEGIN
+
+#ifdef __PATH_GUIDING__
+
+/* Minimum number of training samples before a cell is used for sampling. */
+static const uint PATH_GUIDING_MIN_SAMPLES = 64;
+/* Fraction of the distribution spread uniformly over the sphere, so that
+ * directions which happened to receive no radiance in training remain reachable. */
+static const float PATH_GUIDING_UNIFORM_FRACTION = 0.1f;
+
+PathGuidingField::PathGuidingField()
+{
+  kernel_data.train = NULL;
+  kernel_data.train_samples = NULL;
+  kernel_data.cdf = NULL;
+}
+
+void PathGuidingField::alloc()
+{
+  train.resize(PATH_GUIDING_NUM_CELLS * PATH_GUIDING_NUM_BINS);
+  train_samples.resize(PATH_GUIDING_NUM_CELLS);
+  cdf_samples.resize(PATH_GUIDING_NUM_CELLS);
+  cdf.resize(PATH_GUIDING_NUM_CELLS * PATH_GUIDING_NUM_BINS);
+
+  kernel_data.train = train.data();
+  kernel_data.train_samples = train_samples.data();
+  kernel_data.cdf = cdf.data();
+
+  reset();
+}
+
+void PathGuidingField::reset()
+{
+  std::fill(train.begin(), train.end(), 0.0f);
+  std::fill(train_samples.begin(), train_samples.end(), 0);
+  std::fill(cdf_samples.begin(), cdf_samples.end(), 0);
+  std::fill(cdf.begin(), cdf.end(), 0.0f);
+}
+
+void PathGuidingField::update_cell(int cell)
+{
+  const uint num_samples = train_samples[cell];
+  if (num_samples == cdf_samples[cell]) {
+    return;
+  }
+  cdf_samples[cell] = num_samples;
+
+  const float *cell_train = &train[cell * PATH_GUIDING_NUM_BINS];
+  float *cell_cdf = &cdf[cell * PATH_GUIDING_NUM_BINS];
+
+  float sum = 0.0f;
+  for (int i = 0; i < PATH_GUIDING_NUM_BINS; i++) {
+    sum += cell_train[i];
+  }
+
+  if (num_samples < PATH_GUIDING_MIN_SAMPLES || !(sum > 0.0f)) {
+    /* Not enough data yet, leave the cell disabled. */
+    cell_cdf[PATH_GUIDING_NUM_BINS - 1] = 0.0f;
+    return;
+  }
+
+  const float uniform = PATH_GUIDING_UNIFORM_FRACTION / PATH_GUIDING_NUM_BINS;
+  const float scale = (1.0f - PATH_GUIDING_UNIFORM_FRACTION) / sum;
+
+  float accum = 0.0f;
+  for (int i = 0; i < PATH_GUIDING_NUM_BINS; i++) {
+    accum += cell_train[i] * scale + uniform;
+    cell_cdf[i] = accum;
+  }
+
+  /* Avoid numerical drift, sampling expects the last entry to be exactly one. */
+  cell_cdf[PATH_GUIDING_NUM_BINS - 1] = 1.0f;
+}
+
+void PathGuidingField::update()
+{
+  if (kernel_data.cdf == NULL) {
+    return;
+  }
+
+  parallel_for(blocked_range<int>(0, PATH_GUIDING_NUM_CELLS),
+               [&](const blocked_range<int> &range) {
+                 for (int cell = range.begin(); cell != range.end(); cell++) {
+                   update_cell(cell);
+                 }
+               });
+}
+
+KernelPathGuiding *PathGuidingField::get_kernel_data()
+{
+  if (kernel_data.cdf == NULL) {
+    VLOG(1) << "Allocating path guiding field with " << PATH_GUIDING_NUM_CELLS << " cells.";
+    alloc();
+  }
+
+  return &kernel_data;
+}
+
+#endif /* __PATH_GUIDING__ */
+
+CCL_NAMESPACE_END
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __DEVICE_PATH_GUIDING_H__
+#define __DEVICE_PATH_GUIDING_H__
+
+#include "kernel/kernel_types.h"
+
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+#ifdef __PATH_GUIDING__
+
+/* Host side storage of the path guiding field used by the CPU kernels.
+ *
+ * Training data is accumulated by the render threads while a pass renders, the
+ * sampling distributions are rebuilt with update() while no render threads are
+ * running, in between passes. */
+class PathGuidingField {
+ public:
+  PathGuidingField();
+
+  /* Discard all training data, for example after the scene changed. */
+  void reset();
+
+  /* Rebuild the sampling distributions from the training data. */
+  void update();
+
+  /* Kernel side view of the field, allocating storage on first use. */
+  KernelPathGuiding *get_kernel_data();
+
+ protected:
+  void alloc();
+  void update_cell(int cell);
+
+  vector<float> train;
+  vector<uint> train_samples;
+  vector<uint> cdf_samples;
+  vector<float> cdf;
+
+  KernelPathGuiding kernel_data;
+};
+
+#endif /* __PATH_GUIDING__ */
+
+CCL_NAMESPACE_END
+
+#endif /* __DEVICE_PATH_GUIDING_H__ */
@@ -86,6 +86,9 @@ class DenoiseParams {
   /* Passes handed over to the OIDN/OptiX denoiser (default to color + albedo). */
   DenoiserInput input_passes;
 
+  /* CPU threads denoising tiles with OIDN while other tiles render, zero for automatic. */
+  int num_threads;
+
   DenoiseParams()
   {
     use = false;
@@ -103,6 +106,7 @@ class DenoiseParams {
     /* Default to color + albedo only, since normal input does not always have the desired effect
      * when denoising with OptiX. */
     input_passes = DENOISER_INPUT_RGB_ALBEDO;
+    num_threads = 0;
 
     start_sample = 0;
   }
@@ -39,6 +39,7 @@ CCL_NAMESPACE_BEGIN
 /* Regular BVH traversal */
 
 #  include "kernel/bvh/bvh_nodes.h"
+#  include "kernel/bvh/obvh_nodes.h"
 
 #  define BVH_FUNCTION_NAME bvh_intersect
 #  define BVH_FUNCTION_FEATURES 0
@@ -77,6 +77,14 @@ ccl_device_inline
   do {
     do {
       /* traverse internal nodes */
+#if defined(__KERNEL_AVX2__)
+      if (kernel_data.bvh.bvh_layout == BVH_LAYOUT_BVH8) {
+        while (node_addr >= 0 && node_addr != ENTRYPOINT_SENTINEL) {
+          node_addr = obvh_node_traverse(
+              kg, P, idir, isect_t, node_addr, visibility, traversal_stack, &stack_ptr);
+        }
+      }
+#endif
       while (node_addr >= 0 && node_addr != ENTRYPOINT_SENTINEL) {
         int node_addr_child1, traverse_mask;
         float dist[2];
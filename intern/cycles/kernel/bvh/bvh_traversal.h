@@ -73,6 +73,15 @@ ccl_device_noinline bool BVH_FUNCTION_FULL_NAME(BVH)(KernelGlobals *kg,
   do {
     do {
       /* traverse internal nodes */
+#if defined(__KERNEL_AVX2__)
+      if (kernel_data.bvh.bvh_layout == BVH_LAYOUT_BVH8) {
+        while (node_addr >= 0 && node_addr != ENTRYPOINT_SENTINEL) {
+          node_addr = obvh_node_traverse(
+              kg, P, idir, isect->t, node_addr, visibility, traversal_stack, &stack_ptr);
+          BVH_DEBUG_NEXT_NODE();
+        }
+      }
+#endif
       while (node_addr >= 0 && node_addr != ENTRYPOINT_SENTINEL) {
         int node_addr_child1, traverse_mask;
         float dist[2];
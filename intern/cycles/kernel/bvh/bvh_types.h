@@ -30,7 +30,12 @@ CCL_NAMESPACE_BEGIN
 #define ENTRYPOINT_SENTINEL 0x76543210
 
 /* 64 object BVH + 64 mesh BVH + 64 object node splitting */
-#define BVH_STACK_SIZE 192
+#ifdef __KERNEL_AVX2__
+/* 8-wide nodes push up to 7 children per level. */
+#  define BVH_STACK_SIZE 768
+#else
+#  define BVH_STACK_SIZE 192
+#endif
 /* BVH intersection function variations */
 
 #define BVH_MOTION 1
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Traversal of 8-wide BVH nodes with quantized child bounds, see bvh/bvh8.h
+ * for the node layout. All eight children are tested at once using AVX2. */
+
+#ifdef __KERNEL_AVX2__
+
+ccl_device_forceinline avxf obvh_node_dequantize(const uchar *quantized,
+                                                 const float origin,
+                                                 const float step)
+{
+  const __m256i q = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)quantized));
+  return madd(avxf(_mm256_cvtepi32_ps(q)), avxf(step), avxf(origin));
+}
+
+ccl_device_forceinline uint obvh_node_intersect(KernelGlobals *kg,
+                                                const float3 P,
+                                                const float3 idir,
+                                                const float t,
+                                                const int node_addr,
+                                                const uint visibility,
+                                                avxf *dist)
+{
+  const float4 origin = kernel_tex_fetch(__bvh_nodes, node_addr + 0);
+  const float4 step = kernel_tex_fetch(__bvh_nodes, node_addr + 1);
+  const uchar *qx = (const uchar *)&kernel_tex_fetch(__bvh_nodes, node_addr + 2);
+  const uchar *qy = (const uchar *)&kernel_tex_fetch(__bvh_nodes, node_addr + 3);
+  const uchar *qz = (const uchar *)&kernel_tex_fetch(__bvh_nodes, node_addr + 4);
+
+  const avxf idir_x(idir.x), idir_y(idir.y), idir_z(idir.z);
+  const avxf P_idir_x(P.x * idir.x), P_idir_y(P.y * idir.y), P_idir_z(P.z * idir.z);
+
+  /* intersect ray against child nodes */
+  const avxf lo_x = msub(obvh_node_dequantize(qx, origin.x, step.x), idir_x, P_idir_x);
+  const avxf hi_x = msub(obvh_node_dequantize(qx + 8, origin.x, step.x), idir_x, P_idir_x);
+  const avxf lo_y = msub(obvh_node_dequantize(qy, origin.y, step.y), idir_y, P_idir_y);
+  const avxf hi_y = msub(obvh_node_dequantize(qy + 8, origin.y, step.y), idir_y, P_idir_y);
+  const avxf lo_z = msub(obvh_node_dequantize(qz, origin.z, step.z), idir_z, P_idir_z);
+  const avxf hi_z = msub(obvh_node_dequantize(qz + 8, origin.z, step.z), idir_z, P_idir_z);
+
+  const avxf tnear = max(max(min(lo_x, hi_x), min(lo_y, hi_y)),
+                         max(min(lo_z, hi_z), avxf(0.0f)));
+  const avxf tfar = min(min(max(lo_x, hi_x), max(lo_y, hi_y)), min(max(lo_z, hi_z), avxf(t)));
+
+  uint mask = movemask(tnear <= tfar);
+
+#ifdef __VISIBILITY_FLAG__
+  /* Unused child slots have no visibility flags. */
+  const __m256i child_visibility = _mm256_loadu_si256(
+      (const __m256i *)&kernel_tex_fetch(__bvh_nodes, node_addr + 7));
+  const __m256i invisible = _mm256_cmpeq_epi32(
+      _mm256_and_si256(child_visibility, _mm256_set1_epi32(visibility)),
+      _mm256_setzero_si256());
+  mask &= ~(uint)_mm256_movemask_ps(_mm256_castsi256_ps(invisible));
+#else
+  (void)visibility;
+  mask &= (1u << __float_as_int(origin.w)) - 1u;
+#endif
+
+  *dist = tnear;
+  return mask;
+}
+
+/* Intersect the ray with all children of an 8-wide node. The intersected
+ * children except the nearest one are pushed on the stack, sorted so the
+ * nearer ones are visited first. Returns the nearest child, or the next node
+ * from the stack when no child was intersected. */
+ccl_device_forceinline int obvh_node_traverse(KernelGlobals *kg,
+                                              const float3 P,
+                                              const float3 idir,
+                                              const float t,
+                                              const int node_addr,
+                                              const uint visibility,
+                                              int *traversal_stack,
+                                              int *stack_ptr)
+{
+  avxf dist;
+  uint mask = obvh_node_intersect(kg, P, idir, t, node_addr, visibility, &dist);
+
+  if (mask == 0) {
+    /* No child was intersected. */
+    return traversal_stack[(*stack_ptr)--];
+  }
+
+  const int *child = (const int *)&kernel_tex_fetch(__bvh_nodes, node_addr + 5);
+
+  const int first = bitscan(mask);
+  mask &= mask - 1;
+  if (mask == 0) {
+    /* One child was intersected. */
+    return child[first];
+  }
+
+  /* Insertion sort of the intersected children on the stack, farthest first. */
+  const int base = *stack_ptr + 1;
+  float stack_dist[8];
+  int num = 1;
+  stack_dist[0] = dist[first];
+  traversal_stack[base] = child[first];
+
+  while (mask != 0) {
+    const int i = bitscan(mask);
+    mask &= mask - 1;
+
+    const float d = dist[i];
+    int j = num++;
+    for (; j > 0 && stack_dist[j - 1] < d; j--) {
+      stack_dist[j] = stack_dist[j - 1];
+      traversal_stack[base + j] = traversal_stack[base + j - 1];
+    }
+    stack_dist[j] = d;
+    traversal_stack[base + j] = child[i];
+  }
+
+  kernel_assert(base + num - 1 < BVH_STACK_SIZE);
+
+  /* Continue with the nearest child. */
+  *stack_ptr = base + num - 2;
+  return traversal_stack[base + num - 1];
+}
+
+#endif /* __KERNEL_AVX2__ */
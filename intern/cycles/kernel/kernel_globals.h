@@ -78,6 +78,15 @@ typedef struct KernelGlobals {
   CoverageMap *coverage_material;
   CoverageMap *coverage_asset;
 
+#  ifdef __PATH_GUIDING__
+  /* Path guiding field shared by all threads, NULL when guiding is disabled. */
+  KernelPathGuiding *path_guiding;
+  /* Guiding distribution of the shading point that lights are sampled from. */
+  const float *path_guiding_cdf;
+  /* Record training data, only when the distributions are rebuilt after this pass. */
+  bool path_guiding_record;
+#  endif
+
   /* split kernel */
   SplitData split_data;
   SplitParams split_param_data;
@@ -524,6 +524,11 @@ ccl_device_forceinline void kernel_path_integrate(KernelGlobals *kg,
   /* Shader data memory used for both volumes and surfaces, saves stack space. */
   ShaderData sd;
 
+#  ifdef __PATH_GUIDING__
+  PathGuidingState guiding_state;
+  path_guiding_state_init(&guiding_state);
+#  endif
+
 #  ifdef __SUBSURFACE__
   SubsurfaceIndirectRays ss_indirect;
   kernel_path_subsurface_init_indirect(&ss_indirect);
@@ -625,7 +630,14 @@ ccl_device_forceinline void kernel_path_integrate(KernelGlobals *kg,
 
 #  ifdef __EMISSION__
         /* direct lighting */
+#    ifdef __PATH_GUIDING__
+        int guiding_cell;
+        kg->path_guiding_cdf = path_guiding_cell_cdf(kg, &sd, &guiding_cell);
+#    endif
         kernel_path_surface_connect_light(kg, &sd, emission_sd, throughput, state, L);
+#    ifdef __PATH_GUIDING__
+        kg->path_guiding_cdf = NULL;
+#    endif
 #  endif /* __EMISSION__ */
 
 #  ifdef __VOLUME__
@@ -633,10 +645,21 @@ ccl_device_forceinline void kernel_path_integrate(KernelGlobals *kg,
 #  endif
 
       /* compute direct lighting and next bounce */
+#  ifdef __PATH_GUIDING__
+      if (!kernel_path_guiding_surface_bounce(
+              kg, &sd, &throughput, state, L, ray, &guiding_state))
+        break;
+#  else
       if (!kernel_path_surface_bounce(kg, &sd, &throughput, state, &L->state, ray))
         break;
+#  endif
     }
 
+#  ifdef __PATH_GUIDING__
+    /* Train guiding with the radiance found along this path segment. */
+    path_guiding_commit(kg, &guiding_state, L);
+#  endif
+
 #  ifdef __SUBSURFACE__
     /* Trace indirect subsurface rays by restarting the loop. this uses less
      * stack memory than invoking kernel_path_indirect.
@@ -0,0 +1,250 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Path Guiding
+ *
+ * Online learned directional distributions for indirect diffuse bounces. Each
+ * surface bounce records the sampled direction into a spatial hash of
+ * histograms, together with the radiance that later arrives along it. Between
+ * passes the host turns the histograms into CDFs, which are then mixed with
+ * BSDF sampling using one-sample MIS. Since the sampling CDFs do not
+ * change while a pass renders, the mixture pdf is exact and the result stays
+ * unbiased, only the amount of noise depends on the quality of the training.
+ * Renders that are not progressive are split into training passes for the
+ * first samples, see TileManager::use_training_passes.
+ *
+ * Light sampling at a guided shading point uses the same mixture density for
+ * MIS, see shader_bsdf_eval(). */
+
+#include "util/util_atomic.h"
+
+CCL_NAMESPACE_BEGIN
+
+#ifdef __PATH_GUIDING__
+
+/* Probability of sampling the guiding distribution instead of the BSDF, once
+ * the cell has been trained. */
+#  define PATH_GUIDING_PROBABILITY 0.5f
+/* Maximum number of bounces per path recorded for training. */
+#  define PATH_GUIDING_MAX_VERTICES 8
+
+typedef struct PathGuidingVertex {
+  /* Path throughput after the bounce. */
+  float3 throughput;
+  /* Radiance accumulated along the path before the bounce. */
+  float3 L_prefix;
+  /* Probability density of the sampled direction. */
+  float pdf;
+  int cell;
+  int bin;
+} PathGuidingVertex;
+
+typedef struct PathGuidingState {
+  int num_vertices;
+  PathGuidingVertex vertex[PATH_GUIDING_MAX_VERTICES];
+} PathGuidingState;
+
+ccl_device_inline void path_guiding_state_init(PathGuidingState *gs)
+{
+  gs->num_vertices = 0;
+}
+
+ccl_device_inline int path_guiding_cell(KernelGlobals *kg, float3 P, float3 N)
+{
+  const float inv_cell_size = kernel_data.integrator.guiding_inv_cell_size;
+  const int x = float_to_int(floorf(P.x * inv_cell_size));
+  const int y = float_to_int(floorf(P.y * inv_cell_size));
+  const int z = float_to_int(floorf(P.z * inv_cell_size));
+
+  /* Keep both sides of thin walls apart by including the dominant normal axis. */
+  const float3 aN = fabs(N);
+  uint side;
+  if (aN.x > aN.y && aN.x > aN.z) {
+    side = (N.x > 0.0f) ? 0 : 1;
+  }
+  else if (aN.y > aN.z) {
+    side = (N.y > 0.0f) ? 2 : 3;
+  }
+  else {
+    side = (N.z > 0.0f) ? 4 : 5;
+  }
+
+  return hash_uint4(x, y, z, side) & (PATH_GUIDING_NUM_CELLS - 1);
+}
+
+ccl_device_inline int path_guiding_direction_to_bin(float3 D)
+{
+  const int res = PATH_GUIDING_RESOLUTION;
+  const float u = atan2f(D.y, D.x) * M_1_2PI_F + 0.5f;
+  const float v = D.z * 0.5f + 0.5f;
+  const int iu = clamp(float_to_int(u * res), 0, res - 1);
+  const int iv = clamp(float_to_int(v * res), 0, res - 1);
+  return iv * res + iu;
+}
+
+ccl_device_inline float path_guiding_bin_probability(const float *cdf, int bin)
+{
+  return (bin > 0) ? cdf[bin] - cdf[bin - 1] : cdf[0];
+}
+
+/* Solid angle density of a direction, bins cover equal areas of the sphere. */
+ccl_device_inline float path_guiding_pdf(const float *cdf, float3 D)
+{
+  const int bin = path_guiding_direction_to_bin(D);
+  return path_guiding_bin_probability(cdf, bin) * (PATH_GUIDING_NUM_BINS / M_4PI_F);
+}
+
+ccl_device float3 path_guiding_sample(const float *cdf, float randu, float randv, float *pdf)
+{
+  /* Find first bin with a CDF value larger than randu. */
+  int lo = 0;
+  int hi = PATH_GUIDING_NUM_BINS - 1;
+  while (lo < hi) {
+    const int mid = (lo + hi) >> 1;
+    if (randu < cdf[mid]) {
+      hi = mid;
+    }
+    else {
+      lo = mid + 1;
+    }
+  }
+
+  const int bin = lo;
+  const float cdf_prev = (bin > 0) ? cdf[bin - 1] : 0.0f;
+  const float probability = cdf[bin] - cdf_prev;
+
+  /* Reuse the random number within the bin to preserve stratification. */
+  randu = clamp((randu - cdf_prev) / probability, 0.0f, 1.0f - FLT_EPSILON);
+
+  const int res = PATH_GUIDING_RESOLUTION;
+  const float u = ((bin % res) + randu) / res;
+  const float v = ((bin / res) + randv) / res;
+
+  const float z = 2.0f * v - 1.0f;
+  const float r = safe_sqrtf(1.0f - z * z);
+  const float phi = (u - 0.5f) * M_2PI_F;
+
+  *pdf = probability * (PATH_GUIDING_NUM_BINS / M_4PI_F);
+  return make_float3(r * cosf(phi), r * sinf(phi), z);
+}
+
+/* Guiding only handles diffuse closures, for which the sampled direction fully
+ * determines the label and there are no singular lobes that can't be mixed. */
+ccl_device_inline bool path_guiding_shader_supported(const ShaderData *sd)
+{
+  if (!(sd->flag & SD_BSDF_HAS_EVAL) || (sd->flag & SD_BSSRDF)) {
+    return false;
+  }
+
+  for (int i = 0; i < sd->num_closure; i++) {
+    const ShaderClosure *sc = &sd->closure[i];
+
+    if (CLOSURE_IS_BSDF(sc->type) && !CLOSURE_IS_BSDF_DIFFUSE(sc->type)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/* Sampling distribution of the cell containing the shading point, or NULL when
+ * the shader is not supported or the cell has not been trained yet. */
+ccl_device_inline const float *path_guiding_cell_cdf(KernelGlobals *kg,
+                                                     const ShaderData *sd,
+                                                     int *r_cell)
+{
+  *r_cell = -1;
+
+  if (!kernel_data.integrator.use_guiding || kg->path_guiding == NULL ||
+      !path_guiding_shader_supported(sd)) {
+    return NULL;
+  }
+
+  *r_cell = path_guiding_cell(kg, sd->P, sd->Ng);
+  const float *cdf = kg->path_guiding->cdf + (*r_cell) * PATH_GUIDING_NUM_BINS;
+  return (cdf[PATH_GUIDING_NUM_BINS - 1] > 0.0f) ? cdf : NULL;
+}
+
+/* Density of the mixture of BSDF and guided sampling, for MIS with light sampling. */
+ccl_device_inline float path_guiding_mis_pdf(const float *cdf, float3 D, float bsdf_pdf)
+{
+  return PATH_GUIDING_PROBABILITY * path_guiding_pdf(cdf, D) +
+         (1.0f - PATH_GUIDING_PROBABILITY) * bsdf_pdf;
+}
+
+/* Total radiance accumulated so far. Only differences between two points along
+ * the same path are used, so contributions of the first bounce that end up in
+ * separate passes do not have to be recombined. */
+ccl_device_inline float3 path_guiding_radiance_sum(const PathRadiance *L)
+{
+#  ifdef __PASSES__
+  if (L->use_light_pass) {
+    return L->emission + L->background + L->direct_emission + L->indirect + L->direct_diffuse +
+           L->direct_glossy + L->direct_transmission + L->direct_volume;
+  }
+#  endif
+  return L->emission;
+}
+
+ccl_device_inline void path_guiding_record_vertex(PathGuidingState *gs,
+                                                  int cell,
+                                                  float3 D,
+                                                  float3 throughput,
+                                                  float pdf,
+                                                  float3 L_prefix)
+{
+  if (gs->num_vertices < PATH_GUIDING_MAX_VERTICES) {
+    PathGuidingVertex *v = &gs->vertex[gs->num_vertices++];
+    v->throughput = throughput;
+    v->L_prefix = L_prefix;
+    v->pdf = pdf;
+    v->cell = cell;
+    v->bin = path_guiding_direction_to_bin(D);
+  }
+}
+
+/* Add the radiance that arrived along each recorded direction to the training
+ * histograms, and reset the state for the next path segment. */
+ccl_device void path_guiding_commit(KernelGlobals *kg, PathGuidingState *gs, PathRadiance *L)
+{
+  if (gs->num_vertices == 0) {
+    return;
+  }
+
+  KernelPathGuiding *guiding = kg->path_guiding;
+  const float3 L_sum = path_guiding_radiance_sum(L);
+
+  for (int i = 0; i < gs->num_vertices; i++) {
+    const PathGuidingVertex *v = &gs->vertex[i];
+
+    /* Incident radiance estimate, divided by the sampling density so that the
+     * histogram bins estimate the integral of incident radiance over their area. */
+    const float3 L_incident = safe_divide_color(L_sum - v->L_prefix, v->throughput);
+    const float value = average(L_incident) / v->pdf;
+
+    if (value > 0.0f && isfinite_safe(value)) {
+      atomic_add_and_fetch_float(&guiding->train[v->cell * PATH_GUIDING_NUM_BINS + v->bin],
+                                 value);
+    }
+    atomic_fetch_and_add_uint32(&guiding->train_samples[v->cell], 1);
+  }
+
+  gs->num_vertices = 0;
+}
+
+#endif /* __PATH_GUIDING__ */
+
+CCL_NAMESPACE_END
@@ -266,6 +266,50 @@ ccl_device_inline void kernel_path_surface_connect_light(KernelGlobals *kg,
 #endif
 }
 
+/* path tracing: update path state and setup the continuation ray after a sampled
+ * surface bounce, shared by BSDF and guided sampling */
+ccl_device_inline void kernel_path_surface_bounce_setup(KernelGlobals *kg,
+                                                        ShaderData *sd,
+                                                        ccl_addr_space PathState *state,
+                                                        ccl_addr_space Ray *ray,
+                                                        int label,
+                                                        float bsdf_pdf,
+                                                        float3 bsdf_omega_in,
+                                                        differential3 bsdf_domega_in)
+{
+  /* set labels */
+  if (!(label & LABEL_TRANSPARENT)) {
+    state->ray_pdf = bsdf_pdf;
+#ifdef __LAMP_MIS__
+    state->ray_t = 0.0f;
+#endif
+    state->min_ray_pdf = fminf(bsdf_pdf, state->min_ray_pdf);
+  }
+
+  /* update path state */
+  path_state_next(kg, state, label);
+
+  /* setup ray */
+  ray->P = ray_offset(sd->P, (label & LABEL_TRANSMIT) ? -sd->Ng : sd->Ng);
+  ray->D = normalize(bsdf_omega_in);
+
+  if (state->bounce == 0)
+    ray->t -= sd->ray_length; /* clipping works through transparent */
+  else
+    ray->t = FLT_MAX;
+
+#ifdef __RAY_DIFFERENTIALS__
+  ray->dP = sd->dP;
+  ray->dD = bsdf_domega_in;
+#endif
+
+#ifdef __VOLUME__
+  /* enter/exit volume */
+  if (label & LABEL_TRANSMIT)
+    kernel_volume_stack_enter_exit(kg, sd, state->volume_stack);
+#endif
+}
+
 /* path tracing: bounce off or through surface to with new direction stored in ray */
 ccl_device bool kernel_path_surface_bounce(KernelGlobals *kg,
                                            ShaderData *sd,
@@ -296,37 +340,8 @@ ccl_device bool kernel_path_surface_bounce(KernelGlobals *kg,
     /* modify throughput */
     path_radiance_bsdf_bounce(kg, L_state, throughput, &bsdf_eval, bsdf_pdf, state->bounce, label);
 
-    /* set labels */
-    if (!(label & LABEL_TRANSPARENT)) {
-      state->ray_pdf = bsdf_pdf;
-#ifdef __LAMP_MIS__
-      state->ray_t = 0.0f;
-#endif
-      state->min_ray_pdf = fminf(bsdf_pdf, state->min_ray_pdf);
-    }
-
-    /* update path state */
-    path_state_next(kg, state, label);
-
-    /* setup ray */
-    ray->P = ray_offset(sd->P, (label & LABEL_TRANSMIT) ? -sd->Ng : sd->Ng);
-    ray->D = normalize(bsdf_omega_in);
-
-    if (state->bounce == 0)
-      ray->t -= sd->ray_length; /* clipping works through transparent */
-    else
-      ray->t = FLT_MAX;
-
-#ifdef __RAY_DIFFERENTIALS__
-    ray->dP = sd->dP;
-    ray->dD = bsdf_domega_in;
-#endif
-
-#ifdef __VOLUME__
-    /* enter/exit volume */
-    if (label & LABEL_TRANSMIT)
-      kernel_volume_stack_enter_exit(kg, sd, state->volume_stack);
-#endif
+    kernel_path_surface_bounce_setup(
+        kg, sd, state, ray, label, bsdf_pdf, bsdf_omega_in, bsdf_domega_in);
     return true;
   }
 #ifdef __VOLUME__
@@ -357,4 +372,81 @@ ccl_device bool kernel_path_surface_bounce(KernelGlobals *kg,
   }
 }
 
+#ifdef __PATH_GUIDING__
+/* path tracing: bounce off surface, mixing BSDF sampling with the learned path
+ * guiding distribution of the cell, and record the vertex for training */
+ccl_device bool kernel_path_guiding_surface_bounce(KernelGlobals *kg,
+                                                   ShaderData *sd,
+                                                   float3 *throughput,
+                                                   PathState *state,
+                                                   PathRadiance *L,
+                                                   Ray *ray,
+                                                   PathGuidingState *gs)
+{
+  int cell;
+  const float *cdf = path_guiding_cell_cdf(kg, sd, &cell);
+
+  if (cell == -1 || !(sd->flag & SD_BSDF) || (cdf == NULL && !kg->path_guiding_record)) {
+    return kernel_path_surface_bounce(kg, sd, throughput, state, &L->state, ray);
+  }
+
+  PROFILING_INIT(kg, PROFILING_SURFACE_BOUNCE);
+
+  /* Untrained cells still record BSDF samples, to learn the distribution. */
+  const float guide_probability = (cdf != NULL) ? PATH_GUIDING_PROBABILITY : 0.0f;
+
+  float bsdf_u, bsdf_v;
+  path_state_rng_2D(kg, state, PRNG_BSDF_U, &bsdf_u, &bsdf_v);
+
+  float bsdf_pdf = 0.0f, guide_pdf = 0.0f;
+  BsdfEval bsdf_eval ccl_optional_struct_init;
+  float3 bsdf_omega_in ccl_optional_struct_init;
+  differential3 bsdf_domega_in ccl_optional_struct_init;
+  int label;
+
+  if (bsdf_u < guide_probability) {
+    /* sample guiding distribution and evaluate all closures for the direction */
+    bsdf_omega_in = path_guiding_sample(cdf, bsdf_u / guide_probability, bsdf_v, &guide_pdf);
+    bsdf_domega_in = differential3_zero();
+
+    bsdf_eval_init(&bsdf_eval, NBUILTIN_CLOSURES, zero_float3(), kernel_data.film.use_light_pass);
+    _shader_bsdf_multi_eval(kg, sd, bsdf_omega_in, &bsdf_pdf, NULL, &bsdf_eval, 0.0f, 0.0f);
+
+    label = LABEL_DIFFUSE |
+            ((dot(bsdf_omega_in, sd->Ng) < 0.0f) ? LABEL_TRANSMIT : LABEL_REFLECT);
+  }
+  else {
+    /* sample BSDF and look up the density of the guiding distribution */
+    bsdf_u = (bsdf_u - guide_probability) / (1.0f - guide_probability);
+    label = shader_bsdf_sample(
+        kg, sd, bsdf_u, bsdf_v, &bsdf_eval, &bsdf_omega_in, &bsdf_domega_in, &bsdf_pdf);
+
+    if (bsdf_pdf == 0.0f)
+      return false;
+
+    if (cdf != NULL) {
+      guide_pdf = path_guiding_pdf(cdf, bsdf_omega_in);
+    }
+  }
+
+  /* one-sample MIS of both strategies */
+  const float pdf = guide_probability * guide_pdf + (1.0f - guide_probability) * bsdf_pdf;
+
+  if (pdf == 0.0f || bsdf_eval_is_zero(&bsdf_eval))
+    return false;
+
+  /* modify throughput */
+  path_radiance_bsdf_bounce(kg, &L->state, throughput, &bsdf_eval, pdf, state->bounce, label);
+
+  if (kg->path_guiding_record) {
+    path_guiding_record_vertex(
+        gs, cell, bsdf_omega_in, *throughput, pdf, path_guiding_radiance_sum(L));
+  }
+
+  kernel_path_surface_bounce_setup(
+      kg, sd, state, ray, label, pdf, bsdf_omega_in, bsdf_domega_in);
+  return true;
+}
+#endif /* __PATH_GUIDING__ */
+
 CCL_NAMESPACE_END
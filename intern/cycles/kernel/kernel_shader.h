@@ -32,6 +32,8 @@
 
 #include "kernel/svm/svm.h"
 
+#include "kernel/kernel_path_guiding.h"
+
 CCL_NAMESPACE_BEGIN
 
 /* ShaderData setup from incoming ray */
@@ -628,6 +630,13 @@ ccl_device_inline
     float pdf;
     _shader_bsdf_multi_eval(kg, sd, omega_in, &pdf, NULL, eval, 0.0f, 0.0f);
     if (use_mis) {
+#ifdef __PATH_GUIDING__
+      /* The bounce from this shading point may also be sampled from the guiding
+       * distribution, so MIS must use the density of the mixture. */
+      if (kg->path_guiding_cdf != NULL) {
+        pdf = path_guiding_mis_pdf(kg->path_guiding_cdf, omega_in, pdf);
+      }
+#endif
       float weight = power_heuristic(light_pdf, pdf);
       bsdf_eval_mis(eval, weight);
     }
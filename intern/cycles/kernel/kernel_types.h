@@ -124,6 +124,7 @@ CCL_NAMESPACE_BEGIN
 #  endif
 #  define __VOLUME_DECOUPLED__
 #  define __VOLUME_RECORD_ALL__
+#  define __PATH_GUIDING__
 #endif /* __KERNEL_CPU__ */
 
 #ifdef __KERNEL_CUDA__
@@ -1387,7 +1388,9 @@ typedef struct KernelIntegrator {
 
   int max_closures;
 
-  int pad1, pad2;
+  /* path guiding */
+  int use_guiding;
+  float guiding_inv_cell_size;
 } KernelIntegrator;
 static_assert_align(KernelIntegrator, 16);
 
@@ -1395,14 +1398,16 @@ typedef enum KernelBVHLayout {
   BVH_LAYOUT_NONE = 0,
 
   BVH_LAYOUT_BVH2 = (1 << 0),
-  BVH_LAYOUT_EMBREE = (1 << 1),
-  BVH_LAYOUT_OPTIX = (1 << 2),
-  BVH_LAYOUT_MULTI_OPTIX = (1 << 3),
-  BVH_LAYOUT_MULTI_OPTIX_EMBREE = (1 << 4),
-
-  /* Default BVH layout to use for CPU. */
+  BVH_LAYOUT_BVH8 = (1 << 1),
+  BVH_LAYOUT_EMBREE = (1 << 2),
+  BVH_LAYOUT_OPTIX = (1 << 3),
+  BVH_LAYOUT_MULTI_OPTIX = (1 << 4),
+  BVH_LAYOUT_MULTI_OPTIX_EMBREE = (1 << 5),
+
+  /* Default BVH layout to use for CPU. When Embree is not available, the
+   * widest supported native layout is used instead. */
   BVH_LAYOUT_AUTO = BVH_LAYOUT_EMBREE,
-  BVH_LAYOUT_ALL = BVH_LAYOUT_BVH2 | BVH_LAYOUT_EMBREE | BVH_LAYOUT_OPTIX,
+  BVH_LAYOUT_ALL = BVH_LAYOUT_BVH2 | BVH_LAYOUT_BVH8 | BVH_LAYOUT_EMBREE | BVH_LAYOUT_OPTIX,
 } KernelBVHLayout;
 
 typedef struct KernelBVH {
@@ -1700,6 +1705,32 @@ typedef struct WorkTile {
   ccl_global float *buffer;
 } WorkTile;
 
+/* Path Guiding
+ *
+ * Spatial hash of directional distributions, learned while rendering. Cells are
+ * addressed by hashing the quantized position and dominant normal axis. Every cell
+ * stores a PATH_GUIDING_RESOLUTION x PATH_GUIDING_RESOLUTION histogram over the
+ * sphere, using an equal-area (cos theta, phi) parameterization.
+ *
+ * The training histograms are atomically accumulated by the kernel, while the
+ * sampling CDFs are rebuilt on the host between progressive passes and are
+ * read-only during rendering. */
+
+#ifdef __PATH_GUIDING__
+#  define PATH_GUIDING_RESOLUTION 16
+#  define PATH_GUIDING_NUM_BINS (PATH_GUIDING_RESOLUTION * PATH_GUIDING_RESOLUTION)
+#  define PATH_GUIDING_NUM_CELLS (1 << 14)
+
+typedef struct KernelPathGuiding {
+  /* Accumulated incident radiance estimates, PATH_GUIDING_NUM_BINS per cell. */
+  float *train;
+  /* Number of training samples recorded per cell. */
+  uint *train_samples;
+  /* Cumulative distribution per cell, last entry is zero for untrained cells. */
+  float *cdf;
+} KernelPathGuiding;
+#endif /* __PATH_GUIDING__ */
+
 /* Pre-computed sample table sizes for PMJ02 sampler. */
 #define NUM_PMJ_SAMPLES (64 * 64)
 #define NUM_PMJ_PATTERNS 48
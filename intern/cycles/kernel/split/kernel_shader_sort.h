@@ -16,6 +16,51 @@
 
 CCL_NAMESPACE_BEGIN
 
+#ifndef __KERNEL_GPU__
+/* Order by shader, and by position in the queue for rays with the same shader so
+ * that the result is deterministic. */
+ccl_device_inline bool shader_sort_less(const uint *value, ushort a, ushort b)
+{
+  return (value[a] < value[b]) || (value[a] == value[b] && a < b);
+}
+
+ccl_device_inline void shader_sort_sift_down(const uint *value, ushort *index, uint root, uint n)
+{
+  while (true) {
+    uint child = 2 * root + 1;
+    if (child >= n) {
+      break;
+    }
+    if (child + 1 < n && shader_sort_less(value, index[child], index[child + 1])) {
+      child++;
+    }
+    if (!shader_sort_less(value, index[root], index[child])) {
+      break;
+    }
+
+    const ushort tmp = index[root];
+    index[root] = index[child];
+    index[child] = tmp;
+    root = child;
+  }
+}
+
+/* Heap sort of the block on a single thread, in place and without extra memory. */
+ccl_device void shader_sort_block_cpu(const uint *value, ushort *index, uint n)
+{
+  for (uint i = n / 2; i-- > 0;) {
+    shader_sort_sift_down(value, index, i, n);
+  }
+
+  for (uint end = n; end-- > 1;) {
+    const ushort tmp = index[0];
+    index[0] = index[end];
+    index[end] = tmp;
+    shader_sort_sift_down(value, index, 0, end);
+  }
+}
+#endif
+
 ccl_device void kernel_shader_sort(KernelGlobals *kg, ccl_local_param ShaderSortLocals *locals)
 {
 #ifndef __KERNEL_CUDA__
@@ -54,7 +99,6 @@ ccl_device void kernel_shader_sort(KernelGlobals *kg, ccl_local_param ShaderSort
   }
   ccl_barrier(CCL_LOCAL_MEM_FENCE);
 
-  /* skip sorting for cpu split kernel */
 #  ifdef __KERNEL_OPENCL__
 
   /* bitonic sort */
@@ -77,6 +121,12 @@ ccl_device void kernel_shader_sort(KernelGlobals *kg, ccl_local_param ShaderSort
       }
     }
   }
+#  else
+  /* The CPU runs the whole block on one thread, so rays hitting the same shader
+   * are evaluated one after another with better instruction and data coherence. */
+  const uint num = qsize - offset;
+  shader_sort_block_cpu(
+      local_value, local_index, (num < SHADER_SORT_BLOCK_SIZE) ? num : SHADER_SORT_BLOCK_SIZE);
 #  endif /* __KERNEL_OPENCL__ */
 
   /* copy to destination */
@@ -1271,7 +1271,8 @@ void GeometryManager::device_update_bvh(Device *device,
     return;
   }
 
-  const bool has_bvh2_layout = (bparams.bvh_layout == BVH_LAYOUT_BVH2);
+  const bool has_bvh2_layout = (bparams.bvh_layout == BVH_LAYOUT_BVH2 ||
+                                bparams.bvh_layout == BVH_LAYOUT_BVH8);
 
   PackedBVH pack;
   if (has_bvh2_layout) {
@@ -1839,6 +1840,23 @@ void GeometryManager::device_update(Device *device,
         dicing_camera->get_full_width(), dicing_camera->get_full_height(), 1);
     dicing_camera->update(scene);
 
+    /* Compute cache keys first, tessellation modifies the mesh. */
+    const bool use_shared_subdivision = scene->params.use_shared_subdivision;
+    vector<string> tess_keys;
+    tess_keys.reserve(total_tess_needed);
+    foreach (Geometry *geom, scene->geometry) {
+      if (!(geom->is_modified() && geom->is_mesh())) {
+        continue;
+      }
+
+      Mesh *mesh = static_cast<Mesh *>(geom);
+      if (mesh->need_tesselation()) {
+        tess_keys.push_back(tessellation_cache.key(mesh, dicing_camera, use_shared_subdivision));
+      }
+    }
+
+    tessellation_cache.begin_update(tess_keys);
+
     size_t i = 0;
     foreach (Geometry *geom, scene->geometry) {
       if (!(geom->is_modified() && geom->is_mesh())) {
@@ -1856,9 +1874,14 @@ void GeometryManager::device_update(Device *device,
 
         progress.set_status("Updating Mesh", msg);
 
-        mesh->subd_params->camera = dicing_camera;
-        DiagSplit dsplit(*mesh->subd_params);
-        mesh->tessellate(&dsplit);
+        const string &key = tess_keys[i];
+        if (!tessellation_cache.restore(key, mesh)) {
+          mesh->subd_params->camera = dicing_camera;
+          DiagSplit dsplit(*mesh->subd_params);
+          mesh->tessellate(&dsplit);
+
+          tessellation_cache.store(key, mesh);
+        }
 
         i++;
 
@@ -1868,6 +1891,8 @@ void GeometryManager::device_update(Device *device,
       }
     }
 
+    tessellation_cache.end_update();
+
     if (progress.get_cancel()) {
       return;
     }
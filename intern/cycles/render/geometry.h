@@ -22,6 +22,7 @@
 #include "bvh/bvh_params.h"
 
 #include "render/attribute.h"
+#include "render/tessellation_cache.h"
 
 #include "util/util_boundbox.h"
 #include "util/util_set.h"
@@ -223,6 +224,9 @@ class GeometryManager {
   /* Update Flags */
   bool need_flags_update;
 
+  /* Results of adaptive subdivision, reused across meshes and updates. */
+  TessellationCache tessellation_cache;
+
   /* Constructor/Destructor */
   GeometryManager();
   ~GeometryManager();
@@ -78,6 +78,8 @@ NODE_DEFINE(Integrator)
   SOCKET_FLOAT(adaptive_threshold, "Adaptive Threshold", 0.0f);
   SOCKET_INT(adaptive_min_samples, "Adaptive Min Samples", 0);
 
+  SOCKET_BOOLEAN(use_guiding, "Use Guiding", false);
+
   SOCKET_BOOLEAN(sample_all_lights_direct, "Sample All Lights Direct", true);
   SOCKET_BOOLEAN(sample_all_lights_indirect, "Sample All Lights Indirect", true);
   SOCKET_FLOAT(light_sampling_threshold, "Light Sampling Threshold", 0.05f);
@@ -104,8 +106,32 @@ Integrator::~Integrator()
 {
 }
 
+void Integrator::device_update_guiding(Device *device, DeviceScene *dscene, Scene *scene)
+{
+  KernelIntegrator *kintegrator = &dscene->data.integrator;
+
+  /* Path guiding is only implemented for the CPU path tracing kernel. The spatial
+   * resolution of the guiding field follows the size of the scene. */
+  kintegrator->use_guiding = use_guiding && (method == PATH) &&
+                             (device->info.type == DEVICE_CPU);
+  kintegrator->guiding_inv_cell_size = 0.0f;
+  if (kintegrator->use_guiding) {
+    BoundBox bounds = BoundBox::empty;
+    foreach (Object *object, scene->objects) {
+      bounds.grow(object->bounds);
+    }
+
+    const float size = (bounds.valid()) ? max3(bounds.size()) : 0.0f;
+    kintegrator->guiding_inv_cell_size = (size > 0.0f) ? 64.0f / size : 1.0f;
+  }
+}
+
 void Integrator::device_update(Device *device, DeviceScene *dscene, Scene *scene)
 {
+  /* Objects may have moved without the integrator being modified, keep the guiding
+   * grid in sync with the scene bounds on every update. */
+  device_update_guiding(device, dscene, scene);
+
   if (!is_modified())
     return;
 
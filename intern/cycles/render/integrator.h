@@ -78,6 +78,8 @@ class Integrator : public Node {
   NODE_SOCKET_API(int, adaptive_min_samples)
   NODE_SOCKET_API(float, adaptive_threshold)
 
+  NODE_SOCKET_API(bool, use_guiding)
+
   enum Method {
     BRANCHED_PATH = 0,
     PATH = 1,
@@ -104,6 +106,7 @@ class Integrator : public Node {
   ~Integrator();
 
   void device_update(Device *device, DeviceScene *dscene, Scene *scene);
+  void device_update_guiding(Device *device, DeviceScene *dscene, Scene *scene);
   void device_free(Device *device, DeviceScene *dscene, bool force_free = false);
 
   void tag_update(Scene *scene, uint32_t flag);
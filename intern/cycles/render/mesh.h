@@ -191,6 +191,7 @@ class Mesh : public Geometry {
   friend class EdgeDice;
   friend class GeometryManager;
   friend class ObjectManager;
+  friend class TessellationCache;
 
   SubdParams *subd_params = nullptr;
 
@@ -180,6 +180,9 @@ class SceneParams {
   CurveShapeType hair_shape;
   int texture_limit;
 
+  /* Share adaptive subdivision between instances and frames with a similar dicing scale. */
+  bool use_shared_subdivision;
+
   bool background;
 
   SceneParams()
@@ -193,6 +196,7 @@ class SceneParams {
     hair_subdivisions = 3;
     hair_shape = CURVE_RIBBON;
     texture_limit = 0;
+    use_shared_subdivision = true;
     background = true;
   }
 
@@ -204,7 +208,8 @@ class SceneParams {
              use_bvh_unaligned_nodes == params.use_bvh_unaligned_nodes &&
              num_bvh_time_steps == params.num_bvh_time_steps &&
              hair_subdivisions == params.hair_subdivisions && hair_shape == params.hair_shape &&
-             texture_limit == params.texture_limit);
+             texture_limit == params.texture_limit &&
+             use_shared_subdivision == params.use_shared_subdivision);
   }
 
   int curve_subdivisions()
@@ -570,7 +570,9 @@ void Session::release_tile(RenderTile &rtile, const bool need_denoise)
     }
   }
 
-  progress.add_finished_tile(rtile.task == RenderTile::DENOISE);
+  if (!tile_manager.is_training_pass()) {
+    progress.add_finished_tile(rtile.task == RenderTile::DENOISE);
+  }
 
   bool delete_tile;
 
@@ -809,6 +811,13 @@ bool Session::run_update_for_next_iteration()
     delayed_reset.do_reset = false;
   }
 
+  /* Path guiding is trained in between passes, which a non-progressive render otherwise
+   * doesn't have. It's only used by the CPU path tracing kernel. */
+  Integrator *integrator = scene->integrator;
+  tile_manager.use_training_passes = integrator->get_use_guiding() &&
+                                     integrator->get_method() == Integrator::PATH &&
+                                     params.device.type == DEVICE_CPU && !read_bake_tile_cb;
+
   const bool have_tiles = tile_manager.next();
 
   if (have_tiles) {
@@ -0,0 +1,366 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render/tessellation_cache.h"
+#include "render/camera.h"
+#include "render/mesh.h"
+
+#include "subd/subd_dice.h"
+
+#include "util/util_foreach.h"
+#include "util/util_logging.h"
+#include "util/util_md5.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Default memory limit of the cache, 1 GiB. */
+#define TESSELLATION_CACHE_MEMORY_LIMIT (size_t(1) << 30)
+
+int tessellation_dicing_bucket(const Transform &objecttoworld, const Camera *dicing_camera)
+{
+  const Transform &cameratoworld = dicing_camera->get_matrix();
+  const float3 camera_P = transform_get_column(&cameratoworld, 3);
+
+  const float scale = (len(transform_get_column(&objecttoworld, 0)) +
+                       len(transform_get_column(&objecttoworld, 1)) +
+                       len(transform_get_column(&objecttoworld, 2))) *
+                      (1.0f / 3.0f);
+  const float3 P = transform_get_column(&objecttoworld, 3);
+  const float distance = max(len(P - camera_P), 1e-6f);
+
+  return (int)floorf(clamp(2.0f * log2f(scale / distance), -1024.0f, 1024.0f));
+}
+
+/* Hashing */
+
+template<typename T> static void tessellation_hash_value(MD5Hash &md5, const T &value)
+{
+  md5.append((const uint8_t *)&value, sizeof(T));
+}
+
+template<typename T> static void tessellation_hash_array(MD5Hash &md5, const array<T> &data)
+{
+  tessellation_hash_value(md5, data.size());
+  if (data.size()) {
+    md5.append((const uint8_t *)data.data(), data.size() * sizeof(T));
+  }
+}
+
+static void tessellation_hash_attributes(MD5Hash &md5, const AttributeSet &attributes)
+{
+  foreach (const Attribute &attr, attributes.attributes) {
+    md5.append(attr.name.string());
+    tessellation_hash_value(md5, attr.std);
+    tessellation_hash_value(md5, attr.type);
+    tessellation_hash_value(md5, attr.element);
+    tessellation_hash_value(md5, attr.flags);
+    tessellation_hash_value(md5, attr.buffer.size());
+    if (attr.buffer.size()) {
+      md5.append((const uint8_t *)attr.buffer.data(), attr.buffer.size());
+    }
+  }
+}
+
+/* Tessellation Cache */
+
+TessellationCache::TessellationCache()
+    : memory_used(0), memory_limit(TESSELLATION_CACHE_MEMORY_LIMIT), use_counter(0)
+{
+}
+
+TessellationCache::~TessellationCache()
+{
+  clear();
+}
+
+string TessellationCache::key(Mesh *mesh, Camera *dicing_camera, bool use_sharing)
+{
+  MD5Hash md5;
+
+  /* Control cage. */
+  tessellation_hash_value(md5, mesh->get_subdivision_type());
+  tessellation_hash_array(md5, mesh->get_verts());
+  tessellation_hash_array(md5, mesh->get_triangles());
+  tessellation_hash_array(md5, mesh->get_shader());
+  tessellation_hash_array(md5, mesh->get_smooth());
+  tessellation_hash_array(md5, mesh->get_subd_start_corner());
+  tessellation_hash_array(md5, mesh->get_subd_num_corners());
+  tessellation_hash_array(md5, mesh->get_subd_shader());
+  tessellation_hash_array(md5, mesh->get_subd_smooth());
+  tessellation_hash_array(md5, mesh->get_subd_ptex_offset());
+  tessellation_hash_array(md5, mesh->get_subd_face_corners());
+  tessellation_hash_value(md5, mesh->get_num_ngons());
+  tessellation_hash_array(md5, mesh->get_subd_creases_edge());
+  tessellation_hash_array(md5, mesh->get_subd_creases_weight());
+  tessellation_hash_value(md5, mesh->get_num_subd_faces());
+  tessellation_hash_attributes(md5, mesh->attributes);
+  tessellation_hash_attributes(md5, mesh->subd_attributes);
+
+  /* Dicing parameters. */
+  const SubdParams &params = *mesh->get_subd_params();
+  tessellation_hash_value(md5, params.ptex);
+  tessellation_hash_value(md5, params.test_steps);
+  tessellation_hash_value(md5, params.split_threshold);
+  tessellation_hash_value(md5, params.dicing_rate);
+  tessellation_hash_value(md5, params.max_level);
+
+  if (use_sharing) {
+    /* Only the projection of the camera and the dicing bucket of the object. */
+    tessellation_hash_value(md5, dicing_camera->get_camera_type());
+    tessellation_hash_value(md5, dicing_camera->get_panorama_type());
+    tessellation_hash_value(md5, dicing_camera->get_fov());
+    tessellation_hash_value(md5, dicing_camera->get_full_width());
+    tessellation_hash_value(md5, dicing_camera->get_full_height());
+    tessellation_hash_value(md5, dicing_camera->get_offscreen_dicing_scale());
+    tessellation_hash_value(md5, dicing_camera->get_viewplane_left());
+    tessellation_hash_value(md5, dicing_camera->get_viewplane_right());
+    tessellation_hash_value(md5, dicing_camera->get_viewplane_bottom());
+    tessellation_hash_value(md5, dicing_camera->get_viewplane_top());
+
+    const int bucket = tessellation_dicing_bucket(params.objecttoworld, dicing_camera);
+    tessellation_hash_value(md5, bucket);
+  }
+  else {
+    tessellation_hash_value(md5, params.objecttoworld);
+    dicing_camera->hash(md5);
+  }
+
+  return md5.get_hex();
+}
+
+void TessellationCache::begin_update(const vector<string> &keys)
+{
+  previous_requested.clear();
+  for (const auto &it : requested) {
+    previous_requested.insert(it.first);
+  }
+
+  requested.clear();
+  foreach (const string &key, keys) {
+    requested[key]++;
+  }
+
+  used.clear();
+}
+
+void TessellationCache::end_update()
+{
+  size_t num_freed = 0;
+
+  for (auto it = entries.begin(); it != entries.end();) {
+    if (used.find(it->first) == used.end()) {
+      memory_used -= it->second->size;
+      delete it->second;
+      it = entries.erase(it);
+      num_freed++;
+    }
+    else {
+      ++it;
+    }
+  }
+
+  if (num_freed) {
+    VLOG(1) << "Freed " << num_freed << " unused tessellations, " << entries.size()
+            << " remaining in cache using " << string_human_readable_size(memory_used) << ".";
+  }
+}
+
+bool TessellationCache::restore(const string &key, Mesh *mesh)
+{
+  auto it = entries.find(key);
+  if (it == entries.end()) {
+    return false;
+  }
+
+  used.insert(key);
+  Entry *entry = it->second;
+  entry->last_use = ++use_counter;
+
+  /* The setters take ownership of the data, so pass copies. */
+  mesh->set_subdivision_type((Mesh::SubdivisionType)entry->subdivision_type);
+
+  array<float3> verts = entry->verts;
+  array<int> triangles = entry->triangles;
+  array<int> shader = entry->shader;
+  array<bool> smooth = entry->smooth;
+  array<int> triangle_patch = entry->triangle_patch;
+  array<float2> vert_patch_uv = entry->vert_patch_uv;
+  mesh->set_verts(verts);
+  mesh->set_triangles(triangles);
+  mesh->set_shader(shader);
+  mesh->set_smooth(smooth);
+  mesh->set_triangle_patch(triangle_patch);
+  mesh->set_vert_patch_uv(vert_patch_uv);
+
+  mesh->num_subd_verts = entry->num_subd_verts;
+  mesh->vert_to_stitching_key_map = entry->vert_to_stitching_key_map;
+  mesh->vert_stitching_map = entry->vert_stitching_map;
+
+  restore_attributes(mesh->attributes, entry->attributes);
+  restore_attributes(mesh->subd_attributes, entry->subd_attributes);
+
+  delete mesh->patch_table;
+  mesh->patch_table = (entry->has_patch_table) ? new PackedPatchTable(entry->patch_table) : NULL;
+
+  return true;
+}
+
+void TessellationCache::store(const string &key, Mesh *mesh)
+{
+  used.insert(key);
+
+  if (entries.find(key) != entries.end()) {
+    return;
+  }
+
+  /* Only keep results that are likely to be reused. */
+  auto it = requested.find(key);
+  const bool is_shared = (it != requested.end() && it->second > 1);
+  const bool is_static = (previous_requested.find(key) != previous_requested.end());
+  if (!(is_shared || is_static)) {
+    return;
+  }
+
+  Entry *entry = new Entry();
+  entry->subdivision_type = mesh->get_subdivision_type();
+
+  entry->verts = mesh->get_verts();
+  entry->triangles = mesh->get_triangles();
+  entry->shader = mesh->get_shader();
+  entry->smooth = mesh->get_smooth();
+  entry->triangle_patch = mesh->get_triangle_patch();
+  entry->vert_patch_uv = mesh->get_vert_patch_uv();
+
+  entry->num_subd_verts = mesh->num_subd_verts;
+  entry->vert_to_stitching_key_map = mesh->vert_to_stitching_key_map;
+  entry->vert_stitching_map = mesh->vert_stitching_map;
+
+  copy_attributes(entry->attributes, mesh->attributes);
+  copy_attributes(entry->subd_attributes, mesh->subd_attributes);
+
+  entry->has_patch_table = (mesh->patch_table != NULL);
+  if (entry->has_patch_table) {
+    entry->patch_table = *mesh->patch_table;
+  }
+
+  entry->size = entry->memory_size();
+  entry->last_use = ++use_counter;
+
+  if (entry->size > memory_limit) {
+    delete entry;
+    return;
+  }
+
+  free_entries(entry->size);
+
+  VLOG(2) << "Caching tessellation of " << mesh->name << " (" << key << "), "
+          << string_human_readable_size(entry->size) << ".";
+
+  entries[key] = entry;
+  memory_used += entry->size;
+}
+
+void TessellationCache::free_entries(size_t size_needed)
+{
+  /* Free least recently used entries until there is room, the number of entries is small
+   * compared to the cost of tessellation so a linear search is fine. */
+  while (!entries.empty() && memory_used + size_needed > memory_limit) {
+    auto lru = entries.begin();
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+      if (it->second->last_use < lru->second->last_use) {
+        lru = it;
+      }
+    }
+
+    VLOG(2) << "Freeing cached tessellation " << lru->first << " to stay within the memory "
+            << "limit of " << string_human_readable_size(memory_limit) << ".";
+
+    memory_used -= lru->second->size;
+    delete lru->second;
+    entries.erase(lru);
+  }
+}
+
+void TessellationCache::clear()
+{
+  foreach (auto &it, entries) {
+    delete it.second;
+  }
+
+  entries.clear();
+  memory_used = 0;
+  requested.clear();
+  previous_requested.clear();
+  used.clear();
+}
+
+void TessellationCache::set_memory_limit(size_t limit)
+{
+  memory_limit = limit;
+  free_entries(0);
+}
+
+void TessellationCache::copy_attributes(list<CachedAttribute> &dst, const AttributeSet &src)
+{
+  foreach (const Attribute &attr, src.attributes) {
+    dst.push_back(CachedAttribute());
+    CachedAttribute &cached = dst.back();
+    cached.name = attr.name;
+    cached.std = attr.std;
+    cached.type = attr.type;
+    cached.element = attr.element;
+    cached.flags = attr.flags;
+    cached.buffer = attr.buffer;
+  }
+}
+
+void TessellationCache::restore_attributes(AttributeSet &dst, const list<CachedAttribute> &src)
+{
+  foreach (const CachedAttribute &cached, src) {
+    Attribute *attr = (cached.std != ATTR_STD_NONE) ? dst.find(cached.std) :
+                                                      dst.find(cached.name);
+    if (attr == NULL) {
+      attr = (cached.std != ATTR_STD_NONE) ? dst.add(cached.std, cached.name) :
+                                             dst.add(cached.name, cached.type, cached.element);
+    }
+
+    attr->buffer = cached.buffer;
+    attr->flags = cached.flags;
+    attr->modified = true;
+  }
+}
+
+size_t TessellationCache::Entry::memory_size() const
+{
+  size_t size = verts.size() * sizeof(float3) + triangles.size() * sizeof(int) +
+                shader.size() * sizeof(int) + smooth.size() * sizeof(bool) +
+                triangle_patch.size() * sizeof(int) + vert_patch_uv.size() * sizeof(float2);
+
+  foreach (const CachedAttribute &attr, attributes) {
+    size += attr.buffer.size();
+  }
+  foreach (const CachedAttribute &attr, subd_attributes) {
+    size += attr.buffer.size();
+  }
+
+  if (has_patch_table) {
+    size += patch_table.table.size() * sizeof(uint);
+  }
+
+  return size;
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __TESSELLATION_CACHE_H__
+#define __TESSELLATION_CACHE_H__
+
+#include "render/attribute.h"
+
+#include "subd/subd_patch_table.h"
+
+#include "util/util_list.h"
+#include "util/util_map.h"
+#include "util/util_set.h"
+#include "util/util_string.h"
+#include "util/util_transform.h"
+#include "util/util_types.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+class Camera;
+class Mesh;
+
+/* Bucket of the dicing scale of an object, based on its scale relative to the
+ * distance to the dicing camera. Objects in the same bucket have a screen
+ * size within half an octave of each other. Used both for sharing geometry
+ * between objects and in the cache key, so they must use the same camera. */
+int tessellation_dicing_bucket(const Transform &objecttoworld, const Camera *dicing_camera);
+
+/* Tessellation Cache
+ *
+ * Stores the result of adaptive subdivision, so that meshes with an identical
+ * control cage and dicing parameters are only tessellated once. This happens
+ * for identical meshes in the same scene, and for meshes that are synced again
+ * without changes, for example in the next frame of an animation when the
+ * render session is kept alive.
+ *
+ * When sharing is enabled, the exact object and camera transforms are replaced
+ * by their dicing bucket, so that a tessellation can also be reused by
+ * instances and frames where the object has about the same size on screen.
+ *
+ * To avoid holding a copy of every tessellated mesh, results are only stored
+ * once a key is seen more than once, either within one update or in two
+ * consecutive updates. Entries that are not used in an update are freed, and
+ * the least recently used entries are freed to stay within the memory limit. */
+class TessellationCache {
+ public:
+  TessellationCache();
+  ~TessellationCache();
+
+  /* Compute the key for tessellating the mesh with the given dicing camera. */
+  string key(Mesh *mesh, Camera *dicing_camera, bool use_sharing);
+
+  /* Called with the keys of all meshes that will be tessellated in this update. */
+  void begin_update(const vector<string> &keys);
+  void end_update();
+
+  /* Restore a previous tessellation result into the mesh, returns false if there
+   * is none for this key. */
+  bool restore(const string &key, Mesh *mesh);
+  /* Store the tessellation result of the mesh, if the key is likely to be reused. */
+  void store(const string &key, Mesh *mesh);
+
+  void clear();
+
+  /* Maximum memory used by cached results, in bytes. */
+  void set_memory_limit(size_t limit);
+
+ protected:
+  struct CachedAttribute {
+    ustring name;
+    AttributeStandard std;
+    TypeDesc type;
+    AttributeElement element;
+    uint flags;
+    vector<char> buffer;
+  };
+
+  struct Entry {
+    int subdivision_type;
+
+    array<float3> verts;
+    array<int> triangles;
+    array<int> shader;
+    array<bool> smooth;
+    array<int> triangle_patch;
+    array<float2> vert_patch_uv;
+
+    size_t num_subd_verts;
+    unordered_map<int, int> vert_to_stitching_key_map;
+    unordered_multimap<int, int> vert_stitching_map;
+
+    list<CachedAttribute> attributes;
+    list<CachedAttribute> subd_attributes;
+
+    bool has_patch_table;
+    PackedPatchTable patch_table;
+
+    size_t memory_size() const;
+
+    size_t size;
+    uint64_t last_use;
+  };
+
+  static void copy_attributes(list<CachedAttribute> &dst, const AttributeSet &src);
+  static void restore_attributes(AttributeSet &dst, const list<CachedAttribute> &src);
+
+  void free_entries(size_t size_needed);
+
+  map<string, Entry *> entries;
+  size_t memory_used;
+  size_t memory_limit;
+  uint64_t use_counter;
+
+  /* Keys requested in the current and previous update, with their number of uses. */
+  map<string, int> requested;
+  set<string> previous_requested;
+  set<string> used;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __TESSELLATION_CACHE_H__ */
@@ -111,6 +111,8 @@ TileManager::TileManager(bool progressive_,
   range_start_sample = 0;
   range_num_samples = -1;
 
+  use_training_passes = false;
+
   BufferParams buffer_params;
   reset(buffer_params, 0);
 }
@@ -121,7 +123,7 @@ TileManager::~TileManager()
 
 void TileManager::device_free()
 {
-  if (schedule_denoising || progressive) {
+  if (schedule_denoising || progressive || use_training_passes) {
     for (int i = 0; i < state.tiles.size(); i++) {
       delete state.tiles[i].buffers;
       state.tiles[i].buffers = NULL;
@@ -447,6 +449,11 @@ bool TileManager::finish_tile(const int index, const bool need_denoise, bool &de
 
   switch (state.tiles[index].state) {
     case Tile::RENDER: {
+      if (is_training_pass()) {
+        /* The tile is rendered again in the next pass, so it's neither written nor denoised. */
+        state.tiles[index].state = Tile::DONE;
+        return false;
+      }
       if (!(schedule_denoising && need_denoise)) {
         state.tiles[index].state = Tile::DONE;
         delete_tile = !progressive;
@@ -586,14 +593,28 @@ bool TileManager::next()
     set_tiles();
   }
   else {
-    state.sample++;
-
-    if (progressive)
+    if (progressive) {
+      state.sample++;
       state.num_samples = 1;
-    else if (range_num_samples == -1)
-      state.num_samples = num_samples;
-    else
-      state.num_samples = range_num_samples;
+    }
+    else if (state.num_samples == 0) {
+      state.sample = range_start_sample;
+      state.num_samples = get_num_effective_samples();
+    }
+    else {
+      /* Continue after a training pass. */
+      state.sample += state.num_samples;
+      state.num_samples = get_num_effective_samples() - (state.sample - range_start_sample);
+    }
+
+    /* Training passes double in size, each one rendering as many samples as the previous
+     * ones together. */
+    const int num_training_samples = get_num_training_samples();
+    const int num_rendered_samples = state.sample - range_start_sample;
+    if (num_rendered_samples < num_training_samples) {
+      state.num_samples = min(max(num_rendered_samples, 1),
+                              num_training_samples - num_rendered_samples);
+    }
 
     state.resolution_divider = pixel_size;
 
@@ -613,4 +634,22 @@ int TileManager::get_num_effective_samples()
   return (range_num_samples == -1) ? num_samples : range_num_samples;
 }
 
+int TileManager::get_num_training_samples()
+{
+  /* Tile buffers of a training pass stay on the device that rendered them, so multiple
+   * devices can't render the next pass. */
+  if (!use_training_passes || progressive || num_devices != 1) {
+    return 0;
+  }
+
+  /* Train during the first quarter of the samples. */
+  const int num_effective_samples = get_num_effective_samples();
+  return (num_effective_samples == INT_MAX) ? 0 : num_effective_samples / 4;
+}
+
+bool TileManager::is_training_pass()
+{
+  return !progressive && !done();
+}
+
 CCL_NAMESPACE_END
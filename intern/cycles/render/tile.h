@@ -130,6 +130,16 @@ class TileManager {
   /* Get number of actual samples to render. */
   int get_num_effective_samples();
 
+  /* ** Training passes. ** */
+
+  /* Render the first samples of a non-progressive render in passes over all tiles, so
+   * that path guiding can be trained in between. Tiles are kept in memory until their
+   * last pass. */
+  bool use_training_passes;
+
+  /* Pass over all tiles before the remaining samples are rendered tile by tile. */
+  bool is_training_pass();
+
   /* Schedule tiles for denoising after they've been rendered. */
   bool schedule_denoising;
 
@@ -162,6 +172,8 @@ class TileManager {
    */
   bool background;
 
+  int get_num_training_samples();
+
   /* Generate tile list, return number of tiles. */
   int gen_tiles(bool sliced);
   void gen_render_tiles();
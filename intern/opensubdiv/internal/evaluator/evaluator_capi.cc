@@ -112,6 +112,18 @@ void evaluatePatchesLimit(OpenSubdiv_Evaluator *evaluator,
       patch_coords, num_patch_coords, P, dPdu, dPdv);
 }
 
+int evaluateLimitStencil(OpenSubdiv_Evaluator *evaluator,
+                         const int ptex_face_index,
+                         float face_u,
+                         float face_v,
+                         int *r_vertex_indices,
+                         float *r_weights,
+                         const int max_stencil_size)
+{
+  return evaluator->impl->eval_output->evaluateLimitStencil(
+      ptex_face_index, face_u, face_v, r_vertex_indices, r_weights, max_stencil_size);
+}
+
 void evaluateVarying(OpenSubdiv_Evaluator *evaluator,
                      const int ptex_face_index,
                      float face_u,
@@ -149,6 +161,8 @@ void assignFunctionPointers(OpenSubdiv_Evaluator *evaluator)
   evaluator->evaluateFaceVarying = evaluateFaceVarying;
 
   evaluator->evaluatePatchesLimit = evaluatePatchesLimit;
+
+  evaluator->evaluateLimitStencil = evaluateLimitStencil;
 }
 
 }  // namespace
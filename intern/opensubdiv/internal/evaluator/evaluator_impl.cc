@@ -18,6 +18,7 @@
 
 #include "internal/evaluator/evaluator_impl.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 
@@ -585,14 +586,20 @@ class CpuEvalOutput : public VolatileEvalOutput<CpuVertexBuffer,
 // Evaluator wrapper for anonymous API.
 
 CpuEvalOutputAPI::CpuEvalOutputAPI(CpuEvalOutput *implementation,
-                                   OpenSubdiv::Far::PatchMap *patch_map)
-    : implementation_(implementation), patch_map_(patch_map)
+                                   OpenSubdiv::Far::PatchMap *patch_map,
+                                   const OpenSubdiv::Far::PatchTable *patch_table,
+                                   const OpenSubdiv::Far::StencilTable *vertex_stencils)
+    : implementation_(implementation),
+      patch_map_(patch_map),
+      patch_table_(patch_table),
+      vertex_stencils_(vertex_stencils)
 {
 }
 
 CpuEvalOutputAPI::~CpuEvalOutputAPI()
 {
   delete implementation_;
+  delete vertex_stencils_;
 }
 
 void CpuEvalOutputAPI::setCoarsePositions(const float *positions,
@@ -747,6 +754,64 @@ void CpuEvalOutputAPI::evaluatePatchesLimit(const OpenSubdiv_PatchCoord *patch_c
   }
 }
 
+int CpuEvalOutputAPI::evaluateLimitStencil(const int ptex_face_index,
+                                           float face_u,
+                                           float face_v,
+                                           int *r_vertex_indices,
+                                           float *r_weights,
+                                           const int max_stencil_size)
+{
+  assert(face_u >= 0.0f);
+  assert(face_u <= 1.0f);
+  assert(face_v >= 0.0f);
+  assert(face_v <= 1.0f);
+  const PatchTable::PatchHandle *handle = patch_map_->FindPatch(ptex_face_index, face_u, face_v);
+  const OpenSubdiv::Far::ConstIndexArray patch_vertices = patch_table_->GetPatchVertices(*handle);
+  StackOrHeapArray<float, 20> patch_weights(patch_vertices.size());
+  patch_table_->EvaluateBasis(*handle, face_u, face_v, patch_weights.data());
+  // Expand weights of the patch control points to the coarse vertices.
+  const int num_coarse_vertices = vertex_stencils_->GetNumControlVertices();
+  vector<pair<int, float>> elements;
+  elements.reserve(patch_vertices.size() * 4);
+  for (int i = 0; i < patch_vertices.size(); ++i) {
+    const float patch_weight = patch_weights.data()[i];
+    if (patch_weight == 0.0f) {
+      continue;
+    }
+    const int vertex_index = patch_vertices[i];
+    if (vertex_index < num_coarse_vertices) {
+      elements.push_back(make_pair(vertex_index, patch_weight));
+      continue;
+    }
+    const OpenSubdiv::Far::Stencil stencil = vertex_stencils_->GetStencil(vertex_index -
+                                                                          num_coarse_vertices);
+    const int *stencil_indices = stencil.GetVertexIndices();
+    const float *stencil_weights = stencil.GetWeights();
+    for (int j = 0; j < stencil.GetSize(); ++j) {
+      elements.push_back(make_pair(stencil_indices[j], patch_weight * stencil_weights[j]));
+    }
+  }
+  // Merge weights of the same coarse vertex.
+  std::sort(elements.begin(), elements.end());
+  int num_elements = 0;
+  for (size_t i = 0; i < elements.size(); ++i) {
+    if (num_elements != 0 && elements[num_elements - 1].first == elements[i].first) {
+      elements[num_elements - 1].second += elements[i].second;
+    }
+    else {
+      elements[num_elements++] = elements[i];
+    }
+  }
+  if (num_elements > max_stencil_size) {
+    return num_elements;
+  }
+  for (int i = 0; i < num_elements; ++i) {
+    r_vertex_indices[i] = elements[i].first;
+    r_weights[i] = elements[i].second;
+  }
+  return num_elements;
+}
+
 }  // namespace opensubdiv
 }  // namespace blender
 
@@ -874,11 +939,14 @@ OpenSubdiv_EvaluatorImpl *openSubdiv_createEvaluatorInternal(
   // Wrap everything we need into an object which we control from our side.
   OpenSubdiv_EvaluatorImpl *evaluator_descr;
   evaluator_descr = new OpenSubdiv_EvaluatorImpl();
-  evaluator_descr->eval_output = new blender::opensubdiv::CpuEvalOutputAPI(eval_output, patch_map);
+  evaluator_descr->eval_output = new blender::opensubdiv::CpuEvalOutputAPI(
+      eval_output, patch_map, patch_table, vertex_stencils);
   evaluator_descr->patch_map = patch_map;
   evaluator_descr->patch_table = patch_table;
   // TOOD(sergey): Look into whether we've got duplicated stencils arrays.
-  delete vertex_stencils;
+  //
+  // NOTE: Vertex stencils are kept by the API object, they are used to calculate
+  // limit stencils.
   delete varying_stencils;
   for (const StencilTable *table : all_face_varying_stencils) {
     delete table;
@@ -25,6 +25,7 @@
 
 #include <opensubdiv/far/patchMap.h>
 #include <opensubdiv/far/patchTable.h>
+#include <opensubdiv/far/stencilTable.h>
 
 #include "internal/base/memory.h"
 
@@ -45,8 +46,12 @@ class CpuEvalOutput;
 // and such separate?
 class CpuEvalOutputAPI {
  public:
-  // NOTE: API object becomes an owner of evaluator. Patch we are referencing.
-  CpuEvalOutputAPI(CpuEvalOutput *implementation, OpenSubdiv::Far::PatchMap *patch_map);
+  // NOTE: API object becomes an owner of evaluator and vertex stencils. Patch map and patch
+  // table we are referencing.
+  CpuEvalOutputAPI(CpuEvalOutput *implementation,
+                   OpenSubdiv::Far::PatchMap *patch_map,
+                   const OpenSubdiv::Far::PatchTable *patch_table,
+                   const OpenSubdiv::Far::StencilTable *vertex_stencils);
   ~CpuEvalOutputAPI();
 
   // Set coarse positions from a continuous array of coordinates.
@@ -130,9 +135,25 @@ class CpuEvalOutputAPI {
                             float *dPdu,
                             float *dPdv);
 
+  // Get weights of coarse vertices which define limit point at the given
+  // bilinear coordinate of the given ptex face.
+  //
+  // Returns number of stencil elements. Output arrays are only filled in when
+  // they can hold all elements.
+  int evaluateLimitStencil(const int ptex_face_index,
+                           float face_u,
+                           float face_v,
+                           int *r_vertex_indices,
+                           float *r_weights,
+                           const int max_stencil_size);
+
  protected:
   CpuEvalOutput *implementation_;
   OpenSubdiv::Far::PatchMap *patch_map_;
+  const OpenSubdiv::Far::PatchTable *patch_table_;
+  // Stencils of all refined and local points of the patches, same layout as
+  // the vertex buffer used by the implementation.
+  const OpenSubdiv::Far::StencilTable *vertex_stencils_;
 };
 
 }  // namespace opensubdiv
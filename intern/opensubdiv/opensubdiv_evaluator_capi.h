@@ -122,6 +122,24 @@ typedef struct OpenSubdiv_Evaluator {
                                float *dPdu,
                                float *dPdv);
 
+  // Get weights of coarse vertices which define limit point at the given
+  // bilinear coordinate of the given ptex face:
+  //
+  //   P = sum(r_weights[i] * coarse_position[r_vertex_indices[i]])
+  //
+  // Returns number of stencil elements. Output arrays are only filled in when
+  // number of elements does not exceed max_stencil_size, otherwise the caller
+  // is supposed to grow the arrays and call this function again.
+  //
+  // NOTE: Indices are in the space of vertices passed to setCoarsePositions().
+  int (*evaluateLimitStencil)(struct OpenSubdiv_Evaluator *evaluator,
+                              const int ptex_face_index,
+                              float face_u,
+                              float face_v,
+                              int *r_vertex_indices,
+                              float *r_weights,
+                              const int max_stencil_size);
+
   // Implementation of the evaluator.
   struct OpenSubdiv_EvaluatorImpl *impl;
 } OpenSubdiv_Evaluator;
@@ -174,6 +174,10 @@ struct RenderResult;
 /* checks whether there's an image buffer for given image and user */
 bool BKE_image_has_ibuf(struct Image *ima, struct ImageUser *iuser);
 
+/* Read image files in a background thread pool. */
+bool BKE_image_load_async(struct Image *ima, struct ImageUser *iuser);
+struct Image *BKE_image_load_async_pop_finished(void);
+
 /* same as above, but can be used to retrieve images being rendered in
  * a thread safe way, always call both acquire and release */
 struct ImBuf *BKE_image_acquire_ibuf(struct Image *ima, struct ImageUser *iuser, void **r_lock);
@@ -380,6 +384,9 @@ struct GPUTexture *BKE_image_get_gpu_tiles(struct Image *image,
 struct GPUTexture *BKE_image_get_gpu_tilemap(struct Image *image,
                                              struct ImageUser *iuser,
                                              struct ImBuf *ibuf);
+/* Same as #BKE_image_get_gpu_texture, but image files which are not in memory yet are read in
+ * the background. A placeholder texture is returned until they are loaded. */
+struct GPUTexture *BKE_image_get_gpu_texture_async(struct Image *image, struct ImageUser *iuser);
 bool BKE_image_has_gpu_texture_premultiplied_alpha(struct Image *image, struct ImBuf *ibuf);
 void BKE_image_update_gputexture(
     struct Image *ima, struct ImageUser *iuser, int x, int y, int w, int h);
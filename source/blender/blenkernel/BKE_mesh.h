@@ -51,6 +51,7 @@ struct MVert;
 struct Main;
 struct MemArena;
 struct Mesh;
+struct MeshLoopNormalsCache;
 struct ModifierData;
 struct Object;
 struct PointCloud;
@@ -439,6 +440,12 @@ void BKE_mesh_normals_loop_split(const struct MVert *mverts,
                                  MLoopNorSpaceArray *r_lnors_spacearr,
                                  short (*clnors_data)[2],
                                  int *r_loop_to_poly);
+void BKE_mesh_normals_loop_split_cached(const struct Mesh *mesh,
+                                        const float (*polynors)[3],
+                                        const bool use_split_normals,
+                                        const float split_angle,
+                                        float (*r_loopnors)[3]);
+void BKE_mesh_normals_loop_split_cache_free(struct MeshLoopNormalsCache *cache);
 
 void BKE_mesh_normals_loop_custom_set(const struct MVert *mverts,
                                       const int numVerts,
@@ -568,6 +575,18 @@ struct Mesh *BKE_mesh_merge_verts(struct Mesh *mesh,
                                   const int tot_vtargetmap,
                                   const int merge_mode);
 
+/* *** mesh_triangulate.cc *** */
+struct Mesh *BKE_mesh_triangulate(const struct Mesh *mesh,
+                                  const int quad_method,
+                                  const int ngon_method,
+                                  const int min_vertices);
+
+/* *** mesh_edge_split.cc *** */
+struct Mesh *BKE_mesh_edge_split(const struct Mesh *mesh,
+                                 const bool use_edge_angle,
+                                 const float split_angle,
+                                 const bool use_edge_sharp);
+
 /* flush flags */
 void BKE_mesh_flush_hidden_from_verts_ex(const struct MVert *mvert,
                                          const struct MLoop *mloop,
@@ -53,6 +53,11 @@ void multires_set_tot_level(struct Object *ob, struct MultiresModifierData *mmd,
 void multires_mark_as_modified(struct Depsgraph *depsgraph,
                                struct Object *object,
                                enum MultiresModifiedFlags flags);
+/* Same as MULTIRES_COORDS_MODIFIED, but only the given grids are to be reshaped. */
+void multires_mark_grids_as_modified(struct Depsgraph *depsgraph,
+                                     struct Object *object,
+                                     const int *grid_indices,
+                                     int num_grid_indices);
 
 void multires_flush_sculpt_updates(struct Object *object);
 void multires_force_sculpt_rebuild(struct Object *object);
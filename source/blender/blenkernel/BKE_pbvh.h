@@ -60,6 +60,20 @@ typedef struct {
   float (*color)[4];
 } PBVHColorBufferNode;
 
+/**
+ * Vertex data of a leaf node in contiguous arrays, in the order of #PBVHVertexIter.i
+ * with #PBVH_ITER_UNIQUE. See #BKE_pbvh_node_vert_data_ensure.
+ */
+typedef struct PBVHVertData {
+  int totvert;
+  float (*co)[3];
+  float (*no)[3];
+  /** NULL when the PBVH has no paint mask. */
+  float *mask;
+  /** Face set of each primitive of the node (triangle or grid), NULL without face sets. */
+  int *face_sets;
+} PBVHVertData;
+
 typedef enum {
   PBVH_Leaf = 1 << 0,
 
@@ -69,6 +83,7 @@ typedef enum {
   PBVH_UpdateDrawBuffers = 1 << 4,
   PBVH_UpdateRedraw = 1 << 5,
   PBVH_UpdateMask = 1 << 6,
+  PBVH_UpdateVertData = 1 << 7,
   PBVH_UpdateVisibility = 1 << 8,
 
   PBVH_RebuildDrawBuffers = 1 << 9,
@@ -78,6 +93,8 @@ typedef enum {
 
   PBVH_UpdateTopology = 1 << 13,
   PBVH_UpdateColor = 1 << 14,
+  /* Grids of the node were modified since last flush to the multires displacement. */
+  PBVH_UpdateMultires = 1 << 15,
 } PBVHNodeFlags;
 
 typedef struct PBVHFrustumPlanes {
@@ -306,6 +323,7 @@ void BKE_pbvh_update_visibility(PBVH *pbvh);
 void BKE_pbvh_update_normals(PBVH *pbvh, struct SubdivCCG *subdiv_ccg);
 void BKE_pbvh_redraw_BB(PBVH *pbvh, float bb_min[3], float bb_max[3]);
 void BKE_pbvh_get_grid_updates(PBVH *pbvh, bool clear, void ***r_gridfaces, int *r_totface);
+void BKE_pbvh_get_modified_grids(PBVH *pbvh, bool clear, int **r_grid_indices, int *r_totgrid);
 void BKE_pbvh_grids_update(PBVH *pbvh,
                            struct CCGElem **grids,
                            void **gridfaces,
@@ -460,6 +478,10 @@ void pbvh_vertex_iter_init(PBVH *pbvh, PBVHNode *node, PBVHVertexIter *vi, int m
   } \
   ((void)0)
 
+PBVHVertData *BKE_pbvh_node_vert_data_ensure(PBVH *pbvh, PBVHNode *node);
+PBVHVertData *BKE_pbvh_node_vert_data_get(PBVHNode *node);
+void BKE_pbvh_vert_data_free(PBVH *pbvh);
+
 void BKE_pbvh_node_get_proxies(PBVHNode *node, PBVHProxyNode **proxies, int *proxy_count);
 void BKE_pbvh_node_free_proxies(PBVHNode *node);
 PBVHProxyNode *BKE_pbvh_node_add_proxy(PBVH *pbvh, PBVHNode *node);
@@ -36,6 +36,7 @@ struct OpenSubdiv_Converter;
 struct OpenSubdiv_Evaluator;
 struct OpenSubdiv_TopologyRefiner;
 struct Subdiv;
+struct SubdivMeshDeformCache;
 
 typedef enum eSubdivVtxBoundaryInterpolation {
   /* Do not interpolate boundaries. */
@@ -190,6 +191,8 @@ typedef struct Subdiv {
     /* Indexed by base face index, element indicates total number of ptex
      * faces created for preceding base faces. */
     int *face_ptex_offset;
+    /* Subdivided mesh and stencils of its vertices, see BKE_subdiv_to_mesh_deform_cached(). */
+    struct SubdivMeshDeformCache *mesh_deform_cache;
   } cache_;
 } Subdiv;
 
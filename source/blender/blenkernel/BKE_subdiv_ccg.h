@@ -212,6 +212,9 @@ typedef struct SubdivCCG {
     bool coords;
     /* Corresponds to MULTIRES_HIDDEN_MODIFIED. */
     bool hidden;
+    /* Grids which coordinates or masks were modified, allowing reshape to only handle those.
+     * NULL when `coords` applies to all grids. */
+    BLI_bitmap *grids;
   } dirty;
 
   /* Cached values, are not supposed to be accessed directly. */
@@ -342,6 +345,17 @@ const int *BKE_subdiv_ccg_start_face_grid_index_get(const SubdivCCG *subdiv_ccg)
 
 void BKE_subdiv_ccg_grid_hidden_ensure(SubdivCCG *subdiv_ccg, int grid_index);
 
+/* Tag given grids as having modified coordinates.
+ *
+ * Unlike setting `dirty.coords` directly this keeps track of which grids are modified, unless all
+ * of them are already tagged. Grids of the neighbor faces are tagged as well, since stitching
+ * modifies their boundaries. */
+void BKE_subdiv_ccg_grids_tag_modified(SubdivCCG *subdiv_ccg,
+                                       const int *grid_indices,
+                                       int num_grid_indices);
+/* Clear all modification tags, after the changes were flushed to the multires displacement. */
+void BKE_subdiv_ccg_dirty_clear(SubdivCCG *subdiv_ccg);
+
 #ifdef __cplusplus
 }
 #endif
@@ -49,6 +49,19 @@ struct Mesh *BKE_subdiv_to_mesh(struct Subdiv *subdiv,
                                 const SubdivToMeshSettings *settings,
                                 const struct Mesh *coarse_mesh);
 
+/* Same as BKE_subdiv_to_mesh(), but keeps the subdivided mesh and stencils of its vertices in
+ * the subdivision descriptor. Following calls for a deformed coarse mesh of the same topology
+ * only re-calculate vertex positions, as a weighted sum of the coarse ones.
+ *
+ * Attributes other than vertex positions are kept from the call which has created the cache,
+ * and normals are calculated from the subdivided faces. The cache is only invalidated when
+ * the topology, loose edges or layout of the custom data layers change. */
+struct Mesh *BKE_subdiv_to_mesh_deform_cached(struct Subdiv *subdiv,
+                                              const SubdivToMeshSettings *settings,
+                                              const struct Mesh *coarse_mesh);
+
+void BKE_subdiv_mesh_deform_cache_free(struct Subdiv *subdiv);
+
 #ifdef __cplusplus
 }
 #endif
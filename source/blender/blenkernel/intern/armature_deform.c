@@ -34,6 +34,7 @@
 
 #include "BLI_listbase.h"
 #include "BLI_math.h"
+#include "BLI_simd.h"
 #include "BLI_task.h"
 #include "BLI_utildefines.h"
 
@@ -232,6 +233,80 @@ static void pchan_bone_deform(bPoseChannel *pchan,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Armature Deform Skinning Kernel
+ *
+ * Fast path for vertices which are only deformed by vertex groups of regular bones. Deformation
+ * of the bones is gathered into a contiguous array indexed by vertex group, so the per-vertex
+ * loop does not access pose channels. For linear blending the object space transform is folded
+ * into the bone matrices, so that blending becomes a weighted sum of matrices followed by a
+ * single transform of the vertex.
+ * \{ */
+
+typedef struct ArmatureSkinBone {
+  /* `postmat * chan_mat * premat`, used for linear blending. */
+  float mat[4][4];
+  /* Armature space deformation, used for dual quaternion blending. */
+  const DualQuat *dq;
+  /* Deformation depends on the vertex position (B-Bones, or weight multiplied by envelope),
+   * vertices affected by such bones use the generic code path. */
+  bool is_position_dependent;
+} ArmatureSkinBone;
+
+static ArmatureSkinBone *armature_skin_bones_create(bPoseChannel **pchan_from_defbase,
+                                                    const int defbase_len,
+                                                    const float premat[4][4],
+                                                    const float postmat[4][4])
+{
+  ArmatureSkinBone *skin_bones = MEM_calloc_arrayN(
+      defbase_len, sizeof(*skin_bones), "armature skin bones");
+  for (int i = 0; i < defbase_len; i++) {
+    const bPoseChannel *pchan = pchan_from_defbase[i];
+    if (pchan == NULL) {
+      continue;
+    }
+    const Bone *bone = pchan->bone;
+    ArmatureSkinBone *skin_bone = &skin_bones[i];
+    mul_m4_series(skin_bone->mat, postmat, pchan->chan_mat, premat);
+    skin_bone->dq = &pchan->runtime.deform_dual_quat;
+    skin_bone->is_position_dependent = (bone->segments > 1 &&
+                                        pchan->runtime.bbone_segments == bone->segments) ||
+                                       (bone->flag & BONE_MULT_VG_ENV);
+  }
+  return skin_bones;
+}
+
+/* Same as #add_weighted_dq_dq. */
+BLI_INLINE void armature_skin_add_weighted_dq(DualQuat *dq_sum,
+                                              const DualQuat *dq,
+                                              const float weight)
+{
+#ifdef BLI_HAVE_SSE2
+  /* Make sure we interpolate quaternions in the right direction. */
+  const bool flipped = dot_qtqt(dq->quat, dq_sum->quat) < 0.0f;
+  const __m128 signed_weight = _mm_set1_ps(flipped ? -weight : weight);
+  _mm_storeu_ps(dq_sum->quat,
+                _mm_add_ps(_mm_loadu_ps(dq_sum->quat),
+                           _mm_mul_ps(_mm_loadu_ps(dq->quat), signed_weight)));
+  _mm_storeu_ps(dq_sum->trans,
+                _mm_add_ps(_mm_loadu_ps(dq_sum->trans),
+                           _mm_mul_ps(_mm_loadu_ps(dq->trans), signed_weight)));
+  if (dq->scale_weight) {
+    const __m128 weight_vec = _mm_set1_ps(weight);
+    for (int i = 0; i < 4; i++) {
+      _mm_storeu_ps(dq_sum->scale[i],
+                    _mm_add_ps(_mm_loadu_ps(dq_sum->scale[i]),
+                               _mm_mul_ps(_mm_loadu_ps(dq->scale[i]), weight_vec)));
+    }
+    dq_sum->scale_weight += weight;
+  }
+#else
+  add_weighted_dq_dq(dq_sum, dq, weight);
+#endif
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Armature Deform #BKE_armature_deform_coords API
  *
@@ -259,6 +334,9 @@ typedef struct ArmatureUserdata {
   bPoseChannel **pchan_from_defbase;
   int defbase_len;
 
+  /* Indexed by vertex group, NULL when the skinning kernel can not be used. */
+  const ArmatureSkinBone *skin_bones;
+
   float premat[4][4];
   float postmat[4][4];
 
@@ -268,6 +346,99 @@ typedef struct ArmatureUserdata {
   } bmesh;
 } ArmatureUserdata;
 
+/**
+ * Deform object space coordinate `co` by the vertex groups of `dvert`.
+ *
+ * \return false when the vertex is to be handled by the generic code path, in which case `co`
+ * is not modified.
+ */
+static bool armature_vert_skin(const ArmatureUserdata *data,
+                               const MDeformVert *dvert,
+                               float co[3])
+{
+  bPoseChannel *const *pchan_from_defbase = data->pchan_from_defbase;
+  const ArmatureSkinBone *skin_bones = data->skin_bones;
+  const bool use_quaternion = data->use_quaternion;
+
+#ifdef BLI_HAVE_SSE2
+  __m128 mat_vec[4] = {_mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps()};
+#else
+  float mat[4][4] = {{0.0f}};
+#endif
+  DualQuat sumdq;
+  if (use_quaternion) {
+    memset(&sumdq, 0, sizeof(sumdq));
+  }
+  float contrib = 0.0f;
+  bool deformed = false;
+
+  const MDeformWeight *dw = dvert->dw;
+  for (int j = dvert->totweight; j != 0; j--, dw++) {
+    const uint index = dw->def_nr;
+    if (index >= data->defbase_len || pchan_from_defbase[index] == NULL) {
+      continue;
+    }
+    const ArmatureSkinBone *skin_bone = &skin_bones[index];
+    if (skin_bone->is_position_dependent) {
+      return false;
+    }
+    deformed = true;
+    const float weight = dw->weight;
+    if (weight == 0.0f) {
+      continue;
+    }
+    if (use_quaternion) {
+      armature_skin_add_weighted_dq(&sumdq, skin_bone->dq, weight);
+    }
+    else {
+#ifdef BLI_HAVE_SSE2
+      const __m128 weight_vec = _mm_set1_ps(weight);
+      for (int k = 0; k < 4; k++) {
+        mat_vec[k] = _mm_add_ps(mat_vec[k],
+                                _mm_mul_ps(_mm_loadu_ps(skin_bone->mat[k]), weight_vec));
+      }
+#else
+      madd_m4_m4m4fl(mat, mat, skin_bone->mat, weight);
+#endif
+    }
+    contrib += weight;
+  }
+
+  /* Vertex groups without bones use envelopes, see #armature_vert_task_with_dvert. */
+  if (!deformed && data->use_envelope) {
+    return false;
+  }
+
+  /* actually should be EPSILON? weight values and contrib can be like 10e-39 small */
+  if (contrib <= 0.0001f) {
+    mul_m4_v3(data->premat, co);
+    mul_m4_v3(data->postmat, co);
+  }
+  else if (use_quaternion) {
+    mul_m4_v3(data->premat, co);
+    normalize_dq(&sumdq, contrib);
+    mul_v3m3_dq(co, NULL, &sumdq);
+    mul_m4_v3(data->postmat, co);
+  }
+  else {
+    /* Weights of the blended matrices sum up to contrib. */
+#ifdef BLI_HAVE_SSE2
+    __m128 co_vec = _mm_add_ps(_mm_mul_ps(mat_vec[0], _mm_set1_ps(co[0])),
+                               _mm_mul_ps(mat_vec[1], _mm_set1_ps(co[1])));
+    co_vec = _mm_add_ps(co_vec, _mm_mul_ps(mat_vec[2], _mm_set1_ps(co[2])));
+    co_vec = _mm_add_ps(co_vec, mat_vec[3]);
+    co_vec = _mm_mul_ps(co_vec, _mm_set1_ps(1.0f / contrib));
+    float co_result[4];
+    _mm_storeu_ps(co_result, co_vec);
+    copy_v3_v3(co, co_result);
+#else
+    mul_m4_v3(mat, co);
+    mul_v3_fl(co, 1.0f / contrib);
+#endif
+  }
+  return true;
+}
+
 static void armature_vert_task_with_dvert(const ArmatureUserdata *data,
                                           const int i,
                                           const MDeformVert *dvert)
@@ -280,6 +451,12 @@ static void armature_vert_task_with_dvert(const ArmatureUserdata *data,
   const bool use_dverts = data->use_dverts;
   const int armature_def_nr = data->armature_def_nr;
 
+  if (data->skin_bones && dvert && dvert->totweight) {
+    if (armature_vert_skin(data, dvert, vert_coords[i])) {
+      return;
+    }
+  }
+
   DualQuat sumdq, *dq = NULL;
   bPoseChannel *pchan;
   float *co, dco[3];
@@ -592,6 +769,16 @@ static void armature_deform_coords_impl(const Object *ob_arm,
   mul_m4_m4m4(data.postmat, obinv, ob_arm->obmat);
   invert_m4_m4(data.premat, data.postmat);
 
+  /* The skinning kernel covers plain vertex group deformation, blending with the overall
+   * armature group or previous coordinates and crazy-space matrices use the generic path. */
+  ArmatureSkinBone *skin_bones = NULL;
+  if (use_dverts && armature_def_nr == -1 && vert_coords_prev == NULL &&
+      vert_deform_mats == NULL) {
+    skin_bones = armature_skin_bones_create(
+        pchan_from_defbase, defbase_len, data.premat, data.postmat);
+    data.skin_bones = skin_bones;
+  }
+
   if (em_target != NULL) {
     /* While this could cause an extra loop over mesh data, in most cases this will
      * have already been properly set. */
@@ -619,6 +806,9 @@ static void armature_deform_coords_impl(const Object *ob_arm,
   if (pchan_from_defbase) {
     MEM_freeN(pchan_from_defbase);
   }
+  if (skin_bones) {
+    MEM_freeN(skin_bones);
+  }
 }
 
 void BKE_armature_deform_coords_with_gpencil_stroke(const Object *ob_arm,
@@ -117,6 +117,10 @@ static ThreadMutex *image_mutex;
 static void image_init(Image *ima, short source, short type);
 static void image_free_packedfiles(Image *ima);
 static void copy_image_packedfiles(ListBase *lb_dst, const ListBase *lb_src);
+static ImBuf *image_preload_take(Image *ima, const char *filepath, const int flag);
+static void image_load_async_cancel(Image *ima);
+static void image_load_async_init(void);
+static void image_load_async_exit(void);
 
 static void image_init_data(ID *id)
 {
@@ -171,6 +175,9 @@ static void image_free_data(ID *id)
 {
   Image *image = (Image *)id;
 
+  /* Background loading may still use the image. */
+  image_load_async_cancel(image);
+
   /* Also frees animdata. */
   BKE_image_free_buffers(image);
 
@@ -432,10 +439,12 @@ static struct ImBuf *imagecache_get(Image *image, int index)
 void BKE_images_init(void)
 {
   image_mutex = BLI_mutex_alloc();
+  image_load_async_init();
 }
 
 void BKE_images_exit(void)
 {
+  image_load_async_exit();
   BLI_mutex_free(image_mutex);
 }
 
@@ -4498,8 +4507,11 @@ static ImBuf *load_image_single(Image *ima,
 
     BKE_image_user_file_path(&iuser_t, ima, filepath);
 
-    /* read ibuf */
-    ibuf = IMB_loadiffname(filepath, flag, ima->colorspace_settings.name);
+    /* read ibuf, unless it was already read by a background load */
+    ibuf = image_preload_take(ima, filepath, flag);
+    if (ibuf == NULL) {
+      ibuf = IMB_loadiffname(filepath, flag, ima->colorspace_settings.name);
+    }
   }
 
   if (ibuf) {
@@ -5190,6 +5202,285 @@ bool BKE_image_has_ibuf(Image *ima, ImageUser *iuser)
   return ibuf != NULL;
 }
 
+/* ******** Asynchronous loading ******** */
+
+/* Loading image files in the background, so drawing doesn't have to wait for them. Files are
+ * decoded without holding image_mutex, which allows loading many images in parallel. The
+ * decoded buffer is then handed to the regular loading code through image_preload. */
+
+enum {
+  IMAGE_LOAD_QUEUED = 0,
+  IMAGE_LOAD_RUNNING = 1,
+};
+
+typedef struct ImageLoadRequest {
+  struct ImageLoadRequest *next, *prev;
+  Image *image;
+  ImageUser iuser;
+  int entry;
+  int index;
+  int status;
+} ImageLoadRequest;
+
+static struct {
+  TaskPool *task_pool;
+  /* Queued and running requests. */
+  ListBase requests;
+  /* LinkData of images that finished loading, for BKE_image_load_async_pop_finished. */
+  ListBase finished;
+  ThreadMutex mutex;
+  /* Notified when a running request finishes. */
+  ThreadCondition finished_cond;
+} image_load_queue = {NULL};
+
+/* File decoded by a background load, protected by image_mutex. */
+static struct {
+  Image *image;
+  char filepath[FILE_MAX];
+  int flag;
+  /* Color space of the image when the file was read, and as returned by the file reader. */
+  char colorspace[IM_MAX_SPACE];
+  char colorspace_result[IM_MAX_SPACE];
+  ImBuf *ibuf;
+} image_preload = {NULL};
+
+/* Use the buffer decoded by a background load if it matches the file to be read. */
+static ImBuf *image_preload_take(Image *ima, const char *filepath, const int flag)
+{
+  ImBuf *ibuf = NULL;
+
+  if (image_preload.ibuf && image_preload.image == ima && image_preload.flag == flag &&
+      STREQ(image_preload.filepath, filepath) &&
+      STREQ(image_preload.colorspace, ima->colorspace_settings.name)) {
+    ibuf = image_preload.ibuf;
+    image_preload.ibuf = NULL;
+    /* Same as reading the file with the image color space. */
+    STRNCPY(ima->colorspace_settings.name, image_preload.colorspace_result);
+  }
+
+  return ibuf;
+}
+
+/* Only single images from files, other sources are either fast to get or need to go through
+ * the image state for every frame. */
+static bool image_load_async_supported(Image *ima)
+{
+  return ima->source == IMA_SRC_FILE && ima->type == IMA_TYPE_IMAGE &&
+         !BKE_image_has_packedfile(ima) && !BKE_image_is_multiview(ima);
+}
+
+static void image_load_async_task(TaskPool *__restrict UNUSED(pool), void *taskdata)
+{
+  ImageLoadRequest *request = (ImageLoadRequest *)taskdata;
+  Image *ima = request->image;
+  ImageUser iuser = request->iuser;
+  char filepath[FILE_MAX];
+  char colorspace[IM_MAX_SPACE];
+  int flag = 0;
+  bool do_load = false;
+
+  BLI_mutex_lock(&image_load_queue.mutex);
+  if (BLI_findindex(&image_load_queue.requests, request) == -1) {
+    /* Canceled. */
+    BLI_mutex_unlock(&image_load_queue.mutex);
+    return;
+  }
+  request->status = IMAGE_LOAD_RUNNING;
+  BLI_mutex_unlock(&image_load_queue.mutex);
+
+  BLI_mutex_lock(image_mutex);
+  ImBuf *ibuf = image_get_cached_ibuf(ima, &iuser, NULL, NULL);
+  if (ibuf == NULL && image_quick_test(ima, &iuser) && image_load_async_supported(ima)) {
+    /* Same as load_image_single(). */
+    flag = IB_rect | IB_multilayer | IB_metadata;
+    flag |= imbuf_alpha_flags_for_image(ima);
+    iuser.view = 0;
+    BKE_image_user_file_path(&iuser, ima, filepath);
+    STRNCPY(colorspace, ima->colorspace_settings.name);
+    do_load = true;
+  }
+  IMB_freeImBuf(ibuf);
+  BLI_mutex_unlock(image_mutex);
+
+  if (do_load) {
+    char colorspace_result[IM_MAX_SPACE];
+    STRNCPY(colorspace_result, colorspace);
+    ImBuf *ibuf_file = IMB_loadiffname(filepath, flag, colorspace_result);
+
+    BLI_mutex_lock(image_mutex);
+
+    image_preload.image = ima;
+    image_preload.flag = flag;
+    image_preload.ibuf = ibuf_file;
+    STRNCPY(image_preload.filepath, filepath);
+    STRNCPY(image_preload.colorspace, colorspace);
+    STRNCPY(image_preload.colorspace_result, colorspace_result);
+
+    /* Goes through load_image_single(), which takes the decoded buffer. When reading failed
+     * this tries again, to get the same error handling as regular loading. */
+    iuser = request->iuser;
+    ibuf = image_acquire_ibuf(ima, &iuser, NULL);
+    IMB_freeImBuf(ibuf);
+
+    /* The image changed in the meantime. */
+    if (image_preload.ibuf) {
+      IMB_freeImBuf(image_preload.ibuf);
+    }
+    memset(&image_preload, 0, sizeof(image_preload));
+
+    BLI_mutex_unlock(image_mutex);
+  }
+
+  BLI_mutex_lock(&image_load_queue.mutex);
+  BLI_remlink(&image_load_queue.requests, request);
+  BLI_addtail(&image_load_queue.finished, BLI_genericNodeN(ima));
+  BLI_condition_notify_all(&image_load_queue.finished_cond);
+  BLI_mutex_unlock(&image_load_queue.mutex);
+}
+
+/**
+ * Start loading the image buffer for the given image user in the background, unless it is
+ * already in memory or the image is not read from a file.
+ *
+ * \return true when the buffer can be acquired without waiting for the file to be read.
+ */
+bool BKE_image_load_async(Image *ima, ImageUser *iuser)
+{
+  if (!image_quick_test(ima, iuser)) {
+    /* Failed images are handled by regular acquiring. */
+    return true;
+  }
+
+  int entry = 0, index = 0;
+  bool is_loaded = true;
+
+  BLI_mutex_lock(image_mutex);
+  if (image_load_async_supported(ima)) {
+    ImBuf *ibuf = image_get_cached_ibuf(ima, iuser, &entry, &index);
+    is_loaded = (ibuf != NULL);
+    IMB_freeImBuf(ibuf);
+  }
+  BLI_mutex_unlock(image_mutex);
+
+  if (is_loaded) {
+    return true;
+  }
+
+  BLI_mutex_lock(&image_load_queue.mutex);
+
+  LISTBASE_FOREACH (ImageLoadRequest *, request, &image_load_queue.requests) {
+    if (request->image == ima && request->entry == entry && request->index == index) {
+      BLI_mutex_unlock(&image_load_queue.mutex);
+      return false;
+    }
+  }
+
+  if (image_load_queue.task_pool == NULL) {
+    image_load_queue.task_pool = BLI_task_pool_create_background(NULL, TASK_PRIORITY_LOW);
+  }
+
+  ImageLoadRequest *request = MEM_callocN(sizeof(ImageLoadRequest), __func__);
+  request->image = ima;
+  if (iuser) {
+    request->iuser = *iuser;
+  }
+  else {
+    BKE_imageuser_default(&request->iuser);
+  }
+  request->entry = entry;
+  request->index = index;
+  request->status = IMAGE_LOAD_QUEUED;
+  BLI_addtail(&image_load_queue.requests, request);
+
+  /* The task pool owns the request, it stays valid after it was removed from the queue. */
+  BLI_task_pool_push(image_load_queue.task_pool, image_load_async_task, request, true, NULL);
+
+  BLI_mutex_unlock(&image_load_queue.mutex);
+
+  return false;
+}
+
+/**
+ * Get the next image which finished loading in the background, NULL when there are none.
+ * Its GPU textures are tagged for refresh, to replace placeholders. Only call from the main
+ * thread.
+ */
+Image *BKE_image_load_async_pop_finished(void)
+{
+  BLI_assert(BLI_thread_is_main());
+
+  Image *ima = NULL;
+
+  BLI_mutex_lock(&image_load_queue.mutex);
+  LinkData *link = BLI_pophead(&image_load_queue.finished);
+  BLI_mutex_unlock(&image_load_queue.mutex);
+
+  if (link) {
+    ima = link->data;
+    MEM_freeN(link);
+  }
+
+  if (ima) {
+    ima->gpuflag |= IMA_GPU_REFRESH;
+  }
+
+  return ima;
+}
+
+/* Remove all requests for the image, or all requests when it is NULL. Waits for the ones which
+ * are being loaded. */
+static void image_load_async_cancel(Image *ima)
+{
+  BLI_mutex_lock(&image_load_queue.mutex);
+
+  bool is_running;
+  do {
+    is_running = false;
+    LISTBASE_FOREACH_MUTABLE (ImageLoadRequest *, request, &image_load_queue.requests) {
+      if (ima && request->image != ima) {
+        continue;
+      }
+      if (request->status == IMAGE_LOAD_RUNNING) {
+        is_running = true;
+      }
+      else {
+        /* The task finds that it's not in the queue anymore. */
+        BLI_remlink(&image_load_queue.requests, request);
+      }
+    }
+    if (is_running) {
+      BLI_condition_wait(&image_load_queue.finished_cond, &image_load_queue.mutex);
+    }
+  } while (is_running);
+
+  LISTBASE_FOREACH_MUTABLE (LinkData *, link, &image_load_queue.finished) {
+    if (ima == NULL || link->data == ima) {
+      BLI_freelinkN(&image_load_queue.finished, link);
+    }
+  }
+
+  BLI_mutex_unlock(&image_load_queue.mutex);
+}
+
+static void image_load_async_init(void)
+{
+  BLI_mutex_init(&image_load_queue.mutex);
+  BLI_condition_init(&image_load_queue.finished_cond);
+}
+
+static void image_load_async_exit(void)
+{
+  image_load_async_cancel(NULL);
+
+  if (image_load_queue.task_pool) {
+    BLI_task_pool_free(image_load_queue.task_pool);
+    image_load_queue.task_pool = NULL;
+  }
+
+  BLI_condition_end(&image_load_queue.finished_cond);
+  BLI_mutex_end(&image_load_queue.mutex);
+}
+
 /* ******** Pool for image buffers ******** */
 
 typedef struct ImagePoolItem {
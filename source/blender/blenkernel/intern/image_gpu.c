@@ -295,10 +295,17 @@ static GPUTexture *image_gpu_texture_error_create(eGPUTextureTarget textarget)
   }
 }
 
+static GPUTexture *image_gpu_texture_placeholder_create(void)
+{
+  const float pixel[4] = {0.5f, 0.5f, 0.5f, 1.0f};
+  return GPU_texture_create_2d("placeholder_tex", 1, 1, 1, GPU_RGBA8, pixel);
+}
+
 static GPUTexture *image_get_gpu_texture(Image *ima,
                                          ImageUser *iuser,
                                          ImBuf *ibuf,
-                                         eGPUTextureTarget textarget)
+                                         eGPUTextureTarget textarget,
+                                         const bool use_async_load)
 {
   if (ima == NULL) {
     return NULL;
@@ -335,6 +342,11 @@ static GPUTexture *image_get_gpu_texture(Image *ima,
   }
 #undef GPU_FLAGS_TO_CHECK
 
+  /* Callers which can't use placeholders wait for the image to be loaded. */
+  if ((ima->gpuflag & IMA_GPU_PLACEHOLDER) && !use_async_load) {
+    ima->gpuflag |= IMA_GPU_REFRESH;
+  }
+
   /* Check if image has been updated and tagged to be updated (full or partial). */
   ImageTile *tile = BKE_image_get_tile(ima, 0);
   if (((ima->gpuflag & IMA_GPU_REFRESH) != 0) ||
@@ -380,6 +392,15 @@ static GPUTexture *image_get_gpu_texture(Image *ima,
     return *tex;
   }
 
+  /* Don't wait for the file to be read, the placeholder is replaced with the actual texture
+   * when #BKE_image_load_async_pop_finished tags the image for refresh. */
+  if (ibuf == NULL && use_async_load && textarget == TEXTARGET_2D &&
+      !BKE_image_load_async(ima, iuser)) {
+    *tex = image_gpu_texture_placeholder_create();
+    ima->gpuflag |= IMA_GPU_PLACEHOLDER;
+    return *tex;
+  }
+
   /* check if we have a valid image buffer */
   ImBuf *ibuf_intern = ibuf;
   if (ibuf_intern == NULL) {
@@ -438,17 +459,22 @@ static GPUTexture *image_get_gpu_texture(Image *ima,
 
 GPUTexture *BKE_image_get_gpu_texture(Image *image, ImageUser *iuser, ImBuf *ibuf)
 {
-  return image_get_gpu_texture(image, iuser, ibuf, TEXTARGET_2D);
+  return image_get_gpu_texture(image, iuser, ibuf, TEXTARGET_2D, false);
+}
+
+GPUTexture *BKE_image_get_gpu_texture_async(Image *image, ImageUser *iuser)
+{
+  return image_get_gpu_texture(image, iuser, NULL, TEXTARGET_2D, true);
 }
 
 GPUTexture *BKE_image_get_gpu_tiles(Image *image, ImageUser *iuser, ImBuf *ibuf)
 {
-  return image_get_gpu_texture(image, iuser, ibuf, TEXTARGET_2D_ARRAY);
+  return image_get_gpu_texture(image, iuser, ibuf, TEXTARGET_2D_ARRAY, false);
 }
 
 GPUTexture *BKE_image_get_gpu_tilemap(Image *image, ImageUser *iuser, ImBuf *ibuf)
 {
-  return image_get_gpu_texture(image, iuser, ibuf, TEXTARGET_TILE_MAPPING);
+  return image_get_gpu_texture(image, iuser, ibuf, TEXTARGET_TILE_MAPPING, false);
 }
 
 /** \} */
@@ -511,7 +537,7 @@ static void image_free_gpu(Image *ima, const bool immediate)
     }
   }
 
-  ima->gpuflag &= ~IMA_GPU_MIPMAP_COMPLETE;
+  ima->gpuflag &= ~(IMA_GPU_MIPMAP_COMPLETE | IMA_GPU_PLACEHOLDER);
 }
 
 void BKE_image_free_gputextures(Image *ima)
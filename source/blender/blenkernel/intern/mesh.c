@@ -1853,21 +1853,27 @@ void BKE_mesh_calc_normals_split_ex(Mesh *mesh, MLoopNorSpaceArray *r_lnors_spac
     free_polynors = true;
   }
 
-  BKE_mesh_normals_loop_split(mesh->mvert,
-                              mesh->totvert,
-                              mesh->medge,
-                              mesh->totedge,
-                              mesh->mloop,
-                              r_loopnors,
-                              mesh->totloop,
-                              mesh->mpoly,
-                              (const float(*)[3])polynors,
-                              mesh->totpoly,
-                              use_split_normals,
-                              split_angle,
-                              r_lnors_spacearr,
-                              clnors,
-                              NULL);
+  if (r_lnors_spacearr == NULL) {
+    BKE_mesh_normals_loop_split_cached(
+        mesh, (const float(*)[3])polynors, use_split_normals, split_angle, r_loopnors);
+  }
+  else {
+    BKE_mesh_normals_loop_split(mesh->mvert,
+                                mesh->totvert,
+                                mesh->medge,
+                                mesh->totedge,
+                                mesh->mloop,
+                                r_loopnors,
+                                mesh->totloop,
+                                mesh->mpoly,
+                                (const float(*)[3])polynors,
+                                mesh->totpoly,
+                                use_split_normals,
+                                split_angle,
+                                r_lnors_spacearr,
+                                clnors,
+                                NULL);
+  }
 
   if (free_polynors) {
     MEM_freeN(polynors);
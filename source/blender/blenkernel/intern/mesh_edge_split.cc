@@ -0,0 +1,397 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup bke
+ *
+ * Split mesh edges by angle or sharp flag without converting to #BMesh,
+ * matching the result of #BM_mesh_edgesplit on tagged edges.
+ */
+
+#include "MEM_guardedalloc.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BLI_array.hh"
+#include "BLI_float3.hh"
+#include "BLI_index_mask.hh"
+#include "BLI_math_base.h"
+#include "BLI_math_vector.h"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
+
+#include "BKE_customdata.h"
+#include "BKE_mesh.h"
+#include "BKE_mesh_mapping.h"
+
+namespace blender::bke::mesh_edge_split {
+
+/**
+ * Corners of each edge, in polygon order.
+ */
+struct EdgeCornerMap {
+  Array<int> offsets;
+  Array<int> corners;
+
+  Span<int> edge_corners(const int edge) const
+  {
+    return corners.as_span().slice(offsets[edge], offsets[edge + 1] - offsets[edge]);
+  }
+};
+
+static EdgeCornerMap build_edge_corner_map(const Mesh &mesh)
+{
+  EdgeCornerMap map;
+  map.offsets = Array<int>(mesh.totedge + 1, 0);
+  map.corners = Array<int>(mesh.totloop);
+
+  const Span<MLoop> loops(mesh.mloop, mesh.totloop);
+  for (const MLoop &ml : loops) {
+    map.offsets[ml.e + 1]++;
+  }
+  for (const int i : IndexRange(mesh.totedge)) {
+    map.offsets[i + 1] += map.offsets[i];
+  }
+
+  Array<int> fill(map.offsets.as_span().drop_back(1));
+  const Span<MPoly> polys(mesh.mpoly, mesh.totpoly);
+  for (const MPoly &mp : polys) {
+    for (const int corner : IndexRange(mp.loopstart, mp.totloop)) {
+      map.corners[fill[loops[corner].e]++] = corner;
+    }
+  }
+  return map;
+}
+
+static Vector<int64_t> find_split_edges(const Mesh &mesh,
+                                        const EdgeCornerMap &edge_corners,
+                                        Span<int> corner_to_poly,
+                                        const bool use_edge_angle,
+                                        const float split_angle,
+                                        const bool use_edge_sharp)
+{
+  const float threshold = cosf(split_angle + 0.000000175f);
+  const bool do_split_angle = use_edge_angle && split_angle < (float)M_PI;
+  const bool do_split_all = do_split_angle && split_angle < FLT_EPSILON;
+  const bool calc_poly_normals = do_split_angle && !do_split_all;
+
+  Array<float3> poly_normals;
+  if (calc_poly_normals) {
+    poly_normals.reinitialize(mesh.totpoly);
+    threading::parallel_for(IndexRange(mesh.totpoly), 1024, [&](IndexRange range) {
+      for (const int i : range) {
+        const MPoly &mp = mesh.mpoly[i];
+        BKE_mesh_calc_poly_normal(&mp, &mesh.mloop[mp.loopstart], mesh.mvert, poly_normals[i]);
+      }
+    });
+  }
+
+  Array<bool> split_edges(mesh.totedge);
+  threading::parallel_for(IndexRange(mesh.totedge), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      const Span<int> corners = edge_corners.edge_corners(i);
+      bool split = false;
+      if (do_split_angle && corners.size() >= 2) {
+        split = /* 3+ faces on this edge, always split. */
+            corners.size() > 2 ||
+            /* 0° angle setting, we want to split on all edges. */
+            do_split_all ||
+            /* 2 face edge - check angle. */
+            (dot_v3v3(poly_normals[corner_to_poly[corners[0]]],
+                      poly_normals[corner_to_poly[corners[1]]]) < threshold);
+      }
+      if (use_edge_sharp && !corners.is_empty()) {
+        split = split || (mesh.medge[i].flag & ME_SHARP);
+      }
+      split_edges[i] = split;
+    }
+  });
+
+  Vector<int64_t> indices;
+  for (const int i : IndexRange(mesh.totedge)) {
+    if (split_edges[i]) {
+      indices.append(i);
+    }
+  }
+  return indices;
+}
+
+static Mesh *edge_split(const Mesh &mesh,
+                        const bool use_edge_angle,
+                        const float split_angle,
+                        const bool use_edge_sharp)
+{
+  const Span<MPoly> polys(mesh.mpoly, mesh.totpoly);
+  const Span<MLoop> loops(mesh.mloop, mesh.totloop);
+  const Span<MEdge> edges(mesh.medge, mesh.totedge);
+
+  Array<int> corner_to_poly(mesh.totloop);
+  threading::parallel_for(polys.index_range(), 1024, [&](IndexRange range) {
+    for (const int i : range) {
+      corner_to_poly.as_mutable_span().slice(polys[i].loopstart, polys[i].totloop).fill(i);
+    }
+  });
+
+  const auto corner_prev = [&](const int corner) {
+    const MPoly &mp = polys[corner_to_poly[corner]];
+    return corner == mp.loopstart ? corner + mp.totloop - 1 : corner - 1;
+  };
+  const auto corner_next = [&](const int corner) {
+    const MPoly &mp = polys[corner_to_poly[corner]];
+    return corner == mp.loopstart + mp.totloop - 1 ? mp.loopstart : corner + 1;
+  };
+
+  const EdgeCornerMap edge_corners = build_edge_corner_map(mesh);
+  const Vector<int64_t> split_edge_indices = find_split_edges(
+      mesh, edge_corners, corner_to_poly, use_edge_angle, split_angle, use_edge_sharp);
+  const IndexMask split_edge_mask(split_edge_indices);
+
+  Array<bool> is_split_edge(mesh.totedge, false);
+  Array<bool> is_split_vert(mesh.totvert, false);
+  for (const int64_t i : split_edge_mask) {
+    is_split_edge[i] = true;
+    is_split_vert[edges[i].v1] = true;
+    is_split_vert[edges[i].v2] = true;
+  }
+
+  MeshElemMap *vert_corner_map;
+  int *vert_corner_mem;
+  BKE_mesh_vert_loop_map_create(&vert_corner_map,
+                                &vert_corner_mem,
+                                mesh.mpoly,
+                                mesh.mloop,
+                                mesh.totvert,
+                                mesh.totpoly,
+                                mesh.totloop);
+
+  /* Group the corners around each vertex into fans connected by edges that aren't split,
+   * every fan besides the first gets a new vertex. */
+  Array<int> corner_fan(mesh.totloop, 0);
+  Array<int> vert_offsets(mesh.totvert + 1, 0);
+  threading::parallel_for(IndexRange(mesh.totvert), 1024, [&](IndexRange range) {
+    Vector<int, 16> fan_parent;
+    for (const int vert : range) {
+      if (!is_split_vert[vert]) {
+        continue;
+      }
+      const Span<int> corners(vert_corner_map[vert].indices, vert_corner_map[vert].count);
+
+      fan_parent.clear();
+      for (const int i : corners.index_range()) {
+        fan_parent.append(i);
+      }
+      const auto find_root = [&](int i) {
+        while (fan_parent[i] != i) {
+          i = fan_parent[i] = fan_parent[fan_parent[i]];
+        }
+        return i;
+      };
+
+      for (const int i : corners.index_range()) {
+        const int edges_i[2] = {int(loops[corners[i]].e),
+                                int(loops[corner_prev(corners[i])].e)};
+        for (int j = i + 1; j < corners.size(); j++) {
+          const int edges_j[2] = {int(loops[corners[j]].e),
+                                  int(loops[corner_prev(corners[j])].e)};
+          for (const int edge : edges_i) {
+            if (!is_split_edge[edge] && ELEM(edge, edges_j[0], edges_j[1])) {
+              const int root_i = find_root(i);
+              const int root_j = find_root(j);
+              /* Keep the lowest index as root, so the first corner is always in the first fan. */
+              fan_parent[max_ii(root_i, root_j)] = min_ii(root_i, root_j);
+            }
+          }
+        }
+      }
+
+      int fans_len = 0;
+      for (const int i : corners.index_range()) {
+        const int root = find_root(i);
+        if (root == i) {
+          corner_fan[corners[i]] = fans_len++;
+        }
+        else {
+          corner_fan[corners[i]] = corner_fan[corners[root]];
+        }
+      }
+      vert_offsets[vert] = max_ii(fans_len - 1, 0);
+    }
+  });
+
+  /* Like #BM_vert_separate, every loose edge of a split vertex gets a vertex of its own,
+   * after the vertices of the fans. */
+  Array<int> vert_loose_edges_len(mesh.totvert, 0);
+  for (const int edge : edges.index_range()) {
+    if (edge_corners.edge_corners(edge).is_empty()) {
+      for (const int vert : {int(edges[edge].v1), int(edges[edge].v2)}) {
+        if (is_split_vert[vert]) {
+          vert_loose_edges_len[vert]++;
+          vert_offsets[vert]++;
+        }
+      }
+    }
+  }
+
+  /* Accumulate the number of new vertices into offsets of the first new vertex. */
+  int new_verts_len = 0;
+  for (const int vert : IndexRange(mesh.totvert)) {
+    const int count = vert_offsets[vert];
+    vert_offsets[vert] = mesh.totvert + new_verts_len;
+    new_verts_len += count;
+  }
+  vert_offsets[mesh.totvert] = mesh.totvert + new_verts_len;
+
+  Array<int> corner_verts(mesh.totloop);
+  Array<int> new_vert_orig(new_verts_len);
+  threading::parallel_for(IndexRange(mesh.totvert), 1024, [&](IndexRange range) {
+    for (const int vert : range) {
+      const Span<int> corners(vert_corner_map[vert].indices, vert_corner_map[vert].count);
+      for (const int corner : corners) {
+        const int fan = corner_fan[corner];
+        corner_verts[corner] = fan == 0 ? vert : vert_offsets[vert] + fan - 1;
+      }
+      for (int new_vert = vert_offsets[vert]; new_vert < vert_offsets[vert + 1]; new_vert++) {
+        new_vert_orig[new_vert - mesh.totvert] = vert;
+      }
+    }
+  });
+
+  MEM_freeN(vert_corner_map);
+  MEM_freeN(vert_corner_mem);
+
+  /* The vertices of edge corners after splitting. */
+  const auto corner_edge_verts = [&](const int edge, const int corner) {
+    const MEdge &med = edges[edge];
+    const int v_corner = corner_verts[corner];
+    const int v_next = corner_verts[corner_next(corner)];
+    return std::pair<int, int>(med.v1 == loops[corner].v ? v_corner : v_next,
+                               med.v2 == loops[corner].v ? v_corner : v_next);
+  };
+
+  /* Split edges get a new edge for every unique pair of vertices, past the first. */
+  Array<int> edge_offsets(mesh.totedge, 0);
+  threading::parallel_for(split_edge_mask.index_range(), 1024, [&](IndexRange range) {
+    Vector<std::pair<int, int>, 16> unique_verts;
+    for (const int64_t edge : split_edge_mask.indices().slice(range)) {
+      unique_verts.clear();
+      for (const int corner : edge_corners.edge_corners(edge)) {
+        unique_verts.append_non_duplicates(corner_edge_verts(edge, corner));
+      }
+      edge_offsets[edge] = int(unique_verts.size()) - 1;
+    }
+  });
+
+  int new_edges_len = 0;
+  for (const int edge : IndexRange(mesh.totedge)) {
+    const int count = edge_offsets[edge];
+    edge_offsets[edge] = mesh.totedge + new_edges_len;
+    new_edges_len += count;
+  }
+
+  Mesh *result = BKE_mesh_new_nomain_from_template(&mesh,
+                                                   mesh.totvert + new_verts_len,
+                                                   mesh.totedge + new_edges_len,
+                                                   0,
+                                                   mesh.totloop,
+                                                   mesh.totpoly);
+
+  CustomData_copy_data(&mesh.vdata, &result->vdata, 0, 0, mesh.totvert);
+  CustomData_copy_data(&mesh.edata, &result->edata, 0, 0, mesh.totedge);
+  CustomData_copy_data(&mesh.ldata, &result->ldata, 0, 0, mesh.totloop);
+  CustomData_copy_data(&mesh.pdata, &result->pdata, 0, 0, mesh.totpoly);
+
+  threading::parallel_for(IndexRange(new_verts_len), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      CustomData_copy_data(&mesh.vdata, &result->vdata, new_vert_orig[i], mesh.totvert + i, 1);
+    }
+  });
+
+  MutableSpan<MEdge> result_edges(result->medge, result->totedge);
+  MutableSpan<MLoop> result_loops(result->mloop, result->totloop);
+  threading::parallel_for(edges.index_range(), 1024, [&](IndexRange range) {
+    Vector<std::pair<int, int>, 16> unique_verts;
+    for (const int edge : range) {
+      const Span<int> corners = edge_corners.edge_corners(edge);
+      if (corners.is_empty()) {
+        /* Loose edges are handled below. */
+        continue;
+      }
+      if (!is_split_edge[edge]) {
+        /* All corners are in the same fans. */
+        const std::pair<int, int> verts = corner_edge_verts(edge, corners[0]);
+        result_edges[edge].v1 = verts.first;
+        result_edges[edge].v2 = verts.second;
+        continue;
+      }
+
+      unique_verts.clear();
+      for (const int corner : corners) {
+        const std::pair<int, int> verts = corner_edge_verts(edge, corner);
+        int index = int(unique_verts.first_index_of_try(verts));
+        if (index == -1) {
+          index = int(unique_verts.append_and_get_index(verts));
+          const int dst_edge = index == 0 ? edge : edge_offsets[edge] + index - 1;
+          if (index != 0) {
+            CustomData_copy_data(&mesh.edata, &result->edata, edge, dst_edge, 1);
+          }
+          result_edges[dst_edge].v1 = verts.first;
+          result_edges[dst_edge].v2 = verts.second;
+        }
+        result_loops[corner].e = index == 0 ? edge : edge_offsets[edge] + index - 1;
+      }
+    }
+  });
+
+  threading::parallel_for(loops.index_range(), 4096, [&](IndexRange range) {
+    for (const int corner : range) {
+      result_loops[corner].v = corner_verts[corner];
+    }
+  });
+
+  /* Loose edges use the last new vertices of their split vertices, in edge order. */
+  for (const int edge : edges.index_range()) {
+    if (edge_corners.edge_corners(edge).is_empty()) {
+      for (uint *vert : {&result_edges[edge].v1, &result_edges[edge].v2}) {
+        if (is_split_vert[*vert]) {
+          const int new_vert = vert_offsets[*vert + 1] - vert_loose_edges_len[*vert]--;
+          *vert = uint(new_vert);
+        }
+      }
+    }
+  }
+
+  return result;
+}
+
+}  // namespace blender::bke::mesh_edge_split
+
+/**
+ * Split edges with an angle between their faces larger than \a split_angle
+ * and/or edges marked as sharp, so the faces on either side no longer share vertices.
+ *
+ * Only the vertices of split edges are separated,
+ * into fans of faces connected by edges that aren't split.
+ * Loose edges at those vertices are separated as well, each getting its own vertex.
+ */
+Mesh *BKE_mesh_edge_split(const Mesh *mesh,
+                          const bool use_edge_angle,
+                          const float split_angle,
+                          const bool use_edge_sharp)
+{
+  return blender::bke::mesh_edge_split::edge_split(
+      *mesh, use_edge_angle, split_angle, use_edge_sharp);
+}
@@ -0,0 +1,257 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include <vector>
+
+#include "BLI_array.hh"
+#include "BLI_float3.hh"
+#include "BLI_math.h"
+#include "BLI_vector.hh"
+
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "bmesh.h"
+#include "bmesh_tools.h"
+
+namespace blender::bke::tests {
+
+/* A 2x2 grid of quads around vertex 4, the middle column is folded up by \a fold_height. */
+static Vector<float3> grid_positions(const float fold_height)
+{
+  Vector<float3> positions;
+  for (const int y : IndexRange(3)) {
+    for (const int x : IndexRange(3)) {
+      positions.append({float(x), float(y), x == 1 ? fold_height : 0.0f});
+    }
+  }
+  return positions;
+}
+
+static const Vector<Vector<int>> grid_polys = {
+    {0, 1, 4, 3}, {1, 2, 5, 4}, {3, 4, 7, 6}, {4, 5, 8, 7}};
+
+/* Loose edges are added before the edges of the polygons. */
+static Mesh *create_mesh(const Vector<float3> &positions,
+                         const Vector<Vector<int>> &polys,
+                         const Vector<std::pair<int, int>> &loose_edges,
+                         const Vector<std::pair<int, int>> &sharp_edges)
+{
+  int loops_len = 0;
+  for (const Vector<int> &poly : polys) {
+    loops_len += poly.size();
+  }
+
+  Mesh *mesh = BKE_mesh_new_nomain(
+      positions.size(), loose_edges.size(), 0, loops_len, polys.size());
+  for (const int i : positions.index_range()) {
+    copy_v3_v3(mesh->mvert[i].co, positions[i]);
+  }
+  for (const int i : loose_edges.index_range()) {
+    mesh->medge[i].v1 = loose_edges[i].first;
+    mesh->medge[i].v2 = loose_edges[i].second;
+    mesh->medge[i].flag = ME_EDGEDRAW | ME_EDGERENDER | ME_LOOSEEDGE;
+  }
+  int loop = 0;
+  for (const int i : polys.index_range()) {
+    mesh->mpoly[i].loopstart = loop;
+    mesh->mpoly[i].totloop = polys[i].size();
+    for (const int vert : polys[i]) {
+      mesh->mloop[loop++].v = vert;
+    }
+  }
+  BKE_mesh_calc_edges(mesh, true, false);
+
+  for (MEdge &me : MutableSpan(mesh->medge, mesh->totedge)) {
+    for (const std::pair<int, int> &sharp_edge : sharp_edges) {
+      if ((int(me.v1) == sharp_edge.first && int(me.v2) == sharp_edge.second) ||
+          (int(me.v1) == sharp_edge.second && int(me.v2) == sharp_edge.first)) {
+        me.flag |= ME_SHARP;
+      }
+    }
+  }
+  return mesh;
+}
+
+/* The edge split modifier before #BKE_mesh_edge_split replaced it. */
+static Mesh *edge_split_bmesh(const Mesh *mesh,
+                              const bool use_edge_angle,
+                              const float split_angle,
+                              const bool use_edge_sharp)
+{
+  const float threshold = cosf(split_angle + 0.000000175f);
+  const bool do_split_angle = use_edge_angle && split_angle < (float)M_PI;
+  const bool do_split_all = do_split_angle && split_angle < FLT_EPSILON;
+
+  BMeshCreateParams create_params{};
+  BMeshFromMeshParams convert_params{};
+  convert_params.calc_face_normal = true;
+  BMesh *bm = BKE_mesh_to_bmesh_ex(mesh, &create_params, &convert_params);
+
+  BMIter iter;
+  BMEdge *e;
+  BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
+    BMLoop *l1 = e->l;
+    if (l1 == nullptr) {
+      continue;
+    }
+    BMLoop *l2 = l1->radial_next;
+    if (do_split_angle && l2 != l1 &&
+        (l1 != l2->radial_next || do_split_all || dot_v3v3(l1->f->no, l2->f->no) < threshold)) {
+      BM_elem_flag_enable(e, BM_ELEM_TAG);
+    }
+    if (use_edge_sharp && !BM_elem_flag_test(e, BM_ELEM_SMOOTH)) {
+      BM_elem_flag_enable(e, BM_ELEM_TAG);
+    }
+  }
+
+  BM_mesh_edgesplit(bm, false, true, false);
+
+  Mesh *result = BKE_mesh_from_bmesh_for_eval_nomain(bm, nullptr, mesh);
+  BM_mesh_free(bm);
+  return result;
+}
+
+/**
+ * The vertex of every corner and of both ends of the loose edges, as the first of them using the
+ * same vertex. This doesn't depend on the order of the vertices.
+ */
+static std::vector<int> vert_incidences(const Mesh *mesh)
+{
+  Array<bool> edge_is_loose(mesh->totedge, true);
+  std::vector<int> verts;
+  for (const MLoop &ml : Span(mesh->mloop, mesh->totloop)) {
+    edge_is_loose[ml.e] = false;
+    verts.push_back(ml.v);
+  }
+  for (const int i : IndexRange(mesh->totedge)) {
+    if (edge_is_loose[i]) {
+      verts.push_back(mesh->medge[i].v1);
+      verts.push_back(mesh->medge[i].v2);
+    }
+  }
+
+  Array<int> vert_first_incidence(mesh->totvert, -1);
+  std::vector<int> incidences;
+  for (const int i : IndexRange(verts.size())) {
+    int &first_incidence = vert_first_incidence[verts[i]];
+    if (first_incidence == -1) {
+      first_incidence = i;
+    }
+    incidences.push_back(first_incidence);
+  }
+  return incidences;
+}
+
+/**
+ * Split with #BKE_mesh_edge_split and with BMesh, both must separate the same corners and loose
+ * edges into the same vertices.
+ */
+static void test_edge_split(const Mesh *mesh,
+                            const bool use_edge_angle,
+                            const float split_angle,
+                            const bool use_edge_sharp)
+{
+  Mesh *result = BKE_mesh_edge_split(mesh, use_edge_angle, split_angle, use_edge_sharp);
+  Mesh *expected = edge_split_bmesh(mesh, use_edge_angle, split_angle, use_edge_sharp);
+
+  EXPECT_EQ(result->totvert, expected->totvert);
+  EXPECT_EQ(result->totedge, expected->totedge);
+  EXPECT_EQ(result->totpoly, expected->totpoly);
+  EXPECT_EQ(result->totloop, expected->totloop);
+  EXPECT_EQ(vert_incidences(result), vert_incidences(expected));
+  EXPECT_FALSE(BKE_mesh_validate(result, false, false));
+
+  BKE_id_free(nullptr, result);
+  BKE_id_free(nullptr, expected);
+}
+
+TEST(mesh_edge_split, sharp)
+{
+  BKE_idtype_init();
+  Mesh *mesh = create_mesh(grid_positions(0.0f), grid_polys, {}, {{1, 4}, {4, 7}, {0, 1}});
+  test_edge_split(mesh, false, 0.0f, true);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST(mesh_edge_split, sharp_ends_inside)
+{
+  BKE_idtype_init();
+  /* Vertex 4 has a single fan, it is not separated. */
+  Mesh *mesh = create_mesh(grid_positions(0.0f), grid_polys, {}, {{1, 4}});
+  test_edge_split(mesh, false, 0.0f, true);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST(mesh_edge_split, angle)
+{
+  BKE_idtype_init();
+  Mesh *mesh = create_mesh(grid_positions(0.5f), grid_polys, {}, {});
+  test_edge_split(mesh, true, DEG2RADF(30.0f), false);
+  test_edge_split(mesh, true, DEG2RADF(60.0f), false);
+  test_edge_split(mesh, true, 0.0f, false);
+  test_edge_split(mesh, true, (float)M_PI, false);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST(mesh_edge_split, angle_non_manifold)
+{
+  BKE_idtype_init();
+  /* Three faces on edge 1-4 are always split. */
+  Vector<float3> positions = grid_positions(0.0f);
+  positions.append({1.0f, 0.5f, 1.0f});
+  Vector<Vector<int>> polys = grid_polys;
+  polys.append({1, 4, 9});
+  Mesh *mesh = create_mesh(positions, polys, {}, {});
+  test_edge_split(mesh, true, DEG2RADF(60.0f), false);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST(mesh_edge_split, loose_edges)
+{
+  BKE_idtype_init();
+  /* Loose edges at split vertex 4 get vertices of their own, the one at vertex 0 which isn't
+   * split keeps using it. */
+  Vector<float3> positions = grid_positions(0.0f);
+  positions.append({1.0f, 1.0f, 1.0f});
+  positions.append({1.5f, 1.0f, 1.0f});
+  positions.append({-1.0f, 0.0f, 0.0f});
+  Mesh *mesh = create_mesh(positions,
+                           grid_polys,
+                           {{4, 9}, {10, 4}, {9, 10}, {0, 11}},
+                           {{1, 4}, {4, 7}});
+  test_edge_split(mesh, false, 0.0f, true);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST(mesh_edge_split, loose_edges_angle)
+{
+  BKE_idtype_init();
+  Vector<float3> positions = grid_positions(0.5f);
+  positions.append({1.0f, 1.0f, 2.0f});
+  Mesh *mesh = create_mesh(positions, grid_polys, {{4, 9}, {1, 9}}, {});
+  test_edge_split(mesh, true, DEG2RADF(30.0f), false);
+  BKE_id_free(nullptr, mesh);
+}
+
+}  // namespace blender::bke::tests
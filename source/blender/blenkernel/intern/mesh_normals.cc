@@ -31,11 +31,14 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
 
 #include "BLI_alloca.h"
 #include "BLI_bitmap.h"
+#include "BLI_hash_mm2a.h"
 
 #include "BLI_linklist.h"
 #include "BLI_linklist_stack.h"
@@ -43,6 +46,7 @@
 #include "BLI_memarena.h"
 #include "BLI_stack.h"
 #include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_customdata.h"
@@ -845,113 +849,175 @@ struct LoopSplitTaskDataCommon {
 /* See comment about edge_to_loops below. */
 #define IS_EDGE_SHARP(_e2l) (ELEM((_e2l)[1], INDEX_UNSET, INDEX_INVALID))
 
-static void mesh_edges_sharp_tag(LoopSplitTaskDataCommon *data,
-                                 const bool check_angle,
-                                 const float split_angle,
-                                 const bool do_sharp_edges_tag)
+/**
+ * Lower the value at \a p to \a value if it is greater, return the previous value.
+ */
+BLI_INLINE int loop_index_fetch_and_min(int *p, const int value)
 {
-  const MVert *mverts = data->mverts;
-  const MEdge *medges = data->medges;
-  const MLoop *mloops = data->mloops;
+  int prev = *p;
+  while (value < prev) {
+    const int orig = atomic_cas_int32(p, prev, value);
+    if (orig == prev) {
+      break;
+    }
+    prev = orig;
+  }
+  return prev;
+}
 
-  const MPoly *mpolys = data->mpolys;
+struct MeshEdgesSharpTagData {
+  LoopSplitTaskDataCommon *common_data;
+  /** Number of loops using each edge, only the two lowest are stored in edge_to_loops. */
+  int *edge_users;
+  float split_angle_cos;
+  bool check_angle;
+  bool do_sharp_edges_tag;
+};
 
-  const int numEdges = data->numEdges;
-  const int numPolys = data->numPolys;
+static void mesh_edges_sharp_tag_init_cb(void *__restrict userdata,
+                                         const int me_index,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  MeshEdgesSharpTagData *data = (MeshEdgesSharpTagData *)userdata;
+  int *e2l = data->common_data->edge_to_loops[me_index];
+  e2l[0] = e2l[1] = INT_MAX;
+}
 
-  float(*loopnors)[3] = data->loopnors; /* NOTE: loopnors may be nullptr here. */
-  const float(*polynors)[3] = data->polynors;
+static void mesh_edges_sharp_tag_poly_cb(void *__restrict userdata,
+                                         const int mp_index,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  MeshEdgesSharpTagData *data = (MeshEdgesSharpTagData *)userdata;
+  LoopSplitTaskDataCommon *common_data = data->common_data;
 
-  int(*edge_to_loops)[2] = data->edge_to_loops;
-  int *loop_to_poly = data->loop_to_poly;
+  const MVert *mverts = common_data->mverts;
+  const MLoop *mloops = common_data->mloops;
+  const MPoly *mp = &common_data->mpolys[mp_index];
 
-  BLI_bitmap *sharp_edges = do_sharp_edges_tag ? BLI_BITMAP_NEW(numEdges, __func__) : nullptr;
+  float(*loopnors)[3] = common_data->loopnors; /* NOTE: loopnors may be nullptr here. */
+  int(*edge_to_loops)[2] = common_data->edge_to_loops;
+  int *loop_to_poly = common_data->loop_to_poly;
 
-  const MPoly *mp;
-  int mp_index;
+  const int ml_last_index = (mp->loopstart + mp->totloop) - 1;
+  for (int ml_curr_index = mp->loopstart; ml_curr_index <= ml_last_index; ml_curr_index++) {
+    const MLoop *ml_curr = &mloops[ml_curr_index];
 
-  const float split_angle_cos = check_angle ? cosf(split_angle) : -1.0f;
+    loop_to_poly[ml_curr_index] = mp_index;
 
-  for (mp = mpolys, mp_index = 0; mp_index < numPolys; mp++, mp_index++) {
-    const MLoop *ml_curr;
-    int *e2l;
-    int ml_curr_index = mp->loopstart;
-    const int ml_last_index = (ml_curr_index + mp->totloop) - 1;
+    /* Pre-populate all loop normals as if their verts were all-smooth,
+     * this way we don't have to compute those later!
+     */
+    if (loopnors) {
+      normal_short_to_float_v3(loopnors[ml_curr_index], mverts[ml_curr->v].no);
+    }
 
-    ml_curr = &mloops[ml_curr_index];
+    /* Keep the two lowest loops of the edge, the order in which they are found when walking
+     * over polygons defines the sharpness of the edge. A loop replaced by a lower one in the
+     * first slot becomes a candidate for the second slot. */
+    atomic_fetch_and_add_int32(&data->edge_users[ml_curr->e], 1);
+    int *e2l = edge_to_loops[ml_curr->e];
+    const int ml_replaced_index = loop_index_fetch_and_min(&e2l[0], ml_curr_index);
+    loop_index_fetch_and_min(&e2l[1], max_ii(ml_replaced_index, ml_curr_index));
+  }
+}
 
-    for (; ml_curr_index <= ml_last_index; ml_curr++, ml_curr_index++) {
-      e2l = edge_to_loops[ml_curr->e];
+static void mesh_edges_sharp_tag_edge_cb(void *__restrict userdata,
+                                         const int me_index,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  MeshEdgesSharpTagData *data = (MeshEdgesSharpTagData *)userdata;
+  LoopSplitTaskDataCommon *common_data = data->common_data;
 
-      loop_to_poly[ml_curr_index] = mp_index;
+  MEdge *me = (MEdge *)&common_data->medges[me_index];
+  const MLoop *mloops = common_data->mloops;
+  const MPoly *mpolys = common_data->mpolys;
+  const float(*polynors)[3] = common_data->polynors;
+  const int *loop_to_poly = common_data->loop_to_poly;
 
-      /* Pre-populate all loop normals as if their verts were all-smooth,
-       * this way we don't have to compute those later!
-       */
-      if (loopnors) {
-        normal_short_to_float_v3(loopnors[ml_curr_index], mverts[ml_curr->v].no);
-      }
+  const int edge_users = data->edge_users[me_index];
+  int *e2l = common_data->edge_to_loops[me_index];
 
-      /* Check whether current edge might be smooth or sharp */
-      if ((e2l[0] | e2l[1]) == 0) {
-        /* 'Empty' edge until now, set e2l[0] (and e2l[1] to INDEX_UNSET to tag it as unset). */
-        e2l[0] = ml_curr_index;
-        /* We have to check this here too, else we might miss some flat faces!!! */
-        e2l[1] = (mp->flag & ME_SMOOTH) ? INDEX_UNSET : INDEX_INVALID;
-      }
-      else if (e2l[1] == INDEX_UNSET) {
-        const bool is_angle_sharp = (check_angle &&
-                                     dot_v3v3(polynors[loop_to_poly[e2l[0]]], polynors[mp_index]) <
-                                         split_angle_cos);
-
-        /* Second loop using this edge, time to test its sharpness.
-         * An edge is sharp if it is tagged as such, or its face is not smooth,
-         * or both poly have opposed (flipped) normals, i.e. both loops on the same edge share the
-         * same vertex, or angle between both its polys' normals is above split_angle value.
-         */
-        if (!(mp->flag & ME_SMOOTH) || (medges[ml_curr->e].flag & ME_SHARP) ||
-            ml_curr->v == mloops[e2l[0]].v || is_angle_sharp) {
-          /* NOTE: we are sure that loop != 0 here ;). */
-          e2l[1] = INDEX_INVALID;
-
-          /* We want to avoid tagging edges as sharp when it is already defined as such by
-           * other causes than angle threshold... */
-          if (do_sharp_edges_tag && is_angle_sharp) {
-            BLI_BITMAP_SET(sharp_edges, ml_curr->e, true);
-          }
-        }
-        else {
-          e2l[1] = ml_curr_index;
-        }
-      }
-      else if (!IS_EDGE_SHARP(e2l)) {
-        /* More than two loops using this edge, tag as sharp if not yet done. */
-        e2l[1] = INDEX_INVALID;
-
-        /* We want to avoid tagging edges as sharp when it is already defined as such by
-         * other causes than angle threshold... */
-        if (do_sharp_edges_tag) {
-          BLI_BITMAP_SET(sharp_edges, ml_curr->e, false);
-        }
-      }
-      /* Else, edge is already 'disqualified' (i.e. sharp)! */
-    }
+  if (edge_users == 0) {
+    /* Loose edge, set both values to 0. */
+    e2l[0] = e2l[1] = 0;
+    return;
   }
 
-  /* If requested, do actual tagging of edges as sharp in another loop. */
-  if (do_sharp_edges_tag) {
-    MEdge *me;
-    int me_index;
-    for (me = (MEdge *)medges, me_index = 0; me_index < numEdges; me++, me_index++) {
-      if (BLI_BITMAP_TEST(sharp_edges, me_index)) {
-        me->flag |= ME_SHARP;
-      }
-    }
+  if (edge_users == 1) {
+    /* Boundary edge, #INDEX_UNSET tags it as smooth so far, it is sharp in any case. */
+    e2l[1] = (mpolys[loop_to_poly[e2l[0]]].flag & ME_SMOOTH) ? INDEX_UNSET : INDEX_INVALID;
+    return;
+  }
 
-    MEM_freeN(sharp_edges);
+  if (!(mpolys[loop_to_poly[e2l[0]]].flag & ME_SMOOTH)) {
+    /* Flat first face, tag as sharp. */
+    e2l[1] = INDEX_INVALID;
+    return;
+  }
+
+  const int mp_index = loop_to_poly[e2l[1]];
+  const MPoly *mp = &mpolys[mp_index];
+  const bool is_angle_sharp = (data->check_angle &&
+                               dot_v3v3(polynors[loop_to_poly[e2l[0]]], polynors[mp_index]) <
+                                   data->split_angle_cos);
+
+  /* Second loop using this edge, time to test its sharpness.
+   * An edge is sharp if it is tagged as such, or its face is not smooth,
+   * or both poly have opposed (flipped) normals, i.e. both loops on the same edge share the
+   * same vertex, or angle between both its polys' normals is above split_angle value.
+   */
+  if (!(mp->flag & ME_SMOOTH) || (me->flag & ME_SHARP) ||
+      mloops[e2l[1]].v == mloops[e2l[0]].v || is_angle_sharp) {
+    e2l[1] = INDEX_INVALID;
+
+    /* We want to avoid tagging edges as sharp when it is already defined as such by
+     * other causes than angle threshold... */
+    if (data->do_sharp_edges_tag && is_angle_sharp) {
+      me->flag |= ME_SHARP;
+    }
+  }
+  else if (edge_users > 2) {
+    /* More than two loops using this edge, tag as sharp. Only the angle between the first two
+     * faces tags the edge itself, like for manifold edges. */
+    e2l[1] = INDEX_INVALID;
   }
 }
 
+/**
+ * Fill the edge to loops and loop to polygon mappings, and find which edges are sharp.
+ *
+ * Each edge only gets its two lowest loops, so this is done in threaded passes:
+ * after resetting the edge to loops mapping, the first one over polygons gathers the loops of
+ * each edge,
+ * the second one over edges decides of their sharpness.
+ */
+static void mesh_edges_sharp_tag(LoopSplitTaskDataCommon *data,
+                                 const bool check_angle,
+                                 const float split_angle,
+                                 const bool do_sharp_edges_tag)
+{
+  const int numEdges = data->numEdges;
+  const int numPolys = data->numPolys;
+
+  MeshEdgesSharpTagData tag_data;
+  tag_data.common_data = data;
+  tag_data.edge_users = (int *)MEM_calloc_arrayN(
+      (size_t)numEdges, sizeof(*tag_data.edge_users), __func__);
+  tag_data.split_angle_cos = check_angle ? cosf(split_angle) : -1.0f;
+  tag_data.check_angle = check_angle;
+  tag_data.do_sharp_edges_tag = do_sharp_edges_tag;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+
+  BLI_task_parallel_range(0, numEdges, &tag_data, mesh_edges_sharp_tag_init_cb, &settings);
+  BLI_task_parallel_range(0, numPolys, &tag_data, mesh_edges_sharp_tag_poly_cb, &settings);
+  BLI_task_parallel_range(0, numEdges, &tag_data, mesh_edges_sharp_tag_edge_cb, &settings);
+
+  MEM_freeN(tag_data.edge_users);
+}
+
 /**
  * Define sharp edges as needed to mimic 'autosmooth' from angle threshold.
  *
@@ -982,6 +1048,7 @@ void BKE_edges_sharp_from_angle_set(const struct MVert *mverts,
   int *loop_to_poly = (int *)MEM_malloc_arrayN((size_t)numLoops, sizeof(*loop_to_poly), __func__);
 
   LoopSplitTaskDataCommon common_data;
+  common_data.loopnors = nullptr;
   common_data.mverts = mverts;
   common_data.medges = medges;
   common_data.mloops = mloops;
@@ -1337,54 +1404,62 @@ static void loop_split_worker_do(LoopSplitTaskDataCommon *common_data,
   }
 }
 
-static void loop_split_worker(TaskPool *__restrict pool, void *taskdata)
-{
-  LoopSplitTaskDataCommon *common_data = (LoopSplitTaskDataCommon *)BLI_task_pool_user_data(pool);
-  LoopSplitTaskData *data = (LoopSplitTaskData *)taskdata;
-
-  /* Temp edge vectors stack, only used when computing lnor spacearr. */
-  BLI_Stack *edge_vectors = common_data->lnors_spacearr ?
-                                BLI_stack_new(sizeof(float[3]), __func__) :
-                                nullptr;
+struct LoopSplitWorkerTLS {
+  /** Temp edge vectors stack, only used when computing lnor spacearr. */
+  BLI_Stack *edge_vectors;
+};
 
-#ifdef DEBUG_TIME
-  TIMEIT_START_AVERAGED(loop_split_worker);
-#endif
+struct LoopSplitWorkerData {
+  LoopSplitTaskDataCommon *common_data;
+  LoopSplitTaskData *tasks;
+};
 
-  for (int i = 0; i < LOOP_SPLIT_TASK_BLOCK_SIZE; i++, data++) {
-    /* A nullptr ml_curr is used to tag ended data! */
-    if (data->ml_curr == nullptr) {
-      break;
-    }
+static void loop_split_worker(void *__restrict userdata,
+                              const int task_index,
+                              const TaskParallelTLS *__restrict tls)
+{
+  LoopSplitWorkerData *data = (LoopSplitWorkerData *)userdata;
+  LoopSplitWorkerTLS *tls_data = (LoopSplitWorkerTLS *)tls->userdata_chunk;
 
-    loop_split_worker_do(common_data, data, edge_vectors);
+  if (data->common_data->lnors_spacearr && tls_data->edge_vectors == nullptr) {
+    tls_data->edge_vectors = BLI_stack_new(sizeof(float[3]), __func__);
   }
 
-  if (edge_vectors) {
-    BLI_stack_free(edge_vectors);
-  }
+  loop_split_worker_do(data->common_data, &data->tasks[task_index], tls_data->edge_vectors);
+}
 
-#ifdef DEBUG_TIME
-  TIMEIT_END_AVERAGED(loop_split_worker);
-#endif
+static void loop_split_worker_free(const void *__restrict UNUSED(userdata),
+                                   void *__restrict tls_v)
+{
+  LoopSplitWorkerTLS *tls_data = (LoopSplitWorkerTLS *)tls_v;
+  if (tls_data->edge_vectors) {
+    BLI_stack_free(tls_data->edge_vectors);
+  }
 }
 
 /**
- * Check whether given loop is part of an unknown-so-far cyclic smooth fan, or not.
+ * Walk the smooth fan of given loop, and return its entry point if it is a cyclic smooth fan,
+ * or -1 otherwise (also when the fan is walked from another loop).
  * Needed because cyclic smooth fans have no obvious 'entry point',
  * and yet we need to walk them once, and only once.
+ *
+ * The loop of lowest index is used as entry point, so that the result doesn't depend on which
+ * loop of the fan is walked first. \a loop_walk stores the lowest loop a walk reaching each loop
+ * started from: walks stop when reaching a loop claimed by a lower one, which keeps walking.
+ * This way loops are only walked about once, even when several threads walk the same fan.
  */
-static bool loop_split_generator_check_cyclic_smooth_fan(const MLoop *mloops,
-                                                         const MPoly *mpolys,
-                                                         const int (*edge_to_loops)[2],
-                                                         const int *loop_to_poly,
-                                                         const int *e2l_prev,
-                                                         BLI_bitmap *skip_loops,
-                                                         const MLoop *ml_curr,
-                                                         const MLoop *ml_prev,
-                                                         const int ml_curr_index,
-                                                         const int ml_prev_index,
-                                                         const int mp_curr_index)
+static int loop_split_generator_cyclic_smooth_fan_start(const MLoop *mloops,
+                                                        const MPoly *mpolys,
+                                                        const int (*edge_to_loops)[2],
+                                                        const int *loop_to_poly,
+                                                        const int *e2l_prev,
+                                                        int *loop_walk,
+                                                        const MLoop *ml_curr,
+                                                        const MLoop *ml_prev,
+                                                        const int ml_curr_index,
+                                                        const int ml_prev_index,
+                                                        const int mp_curr_index,
+                                                        const int numLoops)
 {
   const uint mv_pivot_index = ml_curr->v; /* The vertex we are "fanning" around! */
   const int *e2lfan_curr;
@@ -1395,7 +1470,7 @@ static bool loop_split_generator_check_cyclic_smooth_fan(const MLoop *mloops,
   e2lfan_curr = e2l_prev;
   if (IS_EDGE_SHARP(e2lfan_curr)) {
     /* Sharp loop, so not a cyclic smooth fan... */
-    return false;
+    return -1;
   }
 
   mlfan_curr = ml_prev;
@@ -1407,10 +1482,11 @@ static bool loop_split_generator_check_cyclic_smooth_fan(const MLoop *mloops,
   BLI_assert(mlfan_vert_index >= 0);
   BLI_assert(mpfan_curr_index >= 0);
 
-  BLI_assert(!BLI_BITMAP_TEST(skip_loops, mlfan_vert_index));
-  BLI_BITMAP_ENABLE(skip_loops, mlfan_vert_index);
+  int fan_start_index = ml_curr_index;
 
-  while (true) {
+  /* A fan can not have more loops than the mesh, this only guards against endless walks on
+   * degenerate topology. */
+  for (int fan_len = 0; fan_len < numLoops; fan_len++) {
     /* Find next loop of the smooth fan. */
     BKE_mesh_loop_manifold_fan_around_vert_next(mloops,
                                                 mpolys,
@@ -1426,132 +1502,155 @@ static bool loop_split_generator_check_cyclic_smooth_fan(const MLoop *mloops,
 
     if (IS_EDGE_SHARP(e2lfan_curr)) {
       /* Sharp loop/edge, so not a cyclic smooth fan... */
-      return false;
+      return -1;
     }
     /* Smooth loop/edge... */
-    if (BLI_BITMAP_TEST(skip_loops, mlfan_vert_index)) {
-      if (mlfan_vert_index == ml_curr_index) {
-        /* We walked around a whole cyclic smooth fan without finding any already-processed loop,
-         * means we can use initial ml_curr/ml_prev edge as start for this smooth fan. */
-        return true;
-      }
-      /* ... already checked in some previous looping, we can abort. */
-      return false;
+    if (mlfan_vert_index == ml_curr_index) {
+      /* We walked around a whole cyclic smooth fan. */
+      return fan_start_index;
     }
 
-    /* ... we can skip it in future, and keep checking the smooth fan. */
-    BLI_BITMAP_ENABLE(skip_loops, mlfan_vert_index);
+    if (loop_index_fetch_and_min(&loop_walk[mlfan_vert_index], ml_curr_index) < ml_curr_index) {
+      /* ... the fan is walked from a lower loop. */
+      return -1;
+    }
+    fan_start_index = min_ii(fan_start_index, mlfan_vert_index);
   }
+  return -1;
 }
 
-static void loop_split_generator(TaskPool *pool, LoopSplitTaskDataCommon *common_data)
+struct LoopSplitGeneratorData {
+  LoopSplitTaskDataCommon *common_data;
+  /** Whether each loop starts a single loop or fan task. */
+  bool *loop_is_task;
+  /** Lowest loop each loop was reached from, see #loop_split_generator_cyclic_smooth_fan_start. */
+  int *loop_walk;
+};
+
+static void loop_split_generator_poly_cb(void *__restrict userdata,
+                                         const int mp_index,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
 {
-  MLoopNorSpaceArray *lnors_spacearr = common_data->lnors_spacearr;
-  float(*loopnors)[3] = common_data->loopnors;
+  LoopSplitGeneratorData *data = (LoopSplitGeneratorData *)userdata;
+  LoopSplitTaskDataCommon *common_data = data->common_data;
 
   const MLoop *mloops = common_data->mloops;
   const MPoly *mpolys = common_data->mpolys;
   const int *loop_to_poly = common_data->loop_to_poly;
   const int(*edge_to_loops)[2] = common_data->edge_to_loops;
-  const int numLoops = common_data->numLoops;
-  const int numPolys = common_data->numPolys;
 
-  const MPoly *mp;
-  int mp_index;
+  const MPoly *mp = &mpolys[mp_index];
+  const int ml_last_index = (mp->loopstart + mp->totloop) - 1;
+  int ml_prev_index = ml_last_index;
 
-  const MLoop *ml_curr;
-  const MLoop *ml_prev;
-  int ml_curr_index;
-  int ml_prev_index;
+  for (int ml_curr_index = mp->loopstart; ml_curr_index <= ml_last_index; ml_curr_index++) {
+    const MLoop *ml_curr = &mloops[ml_curr_index];
+    const MLoop *ml_prev = &mloops[ml_prev_index];
+    const int *e2l_curr = edge_to_loops[ml_curr->e];
+    const int *e2l_prev = edge_to_loops[ml_prev->e];
 
-  BLI_bitmap *skip_loops = BLI_BITMAP_NEW(numLoops, __func__);
+    if (IS_EDGE_SHARP(e2l_curr)) {
+      data->loop_is_task[ml_curr_index] = true;
+    }
+    /* A smooth edge, we have to check for cyclic smooth fan case.
+     * Loops reached by the walk of another loop belong to the same fan, no need to walk it. */
+    else if (atomic_cas_int32(&data->loop_walk[ml_curr_index], INT_MAX, ml_curr_index) ==
+             INT_MAX) {
+      /* NOTE: In theory, we could make #loop_split_generator_cyclic_smooth_fan_start() store
+       * mlfan_vert_index'es and edge indexes in two stacks, to avoid having to fan again around
+       * the vert during actual computation of `clnor` & `clnorspace`.
+       * However, this would complicate the code, add more memory usage, and despite its logical
+       * complexity, #loop_manifold_fan_around_vert_next() is quite cheap in term of CPU cycles,
+       * so really think it's not worth it. */
+      const int fan_start_index = loop_split_generator_cyclic_smooth_fan_start(
+          mloops,
+          mpolys,
+          edge_to_loops,
+          loop_to_poly,
+          e2l_prev,
+          data->loop_walk,
+          ml_curr,
+          ml_prev,
+          ml_curr_index,
+          ml_prev_index,
+          mp_index,
+          common_data->numLoops);
+      if (fan_start_index != -1) {
+        /* Loops of a cyclic fan all use smooth edges, this is never written for sharp ones. */
+        data->loop_is_task[fan_start_index] = true;
+      }
+    }
 
-  LoopSplitTaskData *data_buff = nullptr;
-  int data_idx = 0;
+    ml_prev_index = ml_curr_index;
+  }
+}
 
-  /* Temp edge vectors stack, only used when computing lnor spacearr
-   * (and we are not multi-threading). */
-  BLI_Stack *edge_vectors = nullptr;
+/**
+ * Find all smooth fans and single loops, and compute their normals.
+ *
+ * Fans are found by a threaded pass over polygons, then their tasks are created in loop order,
+ * since #BKE_lnor_space_create is not thread-safe, and finally all tasks are run in parallel.
+ */
+static void loop_split_generator(LoopSplitTaskDataCommon *common_data)
+{
+  MLoopNorSpaceArray *lnors_spacearr = common_data->lnors_spacearr;
+  float(*loopnors)[3] = common_data->loopnors;
+
+  const MLoop *mloops = common_data->mloops;
+  const MPoly *mpolys = common_data->mpolys;
+  const int(*edge_to_loops)[2] = common_data->edge_to_loops;
+  const int numLoops = common_data->numLoops;
+  const int numPolys = common_data->numPolys;
 
 #ifdef DEBUG_TIME
   TIMEIT_START_AVERAGED(loop_split_generator);
 #endif
 
-  if (!pool) {
-    if (lnors_spacearr) {
-      edge_vectors = BLI_stack_new(sizeof(float[3]), __func__);
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = LOOP_SPLIT_TASK_BLOCK_SIZE;
+  /* Not enough loops to be worth the whole threading overhead... */
+  settings.use_threading = (numLoops >= LOOP_SPLIT_TASK_BLOCK_SIZE * 8);
+
+  LoopSplitGeneratorData generator_data;
+  generator_data.common_data = common_data;
+  generator_data.loop_is_task = (bool *)MEM_calloc_arrayN(
+      (size_t)numLoops, sizeof(*generator_data.loop_is_task), __func__);
+  generator_data.loop_walk = (int *)MEM_malloc_arrayN(
+      (size_t)numLoops, sizeof(*generator_data.loop_walk), __func__);
+  copy_vn_i(generator_data.loop_walk, numLoops, INT_MAX);
+
+  BLI_task_parallel_range(0, numPolys, &generator_data, loop_split_generator_poly_cb, &settings);
+
+  int tasks_len = 0;
+  for (int ml_index = 0; ml_index < numLoops; ml_index++) {
+    if (generator_data.loop_is_task[ml_index]) {
+      tasks_len++;
     }
   }
 
+  LoopSplitTaskData *tasks = (LoopSplitTaskData *)MEM_calloc_arrayN(
+      (size_t)max_ii(tasks_len, 1), sizeof(*tasks), __func__);
+  LoopSplitTaskData *data = tasks;
+
   /* We now know edges that can be smoothed (with their vector, and their two loops),
    * and edges that will be hard! Now, time to generate the normals.
    */
-  for (mp = mpolys, mp_index = 0; mp_index < numPolys; mp++, mp_index++) {
-    float(*lnors)[3];
+  for (int mp_index = 0; mp_index < numPolys; mp_index++) {
+    const MPoly *mp = &mpolys[mp_index];
     const int ml_last_index = (mp->loopstart + mp->totloop) - 1;
-    ml_curr_index = mp->loopstart;
-    ml_prev_index = ml_last_index;
+    int ml_prev_index = ml_last_index;
 
-    ml_curr = &mloops[ml_curr_index];
-    ml_prev = &mloops[ml_prev_index];
-    lnors = &loopnors[ml_curr_index];
+    for (int ml_curr_index = mp->loopstart; ml_curr_index <= ml_last_index; ml_curr_index++) {
+      const MLoop *ml_curr = &mloops[ml_curr_index];
+      const MLoop *ml_prev = &mloops[ml_prev_index];
 
-    for (; ml_curr_index <= ml_last_index; ml_curr++, ml_curr_index++, lnors++) {
-      const int *e2l_curr = edge_to_loops[ml_curr->e];
-      const int *e2l_prev = edge_to_loops[ml_prev->e];
-
-#if 0
-      printf("Checking loop %d / edge %u / vert %u (sharp edge: %d, skiploop: %d)...",
-             ml_curr_index,
-             ml_curr->e,
-             ml_curr->v,
-             IS_EDGE_SHARP(e2l_curr),
-             BLI_BITMAP_TEST_BOOL(skip_loops, ml_curr_index));
-#endif
-
-      /* A smooth edge, we have to check for cyclic smooth fan case.
-       * If we find a new, never-processed cyclic smooth fan, we can do it now using that loop/edge
-       * as 'entry point', otherwise we can skip it. */
-
-      /* NOTE: In theory, we could make #loop_split_generator_check_cyclic_smooth_fan() store
-       * mlfan_vert_index'es and edge indexes in two stacks, to avoid having to fan again around
-       * the vert during actual computation of `clnor` & `clnorspace`.
-       * However, this would complicate the code, add more memory usage, and despite its logical
-       * complexity, #loop_manifold_fan_around_vert_next() is quite cheap in term of CPU cycles,
-       * so really think it's not worth it. */
-      if (!IS_EDGE_SHARP(e2l_curr) && (BLI_BITMAP_TEST(skip_loops, ml_curr_index) ||
-                                       !loop_split_generator_check_cyclic_smooth_fan(mloops,
-                                                                                     mpolys,
-                                                                                     edge_to_loops,
-                                                                                     loop_to_poly,
-                                                                                     e2l_prev,
-                                                                                     skip_loops,
-                                                                                     ml_curr,
-                                                                                     ml_prev,
-                                                                                     ml_curr_index,
-                                                                                     ml_prev_index,
-                                                                                     mp_index))) {
-        //              printf("SKIPPING!\n");
-      }
-      else {
-        LoopSplitTaskData *data, data_local;
-
-        //              printf("PROCESSING!\n");
-
-        if (pool) {
-          if (data_idx == 0) {
-            data_buff = (LoopSplitTaskData *)MEM_calloc_arrayN(
-                LOOP_SPLIT_TASK_BLOCK_SIZE, sizeof(*data_buff), __func__);
-          }
-          data = &data_buff[data_idx];
-        }
-        else {
-          data = &data_local;
-          memset(data, 0, sizeof(*data));
-        }
+      if (generator_data.loop_is_task[ml_curr_index]) {
+        const int *e2l_curr = edge_to_loops[ml_curr->e];
+        const int *e2l_prev = edge_to_loops[ml_prev->e];
 
         if (IS_EDGE_SHARP(e2l_curr) && IS_EDGE_SHARP(e2l_prev)) {
-          data->lnor = lnors;
+          data->lnor = &loopnors[ml_curr_index];
           data->ml_curr = ml_curr;
           data->ml_prev = ml_prev;
           data->ml_curr_index = ml_curr_index;
@@ -1575,7 +1674,7 @@ static void loop_split_generator(TaskPool *pool, LoopSplitTaskDataCommon *common
          */
         else {
 #if 0 /* Not needed for 'fan' loops. */
-          data->lnor = lnors;
+          data->lnor = &loopnors[ml_curr_index];
 #endif
           data->ml_curr = ml_curr;
           data->ml_prev = ml_prev;
@@ -1587,34 +1686,30 @@ static void loop_split_generator(TaskPool *pool, LoopSplitTaskDataCommon *common
             data->lnor_space = BKE_lnor_space_create(lnors_spacearr);
           }
         }
-
-        if (pool) {
-          data_idx++;
-          if (data_idx == LOOP_SPLIT_TASK_BLOCK_SIZE) {
-            BLI_task_pool_push(pool, loop_split_worker, data_buff, true, nullptr);
-            data_idx = 0;
-          }
-        }
-        else {
-          loop_split_worker_do(common_data, data, edge_vectors);
-        }
+        data++;
       }
 
-      ml_prev = ml_curr;
       ml_prev_index = ml_curr_index;
     }
   }
+  BLI_assert(data - tasks == tasks_len);
 
-  /* Last block of data... Since it is calloc'ed and we use first nullptr item as stopper,
-   * everything is fine. */
-  if (pool && data_idx) {
-    BLI_task_pool_push(pool, loop_split_worker, data_buff, true, nullptr);
-  }
+  MEM_freeN(generator_data.loop_is_task);
+  MEM_freeN(generator_data.loop_walk);
 
-  if (edge_vectors) {
-    BLI_stack_free(edge_vectors);
-  }
-  MEM_freeN(skip_loops);
+  LoopSplitWorkerData worker_data;
+  worker_data.common_data = common_data;
+  worker_data.tasks = tasks;
+
+  LoopSplitWorkerTLS tls_data = {nullptr};
+  settings.userdata_chunk = &tls_data;
+  settings.userdata_chunk_size = sizeof(tls_data);
+  settings.func_free = loop_split_worker_free;
+  settings.min_iter_per_thread = LOOP_SPLIT_TASK_BLOCK_SIZE / 8;
+
+  BLI_task_parallel_range(0, tasks_len, &worker_data, loop_split_worker, &settings);
+
+  MEM_freeN(tasks);
 
 #ifdef DEBUG_TIME
   TIMEIT_END_AVERAGED(loop_split_generator);
@@ -1735,19 +1830,7 @@ void BKE_mesh_normals_loop_split(const MVert *mverts,
   /* This first loop check which edges are actually smooth, and compute edge vectors. */
   mesh_edges_sharp_tag(&common_data, check_angle, split_angle, false);
 
-  if (numLoops < LOOP_SPLIT_TASK_BLOCK_SIZE * 8) {
-    /* Not enough loops to be worth the whole threading overhead... */
-    loop_split_generator(nullptr, &common_data);
-  }
-  else {
-    TaskPool *task_pool = BLI_task_pool_create(&common_data, TASK_PRIORITY_HIGH);
-
-    loop_split_generator(task_pool, &common_data);
-
-    BLI_task_pool_work_and_wait(task_pool);
-
-    BLI_task_pool_free(task_pool);
-  }
+  loop_split_generator(&common_data);
 
   MEM_freeN(edge_to_loops);
   if (!r_loop_to_poly) {
@@ -2177,3 +2260,257 @@ void BKE_mesh_normals_loop_to_vertex(const int numVerts,
 #undef LNOR_SPACE_TRIGO_THRESHOLD
 
 /** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Mesh Split Normals Cache
+ *
+ * Split normals of a mesh are computed again every time its draw cache is rebuilt or they are
+ * requested by a modifier, even when nothing they depend on changed.
+ * The last computed normals are kept in the mesh runtime data, keyed on hashes of all the data
+ * they depend on: hashing is a lot cheaper than finding and computing the smooth fans.
+ * \{ */
+
+/** Number of elements hashed together, the hashes of those blocks are then hashed again. */
+#define LOOP_NORMALS_CACHE_HASH_BLOCK_SIZE 4096
+
+/** Only held while reading or writing a cache, the normals are computed without it. */
+static ThreadMutex loop_normals_cache_mutex = BLI_MUTEX_INITIALIZER;
+
+struct MeshLoopNormalsCacheKey {
+  int numVerts;
+  int numEdges;
+  int numLoops;
+  int numPolys;
+  /* Hashes of the data are kept separate, so that a change of positions would need a collision
+   * of both the vertex and the polygon normals hashes to go unnoticed. */
+  uint vert_hash;
+  uint edge_hash;
+  uint loop_hash;
+  uint poly_hash;
+  uint polynors_hash;
+  uint clnors_hash;
+  int use_split_normals;
+  float split_angle;
+};
+
+struct MeshLoopNormalsCache {
+  MeshLoopNormalsCacheKey key;
+  float (*loopnors)[3];
+};
+
+using MeshLoopNormalsCacheHashFn = void (*)(BLI_HashMurmur2A *mm2, const void *elems, int index);
+
+static void loop_normals_cache_hash_vert(BLI_HashMurmur2A *mm2, const void *elems, const int index)
+{
+  /* Selection and other flags do not affect normals. */
+  const MVert *mv = &((const MVert *)elems)[index];
+  BLI_hash_mm2a_add(mm2, (const unsigned char *)mv->co, sizeof(mv->co));
+  BLI_hash_mm2a_add(mm2, (const unsigned char *)mv->no, sizeof(mv->no));
+}
+
+static void loop_normals_cache_hash_edge(BLI_HashMurmur2A *mm2, const void *elems, const int index)
+{
+  const MEdge *me = &((const MEdge *)elems)[index];
+  BLI_hash_mm2a_add_int(mm2, (int)me->v1);
+  BLI_hash_mm2a_add_int(mm2, (int)me->v2);
+  BLI_hash_mm2a_add_int(mm2, me->flag & ME_SHARP);
+}
+
+static void loop_normals_cache_hash_loop(BLI_HashMurmur2A *mm2, const void *elems, const int index)
+{
+  const MLoop *ml = &((const MLoop *)elems)[index];
+  BLI_hash_mm2a_add_int(mm2, (int)ml->v);
+  BLI_hash_mm2a_add_int(mm2, (int)ml->e);
+}
+
+static void loop_normals_cache_hash_poly(BLI_HashMurmur2A *mm2, const void *elems, const int index)
+{
+  /* Material indices do not affect normals. */
+  const MPoly *mp = &((const MPoly *)elems)[index];
+  BLI_hash_mm2a_add_int(mm2, mp->loopstart);
+  BLI_hash_mm2a_add_int(mm2, mp->totloop);
+  BLI_hash_mm2a_add_int(mm2, mp->flag & ME_SMOOTH);
+}
+
+static void loop_normals_cache_hash_float3(BLI_HashMurmur2A *mm2,
+                                           const void *elems,
+                                           const int index)
+{
+  const float *value = ((const float(*)[3])elems)[index];
+  BLI_hash_mm2a_add(mm2, (const unsigned char *)value, sizeof(float[3]));
+}
+
+static void loop_normals_cache_hash_short2(BLI_HashMurmur2A *mm2,
+                                           const void *elems,
+                                           const int index)
+{
+  const short *value = ((const short(*)[2])elems)[index];
+  BLI_hash_mm2a_add(mm2, (const unsigned char *)value, sizeof(short[2]));
+}
+
+struct MeshLoopNormalsCacheHashData {
+  const void *elems;
+  int elems_num;
+  MeshLoopNormalsCacheHashFn hash_fn;
+  uint *block_hashes;
+};
+
+static void loop_normals_cache_hash_block_cb(void *__restrict userdata,
+                                             const int block_index,
+                                             const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  MeshLoopNormalsCacheHashData *data = (MeshLoopNormalsCacheHashData *)userdata;
+  const int start = block_index * LOOP_NORMALS_CACHE_HASH_BLOCK_SIZE;
+  const int end = min_ii(start + LOOP_NORMALS_CACHE_HASH_BLOCK_SIZE, data->elems_num);
+
+  BLI_HashMurmur2A mm2;
+  BLI_hash_mm2a_init(&mm2, 0);
+  for (int i = start; i < end; i++) {
+    data->hash_fn(&mm2, data->elems, i);
+  }
+  data->block_hashes[block_index] = BLI_hash_mm2a_end(&mm2);
+}
+
+static uint loop_normals_cache_hash(const void *elems,
+                                    const int elems_num,
+                                    MeshLoopNormalsCacheHashFn hash_fn)
+{
+  if (elems == nullptr || elems_num == 0) {
+    return 0;
+  }
+
+  const int blocks_num = (elems_num + LOOP_NORMALS_CACHE_HASH_BLOCK_SIZE - 1) /
+                         LOOP_NORMALS_CACHE_HASH_BLOCK_SIZE;
+
+  MeshLoopNormalsCacheHashData data;
+  data.elems = elems;
+  data.elems_num = elems_num;
+  data.hash_fn = hash_fn;
+  data.block_hashes = (uint *)MEM_malloc_arrayN(
+      (size_t)blocks_num, sizeof(*data.block_hashes), __func__);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+
+  BLI_task_parallel_range(0, blocks_num, &data, loop_normals_cache_hash_block_cb, &settings);
+
+  const uint hash = BLI_hash_mm2((const unsigned char *)data.block_hashes,
+                                 sizeof(*data.block_hashes) * (size_t)blocks_num,
+                                 (uint)elems_num);
+  MEM_freeN(data.block_hashes);
+  return hash;
+}
+
+/**
+ * Same as #BKE_mesh_normals_loop_split for a whole mesh, without loop normal spaces.
+ * When the mesh data used to compute the normals did not change since the last call,
+ * the normals are copied from the cache stored in the mesh runtime data.
+ *
+ * \note This function only fills a cache, and therefore the mesh argument can
+ * be considered logically const. Concurrent access is protected by a mutex.
+ */
+void BKE_mesh_normals_loop_split_cached(const Mesh *mesh,
+                                        const float (*polynors)[3],
+                                        const bool use_split_normals,
+                                        const float split_angle,
+                                        float (*r_loopnors)[3])
+{
+  Mesh *mesh_mut = (Mesh *)mesh;
+  short(*clnors)[2] = (short(*)[2])CustomData_get_layer(&mesh->ldata, CD_CUSTOMLOOPNORMAL);
+
+  if (!use_split_normals) {
+    /* Trivial to compute, not worth hashing the whole mesh. */
+    BKE_mesh_normals_loop_split(mesh->mvert,
+                                mesh->totvert,
+                                mesh->medge,
+                                mesh->totedge,
+                                mesh->mloop,
+                                r_loopnors,
+                                mesh->totloop,
+                                mesh->mpoly,
+                                polynors,
+                                mesh->totpoly,
+                                false,
+                                split_angle,
+                                nullptr,
+                                clnors,
+                                nullptr);
+    return;
+  }
+
+  MeshLoopNormalsCacheKey key;
+  memset(&key, 0, sizeof(key));
+  key.numVerts = mesh->totvert;
+  key.numEdges = mesh->totedge;
+  key.numLoops = mesh->totloop;
+  key.numPolys = mesh->totpoly;
+  key.vert_hash = loop_normals_cache_hash(
+      mesh->mvert, mesh->totvert, loop_normals_cache_hash_vert);
+  key.edge_hash = loop_normals_cache_hash(
+      mesh->medge, mesh->totedge, loop_normals_cache_hash_edge);
+  key.loop_hash = loop_normals_cache_hash(
+      mesh->mloop, mesh->totloop, loop_normals_cache_hash_loop);
+  key.poly_hash = loop_normals_cache_hash(
+      mesh->mpoly, mesh->totpoly, loop_normals_cache_hash_poly);
+  key.polynors_hash = loop_normals_cache_hash(
+      polynors, mesh->totpoly, loop_normals_cache_hash_float3);
+  key.clnors_hash = loop_normals_cache_hash(
+      clnors, mesh->totloop, loop_normals_cache_hash_short2);
+  key.use_split_normals = use_split_normals;
+  key.split_angle = split_angle;
+
+  BLI_mutex_lock(&loop_normals_cache_mutex);
+  MeshLoopNormalsCache *cache = mesh->runtime.loop_normals_cache;
+  if (cache != nullptr && memcmp(&cache->key, &key, sizeof(key)) == 0) {
+    memcpy(r_loopnors, cache->loopnors, sizeof(*r_loopnors) * (size_t)mesh->totloop);
+    BLI_mutex_unlock(&loop_normals_cache_mutex);
+    return;
+  }
+  BLI_mutex_unlock(&loop_normals_cache_mutex);
+
+  /* The normals are computed without holding the lock, the cache is only filled afterwards. */
+  BKE_mesh_normals_loop_split(mesh->mvert,
+                              mesh->totvert,
+                              mesh->medge,
+                              mesh->totedge,
+                              mesh->mloop,
+                              r_loopnors,
+                              mesh->totloop,
+                              mesh->mpoly,
+                              polynors,
+                              mesh->totpoly,
+                              use_split_normals,
+                              split_angle,
+                              nullptr,
+                              clnors,
+                              nullptr);
+
+  BLI_mutex_lock(&loop_normals_cache_mutex);
+  cache = mesh->runtime.loop_normals_cache;
+  if (cache == nullptr) {
+    cache = (MeshLoopNormalsCache *)MEM_callocN(sizeof(*cache), __func__);
+    mesh_mut->runtime.loop_normals_cache = cache;
+  }
+  if (cache->loopnors == nullptr || cache->key.numLoops != key.numLoops) {
+    MEM_SAFE_FREE(cache->loopnors);
+    cache->loopnors = (float(*)[3])MEM_malloc_arrayN(
+        (size_t)max_ii(mesh->totloop, 1), sizeof(*cache->loopnors), __func__);
+  }
+  memcpy(cache->loopnors, r_loopnors, sizeof(*r_loopnors) * (size_t)mesh->totloop);
+  cache->key = key;
+  BLI_mutex_unlock(&loop_normals_cache_mutex);
+}
+
+void BKE_mesh_normals_loop_split_cache_free(MeshLoopNormalsCache *cache)
+{
+  if (cache == nullptr) {
+    return;
+  }
+  MEM_SAFE_FREE(cache->loopnors);
+  MEM_freeN(cache);
+}
+
+#undef LOOP_NORMALS_CACHE_HASH_BLOCK_SIZE
+
+/** \} */
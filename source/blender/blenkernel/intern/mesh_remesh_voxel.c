@@ -32,6 +32,7 @@
 
 #include "BLI_blenlib.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_mesh_types.h"
@@ -57,45 +58,132 @@
 #endif
 
 #ifdef WITH_OPENVDB
-struct OpenVDBLevelSet *BKE_mesh_remesh_voxel_ovdb_mesh_to_level_set_create(
-    Mesh *mesh, struct OpenVDBTransform *transform)
+typedef struct RemeshVoxelInput {
+  const MVert *mvert;
+  const MLoop *mloop;
+  const MLoopTri *looptri;
+  float *verts;
+  uint *faces;
+} RemeshVoxelInput;
+
+static void remesh_voxel_input_verts_cb(void *__restrict userdata,
+                                        const int i,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RemeshVoxelInput *data = userdata;
+  copy_v3_v3(&data->verts[i * 3], data->mvert[i].co);
+}
+
+static void remesh_voxel_input_faces_cb(void *__restrict userdata,
+                                        const int i,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RemeshVoxelInput *data = userdata;
+  const MLoopTri *lt = &data->looptri[i];
+  data->faces[i * 3] = data->mloop[lt->tri[0]].v;
+  data->faces[i * 3 + 1] = data->mloop[lt->tri[1]].v;
+  data->faces[i * 3 + 2] = data->mloop[lt->tri[2]].v;
+}
+
+/* Flatten the mesh into the vertex and triangle arrays expected by OpenVDB. */
+static void remesh_voxel_input_create(Mesh *mesh,
+                                      float **r_verts,
+                                      uint **r_faces,
+                                      uint *r_totverts,
+                                      uint *r_totfaces)
 {
   BKE_mesh_runtime_looptri_recalc(mesh);
   const MLoopTri *looptri = BKE_mesh_runtime_looptri_ensure(mesh);
-  MVertTri *verttri = MEM_callocN(sizeof(*verttri) * BKE_mesh_runtime_looptri_len(mesh),
-                                  "remesh_looptri");
-  BKE_mesh_runtime_verttri_from_looptri(
-      verttri, mesh->mloop, looptri, BKE_mesh_runtime_looptri_len(mesh));
 
   uint totfaces = BKE_mesh_runtime_looptri_len(mesh);
   uint totverts = mesh->totvert;
-  float *verts = (float *)MEM_malloc_arrayN(totverts * 3, sizeof(float), "remesh_input_verts");
-  uint *faces = (uint *)MEM_malloc_arrayN(totfaces * 3, sizeof(uint), "remesh_input_faces");
 
-  for (uint i = 0; i < totverts; i++) {
-    MVert *mvert = &mesh->mvert[i];
-    verts[i * 3] = mvert->co[0];
-    verts[i * 3 + 1] = mvert->co[1];
-    verts[i * 3 + 2] = mvert->co[2];
-  }
+  RemeshVoxelInput data = {
+      .mvert = mesh->mvert,
+      .mloop = mesh->mloop,
+      .looptri = looptri,
+      .verts = (float *)MEM_malloc_arrayN(totverts * 3, sizeof(float), "remesh_input_verts"),
+      .faces = (uint *)MEM_malloc_arrayN(totfaces * 3, sizeof(uint), "remesh_input_faces"),
+  };
 
-  for (uint i = 0; i < totfaces; i++) {
-    MVertTri *vt = &verttri[i];
-    faces[i * 3] = vt->tri[0];
-    faces[i * 3 + 1] = vt->tri[1];
-    faces[i * 3 + 2] = vt->tri[2];
-  }
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, (int)totverts, &data, remesh_voxel_input_verts_cb, &settings);
+  BLI_task_parallel_range(0, (int)totfaces, &data, remesh_voxel_input_faces_cb, &settings);
+
+  *r_verts = data.verts;
+  *r_faces = data.faces;
+  *r_totverts = totverts;
+  *r_totfaces = totfaces;
+}
+
+struct OpenVDBLevelSet *BKE_mesh_remesh_voxel_ovdb_mesh_to_level_set_create(
+    Mesh *mesh, struct OpenVDBTransform *transform)
+{
+  float *verts;
+  uint *faces;
+  uint totverts, totfaces;
+  remesh_voxel_input_create(mesh, &verts, &faces, &totverts, &totfaces);
 
   struct OpenVDBLevelSet *level_set = OpenVDBLevelSet_create(false, NULL);
   OpenVDBLevelSet_mesh_to_level_set(level_set, verts, faces, totverts, totfaces, transform);
 
   MEM_freeN(verts);
   MEM_freeN(faces);
-  MEM_freeN(verttri);
 
   return level_set;
 }
 
+typedef struct RemeshVoxelOutput {
+  const struct OpenVDBVolumeToMeshData *output_mesh;
+  Mesh *mesh;
+} RemeshVoxelOutput;
+
+static void remesh_voxel_output_verts_cb(void *__restrict userdata,
+                                         const int i,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RemeshVoxelOutput *data = userdata;
+  copy_v3_v3(data->mesh->mvert[i].co, &data->output_mesh->vertices[i * 3]);
+}
+
+static void remesh_voxel_output_quads_cb(void *__restrict userdata,
+                                         const int i,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RemeshVoxelOutput *data = userdata;
+  const uint *quads = data->output_mesh->quads;
+  MPoly *mp = &data->mesh->mpoly[i];
+  MLoop *ml = &data->mesh->mloop[i * 4];
+
+  mp->loopstart = i * 4;
+  mp->totloop = 4;
+
+  ml[0].v = quads[i * 4 + 3];
+  ml[1].v = quads[i * 4 + 2];
+  ml[2].v = quads[i * 4 + 1];
+  ml[3].v = quads[i * 4];
+}
+
+static void remesh_voxel_output_triangles_cb(void *__restrict userdata,
+                                             const int i,
+                                             const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RemeshVoxelOutput *data = userdata;
+  const int totquads = data->output_mesh->totquads;
+  const uint *triangles = data->output_mesh->triangles;
+  MPoly *mp = &data->mesh->mpoly[totquads + i];
+  MLoop *ml = &data->mesh->mloop[totquads * 4 + i * 3];
+
+  mp->loopstart = totquads * 4 + i * 3;
+  mp->totloop = 3;
+
+  ml[0].v = triangles[i * 3 + 2];
+  ml[1].v = triangles[i * 3 + 1];
+  ml[2].v = triangles[i * 3];
+}
+
 Mesh *BKE_mesh_remesh_voxel_ovdb_volume_to_mesh_nomain(struct OpenVDBLevelSet *level_set,
                                                        double isovalue,
                                                        double adaptivity,
@@ -111,30 +199,19 @@ Mesh *BKE_mesh_remesh_voxel_ovdb_volume_to_mesh_nomain(struct OpenVDBLevelSet *l
                                    (output_mesh.totquads * 4) + (output_mesh.tottriangles * 3),
                                    output_mesh.totquads + output_mesh.tottriangles);
 
-  for (int i = 0; i < output_mesh.totvertices; i++) {
-    copy_v3_v3(mesh->mvert[i].co, &output_mesh.vertices[i * 3]);
-  }
-
-  MPoly *mp = mesh->mpoly;
-  MLoop *ml = mesh->mloop;
-  for (int i = 0; i < output_mesh.totquads; i++, mp++, ml += 4) {
-    mp->loopstart = (int)(ml - mesh->mloop);
-    mp->totloop = 4;
+  RemeshVoxelOutput data = {
+      .output_mesh = &output_mesh,
+      .mesh = mesh,
+  };
 
-    ml[0].v = output_mesh.quads[i * 4 + 3];
-    ml[1].v = output_mesh.quads[i * 4 + 2];
-    ml[2].v = output_mesh.quads[i * 4 + 1];
-    ml[3].v = output_mesh.quads[i * 4];
-  }
-
-  for (int i = 0; i < output_mesh.tottriangles; i++, mp++, ml += 3) {
-    mp->loopstart = (int)(ml - mesh->mloop);
-    mp->totloop = 3;
-
-    ml[0].v = output_mesh.triangles[i * 3 + 2];
-    ml[1].v = output_mesh.triangles[i * 3 + 1];
-    ml[2].v = output_mesh.triangles[i * 3];
-  }
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(
+      0, output_mesh.totvertices, &data, remesh_voxel_output_verts_cb, &settings);
+  BLI_task_parallel_range(0, output_mesh.totquads, &data, remesh_voxel_output_quads_cb, &settings);
+  BLI_task_parallel_range(
+      0, output_mesh.tottriangles, &data, remesh_voxel_output_triangles_cb, &settings);
 
   BKE_mesh_calc_edges(mesh, false, false);
   BKE_mesh_calc_normals(mesh);
@@ -312,13 +389,81 @@ Mesh *BKE_mesh_remesh_voxel_to_mesh_nomain(Mesh *mesh,
   return new_mesh;
 }
 
+typedef struct RemeshReprojectData {
+  const BVHTreeFromMesh *bvhtree;
+  const MVert *target_verts;
+  const MPoly *target_polys;
+  const MLoop *target_loops;
+  int *r_nearest;
+} RemeshReprojectData;
+
+static int remesh_reproject_find_nearest(const BVHTreeFromMesh *bvhtree, const float co[3])
+{
+  BVHTreeNearest nearest;
+  nearest.index = -1;
+  nearest.dist_sq = FLT_MAX;
+  BLI_bvhtree_find_nearest(
+      bvhtree->tree, co, &nearest, bvhtree->nearest_callback, (void *)bvhtree);
+  return nearest.index;
+}
+
+static void remesh_reproject_nearest_vert_cb(void *__restrict userdata,
+                                             const int i,
+                                             const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RemeshReprojectData *data = userdata;
+  data->r_nearest[i] = remesh_reproject_find_nearest(data->bvhtree, data->target_verts[i].co);
+}
+
+static void remesh_reproject_nearest_poly_cb(void *__restrict userdata,
+                                             const int i,
+                                             const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RemeshReprojectData *data = userdata;
+  const MPoly *mpoly = &data->target_polys[i];
+  float from_co[3];
+  BKE_mesh_calc_poly_center(
+      mpoly, &data->target_loops[mpoly->loopstart], data->target_verts, from_co);
+  data->r_nearest[i] = remesh_reproject_find_nearest(data->bvhtree, from_co);
+}
+
+/**
+ * Find the nearest source element for all target vertices (or polygon centers when
+ * \a use_polys is set) at once, so the BVH queries run in parallel and are shared between all
+ * reprojected layers. Elements without a nearest source element get -1.
+ */
+static int *remesh_reproject_nearest_indices(const BVHTreeFromMesh *bvhtree,
+                                             const Mesh *target,
+                                             const bool use_polys)
+{
+  const int tot = use_polys ? target->totpoly : target->totvert;
+  RemeshReprojectData data = {
+      .bvhtree = bvhtree,
+      .target_verts = CustomData_get_layer(&target->vdata, CD_MVERT),
+      .target_polys = CustomData_get_layer(&target->pdata, CD_MPOLY),
+      .target_loops = CustomData_get_layer(&target->ldata, CD_MLOOP),
+      .r_nearest = MEM_malloc_arrayN(tot, sizeof(int), __func__),
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0,
+                          tot,
+                          &data,
+                          use_polys ? remesh_reproject_nearest_poly_cb :
+                                      remesh_reproject_nearest_vert_cb,
+                          &settings);
+
+  return data.r_nearest;
+}
+
 void BKE_mesh_remesh_reproject_paint_mask(Mesh *target, Mesh *source)
 {
   BVHTreeFromMesh bvhtree = {
       .nearest_callback = NULL,
   };
   BKE_bvhtree_from_mesh_get(&bvhtree, source, BVHTREE_FROM_VERTS, 2);
-  MVert *target_verts = CustomData_get_layer(&target->vdata, CD_MVERT);
 
   float *target_mask;
   if (CustomData_has_layer(&target->vdata, CD_PAINT_MASK)) {
@@ -338,17 +483,13 @@ void BKE_mesh_remesh_reproject_paint_mask(Mesh *target, Mesh *source)
         &source->vdata, CD_PAINT_MASK, CD_CALLOC, NULL, source->totvert);
   }
 
+  int *nearest = remesh_reproject_nearest_indices(&bvhtree, target, false);
   for (int i = 0; i < target->totvert; i++) {
-    float from_co[3];
-    BVHTreeNearest nearest;
-    nearest.index = -1;
-    nearest.dist_sq = FLT_MAX;
-    copy_v3_v3(from_co, target_verts[i].co);
-    BLI_bvhtree_find_nearest(bvhtree.tree, from_co, &nearest, bvhtree.nearest_callback, &bvhtree);
-    if (nearest.index != -1) {
-      target_mask[i] = source_mask[nearest.index];
+    if (nearest[i] != -1) {
+      target_mask[i] = source_mask[nearest[i]];
     }
   }
+  MEM_freeN(nearest);
   free_bvhtree_from_mesh(&bvhtree);
 }
 
@@ -358,10 +499,6 @@ void BKE_remesh_reproject_sculpt_face_sets(Mesh *target, Mesh *source)
       .nearest_callback = NULL,
   };
 
-  const MPoly *target_polys = CustomData_get_layer(&target->pdata, CD_MPOLY);
-  const MVert *target_verts = CustomData_get_layer(&target->vdata, CD_MVERT);
-  const MLoop *target_loops = CustomData_get_layer(&target->ldata, CD_MLOOP);
-
   int *target_face_sets;
   if (CustomData_has_layer(&target->pdata, CD_SCULPT_FACE_SETS)) {
     target_face_sets = CustomData_get_layer(&target->pdata, CD_SCULPT_FACE_SETS);
@@ -383,32 +520,33 @@ void BKE_remesh_reproject_sculpt_face_sets(Mesh *target, Mesh *source)
   const MLoopTri *looptri = BKE_mesh_runtime_looptri_ensure(source);
   BKE_bvhtree_from_mesh_get(&bvhtree, source, BVHTREE_FROM_LOOPTRI, 2);
 
+  int *nearest = remesh_reproject_nearest_indices(&bvhtree, target, true);
   for (int i = 0; i < target->totpoly; i++) {
-    float from_co[3];
-    BVHTreeNearest nearest;
-    nearest.index = -1;
-    nearest.dist_sq = FLT_MAX;
-    const MPoly *mpoly = &target_polys[i];
-    BKE_mesh_calc_poly_center(mpoly, &target_loops[mpoly->loopstart], target_verts, from_co);
-    BLI_bvhtree_find_nearest(bvhtree.tree, from_co, &nearest, bvhtree.nearest_callback, &bvhtree);
-    if (nearest.index != -1) {
-      target_face_sets[i] = source_face_sets[looptri[nearest.index].poly];
+    if (nearest[i] != -1) {
+      target_face_sets[i] = source_face_sets[looptri[nearest[i]].poly];
     }
     else {
       target_face_sets[i] = 1;
     }
   }
+  MEM_freeN(nearest);
   free_bvhtree_from_mesh(&bvhtree);
 }
 
 void BKE_remesh_reproject_vertex_paint(Mesh *target, Mesh *source)
 {
+  int tot_color_layer = CustomData_number_of_layers(&source->vdata, CD_PROP_COLOR);
+  if (tot_color_layer == 0) {
+    return;
+  }
+
   BVHTreeFromMesh bvhtree = {
       .nearest_callback = NULL,
   };
   BKE_bvhtree_from_mesh_get(&bvhtree, source, BVHTREE_FROM_VERTS, 2);
 
-  int tot_color_layer = CustomData_number_of_layers(&source->vdata, CD_PROP_COLOR);
+  /* The nearest vertices are the same for all layers. */
+  int *nearest = remesh_reproject_nearest_indices(&bvhtree, target, false);
 
   for (int layer_n = 0; layer_n < tot_color_layer; layer_n++) {
     const char *layer_name = CustomData_get_layer_name(&source->vdata, CD_PROP_COLOR, layer_n);
@@ -416,19 +554,14 @@ void BKE_remesh_reproject_vertex_paint(Mesh *target, Mesh *source)
         &target->vdata, CD_PROP_COLOR, CD_CALLOC, NULL, target->totvert, layer_name);
 
     MPropCol *target_color = CustomData_get_layer_n(&target->vdata, CD_PROP_COLOR, layer_n);
-    MVert *target_verts = CustomData_get_layer(&target->vdata, CD_MVERT);
     MPropCol *source_color = CustomData_get_layer_n(&source->vdata, CD_PROP_COLOR, layer_n);
     for (int i = 0; i < target->totvert; i++) {
-      BVHTreeNearest nearest;
-      nearest.index = -1;
-      nearest.dist_sq = FLT_MAX;
-      BLI_bvhtree_find_nearest(
-          bvhtree.tree, target_verts[i].co, &nearest, bvhtree.nearest_callback, &bvhtree);
-      if (nearest.index != -1) {
-        copy_v4_v4(target_color[i].color, source_color[nearest.index].color);
+      if (nearest[i] != -1) {
+        copy_v4_v4(target_color[i].color, source_color[nearest[i]].color);
       }
     }
   }
+  MEM_freeN(nearest);
   free_bvhtree_from_mesh(&bvhtree);
 }
 
@@ -0,0 +1,408 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup bke
+ *
+ * Triangulate mesh polygons without converting to #BMesh,
+ * matching the quad and n-gon methods of #BM_face_triangulate.
+ */
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_modifier_types.h"
+
+#include "BLI_array.hh"
+#include "BLI_enumerable_thread_specific.hh"
+#include "BLI_heap.h"
+#include "BLI_map.hh"
+#include "BLI_math_geom.h"
+#include "BLI_math_vector.h"
+#include "BLI_memarena.h"
+#include "BLI_polyfill_2d.h"
+#include "BLI_polyfill_2d_beautify.h"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
+
+#include "BKE_customdata.h"
+#include "BKE_mesh.h"
+
+namespace blender::bke::mesh_triangulate {
+
+/** Per thread buffers for n-gon triangulation. */
+struct PolyFillBuffers {
+  MemArena *arena = nullptr;
+  Heap *heap = nullptr;
+  Vector<float> projverts;
+  Vector<uint> tris;
+};
+
+static bool poly_is_triangulated(const MPoly &mp, const int min_vertices)
+{
+  return mp.totloop > 3 && mp.totloop >= min_vertices;
+}
+
+/**
+ * Equivalent of #BM_verts_calc_rotate_beauty (using the area method, without any restrictions).
+ */
+static float quad_calc_rotate_beauty(const float v1[3],
+                                     const float v2[3],
+                                     const float v3[3],
+                                     const float v4[3])
+{
+  const float eps = 1e-5;
+  float v1_xy[2], v2_xy[2], v3_xy[2], v4_xy[2];
+  float no_a[3], no_b[3];
+  float no[3];
+  float axis_mat[3][3];
+  float no_scale;
+
+  if (UNLIKELY(v1 == v3)) {
+    return FLT_MAX;
+  }
+
+  cross_tri_v3(no_a, v2, v3, v4);
+  cross_tri_v3(no_b, v2, v4, v1);
+  add_v3_v3v3(no, no_a, no_b);
+  if (UNLIKELY((no_scale = normalize_v3(no)) == 0.0f)) {
+    return FLT_MAX;
+  }
+
+  axis_dominant_v3_to_m3(axis_mat, no);
+  mul_v2_m3v3(v1_xy, axis_mat, v1);
+  mul_v2_m3v3(v2_xy, axis_mat, v2);
+  mul_v2_m3v3(v3_xy, axis_mat, v3);
+  mul_v2_m3v3(v4_xy, axis_mat, v4);
+
+  /* Ignore faces with opposite winding or that are both degenerate. */
+  if (!(signum_i_ex(cross_tri_v2(v2_xy, v3_xy, v4_xy) / no_scale, eps) +
+        signum_i_ex(cross_tri_v2(v2_xy, v4_xy, v1_xy) / no_scale, eps))) {
+    return FLT_MAX;
+  }
+
+  return BLI_polyfill_beautify_quad_rotate_calc_ex(v1_xy, v2_xy, v3_xy, v4_xy, false, nullptr);
+}
+
+/**
+ * Fill in triangles as corner indices of the polygon (`totloop - 2` triangles).
+ */
+static void poly_calc_tris(const Mesh &mesh,
+                           const MPoly &mp,
+                           const int quad_method,
+                           const int ngon_method,
+                           PolyFillBuffers &buffers,
+                           uint (*r_tris)[3])
+{
+  const MLoop *ml = &mesh.mloop[mp.loopstart];
+  const MVert *mvert = mesh.mvert;
+
+  if (mp.totloop == 4) {
+    /* Corners of the split diagonal, see #BM_face_triangulate. */
+    uint corner_a, corner_b;
+    switch (quad_method) {
+      case MOD_TRIANGULATE_QUAD_FIXED: {
+        corner_a = 0;
+        corner_b = 2;
+        break;
+      }
+      case MOD_TRIANGULATE_QUAD_ALTERNATE: {
+        corner_a = 1;
+        corner_b = 3;
+        break;
+      }
+      case MOD_TRIANGULATE_QUAD_SHORTEDGE:
+      case MOD_TRIANGULATE_QUAD_BEAUTY:
+      default: {
+        const float *co1 = mvert[ml[1].v].co;
+        const float *co2 = mvert[ml[2].v].co;
+        const float *co3 = mvert[ml[3].v].co;
+        const float *co4 = mvert[ml[0].v].co;
+        bool split_24;
+
+        if (quad_method == MOD_TRIANGULATE_QUAD_SHORTEDGE) {
+          const float d1 = len_squared_v3v3(co4, co2);
+          const float d2 = len_squared_v3v3(co1, co3);
+          split_24 = ((d2 - d1) > 0.0f);
+        }
+        else {
+          /* First check if the quad is concave on either diagonal. */
+          const int flip_flag = is_quad_flip_v3(co1, co2, co3, co4);
+          if (UNLIKELY(flip_flag & (1 << 0))) {
+            split_24 = true;
+          }
+          else if (UNLIKELY(flip_flag & (1 << 1))) {
+            split_24 = false;
+          }
+          else {
+            split_24 = (quad_calc_rotate_beauty(co1, co2, co3, co4) > 0.0f);
+          }
+        }
+
+        if (split_24) {
+          corner_a = 0;
+          corner_b = 2;
+        }
+        else {
+          corner_a = 1;
+          corner_b = 3;
+        }
+        break;
+      }
+    }
+
+    ARRAY_SET_ITEMS(r_tris[0], corner_a, (corner_a + 1) % 4, corner_b);
+    ARRAY_SET_ITEMS(r_tris[1], corner_a, corner_b, (corner_b + 1) % 4);
+    return;
+  }
+
+  if (buffers.arena == nullptr) {
+    buffers.arena = BLI_memarena_new(BLI_POLYFILL_ARENA_SIZE, __func__);
+  }
+
+  float no[3];
+  float axis_mat[3][3];
+  BKE_mesh_calc_poly_normal(&mp, ml, mvert, no);
+  axis_dominant_v3_to_m3_negate(axis_mat, no);
+
+  buffers.projverts.resize(mp.totloop * 2);
+  float(*projverts)[2] = reinterpret_cast<float(*)[2]>(buffers.projverts.data());
+  for (int i = 0; i < mp.totloop; i++) {
+    mul_v2_m3v3(projverts[i], axis_mat, mvert[ml[i].v].co);
+  }
+
+  BLI_polyfill_calc_arena(projverts, mp.totloop, 1, r_tris, buffers.arena);
+
+  if (ngon_method == MOD_TRIANGULATE_NGON_BEAUTY) {
+    if (buffers.heap == nullptr) {
+      buffers.heap = BLI_heap_new_ex(BLI_POLYFILL_ALLOC_NGON_RESERVE);
+    }
+    BLI_polyfill_beautify(projverts, mp.totloop, r_tris, buffers.arena, buffers.heap);
+  }
+
+  BLI_memarena_clear(buffers.arena);
+}
+
+static Mesh *triangulate(const Mesh &mesh,
+                         const int quad_method,
+                         const int ngon_method,
+                         const int min_vertices)
+{
+  const Span<MPoly> polys(mesh.mpoly, mesh.totpoly);
+  const Span<MLoop> loops(mesh.mloop, mesh.totloop);
+  const Span<MEdge> edges(mesh.medge, mesh.totedge);
+
+  /* Offsets of the resulting polygons & loops, and of the diagonals of each polygon. */
+  Array<int> poly_offsets(polys.size() + 1);
+  Array<int> loop_offsets(polys.size() + 1);
+  Array<int> diagonal_offsets(polys.size() + 1);
+  poly_offsets[0] = 0;
+  loop_offsets[0] = 0;
+  diagonal_offsets[0] = 0;
+  for (const int i : polys.index_range()) {
+    const MPoly &mp = polys[i];
+    if (poly_is_triangulated(mp, min_vertices)) {
+      poly_offsets[i + 1] = poly_offsets[i] + mp.totloop - 2;
+      loop_offsets[i + 1] = loop_offsets[i] + (mp.totloop - 2) * 3;
+      diagonal_offsets[i + 1] = diagonal_offsets[i] + mp.totloop - 3;
+    }
+    else {
+      poly_offsets[i + 1] = poly_offsets[i] + 1;
+      loop_offsets[i + 1] = loop_offsets[i] + mp.totloop;
+      diagonal_offsets[i + 1] = diagonal_offsets[i];
+    }
+  }
+
+  if (diagonal_offsets.last() == 0) {
+    /* Nothing to triangulate. */
+    return nullptr;
+  }
+
+  /* The source corner of every resulting loop, and the diagonals as ordered vertex pairs. */
+  Array<int> dst_loop_corners(loop_offsets.last());
+  Array<std::pair<int, int>> diagonals(diagonal_offsets.last());
+
+  threading::EnumerableThreadSpecific<PolyFillBuffers> thread_buffers;
+
+  threading::parallel_for(polys.index_range(), 512, [&](IndexRange range) {
+    PolyFillBuffers &buffers = thread_buffers.local();
+    for (const int i : range) {
+      const MPoly &mp = polys[i];
+      const int dst_loop = loop_offsets[i];
+
+      if (!poly_is_triangulated(mp, min_vertices)) {
+        for (const int j : IndexRange(mp.totloop)) {
+          dst_loop_corners[dst_loop + j] = mp.loopstart + j;
+        }
+        continue;
+      }
+
+      const int tris_len = mp.totloop - 2;
+      buffers.tris.resize(tris_len * 3);
+      uint(*tris)[3] = reinterpret_cast<uint(*)[3]>(buffers.tris.data());
+      poly_calc_tris(mesh, mp, quad_method, ngon_method, buffers, tris);
+
+      /* Every diagonal is used by two triangles, only add it once. */
+      MutableSpan<std::pair<int, int>> poly_diagonals = diagonals.as_mutable_span().slice(
+          diagonal_offsets[i], diagonal_offsets[i + 1] - diagonal_offsets[i]);
+      int diagonals_len = 0;
+
+      const MLoop *ml_src = &loops[mp.loopstart];
+      for (const int tri_index : IndexRange(tris_len)) {
+        for (const int j : IndexRange(3)) {
+          const uint corner = tris[tri_index][j];
+          const uint corner_next = tris[tri_index][(j + 1) % 3];
+          dst_loop_corners[dst_loop + tri_index * 3 + j] = mp.loopstart + int(corner);
+
+          if (corner == (corner_next + 1) % mp.totloop ||
+              corner_next == (corner + 1) % mp.totloop) {
+            continue;
+          }
+          const std::pair<int, int> diagonal = {
+              int(min_uu(ml_src[corner].v, ml_src[corner_next].v)),
+              int(max_uu(ml_src[corner].v, ml_src[corner_next].v))};
+          if (!poly_diagonals.as_span().take_front(diagonals_len).contains(diagonal)) {
+            BLI_assert(diagonals_len < poly_diagonals.size());
+            poly_diagonals[diagonals_len++] = diagonal;
+          }
+        }
+      }
+      BLI_assert(diagonals_len == poly_diagonals.size());
+    }
+  });
+
+  for (PolyFillBuffers &buffers : thread_buffers) {
+    if (buffers.arena) {
+      BLI_memarena_free(buffers.arena);
+    }
+    if (buffers.heap) {
+      BLI_heap_free(buffers.heap, nullptr);
+    }
+  }
+
+  /* Like #BM_face_triangulate, diagonals reuse existing edges between their vertices, and
+   * diagonals shared by multiple polygons only get one new edge. New edges are added in
+   * polygon order. */
+  Map<std::pair<int, int>, int> diagonal_edges;
+  diagonal_edges.reserve(diagonals.size());
+  for (const std::pair<int, int> &diagonal : diagonals) {
+    diagonal_edges.add(diagonal, -1);
+  }
+  for (const int i : edges.index_range()) {
+    const MEdge &med = edges[i];
+    int *edge = diagonal_edges.lookup_ptr(
+        {int(min_uu(med.v1, med.v2)), int(max_uu(med.v1, med.v2))});
+    if (edge != nullptr && *edge == -1) {
+      *edge = i;
+    }
+  }
+  Vector<std::pair<int, int>> new_edges;
+  for (const std::pair<int, int> &diagonal : diagonals) {
+    int &edge = diagonal_edges.lookup(diagonal);
+    if (edge == -1) {
+      edge = mesh.totedge + int(new_edges.append_and_get_index(diagonal));
+    }
+  }
+
+  Mesh *result = BKE_mesh_new_nomain_from_template(&mesh,
+                                                   mesh.totvert,
+                                                   mesh.totedge + int(new_edges.size()),
+                                                   0,
+                                                   loop_offsets.last(),
+                                                   poly_offsets.last());
+
+  CustomData_copy_data(&mesh.vdata, &result->vdata, 0, 0, mesh.totvert);
+  CustomData_copy_data(&mesh.edata, &result->edata, 0, 0, mesh.totedge);
+
+  /* New edges are only the split diagonals, their custom-data is left cleared. */
+  for (const int i : new_edges.index_range()) {
+    MEdge &med = result->medge[mesh.totedge + i];
+    med.v1 = uint(new_edges[i].first);
+    med.v2 = uint(new_edges[i].second);
+    med.flag = ME_EDGEDRAW | ME_EDGERENDER;
+  }
+  int *new_edges_origindex = static_cast<int *>(CustomData_get_layer(&result->edata,
+                                                                     CD_ORIGINDEX));
+  if (new_edges_origindex != nullptr) {
+    copy_vn_i(new_edges_origindex + mesh.totedge, int(new_edges.size()), ORIGINDEX_NONE);
+  }
+
+  threading::parallel_for(polys.index_range(), 512, [&](IndexRange range) {
+    for (const int i : range) {
+      const MPoly &mp = polys[i];
+      const int dst_poly = poly_offsets[i];
+      const int dst_loop = loop_offsets[i];
+
+      if (!poly_is_triangulated(mp, min_vertices)) {
+        CustomData_copy_data(&mesh.pdata, &result->pdata, i, dst_poly, 1);
+        CustomData_copy_data(&mesh.ldata, &result->ldata, mp.loopstart, dst_loop, mp.totloop);
+        result->mpoly[dst_poly].loopstart = dst_loop;
+        continue;
+      }
+
+      const int tris_len = mp.totloop - 2;
+      for (const int tri_index : IndexRange(tris_len)) {
+        const int dst_tri_poly = dst_poly + tri_index;
+        const int dst_tri_loop = dst_loop + tri_index * 3;
+
+        CustomData_copy_data(&mesh.pdata, &result->pdata, i, dst_tri_poly, 1);
+        MPoly &mp_dst = result->mpoly[dst_tri_poly];
+        mp_dst.loopstart = dst_tri_loop;
+        mp_dst.totloop = 3;
+
+        for (const int j : IndexRange(3)) {
+          const int corner = dst_loop_corners[dst_tri_loop + j];
+          const int corner_next = dst_loop_corners[dst_tri_loop + (j + 1) % 3];
+          CustomData_copy_data(&mesh.ldata, &result->ldata, corner, dst_tri_loop + j, 1);
+
+          MLoop &ml_dst = result->mloop[dst_tri_loop + j];
+          ml_dst.v = loops[corner].v;
+          if (corner_next == mp.loopstart + (corner - mp.loopstart + 1) % mp.totloop) {
+            ml_dst.e = loops[corner].e;
+          }
+          else if (corner == mp.loopstart + (corner_next - mp.loopstart + 1) % mp.totloop) {
+            ml_dst.e = loops[corner_next].e;
+          }
+          else {
+            const uint v_next = loops[corner_next].v;
+            ml_dst.e = uint(diagonal_edges.lookup(
+                {int(min_uu(ml_dst.v, v_next)), int(max_uu(ml_dst.v, v_next))}));
+          }
+        }
+      }
+    }
+  });
+
+  return result;
+}
+
+}  // namespace blender::bke::mesh_triangulate
+
+/**
+ * Triangulate polygons with at least \a min_vertices (and more than three) vertices.
+ *
+ * Triangles of a polygon replace it in place, new edges are added after the existing edges.
+ * Like #BM_mesh_triangulate, diagonals that already exist as edges use that edge.
+ *
+ * \return The new mesh or NULL when there is nothing to triangulate.
+ */
+Mesh *BKE_mesh_triangulate(const Mesh *mesh,
+                           const int quad_method,
+                           const int ngon_method,
+                           const int min_vertices)
+{
+  return blender::bke::mesh_triangulate::triangulate(
+      *mesh, quad_method, ngon_method, min_vertices);
+}
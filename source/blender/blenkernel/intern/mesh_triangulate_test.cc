@@ -0,0 +1,209 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "BLI_float3.hh"
+#include "BLI_math.h"
+#include "BLI_vector.hh"
+
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_modifier_types.h"
+
+#include "bmesh.h"
+#include "bmesh_tools.h"
+
+namespace blender::bke::tests {
+
+/* Loose edges are added before the edges of the polygons. */
+static Mesh *create_mesh(const Vector<float3> &positions,
+                         const Vector<Vector<int>> &polys,
+                         const Vector<std::pair<int, int>> &loose_edges)
+{
+  int loops_len = 0;
+  for (const Vector<int> &poly : polys) {
+    loops_len += poly.size();
+  }
+
+  Mesh *mesh = BKE_mesh_new_nomain(
+      positions.size(), loose_edges.size(), 0, loops_len, polys.size());
+  for (const int i : positions.index_range()) {
+    copy_v3_v3(mesh->mvert[i].co, positions[i]);
+  }
+  for (const int i : loose_edges.index_range()) {
+    mesh->medge[i].v1 = loose_edges[i].first;
+    mesh->medge[i].v2 = loose_edges[i].second;
+    mesh->medge[i].flag = ME_EDGEDRAW | ME_EDGERENDER | ME_LOOSEEDGE;
+  }
+  int loop = 0;
+  for (const int i : polys.index_range()) {
+    mesh->mpoly[i].loopstart = loop;
+    mesh->mpoly[i].totloop = polys[i].size();
+    for (const int vert : polys[i]) {
+      mesh->mloop[loop++].v = vert;
+    }
+  }
+  BKE_mesh_calc_edges(mesh, true, false);
+  return mesh;
+}
+
+static Mesh *triangulate_bmesh(const Mesh *mesh,
+                               const int quad_method,
+                               const int ngon_method,
+                               const int min_vertices)
+{
+  BMeshCreateParams create_params{};
+  BMeshFromMeshParams convert_params{};
+  convert_params.calc_face_normal = true;
+  BMesh *bm = BKE_mesh_to_bmesh_ex(mesh, &create_params, &convert_params);
+  BM_mesh_triangulate(
+      bm, quad_method, ngon_method, min_vertices, false, nullptr, nullptr, nullptr);
+  Mesh *result = BKE_mesh_from_bmesh_for_eval_nomain(bm, nullptr, mesh);
+  BM_mesh_free(bm);
+  return result;
+}
+
+/* Polygons starting at their lowest vertex, sorted, so the order of the faces doesn't matter. */
+static std::vector<std::vector<int>> sorted_polys(const Mesh *mesh)
+{
+  std::vector<std::vector<int>> polys;
+  for (const MPoly &mp : Span(mesh->mpoly, mesh->totpoly)) {
+    std::vector<int> poly;
+    for (const MLoop &ml : Span(mesh->mloop + mp.loopstart, mp.totloop)) {
+      poly.push_back(ml.v);
+    }
+    std::rotate(poly.begin(), std::min_element(poly.begin(), poly.end()), poly.end());
+    polys.push_back(poly);
+  }
+  std::sort(polys.begin(), polys.end());
+  return polys;
+}
+
+static std::vector<std::pair<int, int>> sorted_edges(const Mesh *mesh)
+{
+  std::vector<std::pair<int, int>> edges;
+  for (const MEdge &me : Span(mesh->medge, mesh->totedge)) {
+    edges.push_back({int(min_uu(me.v1, me.v2)), int(max_uu(me.v1, me.v2))});
+  }
+  std::sort(edges.begin(), edges.end());
+  return edges;
+}
+
+/**
+ * Triangulate with #BKE_mesh_triangulate and with BMesh, which is what it replaces.
+ * Both must give the same faces and edges, without duplicate edges.
+ * Nothing is returned when there is nothing to triangulate, the input is compared then.
+ */
+static void test_triangulate(const Mesh *mesh,
+                             const int quad_method,
+                             const int ngon_method,
+                             const int min_vertices = 4)
+{
+  Mesh *result = BKE_mesh_triangulate(mesh, quad_method, ngon_method, min_vertices);
+  Mesh *expected = triangulate_bmesh(mesh, quad_method, ngon_method, min_vertices);
+  const Mesh *compared = result ? result : mesh;
+
+  EXPECT_EQ(compared->totvert, expected->totvert);
+  EXPECT_EQ(sorted_polys(compared), sorted_polys(expected));
+  EXPECT_EQ(sorted_edges(compared), sorted_edges(expected));
+
+  if (result) {
+    EXPECT_FALSE(BKE_mesh_validate(result, false, false));
+    BKE_id_free(nullptr, result);
+  }
+  BKE_id_free(nullptr, expected);
+}
+
+/* Irregular, so no two triangulations are equally good. */
+static const Vector<float3> ngon_positions = {{0.0f, 0.0f, 0.0f},
+                                              {2.0f, -0.3f, 0.0f},
+                                              {3.1f, 0.8f, 0.0f},
+                                              {2.7f, 2.2f, 0.0f},
+                                              {1.2f, 1.4f, 0.0f},
+                                              {-0.4f, 2.5f, 0.0f},
+                                              {-0.9f, 1.1f, 0.0f}};
+
+static const Vector<float3> quad_positions = {{0.0f, 0.0f, 0.0f},
+                                              {1.0f, -0.2f, 0.1f},
+                                              {1.3f, 1.1f, 0.0f},
+                                              {-0.1f, 0.9f, 0.2f},
+                                              {0.6f, 0.5f, 1.0f},
+                                              {0.7f, 0.4f, -1.0f}};
+
+TEST(mesh_triangulate, ngon)
+{
+  BKE_idtype_init();
+  Mesh *mesh = create_mesh(ngon_positions, {{0, 1, 2, 3, 4, 5, 6}}, {});
+  test_triangulate(mesh, MOD_TRIANGULATE_QUAD_BEAUTY, MOD_TRIANGULATE_NGON_BEAUTY);
+  test_triangulate(mesh, MOD_TRIANGULATE_QUAD_BEAUTY, MOD_TRIANGULATE_NGON_EARCLIP);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST(mesh_triangulate, ngon_min_vertices)
+{
+  BKE_idtype_init();
+  Mesh *mesh = create_mesh(ngon_positions, {{0, 1, 2, 4}, {2, 3, 4}, {0, 4, 5, 6}}, {});
+  test_triangulate(mesh, MOD_TRIANGULATE_QUAD_FIXED, MOD_TRIANGULATE_NGON_BEAUTY, 5);
+  test_triangulate(mesh, MOD_TRIANGULATE_QUAD_FIXED, MOD_TRIANGULATE_NGON_BEAUTY, 4);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST(mesh_triangulate, ngon_diagonal_loose_edge)
+{
+  BKE_idtype_init();
+  Mesh *mesh = create_mesh(ngon_positions, {{0, 1, 2, 3, 4, 5, 6}}, {{0, 2}, {0, 4}, {2, 4}});
+  test_triangulate(mesh, MOD_TRIANGULATE_QUAD_BEAUTY, MOD_TRIANGULATE_NGON_BEAUTY);
+  test_triangulate(mesh, MOD_TRIANGULATE_QUAD_BEAUTY, MOD_TRIANGULATE_NGON_EARCLIP);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST(mesh_triangulate, quad_diagonal_loose_edge)
+{
+  BKE_idtype_init();
+  Mesh *mesh = create_mesh(quad_positions, {{0, 1, 2, 3}}, {{0, 2}});
+  test_triangulate(mesh, MOD_TRIANGULATE_QUAD_FIXED, MOD_TRIANGULATE_NGON_BEAUTY);
+  test_triangulate(mesh, MOD_TRIANGULATE_QUAD_ALTERNATE, MOD_TRIANGULATE_NGON_BEAUTY);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST(mesh_triangulate, quad_diagonal_face_edge)
+{
+  BKE_idtype_init();
+  Mesh *mesh = create_mesh(quad_positions, {{0, 1, 2, 3}, {0, 2, 4}}, {});
+  test_triangulate(mesh, MOD_TRIANGULATE_QUAD_FIXED, MOD_TRIANGULATE_NGON_BEAUTY);
+  test_triangulate(mesh, MOD_TRIANGULATE_QUAD_ALTERNATE, MOD_TRIANGULATE_NGON_BEAUTY);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST(mesh_triangulate, quads_sharing_diagonal)
+{
+  BKE_idtype_init();
+  /* Both quads get the same new diagonal, it must only be added once. */
+  Mesh *mesh = create_mesh(quad_positions, {{0, 1, 2, 3}, {0, 5, 2, 4}}, {});
+  test_triangulate(mesh, MOD_TRIANGULATE_QUAD_FIXED, MOD_TRIANGULATE_NGON_BEAUTY);
+  BKE_id_free(nullptr, mesh);
+}
+
+}  // namespace blender::bke::tests
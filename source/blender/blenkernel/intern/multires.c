@@ -396,7 +396,9 @@ void multires_set_tot_level(Object *ob, MultiresModifierData *mmd, int lvl)
 static void multires_ccg_mark_as_modified(SubdivCCG *subdiv_ccg, MultiresModifiedFlags flags)
 {
   if (flags & MULTIRES_COORDS_MODIFIED) {
+    /* No information about which grids changed, so all of them are to be reshaped. */
     subdiv_ccg->dirty.coords = true;
+    MEM_SAFE_FREE(subdiv_ccg->dirty.grids);
   }
   if (flags & MULTIRES_HIDDEN_MODIFIED) {
     subdiv_ccg->dirty.hidden = true;
@@ -424,6 +426,24 @@ void multires_mark_as_modified(Depsgraph *depsgraph, Object *object, MultiresMod
   multires_ccg_mark_as_modified(subdiv_ccg, flags);
 }
 
+void multires_mark_grids_as_modified(Depsgraph *depsgraph,
+                                     Object *object,
+                                     const int *grid_indices,
+                                     const int num_grid_indices)
+{
+  if (object == NULL) {
+    return;
+  }
+  /* NOTE: See multires_mark_as_modified() about tagging the evaluated object. */
+  Object *object_eval = DEG_get_evaluated_object(depsgraph, object);
+  Mesh *mesh = object_eval->data;
+  SubdivCCG *subdiv_ccg = mesh->runtime.subdiv_ccg;
+  if (subdiv_ccg == NULL) {
+    return;
+  }
+  BKE_subdiv_ccg_grids_tag_modified(subdiv_ccg, grid_indices, num_grid_indices);
+}
+
 void multires_flush_sculpt_updates(Object *object)
 {
   if (object == NULL || object->sculpt == NULL || object->sculpt->pbvh == NULL) {
@@ -449,8 +469,7 @@ void multires_flush_sculpt_updates(Object *object)
   multiresModifier_reshapeFromCCG(
       sculpt_session->multires.modifier->totlvl, mesh, sculpt_session->subdiv_ccg);
 
-  subdiv_ccg->dirty.coords = false;
-  subdiv_ccg->dirty.hidden = false;
+  BKE_subdiv_ccg_dirty_clear(subdiv_ccg);
 }
 
 void multires_force_sculpt_rebuild(Object *object)
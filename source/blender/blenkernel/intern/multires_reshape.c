@@ -35,6 +35,7 @@
 #include "BKE_modifier.h"
 #include "BKE_multires.h"
 #include "BKE_subdiv.h"
+#include "BKE_subdiv_ccg.h"
 #include "BKE_subsurf.h"
 #include "BLI_math_vector.h"
 
@@ -153,7 +154,17 @@ bool multiresModifier_reshapeFromCCG(const int tot_level,
 
   multires_ensure_external_read(coarse_mesh, reshape_context.top.level);
 
-  multires_reshape_store_original_grids(&reshape_context);
+  /* When sculpting on the top level only grids modified by the sculpt mode are to be reshaped,
+   * as long as the other grids already hold valid displacement. Propagation from a lower level
+   * refits the whole surface, so all grids are handled then. */
+  if (subdiv_ccg->dirty.grids != NULL &&
+      reshape_context.reshape.level == reshape_context.top.level &&
+      multires_reshape_has_grids(coarse_mesh, reshape_context.top.level)) {
+    reshape_context.reshape.grids = subdiv_ccg->dirty.grids;
+  }
+  else {
+    multires_reshape_store_original_grids(&reshape_context);
+  }
   multires_reshape_ensure_grids(coarse_mesh, reshape_context.top.level);
   if (!multires_reshape_assign_final_coords_from_ccg(&reshape_context, subdiv_ccg)) {
     multires_reshape_context_free(&reshape_context);
@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include "BLI_bitmap.h"
 #include "BLI_sys_types.h"
 
 #include "BKE_multires.h"
@@ -61,6 +62,11 @@ typedef struct MultiresReshapeContext {
 
     /* Grid size for reshape.level. */
     int grid_size;
+
+    /* Grids which are to be reshaped, all grids are reshaped when NULL.
+     * Only used when reshape.level matches top.level: propagation from a lower level refits the
+     * whole surface. */
+    const BLI_bitmap *grids;
   } reshape;
 
   struct {
@@ -244,6 +250,10 @@ void multires_reshape_evaluate_limit_at_grid(const MultiresReshapeContext *resha
 /* Make sure custom data is allocated for the given level. */
 void multires_reshape_ensure_grids(struct Mesh *mesh, const int level);
 
+/* Check whether displacement and mask grids are all allocated at the given level, meaning that
+ * multires_reshape_ensure_grids() would not modify them. */
+bool multires_reshape_has_grids(const struct Mesh *mesh, const int level);
+
 /* --------------------------------------------------------------------
  * Functions specific to reshaping from a set of vertices in a object position.
  */
@@ -594,6 +594,27 @@ void multires_reshape_ensure_grids(Mesh *mesh, const int level)
   ensure_mask_grids(mesh, level);
 }
 
+bool multires_reshape_has_grids(const Mesh *mesh, const int level)
+{
+  const MDisps *mdisps = CustomData_get_layer(&mesh->ldata, CD_MDISPS);
+  if (mdisps == NULL) {
+    return false;
+  }
+  const GridPaintMask *grid_paint_masks = CustomData_get_layer(&mesh->ldata,
+                                                               CD_GRID_PAINT_MASK);
+  const int num_grids = mesh->totloop;
+  for (int grid_index = 0; grid_index < num_grids; grid_index++) {
+    const MDisps *displacement_grid = &mdisps[grid_index];
+    if (displacement_grid->disps == NULL || displacement_grid->level < level) {
+      return false;
+    }
+    if (grid_paint_masks != NULL && grid_paint_masks[grid_index].level < level) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -663,6 +684,10 @@ static void foreach_grid_face_coordinate_task(void *__restrict userdata_v,
   const int num_corners = mpoly[face_index].totloop;
   int grid_index = reshape_context->face_start_grid_index[face_index];
   for (int corner = 0; corner < num_corners; ++corner, ++grid_index) {
+    if (reshape_context->reshape.grids != NULL &&
+        !BLI_BITMAP_TEST(reshape_context->reshape.grids, grid_index)) {
+      continue;
+    }
     for (int y = 0; y < grid_size; ++y) {
       const float v = (float)y * grid_size_1_inv;
       for (int x = 0; x < grid_size; ++x) {
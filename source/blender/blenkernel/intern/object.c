@@ -1671,8 +1671,7 @@ static void object_update_from_subsurf_ccg(Object *object)
   copy_ccg_data(mesh_cow, mesh_orig, CD_MDISPS);
   copy_ccg_data(mesh_cow, mesh_orig, CD_GRID_PAINT_MASK);
   /* Everything is now up-to-date. */
-  subdiv_ccg->dirty.coords = false;
-  subdiv_ccg->dirty.hidden = false;
+  BKE_subdiv_ccg_dirty_clear(subdiv_ccg);
 }
 
 /**
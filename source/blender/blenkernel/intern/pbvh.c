@@ -703,6 +703,8 @@ void BKE_pbvh_free(PBVH *pbvh)
     }
   }
 
+  BKE_pbvh_vert_data_free(pbvh);
+
   if (pbvh->deformed) {
     if (pbvh->verts) {
       /* if pbvh was deformed, new memory was allocated for verts/faces -- free it */
@@ -1656,6 +1658,44 @@ void BKE_pbvh_get_grid_updates(PBVH *pbvh, bool clear, void ***r_gridfaces, int
   *r_gridfaces = faces;
 }
 
+/* Indices of the grids which were modified since last call with `clear` set, used to only
+ * reshape those into the multires displacement. */
+void BKE_pbvh_get_modified_grids(PBVH *pbvh, bool clear, int **r_grid_indices, int *r_totgrid)
+{
+  BLI_assert(pbvh->type == PBVH_GRIDS);
+
+  int tot = 0;
+  for (int i = 0; i < pbvh->totnode; i++) {
+    const PBVHNode *node = &pbvh->nodes[i];
+    if ((node->flag & PBVH_Leaf) && (node->flag & PBVH_UpdateMultires)) {
+      tot += node->totprim;
+    }
+  }
+
+  if (tot == 0) {
+    *r_totgrid = 0;
+    *r_grid_indices = NULL;
+    return;
+  }
+
+  /* Every grid belongs to exactly one leaf, so there are no duplicates. */
+  int *grid_indices = MEM_mallocN(sizeof(*grid_indices) * tot, "PBVH Modified Grids");
+  int index = 0;
+  for (int i = 0; i < pbvh->totnode; i++) {
+    PBVHNode *node = &pbvh->nodes[i];
+    if ((node->flag & PBVH_Leaf) && (node->flag & PBVH_UpdateMultires)) {
+      memcpy(&grid_indices[index], node->prim_indices, sizeof(int) * node->totprim);
+      index += node->totprim;
+      if (clear) {
+        node->flag &= ~PBVH_UpdateMultires;
+      }
+    }
+  }
+
+  *r_totgrid = tot;
+  *r_grid_indices = grid_indices;
+}
+
 /***************************** PBVH Access ***********************************/
 
 PBVHType BKE_pbvh_type(const PBVH *pbvh)
@@ -1732,12 +1772,14 @@ BMesh *BKE_pbvh_get_bmesh(PBVH *pbvh)
 void BKE_pbvh_node_mark_update(PBVHNode *node)
 {
   node->flag |= PBVH_UpdateNormals | PBVH_UpdateBB | PBVH_UpdateOriginalBB |
-                PBVH_UpdateDrawBuffers | PBVH_UpdateRedraw;
+                PBVH_UpdateDrawBuffers | PBVH_UpdateRedraw | PBVH_UpdateVertData |
+                PBVH_UpdateMultires;
 }
 
 void BKE_pbvh_node_mark_update_mask(PBVHNode *node)
 {
-  node->flag |= PBVH_UpdateMask | PBVH_UpdateDrawBuffers | PBVH_UpdateRedraw;
+  node->flag |= PBVH_UpdateMask | PBVH_UpdateDrawBuffers | PBVH_UpdateRedraw |
+                PBVH_UpdateVertData | PBVH_UpdateMultires;
 }
 
 void BKE_pbvh_node_mark_update_color(PBVHNode *node)
@@ -1758,12 +1800,13 @@ void BKE_pbvh_node_mark_rebuild_draw(PBVHNode *node)
 
 void BKE_pbvh_node_mark_redraw(PBVHNode *node)
 {
-  node->flag |= PBVH_UpdateDrawBuffers | PBVH_UpdateRedraw;
+  /* Also used when changing face sets. */
+  node->flag |= PBVH_UpdateDrawBuffers | PBVH_UpdateRedraw | PBVH_UpdateVertData;
 }
 
 void BKE_pbvh_node_mark_normals_update(PBVHNode *node)
 {
-  node->flag |= PBVH_UpdateNormals;
+  node->flag |= PBVH_UpdateNormals | PBVH_UpdateVertData | PBVH_UpdateMultires;
 }
 
 void BKE_pbvh_node_fully_hidden_set(PBVHNode *node, int fully_hidden)
@@ -2674,6 +2717,11 @@ void BKE_pbvh_update_normals(PBVH *pbvh, struct SubdivCCG *subdiv_ccg)
     }
   }
 
+  /* Normals gathered before the update are outdated. */
+  for (int n = 0; n < totnode; n++) {
+    nodes[n]->flag |= PBVH_UpdateVertData;
+  }
+
   MEM_SAFE_FREE(nodes);
 }
 
@@ -2767,6 +2815,10 @@ void BKE_pbvh_grids_update(
   pbvh->grids = grids;
   pbvh->gridfaces = gridfaces;
 
+  for (int a = 0; a < pbvh->totnode; a++) {
+    pbvh->nodes[a].flag |= PBVH_UpdateVertData;
+  }
+
   if (flagmats != pbvh->grid_flag_mats || pbvh->grid_hidden != grid_hidden) {
     pbvh->grid_flag_mats = flagmats;
     pbvh->grid_hidden = grid_hidden;
@@ -2843,6 +2895,149 @@ bool BKE_pbvh_is_deformed(PBVH *pbvh)
 {
   return pbvh->deformed;
 }
+/* Vertex Data */
+
+static void pbvh_node_vert_data_free(PBVHNode *node)
+{
+  PBVHVertData *vert_data = &node->vert_data;
+
+  MEM_SAFE_FREE(vert_data->co);
+  MEM_SAFE_FREE(vert_data->no);
+  MEM_SAFE_FREE(vert_data->mask);
+  MEM_SAFE_FREE(vert_data->face_sets);
+  vert_data->totvert = 0;
+}
+
+static void pbvh_node_vert_data_gather_faces(PBVH *pbvh, PBVHNode *node, PBVHVertData *vert_data)
+{
+  const float *vmask = CustomData_get_layer(pbvh->vdata, CD_PAINT_MASK);
+
+  for (int i = 0; i < vert_data->totvert; i++) {
+    const int v = node->vert_indices[i];
+    const MVert *mv = &pbvh->verts[v];
+
+    copy_v3_v3(vert_data->co[i], mv->co);
+    normal_short_to_float_v3(vert_data->no[i], mv->no);
+    if (vert_data->mask) {
+      vert_data->mask[i] = vmask[v];
+    }
+  }
+
+  if (vert_data->face_sets) {
+    for (int i = 0; i < node->totprim; i++) {
+      const MLoopTri *lt = &pbvh->looptri[node->prim_indices[i]];
+      vert_data->face_sets[i] = pbvh->face_sets[lt->poly];
+    }
+  }
+}
+
+static void pbvh_node_vert_data_gather_grids(PBVH *pbvh, PBVHNode *node, PBVHVertData *vert_data)
+{
+  const CCGKey *key = &pbvh->gridkey;
+  int i = 0;
+
+  for (int g = 0; g < node->totprim; g++) {
+    const int grid_index = node->prim_indices[g];
+    CCGElem *grid = pbvh->grids[grid_index];
+
+    for (int j = 0; j < key->grid_area; j++, i++) {
+      copy_v3_v3(vert_data->co[i], CCG_elem_offset_co(key, grid, j));
+      copy_v3_v3(vert_data->no[i], CCG_elem_offset_no(key, grid, j));
+      if (vert_data->mask) {
+        vert_data->mask[i] = *CCG_elem_offset_mask(key, grid, j);
+      }
+    }
+
+    if (vert_data->face_sets) {
+      const int face_index = BKE_subdiv_ccg_grid_to_face_index(pbvh->subdiv_ccg, grid_index);
+      vert_data->face_sets[g] = pbvh->face_sets[face_index];
+    }
+  }
+}
+
+/**
+ * Get the coordinates, normals, masks and face sets of a leaf node in contiguous arrays,
+ * so that brushes don't have to load the interleaved mesh or grid data of each vertex.
+ *
+ * The arrays are gathered from the mesh or grids when first needed, and again once the node
+ * has been tagged for an update. Brushes tag their nodes at the start of every stroke step,
+ * so the arrays are gathered once per step and shared by all symmetry passes of the brush.
+ * Proxies are applied to the arrays and written back to the mesh or grids when they are
+ * combined, see #BKE_pbvh_node_vert_data_get. The arrays are reused by the next step and
+ * freed at the end of the stroke by #BKE_pbvh_vert_data_free.
+ *
+ * \return NULL for dynamic topology, where vertices are iterated from sets.
+ */
+PBVHVertData *BKE_pbvh_node_vert_data_ensure(PBVH *pbvh, PBVHNode *node)
+{
+  BLI_assert(node->flag & PBVH_Leaf);
+
+  if (pbvh->type == PBVH_BMESH) {
+    return NULL;
+  }
+
+  PBVHVertData *vert_data = &node->vert_data;
+  if (vert_data->co && !(node->flag & PBVH_UpdateVertData)) {
+    return vert_data;
+  }
+
+  /* Reuse the arrays of the previous step, unless a mask or face sets were added or removed. */
+  const bool use_mask = pbvh_has_mask(pbvh);
+  const bool use_face_sets = pbvh->face_sets && (pbvh->type == PBVH_FACES || pbvh->subdiv_ccg);
+  if (use_mask != (vert_data->mask != NULL) || use_face_sets != (vert_data->face_sets != NULL)) {
+    pbvh_node_vert_data_free(node);
+  }
+
+  if (!vert_data->co) {
+    BKE_pbvh_node_num_verts(pbvh, node, &vert_data->totvert, NULL);
+    vert_data->co = MEM_malloc_arrayN(vert_data->totvert, sizeof(*vert_data->co), __func__);
+    vert_data->no = MEM_malloc_arrayN(vert_data->totvert, sizeof(*vert_data->no), __func__);
+    if (use_mask) {
+      vert_data->mask = MEM_malloc_arrayN(
+          vert_data->totvert, sizeof(*vert_data->mask), __func__);
+    }
+    if (use_face_sets) {
+      vert_data->face_sets = MEM_malloc_arrayN(
+          node->totprim, sizeof(*vert_data->face_sets), __func__);
+    }
+  }
+
+  if (pbvh->type == PBVH_FACES) {
+    pbvh_node_vert_data_gather_faces(pbvh, node, vert_data);
+  }
+  else {
+    pbvh_node_vert_data_gather_grids(pbvh, node, vert_data);
+  }
+
+  node->flag &= ~PBVH_UpdateVertData;
+
+  return vert_data;
+}
+
+/**
+ * Get the vertex data of a node when it was gathered and is up to date, without gathering it.
+ *
+ * When combining proxies, nodes with vertex data apply them to its coordinates, which are then
+ * written back to the mesh or grids. That outdates the normals, so the node is tagged to
+ * gather the arrays again.
+ */
+PBVHVertData *BKE_pbvh_node_vert_data_get(PBVHNode *node)
+{
+  if (node->vert_data.co && !(node->flag & PBVH_UpdateVertData)) {
+    return &node->vert_data;
+  }
+  return NULL;
+}
+
+void BKE_pbvh_vert_data_free(PBVH *pbvh)
+{
+  for (int i = 0; i < pbvh->totnode; i++) {
+    if (pbvh->nodes[i].flag & PBVH_Leaf) {
+      pbvh_node_vert_data_free(&pbvh->nodes[i]);
+    }
+  }
+}
+
 /* Proxies */
 
 PBVHProxyNode *BKE_pbvh_node_add_proxy(PBVH *pbvh, PBVHNode *node)
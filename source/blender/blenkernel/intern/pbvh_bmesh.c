@@ -25,6 +25,7 @@
 #include "BLI_heap_simple.h"
 #include "BLI_math.h"
 #include "BLI_memarena.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_DerivedMesh.h"
@@ -753,8 +754,18 @@ typedef struct {
   int cd_vert_mask_offset;
   int cd_vert_node_offset;
   int cd_face_node_offset;
+  /**
+   * When set, edges are gathered in this buffer of #EdgeQueueCandidate instead of being
+   * inserted in the queue, so that nodes can be searched in parallel.
+   */
+  BLI_Buffer *candidates;
 } EdgeQueueContext;
 
+typedef struct EdgeQueueCandidate {
+  BMEdge *e;
+  float priority;
+} EdgeQueueCandidate;
+
 /* only tag'd edges are in the queue */
 #ifdef USE_EDGEQUEUE_TAG
 #  define EDGE_QUEUE_TEST(e) (BM_elem_flag_test((CHECK_TYPE_INLINE(e, BMEdge *), e), BM_ELEM_TAG))
@@ -833,6 +844,18 @@ static bool check_mask(EdgeQueueContext *eq_ctx, BMVert *v)
   return BM_ELEM_CD_GET_FLOAT(v, eq_ctx->cd_vert_mask_offset) < 1.0f;
 }
 
+static void edge_queue_push(EdgeQueueContext *eq_ctx, BMEdge *e, float priority)
+{
+  BMVert **pair = BLI_mempool_alloc(eq_ctx->pool);
+  pair[0] = e->v1;
+  pair[1] = e->v2;
+  BLI_heapsimple_insert(eq_ctx->q->heap, priority, pair);
+#ifdef USE_EDGEQUEUE_TAG
+  BLI_assert(EDGE_QUEUE_TEST(e) == false);
+  EDGE_QUEUE_ENABLE(e);
+#endif
+}
+
 static void edge_queue_insert(EdgeQueueContext *eq_ctx, BMEdge *e, float priority)
 {
   /* Don't let topology update affect fully masked vertices. This used to
@@ -845,14 +868,15 @@ static void edge_queue_insert(EdgeQueueContext *eq_ctx, BMEdge *e, float priorit
        (check_mask(eq_ctx, e->v1) || check_mask(eq_ctx, e->v2))) &&
       !(BM_elem_flag_test_bool(e->v1, BM_ELEM_HIDDEN) ||
         BM_elem_flag_test_bool(e->v2, BM_ELEM_HIDDEN))) {
-    BMVert **pair = BLI_mempool_alloc(eq_ctx->pool);
-    pair[0] = e->v1;
-    pair[1] = e->v2;
-    BLI_heapsimple_insert(eq_ctx->q->heap, priority, pair);
-#ifdef USE_EDGEQUEUE_TAG
-    BLI_assert(EDGE_QUEUE_TEST(e) == false);
-    EDGE_QUEUE_ENABLE(e);
-#endif
+    if (eq_ctx->candidates) {
+      /* Edges are only tagged once added to the queue, an edge shared by several faces may be
+       * gathered more than once. */
+      EdgeQueueCandidate candidate = {e, priority};
+      BLI_buffer_append(eq_ctx->candidates, EdgeQueueCandidate, candidate);
+    }
+    else {
+      edge_queue_push(eq_ctx, e, priority);
+    }
   }
 }
 
@@ -990,6 +1014,89 @@ static void short_edge_queue_face_add(EdgeQueueContext *eq_ctx, BMFace *f)
   }
 }
 
+typedef struct EdgeQueueFillData {
+  const EdgeQueueContext *eq_ctx;
+  PBVHNode **nodes;
+  /** Edges gathered in each node, a buffer of #EdgeQueueCandidate per node. */
+  BLI_Buffer *node_candidates;
+  void (*face_add)(EdgeQueueContext *eq_ctx, BMFace *f);
+} EdgeQueueFillData;
+
+static void edge_queue_fill_node_cb(void *__restrict userdata,
+                                    const int n,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  EdgeQueueFillData *data = userdata;
+
+  /* Faces and edges are only read here, the queue itself is filled afterwards. */
+  EdgeQueueContext eq_ctx = *data->eq_ctx;
+  eq_ctx.candidates = &data->node_candidates[n];
+
+  GSetIterator gs_iter;
+  GSET_ITER (gs_iter, data->nodes[n]->bm_faces) {
+    BMFace *f = BLI_gsetIterator_getKey(&gs_iter);
+    data->face_add(&eq_ctx, f);
+  }
+}
+
+/**
+ * Check each face of the leaf nodes marked for topology update.
+ *
+ * Nodes are searched in parallel, gathering their edges, then those are added to the queue
+ * in node order, skipping edges found in more than one face.
+ */
+static void edge_queue_fill_from_nodes(EdgeQueueContext *eq_ctx,
+                                       PBVH *pbvh,
+                                       void (*face_add)(EdgeQueueContext *eq_ctx, BMFace *f))
+{
+  PBVHNode **nodes = MEM_malloc_arrayN(pbvh->totnode, sizeof(*nodes), __func__);
+  int totnode = 0;
+
+  for (int n = 0; n < pbvh->totnode; n++) {
+    PBVHNode *node = &pbvh->nodes[n];
+
+    /* Check leaf nodes marked for topology update */
+    if ((node->flag & PBVH_Leaf) && (node->flag & PBVH_UpdateTopology) &&
+        !(node->flag & PBVH_FullyHidden)) {
+      nodes[totnode++] = node;
+    }
+  }
+
+  BLI_Buffer *node_candidates = MEM_malloc_arrayN(
+      max_ii(totnode, 1), sizeof(*node_candidates), __func__);
+  for (int n = 0; n < totnode; n++) {
+    BLI_buffer_field_init(&node_candidates[n], EdgeQueueCandidate);
+  }
+
+  EdgeQueueFillData data = {
+      .eq_ctx = eq_ctx,
+      .nodes = nodes,
+      .node_candidates = node_candidates,
+      .face_add = face_add,
+  };
+
+  TaskParallelSettings settings;
+  BKE_pbvh_parallel_range_settings(&settings, true, totnode);
+  BLI_task_parallel_range(0, totnode, &data, edge_queue_fill_node_cb, &settings);
+
+  for (int n = 0; n < totnode; n++) {
+    BLI_Buffer *candidates = &node_candidates[n];
+    for (size_t i = 0; i < candidates->count; i++) {
+      EdgeQueueCandidate *candidate = &BLI_buffer_at(candidates, EdgeQueueCandidate, i);
+#ifdef USE_EDGEQUEUE_TAG
+      if (EDGE_QUEUE_TEST(candidate->e)) {
+        continue;
+      }
+#endif
+      edge_queue_push(eq_ctx, candidate->e, candidate->priority);
+    }
+    BLI_buffer_field_free(candidates);
+  }
+
+  MEM_freeN(node_candidates);
+  MEM_freeN(nodes);
+}
+
 /* Create a priority queue containing vertex pairs connected by a long
  * edge as defined by PBVH.bm_max_edge_len.
  *
@@ -1035,22 +1142,7 @@ static void long_edge_queue_create(EdgeQueueContext *eq_ctx,
   pbvh_bmesh_edge_tag_verify(pbvh);
 #endif
 
-  for (int n = 0; n < pbvh->totnode; n++) {
-    PBVHNode *node = &pbvh->nodes[n];
-
-    /* Check leaf nodes marked for topology update */
-    if ((node->flag & PBVH_Leaf) && (node->flag & PBVH_UpdateTopology) &&
-        !(node->flag & PBVH_FullyHidden)) {
-      GSetIterator gs_iter;
-
-      /* Check each face */
-      GSET_ITER (gs_iter, node->bm_faces) {
-        BMFace *f = BLI_gsetIterator_getKey(&gs_iter);
-
-        long_edge_queue_face_add(eq_ctx, f);
-      }
-    }
-  }
+  edge_queue_fill_from_nodes(eq_ctx, pbvh, long_edge_queue_face_add);
 }
 
 /* Create a priority queue containing vertex pairs connected by a
@@ -1094,22 +1186,7 @@ static void short_edge_queue_create(EdgeQueueContext *eq_ctx,
     eq_ctx->q->edge_queue_tri_in_range = edge_queue_tri_in_sphere;
   }
 
-  for (int n = 0; n < pbvh->totnode; n++) {
-    PBVHNode *node = &pbvh->nodes[n];
-
-    /* Check leaf nodes marked for topology update */
-    if ((node->flag & PBVH_Leaf) && (node->flag & PBVH_UpdateTopology) &&
-        !(node->flag & PBVH_FullyHidden)) {
-      GSetIterator gs_iter;
-
-      /* Check each face */
-      GSET_ITER (gs_iter, node->bm_faces) {
-        BMFace *f = BLI_gsetIterator_getKey(&gs_iter);
-
-        short_edge_queue_face_add(eq_ctx, f);
-      }
-    }
-  }
+  edge_queue_fill_from_nodes(eq_ctx, pbvh, short_edge_queue_face_add);
 }
 
 /*************************** Topology update **************************/
@@ -1975,6 +2052,9 @@ bool BKE_pbvh_bmesh_update_topology(PBVH *pbvh,
     BLI_assert(len_squared_v3(view_normal) != 0.0f);
   }
 
+  /* Only the edge queues are filled in parallel, see #edge_queue_fill_from_nodes. Collapsing and
+   * subdividing stays serial: it allocates from the BMesh pools, writes to the BMLog and moves
+   * elements between nodes. */
   if (mode & PBVH_Collapse) {
     EdgeQueue q;
     BLI_mempool *queue_pool = BLI_mempool_create(sizeof(BMVert *) * 2, 0, 128, BLI_MEMPOOL_NOP);
@@ -1985,6 +2065,7 @@ bool BKE_pbvh_bmesh_update_topology(PBVH *pbvh,
         cd_vert_mask_offset,
         cd_vert_node_offset,
         cd_face_node_offset,
+        NULL,
     };
 
     short_edge_queue_create(
@@ -2004,6 +2085,7 @@ bool BKE_pbvh_bmesh_update_topology(PBVH *pbvh,
         cd_vert_mask_offset,
         cd_vert_node_offset,
         cd_face_node_offset,
+        NULL,
     };
 
     long_edge_queue_create(
@@ -107,6 +107,9 @@ struct PBVHNode {
 
   /* Used to store the brush color during a stroke and composite it over the original color */
   PBVHColorBufferNode color_buffer;
+
+  /* Contiguous copy of the vertex data, lazily gathered for brushes during a stroke */
+  PBVHVertData vert_data;
 };
 
 typedef enum {
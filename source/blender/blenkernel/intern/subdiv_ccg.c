@@ -636,6 +636,7 @@ void BKE_subdiv_ccg_destroy(SubdivCCG *subdiv_ccg)
   MEM_SAFE_FREE(subdiv_ccg->edges);
   MEM_SAFE_FREE(subdiv_ccg->vertices);
   MEM_SAFE_FREE(subdiv_ccg->grid_flag_mats);
+  MEM_SAFE_FREE(subdiv_ccg->dirty.grids);
   if (subdiv_ccg->grid_hidden != NULL) {
     for (int grid_index = 0; grid_index < num_grids; grid_index++) {
       MEM_SAFE_FREE(subdiv_ccg->grid_hidden[grid_index]);
@@ -2059,6 +2060,74 @@ void BKE_subdiv_ccg_grid_hidden_ensure(SubdivCCG *subdiv_ccg, int grid_index)
   subdiv_ccg->grid_hidden[grid_index] = BLI_BITMAP_NEW(key.grid_area, __func__);
 }
 
+static void subdiv_ccg_face_grids_tag_modified(SubdivCCG *subdiv_ccg, const SubdivCCGFace *face)
+{
+  for (int i = 0; i < face->num_grids; i++) {
+    BLI_BITMAP_ENABLE(subdiv_ccg->dirty.grids, face->start_grid_index + i);
+  }
+}
+
+void BKE_subdiv_ccg_grids_tag_modified(SubdivCCG *subdiv_ccg,
+                                       const int *grid_indices,
+                                       const int num_grid_indices)
+{
+  if (num_grid_indices == 0) {
+    return;
+  }
+  if (subdiv_ccg->dirty.coords && subdiv_ccg->dirty.grids == NULL) {
+    /* All grids are already considered modified. */
+    return;
+  }
+  if (!subdiv_ccg->dirty.coords) {
+    if (subdiv_ccg->dirty.grids == NULL) {
+      subdiv_ccg->dirty.grids = BLI_BITMAP_NEW(subdiv_ccg->num_grids, __func__);
+    }
+    else {
+      BLI_bitmap_set_all(subdiv_ccg->dirty.grids, false, subdiv_ccg->num_grids);
+    }
+    subdiv_ccg->dirty.coords = true;
+  }
+
+  /* Stitching copies boundaries of the modified grids to the grids of all faces sharing a coarse
+   * vertex with them, so those are tagged as well. */
+  Subdiv *subdiv = subdiv_ccg->subdiv;
+  OpenSubdiv_TopologyRefiner *topology_refiner = subdiv->topology_refiner;
+  BLI_bitmap *face_visited = BLI_BITMAP_NEW(subdiv_ccg->num_faces, __func__);
+  StaticOrHeapIntStorage face_vertices_storage;
+  static_or_heap_storage_init(&face_vertices_storage);
+
+  for (int i = 0; i < num_grid_indices; i++) {
+    const SubdivCCGFace *face = subdiv_ccg->grid_faces[grid_indices[i]];
+    const int face_index = face - subdiv_ccg->faces;
+    if (BLI_BITMAP_TEST(face_visited, face_index)) {
+      continue;
+    }
+    BLI_BITMAP_ENABLE(face_visited, face_index);
+    subdiv_ccg_face_grids_tag_modified(subdiv_ccg, face);
+
+    int *face_vertices = static_or_heap_storage_get(&face_vertices_storage, face->num_grids);
+    topology_refiner->getFaceVertices(topology_refiner, face_index, face_vertices);
+    for (int corner = 0; corner < face->num_grids; corner++) {
+      const SubdivCCGAdjacentVertex *adjacent_vertex =
+          &subdiv_ccg->adjacent_vertices[face_vertices[corner]];
+      for (int j = 0; j < adjacent_vertex->num_adjacent_faces; j++) {
+        const int grid_index = adjacent_vertex->corner_coords[j].grid_index;
+        subdiv_ccg_face_grids_tag_modified(subdiv_ccg, subdiv_ccg->grid_faces[grid_index]);
+      }
+    }
+  }
+
+  static_or_heap_storage_free(&face_vertices_storage);
+  MEM_freeN(face_visited);
+}
+
+void BKE_subdiv_ccg_dirty_clear(SubdivCCG *subdiv_ccg)
+{
+  subdiv_ccg->dirty.coords = false;
+  subdiv_ccg->dirty.hidden = false;
+  MEM_SAFE_FREE(subdiv_ccg->dirty.grids);
+}
+
 static void subdiv_ccg_coord_to_ptex_coord(const SubdivCCG *subdiv_ccg,
                                            const SubdivCCGCoord *coord,
                                            int *r_ptex_face_index,
@@ -30,10 +30,14 @@
 #include "DNA_meshdata_types.h"
 
 #include "BLI_alloca.h"
+#include "BLI_bitmap.h"
+#include "BLI_hash_mm2a.h"
 #include "BLI_math_vector.h"
+#include "BLI_task.h"
 
 #include "BKE_customdata.h"
 #include "BKE_key.h"
+#include "BKE_lib_id.h"
 #include "BKE_mesh.h"
 #include "BKE_subdiv.h"
 #include "BKE_subdiv_eval.h"
@@ -41,10 +45,25 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "opensubdiv_evaluator_capi.h"
+
 /* -------------------------------------------------------------------- */
 /** \name Subdivision Context
  * \{ */
 
+/* Describes how position of a subdivided vertex is calculated from the coarse mesh.
+ * Used to build stencils of the deform cache. */
+typedef struct SubdivVertexSource {
+  /* Limit surface point at the given coordinate of the ptex face.
+   * Is ORIGINDEX_NONE for vertices of loose geometry. */
+  int ptex_face_index;
+  float u, v;
+  /* Weighted coarse vertices, for vertices of loose geometry.
+   * Unused elements have ORIGINDEX_NONE index. */
+  int coarse_vertex_indices[4];
+  float coarse_vertex_weights[4];
+} SubdivVertexSource;
+
 typedef struct SubdivMeshContext {
   const SubdivToMeshSettings *settings;
   const Mesh *coarse_mesh;
@@ -76,6 +95,10 @@ typedef struct SubdivMeshContext {
    * when it's not possible is when displacement is used. */
   bool can_evaluate_normals;
   bool have_displacement;
+  /* Sources of all subdivided vertex positions, only allocated when deform cache is being
+   * created. */
+  bool need_vertex_sources;
+  SubdivVertexSource *vertex_sources;
 } SubdivMeshContext;
 
 static void subdiv_mesh_ctx_cache_uv_layers(SubdivMeshContext *ctx)
@@ -113,10 +136,26 @@ static void subdiv_mesh_prepare_accumulator(SubdivMeshContext *ctx, int num_vert
       sizeof(*ctx->accumulated_counters), num_vertices, "subdiv accumulated counters");
 }
 
+static void subdiv_mesh_prepare_vertex_sources(SubdivMeshContext *ctx, int num_vertices)
+{
+  if (!ctx->need_vertex_sources) {
+    return;
+  }
+  ctx->vertex_sources = MEM_malloc_arrayN(
+      num_vertices, sizeof(*ctx->vertex_sources), "subdiv vertex sources");
+  /* Vertices which are not visited by traversal are not affected by coarse positions. */
+  for (int i = 0; i < num_vertices; i++) {
+    SubdivVertexSource *source = &ctx->vertex_sources[i];
+    source->ptex_face_index = ORIGINDEX_NONE;
+    copy_vn_i(source->coarse_vertex_indices, 4, ORIGINDEX_NONE);
+  }
+}
+
 static void subdiv_mesh_context_free(SubdivMeshContext *ctx)
 {
   MEM_SAFE_FREE(ctx->accumulated_normals);
   MEM_SAFE_FREE(ctx->accumulated_counters);
+  MEM_SAFE_FREE(ctx->vertex_sources);
 }
 
 /** \} */
@@ -471,6 +510,45 @@ static void eval_final_point_and_vertex_normal(Subdiv *subdiv,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Vertex sources
+ * \{ */
+
+static void subdiv_mesh_vertex_source_set_ptex(const SubdivMeshContext *ctx,
+                                               const int subdiv_vertex_index,
+                                               const int ptex_face_index,
+                                               const float u,
+                                               const float v)
+{
+  if (ctx->vertex_sources == NULL) {
+    return;
+  }
+  SubdivVertexSource *source = &ctx->vertex_sources[subdiv_vertex_index];
+  source->ptex_face_index = ptex_face_index;
+  source->u = u;
+  source->v = v;
+}
+
+static void subdiv_mesh_vertex_source_set_coarse(const SubdivMeshContext *ctx,
+                                                 const int subdiv_vertex_index,
+                                                 const int coarse_vertex_indices[4],
+                                                 const float coarse_vertex_weights[4])
+{
+  if (ctx->vertex_sources == NULL) {
+    return;
+  }
+  SubdivVertexSource *source = &ctx->vertex_sources[subdiv_vertex_index];
+  source->ptex_face_index = ORIGINDEX_NONE;
+  memcpy(source->coarse_vertex_indices,
+         coarse_vertex_indices,
+         sizeof(source->coarse_vertex_indices));
+  memcpy(source->coarse_vertex_weights,
+         coarse_vertex_weights,
+         sizeof(source->coarse_vertex_weights));
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Accumulation helpers
  * \{ */
@@ -526,6 +604,7 @@ static bool subdiv_mesh_topology_info(const SubdivForeachContext *foreach_contex
       subdiv_context->coarse_mesh, num_vertices, num_edges, 0, num_loops, num_polygons, mask);
   subdiv_mesh_ctx_cache_custom_data_layers(subdiv_context);
   subdiv_mesh_prepare_accumulator(subdiv_context, num_vertices);
+  subdiv_mesh_prepare_vertex_sources(subdiv_context, num_vertices);
   return true;
 }
 
@@ -586,6 +665,7 @@ static void evaluate_vertex_and_apply_displacement_copy(const SubdivMeshContext
   /* Copy custom data and evaluate position. */
   subdiv_vertex_data_copy(ctx, coarse_vert, subdiv_vert);
   BKE_subdiv_eval_limit_point(ctx->subdiv, ptex_face_index, u, v, subdiv_vert->co);
+  subdiv_mesh_vertex_source_set_ptex(ctx, subdiv_vertex_index, ptex_face_index, u, v);
   /* Apply displacement. */
   add_v3_v3(subdiv_vert->co, D);
   /* Copy normal from accumulated storage. */
@@ -619,6 +699,7 @@ static void evaluate_vertex_and_apply_displacement_interpolate(
   /* Interpolate custom data and evaluate position. */
   subdiv_vertex_data_interpolate(ctx, subdiv_vert, vertex_interpolation, u, v);
   BKE_subdiv_eval_limit_point(ctx->subdiv, ptex_face_index, u, v, subdiv_vert->co);
+  subdiv_mesh_vertex_source_set_ptex(ctx, subdiv_vertex_index, ptex_face_index, u, v);
   /* Apply displacement. */
   add_v3_v3(subdiv_vert->co, D);
   /* Copy normal from accumulated storage. */
@@ -794,6 +875,7 @@ static void subdiv_mesh_vertex_inner(const SubdivForeachContext *foreach_context
   subdiv_vertex_data_interpolate(ctx, subdiv_vert, &tls->vertex_interpolation, u, v);
   eval_final_point_and_vertex_normal(
       subdiv, ptex_face_index, u, v, subdiv_vert->co, subdiv_vert->no);
+  subdiv_mesh_vertex_source_set_ptex(ctx, subdiv_vertex_index, ptex_face_index, u, v);
   subdiv_mesh_tag_center_vertex(coarse_poly, subdiv_vert, u, v);
 }
 
@@ -999,6 +1081,11 @@ static void subdiv_mesh_vertex_loose(const SubdivForeachContext *foreach_context
   MVert *subdiv_mvert = subdiv_mesh->mvert;
   MVert *subdiv_vertex = &subdiv_mvert[subdiv_vertex_index];
   subdiv_vertex_data_copy(ctx, coarse_vertex, subdiv_vertex);
+  const int coarse_vertex_indices[4] = {
+      coarse_vertex_index, ORIGINDEX_NONE, ORIGINDEX_NONE, ORIGINDEX_NONE};
+  const float coarse_vertex_weights[4] = {1.0f, 0.0f, 0.0f, 0.0f};
+  subdiv_mesh_vertex_source_set_coarse(
+      ctx, subdiv_vertex_index, coarse_vertex_indices, coarse_vertex_weights);
 }
 
 /* Get neighbor edges of the given one.
@@ -1109,6 +1196,48 @@ static void subdiv_mesh_vertex_of_loose_edge_interpolate(SubdivMeshContext *ctx,
   }
 }
 
+/* Same weights as used for position interpolation in subdiv_mesh_vertex_of_loose_edge(), but
+ * expressed in coarse vertices. Missing neighbors are extrapolated from the edge itself. */
+static void subdiv_mesh_vertex_source_set_loose_edge(const SubdivMeshContext *ctx,
+                                                     const MEdge *coarse_edge,
+                                                     const MEdge *neighbors[2],
+                                                     const float u,
+                                                     const int subdiv_vertex_index)
+{
+  if (ctx->vertex_sources == NULL) {
+    return;
+  }
+  int indices[4] = {coarse_edge->v1, coarse_edge->v2, ORIGINDEX_NONE, ORIGINDEX_NONE};
+  float weights[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+  if (ctx->subdiv->settings.is_simple) {
+    weights[0] = 1.0f - u;
+    weights[1] = u;
+    subdiv_mesh_vertex_source_set_coarse(ctx, subdiv_vertex_index, indices, weights);
+    return;
+  }
+  float curve_weights[4];
+  key_curve_position_weights(u, curve_weights, KEY_BSPLINE);
+  weights[0] = curve_weights[1];
+  weights[1] = curve_weights[2];
+  if (neighbors[0] != NULL) {
+    indices[2] = (neighbors[0]->v1 == coarse_edge->v1) ? neighbors[0]->v2 : neighbors[0]->v1;
+    weights[2] = curve_weights[0];
+  }
+  else {
+    weights[0] += 2.0f * curve_weights[0];
+    weights[1] -= curve_weights[0];
+  }
+  if (neighbors[1] != NULL) {
+    indices[3] = (neighbors[1]->v1 == coarse_edge->v2) ? neighbors[1]->v2 : neighbors[1]->v1;
+    weights[3] = curve_weights[3];
+  }
+  else {
+    weights[0] -= curve_weights[3];
+    weights[1] += 2.0f * curve_weights[3];
+  }
+  subdiv_mesh_vertex_source_set_coarse(ctx, subdiv_vertex_index, indices, weights);
+}
+
 static void subdiv_mesh_vertex_of_loose_edge(const struct SubdivForeachContext *foreach_context,
                                              void *UNUSED(tls),
                                              const int coarse_edge_index,
@@ -1141,6 +1270,8 @@ static void subdiv_mesh_vertex_of_loose_edge(const struct SubdivForeachContext *
     key_curve_position_weights(u, weights, KEY_BSPLINE);
     interp_v3_v3v3v3v3(subdiv_vertex->co, points[0], points[1], points[2], points[3], weights);
   }
+  subdiv_mesh_vertex_source_set_loose_edge(
+      ctx, coarse_edge, neighbors, u, subdiv_vertex_index);
   /* Reset flags and such. */
   subdiv_vertex->flag = 0;
   /* TODO(sergey): This matches old behavior, but we can as well interpolate
@@ -1189,12 +1320,16 @@ static void setup_foreach_callbacks(const SubdivMeshContext *subdiv_context,
 /** \} */
 
 /* -------------------------------------------------------------------- */
-/** \name Public entry point
+/** \name Subdivision process
  * \{ */
 
-Mesh *BKE_subdiv_to_mesh(Subdiv *subdiv,
-                         const SubdivToMeshSettings *settings,
-                         const Mesh *coarse_mesh)
+/* When `r_vertex_sources` is not NULL, sources of all subdivided vertex positions are returned
+ * there. Normals are not evaluated from the limit surface in this case, so that they match the
+ * ones calculated for the deform cache. */
+static Mesh *subdiv_to_mesh_ex(Subdiv *subdiv,
+                               const SubdivToMeshSettings *settings,
+                               const Mesh *coarse_mesh,
+                               SubdivVertexSource **r_vertex_sources)
 {
   BKE_subdiv_stats_begin(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH);
   /* Make sure evaluator is up to date with possible new topology, and that
@@ -1217,7 +1352,9 @@ Mesh *BKE_subdiv_to_mesh(Subdiv *subdiv,
   subdiv_context.subdiv = subdiv;
   subdiv_context.have_displacement = (subdiv->displacement_evaluator != NULL);
   subdiv_context.can_evaluate_normals = !subdiv_context.have_displacement &&
-                                        subdiv_context.subdiv->settings.is_adaptive;
+                                        subdiv_context.subdiv->settings.is_adaptive &&
+                                        r_vertex_sources == NULL;
+  subdiv_context.need_vertex_sources = (r_vertex_sources != NULL);
   /* Multi-threaded traversal/evaluation. */
   BKE_subdiv_stats_begin(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH_GEOMETRY);
   SubdivForeachContext foreach_context;
@@ -1234,9 +1371,354 @@ Mesh *BKE_subdiv_to_mesh(Subdiv *subdiv,
   if (!subdiv_context.can_evaluate_normals) {
     result->runtime.cd_dirty_vert |= CD_MASK_NORMAL;
   }
+  if (r_vertex_sources != NULL) {
+    *r_vertex_sources = subdiv_context.vertex_sources;
+    subdiv_context.vertex_sources = NULL;
+  }
   /* Free used memory. */
   subdiv_mesh_context_free(&subdiv_context);
   return result;
 }
 
 /** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Deform cache
+ *
+ * Position of every subdivided vertex is a weighted sum of the coarse vertex positions, with
+ * weights (stencil) which only depend on topology and subdivision settings. The cache keeps the
+ * subdivided mesh together with stencils of all its vertices, so that a deformed coarse mesh is
+ * subdivided by a sparse matrix-vector product instead of the full topology traversal and limit
+ * surface evaluation.
+ * \{ */
+
+typedef struct SubdivMeshDeformCache {
+  /* Settings and coarse mesh the cache has been created for. */
+  SubdivToMeshSettings settings;
+  int coarse_totvert, coarse_totedge, coarse_totloop, coarse_totpoly;
+  /* Hash of the coarse data which is not covered by the subdivision topology: loose edges and
+   * layout of the custom data layers. */
+  uint coarse_hash;
+  /* Subdivided mesh which is copied for every evaluation. */
+  Mesh *mesh;
+  /* Stencil of the subdivided vertex `i` is stored in the range
+   * [stencil_offsets[i], stencil_offsets[i + 1]) of the indices and weights arrays.
+   * Indices are in the coarse mesh vertex space. */
+  int *stencil_offsets;
+  int *stencil_vertex_indices;
+  float *stencil_weights;
+} SubdivMeshDeformCache;
+
+static void custom_data_layout_hash_add(BLI_HashMurmur2A *mm2, const CustomData *data)
+{
+  BLI_hash_mm2a_add_int(mm2, data->totlayer);
+  for (int i = 0; i < data->totlayer; i++) {
+    const CustomDataLayer *layer = &data->layers[i];
+    BLI_hash_mm2a_add_int(mm2, layer->type);
+    BLI_hash_mm2a_add(mm2, (const uchar *)layer->name, strlen(layer->name));
+  }
+}
+
+static uint subdiv_mesh_deform_cache_coarse_hash(const Mesh *coarse_mesh)
+{
+  BLI_HashMurmur2A mm2;
+  BLI_hash_mm2a_init(&mm2, 0);
+  const MEdge *coarse_medge = coarse_mesh->medge;
+  for (int edge_index = 0; edge_index < coarse_mesh->totedge; edge_index++) {
+    BLI_hash_mm2a_add_int(&mm2, coarse_medge[edge_index].v1);
+    BLI_hash_mm2a_add_int(&mm2, coarse_medge[edge_index].v2);
+  }
+  custom_data_layout_hash_add(&mm2, &coarse_mesh->vdata);
+  custom_data_layout_hash_add(&mm2, &coarse_mesh->edata);
+  custom_data_layout_hash_add(&mm2, &coarse_mesh->ldata);
+  custom_data_layout_hash_add(&mm2, &coarse_mesh->pdata);
+  return BLI_hash_mm2a_end(&mm2);
+}
+
+static bool subdiv_mesh_deform_cache_is_valid(const SubdivMeshDeformCache *cache,
+                                              const SubdivToMeshSettings *settings,
+                                              const Mesh *coarse_mesh)
+{
+  if (cache->settings.resolution != settings->resolution ||
+      cache->settings.use_optimal_display != settings->use_optimal_display) {
+    return false;
+  }
+  if (cache->coarse_totvert != coarse_mesh->totvert ||
+      cache->coarse_totedge != coarse_mesh->totedge ||
+      cache->coarse_totloop != coarse_mesh->totloop ||
+      cache->coarse_totpoly != coarse_mesh->totpoly) {
+    return false;
+  }
+  return cache->coarse_hash == subdiv_mesh_deform_cache_coarse_hash(coarse_mesh);
+}
+
+static void subdiv_mesh_deform_cache_free(SubdivMeshDeformCache *cache)
+{
+  if (cache->mesh != NULL) {
+    BKE_id_free(NULL, cache->mesh);
+  }
+  MEM_SAFE_FREE(cache->stencil_offsets);
+  MEM_SAFE_FREE(cache->stencil_vertex_indices);
+  MEM_SAFE_FREE(cache->stencil_weights);
+  MEM_freeN(cache);
+}
+
+typedef struct DeformCacheStencilsData {
+  Subdiv *subdiv;
+  const SubdivVertexSource *vertex_sources;
+  /* OpenSubdiv operates on vertices used by faces only, maps its vertex indices to the coarse
+   * mesh ones. */
+  const int *manifold_vertex_coarse_index;
+  SubdivMeshDeformCache *cache;
+} DeformCacheStencilsData;
+
+typedef struct DeformCacheStencilsTLS {
+  /* Storage for stencils of the limit surface points, grows on demand. */
+  int *vertex_indices;
+  float *weights;
+  int size;
+} DeformCacheStencilsTLS;
+
+static int *manifold_vertex_coarse_index_get(const Mesh *coarse_mesh)
+{
+  const MLoop *mloop = coarse_mesh->mloop;
+  const MPoly *mpoly = coarse_mesh->mpoly;
+  /* Matches vertex ordering of the converter, see `set_coarse_positions()`. */
+  BLI_bitmap *vertex_used_map = BLI_BITMAP_NEW(coarse_mesh->totvert, "vert used map");
+  for (int poly_index = 0; poly_index < coarse_mesh->totpoly; poly_index++) {
+    const MPoly *poly = &mpoly[poly_index];
+    for (int corner = 0; corner < poly->totloop; corner++) {
+      BLI_BITMAP_ENABLE(vertex_used_map, mloop[poly->loopstart + corner].v);
+    }
+  }
+  int *manifold_vertex_coarse_index = MEM_malloc_arrayN(
+      coarse_mesh->totvert, sizeof(int), "manifold vertex coarse index");
+  for (int vertex_index = 0, manifold_vertex_index = 0; vertex_index < coarse_mesh->totvert;
+       vertex_index++) {
+    if (BLI_BITMAP_TEST_BOOL(vertex_used_map, vertex_index)) {
+      manifold_vertex_coarse_index[manifold_vertex_index++] = vertex_index;
+    }
+  }
+  MEM_freeN(vertex_used_map);
+  return manifold_vertex_coarse_index;
+}
+
+/* Calculate stencil of the given subdivided vertex into the thread local storage.
+ * Returns number of stencil elements. */
+static int deform_cache_vertex_stencil_calc(const DeformCacheStencilsData *data,
+                                            DeformCacheStencilsTLS *tls,
+                                            const int subdiv_vertex_index)
+{
+  const SubdivVertexSource *source = &data->vertex_sources[subdiv_vertex_index];
+  if (tls->vertex_indices == NULL) {
+    tls->size = 64;
+    tls->vertex_indices = MEM_malloc_arrayN(tls->size, sizeof(int), __func__);
+    tls->weights = MEM_malloc_arrayN(tls->size, sizeof(float), __func__);
+  }
+  if (source->ptex_face_index == ORIGINDEX_NONE) {
+    int num_elements = 0;
+    for (int i = 0; i < 4; i++) {
+      if (source->coarse_vertex_indices[i] != ORIGINDEX_NONE) {
+        tls->vertex_indices[num_elements] = source->coarse_vertex_indices[i];
+        tls->weights[num_elements] = source->coarse_vertex_weights[i];
+        num_elements++;
+      }
+    }
+    return num_elements;
+  }
+  OpenSubdiv_Evaluator *evaluator = data->subdiv->evaluator;
+  while (true) {
+    const int num_elements = evaluator->evaluateLimitStencil(evaluator,
+                                                             source->ptex_face_index,
+                                                             source->u,
+                                                             source->v,
+                                                             tls->vertex_indices,
+                                                             tls->weights,
+                                                             tls->size);
+    if (num_elements <= tls->size) {
+      for (int i = 0; i < num_elements; i++) {
+        tls->vertex_indices[i] = data->manifold_vertex_coarse_index[tls->vertex_indices[i]];
+      }
+      return num_elements;
+    }
+    MEM_freeN(tls->vertex_indices);
+    MEM_freeN(tls->weights);
+    tls->size = num_elements;
+    tls->vertex_indices = MEM_malloc_arrayN(tls->size, sizeof(int), __func__);
+    tls->weights = MEM_malloc_arrayN(tls->size, sizeof(float), __func__);
+  }
+}
+
+static void deform_cache_stencil_size_task(void *__restrict userdata,
+                                           const int subdiv_vertex_index,
+                                           const TaskParallelTLS *__restrict tls)
+{
+  const DeformCacheStencilsData *data = userdata;
+  const int num_elements = deform_cache_vertex_stencil_calc(
+      data, tls->userdata_chunk, subdiv_vertex_index);
+  data->cache->stencil_offsets[subdiv_vertex_index + 1] = num_elements;
+}
+
+static void deform_cache_stencil_fill_task(void *__restrict userdata,
+                                           const int subdiv_vertex_index,
+                                           const TaskParallelTLS *__restrict tls)
+{
+  const DeformCacheStencilsData *data = userdata;
+  DeformCacheStencilsTLS *stencil_tls = tls->userdata_chunk;
+  SubdivMeshDeformCache *cache = data->cache;
+  const int num_elements = deform_cache_vertex_stencil_calc(
+      data, stencil_tls, subdiv_vertex_index);
+  const int offset = cache->stencil_offsets[subdiv_vertex_index];
+  BLI_assert(offset + num_elements == cache->stencil_offsets[subdiv_vertex_index + 1]);
+  memcpy(&cache->stencil_vertex_indices[offset],
+         stencil_tls->vertex_indices,
+         sizeof(int) * num_elements);
+  memcpy(&cache->stencil_weights[offset], stencil_tls->weights, sizeof(float) * num_elements);
+}
+
+static void deform_cache_stencil_tls_free(const void *__restrict UNUSED(userdata),
+                                          void *__restrict chunk)
+{
+  DeformCacheStencilsTLS *tls = chunk;
+  MEM_SAFE_FREE(tls->vertex_indices);
+  MEM_SAFE_FREE(tls->weights);
+}
+
+static void subdiv_mesh_deform_cache_stencils_build(SubdivMeshDeformCache *cache,
+                                                    Subdiv *subdiv,
+                                                    const Mesh *coarse_mesh,
+                                                    const SubdivVertexSource *vertex_sources)
+{
+  const int num_vertices = cache->mesh->totvert;
+  DeformCacheStencilsData data;
+  data.subdiv = subdiv;
+  data.vertex_sources = vertex_sources;
+  data.manifold_vertex_coarse_index = manifold_vertex_coarse_index_get(coarse_mesh);
+  data.cache = cache;
+  DeformCacheStencilsTLS tls = {NULL};
+  TaskParallelSettings parallel_range_settings;
+  BLI_parallel_range_settings_defaults(&parallel_range_settings);
+  parallel_range_settings.min_iter_per_thread = 1024;
+  parallel_range_settings.userdata_chunk = &tls;
+  parallel_range_settings.userdata_chunk_size = sizeof(tls);
+  parallel_range_settings.func_free = deform_cache_stencil_tls_free;
+  /* Stencil sizes are not known in advance: calculate them first, and fill in the stencils once
+   * the storage is allocated. */
+  cache->stencil_offsets = MEM_malloc_arrayN(
+      num_vertices + 1, sizeof(int), "subdiv deform cache offsets");
+  cache->stencil_offsets[0] = 0;
+  BLI_task_parallel_range(
+      0, num_vertices, &data, deform_cache_stencil_size_task, &parallel_range_settings);
+  for (int i = 0; i < num_vertices; i++) {
+    cache->stencil_offsets[i + 1] += cache->stencil_offsets[i];
+  }
+  const int num_elements = cache->stencil_offsets[num_vertices];
+  cache->stencil_vertex_indices = MEM_malloc_arrayN(
+      num_elements, sizeof(int), "subdiv deform cache indices");
+  cache->stencil_weights = MEM_malloc_arrayN(
+      num_elements, sizeof(float), "subdiv deform cache weights");
+  BLI_task_parallel_range(
+      0, num_vertices, &data, deform_cache_stencil_fill_task, &parallel_range_settings);
+  MEM_freeN((void *)data.manifold_vertex_coarse_index);
+}
+
+typedef struct DeformCacheApplyData {
+  const SubdivMeshDeformCache *cache;
+  const MVert *coarse_mvert;
+  MVert *subdiv_mvert;
+} DeformCacheApplyData;
+
+static void deform_cache_apply_task(void *__restrict userdata,
+                                    const int subdiv_vertex_index,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const DeformCacheApplyData *data = userdata;
+  const SubdivMeshDeformCache *cache = data->cache;
+  const int *vertex_indices = cache->stencil_vertex_indices;
+  const float *weights = cache->stencil_weights;
+  float co[3] = {0.0f, 0.0f, 0.0f};
+  for (int i = cache->stencil_offsets[subdiv_vertex_index];
+       i < cache->stencil_offsets[subdiv_vertex_index + 1];
+       i++) {
+    madd_v3_v3fl(co, data->coarse_mvert[vertex_indices[i]].co, weights[i]);
+  }
+  copy_v3_v3(data->subdiv_mvert[subdiv_vertex_index].co, co);
+}
+
+static Mesh *subdiv_mesh_deform_cache_apply(const SubdivMeshDeformCache *cache,
+                                            const Mesh *coarse_mesh)
+{
+  Mesh *result = BKE_mesh_copy_for_eval(cache->mesh, false);
+  DeformCacheApplyData data;
+  data.cache = cache;
+  data.coarse_mvert = coarse_mesh->mvert;
+  data.subdiv_mvert = result->mvert;
+  TaskParallelSettings parallel_range_settings;
+  BLI_parallel_range_settings_defaults(&parallel_range_settings);
+  parallel_range_settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(
+      0, result->totvert, &data, deform_cache_apply_task, &parallel_range_settings);
+  result->runtime.cd_dirty_vert |= CD_MASK_NORMAL;
+  return result;
+}
+
+void BKE_subdiv_mesh_deform_cache_free(Subdiv *subdiv)
+{
+  if (subdiv->cache_.mesh_deform_cache != NULL) {
+    subdiv_mesh_deform_cache_free(subdiv->cache_.mesh_deform_cache);
+    subdiv->cache_.mesh_deform_cache = NULL;
+  }
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Public entry point
+ * \{ */
+
+Mesh *BKE_subdiv_to_mesh(Subdiv *subdiv,
+                         const SubdivToMeshSettings *settings,
+                         const Mesh *coarse_mesh)
+{
+  return subdiv_to_mesh_ex(subdiv, settings, coarse_mesh, NULL);
+}
+
+Mesh *BKE_subdiv_to_mesh_deform_cached(Subdiv *subdiv,
+                                       const SubdivToMeshSettings *settings,
+                                       const Mesh *coarse_mesh)
+{
+  if (subdiv->displacement_evaluator != NULL) {
+    /* Displacement is not linear in coarse positions, can not be expressed by stencils. */
+    BKE_subdiv_mesh_deform_cache_free(subdiv);
+    return BKE_subdiv_to_mesh(subdiv, settings, coarse_mesh);
+  }
+  SubdivMeshDeformCache *cache = subdiv->cache_.mesh_deform_cache;
+  if (cache != NULL && subdiv_mesh_deform_cache_is_valid(cache, settings, coarse_mesh)) {
+    BKE_subdiv_stats_begin(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH);
+    Mesh *result = subdiv_mesh_deform_cache_apply(cache, coarse_mesh);
+    BKE_subdiv_stats_end(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH);
+    return result;
+  }
+  BKE_subdiv_mesh_deform_cache_free(subdiv);
+  /* Full subdivision, which also gives information needed for the stencils. */
+  SubdivVertexSource *vertex_sources = NULL;
+  Mesh *result = subdiv_to_mesh_ex(subdiv, settings, coarse_mesh, &vertex_sources);
+  if (result == NULL) {
+    MEM_SAFE_FREE(vertex_sources);
+    return NULL;
+  }
+  cache = MEM_callocN(sizeof(*cache), "subdiv mesh deform cache");
+  cache->settings = *settings;
+  cache->coarse_totvert = coarse_mesh->totvert;
+  cache->coarse_totedge = coarse_mesh->totedge;
+  cache->coarse_totloop = coarse_mesh->totloop;
+  cache->coarse_totpoly = coarse_mesh->totpoly;
+  cache->coarse_hash = subdiv_mesh_deform_cache_coarse_hash(coarse_mesh);
+  cache->mesh = BKE_mesh_copy_for_eval(result, false);
+  subdiv_mesh_deform_cache_stencils_build(cache, subdiv, coarse_mesh, vertex_sources);
+  MEM_freeN(vertex_sources);
+  subdiv->cache_.mesh_deform_cache = cache;
+  return result;
+}
+
+/** \} */
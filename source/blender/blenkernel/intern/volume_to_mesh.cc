@@ -18,6 +18,7 @@
 
 #include "BLI_float3.hh"
 #include "BLI_span.hh"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 
 #include "DNA_mesh_types.h"
@@ -115,9 +116,12 @@ struct VolumeToMeshOp {
 
     /* Better align generated mesh with volume (see T85312). */
     openvdb::Vec3s offset = grid.voxelSize() / 2.0f;
-    for (openvdb::Vec3s &position : this->verts) {
-      position += offset;
-    }
+    MutableSpan<openvdb::Vec3s> verts(this->verts.data(), this->verts.size());
+    threading::parallel_for(verts.index_range(), 4096, [&](IndexRange range) {
+      for (const int i : range) {
+        verts[i] += offset;
+      }
+    });
   }
 };
 
@@ -131,32 +135,38 @@ static Mesh *new_mesh_from_openvdb_data(Span<openvdb::Vec3s> verts,
   Mesh *mesh = BKE_mesh_new_nomain(verts.size(), 0, 0, tot_loops, tot_polys);
 
   /* Write vertices. */
-  for (const int i : verts.index_range()) {
-    const blender::float3 co = blender::float3(verts[i].asV());
-    copy_v3_v3(mesh->mvert[i].co, co);
-  }
+  threading::parallel_for(verts.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      const blender::float3 co = blender::float3(verts[i].asV());
+      copy_v3_v3(mesh->mvert[i].co, co);
+    }
+  });
 
   /* Write triangles. */
-  for (const int i : tris.index_range()) {
-    mesh->mpoly[i].loopstart = 3 * i;
-    mesh->mpoly[i].totloop = 3;
-    for (int j = 0; j < 3; j++) {
-      /* Reverse vertex order to get correct normals. */
-      mesh->mloop[3 * i + j].v = tris[i][2 - j];
+  threading::parallel_for(tris.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      mesh->mpoly[i].loopstart = 3 * i;
+      mesh->mpoly[i].totloop = 3;
+      for (int j = 0; j < 3; j++) {
+        /* Reverse vertex order to get correct normals. */
+        mesh->mloop[3 * i + j].v = tris[i][2 - j];
+      }
     }
-  }
+  });
 
   /* Write quads. */
   const int poly_offset = tris.size();
   const int loop_offset = tris.size() * 3;
-  for (const int i : quads.index_range()) {
-    mesh->mpoly[poly_offset + i].loopstart = loop_offset + 4 * i;
-    mesh->mpoly[poly_offset + i].totloop = 4;
-    for (int j = 0; j < 4; j++) {
-      /* Reverse vertex order to get correct normals. */
-      mesh->mloop[loop_offset + 4 * i + j].v = quads[i][3 - j];
+  threading::parallel_for(quads.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      mesh->mpoly[poly_offset + i].loopstart = loop_offset + 4 * i;
+      mesh->mpoly[poly_offset + i].totloop = 4;
+      for (int j = 0; j < 4; j++) {
+        /* Reverse vertex order to get correct normals. */
+        mesh->mloop[loop_offset + 4 * i + j].v = quads[i][3 - j];
+      }
     }
-  }
+  });
 
   BKE_mesh_calc_edges(mesh, false, false);
   BKE_mesh_calc_normals(mesh);
@@ -81,9 +81,11 @@
 #include "BLI_alloca.h"
 #include "BLI_listbase.h"
 #include "BLI_math_vector.h"
+#include "BLI_task.h"
 
 #include "BKE_customdata.h"
 #include "BKE_mesh.h"
+#include "BKE_mesh_mapping.h"
 #include "BKE_mesh_runtime.h"
 #include "BKE_multires.h"
 
@@ -160,22 +162,309 @@ char BM_mesh_cd_flag_from_bmesh(BMesh *bm)
   return cd_flag;
 }
 
-/* Static function for alloc (duplicate in modifiers_bmesh.c) */
-static BMFace *bm_face_create_from_mpoly(
-    MPoly *mp, MLoop *ml, BMesh *bm, BMVert **vtable, BMEdge **etable)
+/* -------------------------------------------------------------------- */
+/** \name Mesh -> BMesh Threaded Element Creation
+ *
+ * Elements are allocated from the #BMesh memory pools in a single serial pass,
+ * in the same order #BM_vert_create, #BM_edge_create & #BM_face_create would allocate them.
+ * Initializing the elements, copying their custom-data and linking the disk and radial cycles
+ * is done in parallel, the cycles are linked in the order the elements were created in,
+ * so the result is identical to creating the elements one at a time.
+ * \{ */
+
+typedef struct BMFromMeshData {
+  BMesh *bm;
+  const Mesh *me;
+
+  const float (*keyco)[3];
+  const float (**shape_key_table)[3];
+  int tot_shape_keys;
+  bool calc_face_normal;
+
+  int cd_vert_bweight_offset;
+  int cd_edge_bweight_offset;
+  int cd_edge_crease_offset;
+  int cd_shape_key_offset;
+  int cd_shape_keyindex_offset;
+
+  BMVert **vtable;
+  BMEdge **etable;
+  /** Faces by polygon index, NULL for polygons that were skipped. */
+  BMFace **ftable;
+  /** Loops in the order they were created, matching their index. */
+  BMLoop **ltable;
+
+  /** Edges of each vertex in the order they were created in (for the disk cycles). */
+  MeshElemMap *vert_edge_map;
+  /** Loops of each edge in the order they were created in (for the radial cycles). */
+  int *edge_loop_offsets;
+  BMLoop **edge_loops;
+} BMFromMeshData;
+
+/**
+ * Allocate all elements, their tool-flags and custom-data blocks, assigning indices.
+ * Members are initialized by the threaded functions below.
+ *
+ * \return The number of loops created (polygons without loops are skipped).
+ */
+static int bm_from_me_elements_alloc(BMFromMeshData *data)
 {
-  BMVert **verts = BLI_array_alloca(verts, mp->totloop);
-  BMEdge **edges = BLI_array_alloca(edges, mp->totloop);
-  int j;
+  BMesh *bm = data->bm;
+  const Mesh *me = data->me;
+
+  for (int i = 0; i < me->totvert; i++) {
+    BMVert *v = BLI_mempool_alloc(bm->vpool);
+    if (bm->use_toolflags) {
+      ((BMVert_OFlag *)v)->oflags = bm->vtoolflagpool ? BLI_mempool_calloc(bm->vtoolflagpool) :
+                                                        NULL;
+    }
+    v->head.data = bm->vdata.totsize ? BLI_mempool_alloc(bm->vdata.pool) : NULL;
+    BM_elem_index_set(v, i); /* set_ok */
+    data->vtable[i] = v;
+  }
 
-  for (j = 0; j < mp->totloop; j++, ml++) {
-    verts[j] = vtable[ml->v];
-    edges[j] = etable[ml->e];
+  for (int i = 0; i < me->totedge; i++) {
+    BMEdge *e = BLI_mempool_alloc(bm->epool);
+    if (bm->use_toolflags) {
+      ((BMEdge_OFlag *)e)->oflags = bm->etoolflagpool ? BLI_mempool_calloc(bm->etoolflagpool) :
+                                                        NULL;
+    }
+    e->head.data = bm->edata.totsize ? BLI_mempool_alloc(bm->edata.pool) : NULL;
+    BM_elem_index_set(e, i); /* set_ok */
+    data->etable[i] = e;
+  }
+
+  /* Count the loops using each edge, used as offsets into `edge_loops` once accumulated. */
+  int *edge_loop_offsets = data->edge_loop_offsets;
+  const MPoly *mp = me->mpoly;
+  int totloops = 0;
+  for (int i = 0; i < me->totpoly; i++, mp++) {
+    const MLoop *ml = &me->mloop[mp->loopstart];
+    for (int j = 0; j < mp->totloop; j++) {
+      edge_loop_offsets[ml[j].e + 1]++;
+    }
+    totloops += mp->totloop;
+  }
+  for (int i = 0; i < me->totedge; i++) {
+    edge_loop_offsets[i + 1] += edge_loop_offsets[i];
   }
 
-  return BM_face_create(bm, verts, edges, mp->totloop, NULL, BM_CREATE_SKIP_CD);
+  data->ltable = MEM_mallocN(sizeof(*data->ltable) * (size_t)max_ii(totloops, 1), __func__);
+  data->edge_loops = MEM_mallocN(sizeof(*data->edge_loops) * (size_t)max_ii(totloops, 1),
+                                 __func__);
+  int *edge_loop_fill = MEM_dupallocN(edge_loop_offsets);
+
+  const int totface_prev = bm->totface;
+  mp = me->mpoly;
+  totloops = 0;
+  for (int i = 0; i < me->totpoly; i++, mp++) {
+    if (UNLIKELY(mp->totloop == 0)) {
+      printf(
+          "%s: Warning! Bad face in mesh"
+          " \"%s\" at index %d!, skipping\n",
+          __func__,
+          me->id.name + 2,
+          i);
+      data->ftable[i] = NULL;
+      continue;
+    }
+
+    BMFace *f = BLI_mempool_alloc(bm->fpool);
+    if (bm->use_toolflags) {
+      ((BMFace_OFlag *)f)->oflags = bm->ftoolflagpool ? BLI_mempool_calloc(bm->ftoolflagpool) :
+                                                        NULL;
+    }
+
+    const MLoop *ml = &me->mloop[mp->loopstart];
+    BMLoop **loops = &data->ltable[totloops];
+    for (int j = 0; j < mp->totloop; j++) {
+      BMLoop *l = BLI_mempool_alloc(bm->lpool);
+      /* Don't use the #MLoop index since we may have skipped some faces, hence some loops. */
+      BM_elem_index_set(l, totloops++); /* set_ok */
+      data->edge_loops[edge_loop_fill[ml[j].e]++] = l;
+      loops[j] = l;
+    }
+    for (int j = 0; j < mp->totloop; j++) {
+      loops[j]->head.data = bm->ldata.totsize ? BLI_mempool_alloc(bm->ldata.pool) : NULL;
+    }
+    f->head.data = bm->pdata.totsize ? BLI_mempool_alloc(bm->pdata.pool) : NULL;
+
+    /* Used by #bm_from_me_face_fn to find the loops of this face. */
+    f->l_first = loops[0];
+    f->len = mp->totloop;
+
+    /* Don't use 'i' since we may have skipped the face. */
+    BM_elem_index_set(f, bm->totface++); /* set_ok */
+    data->ftable[i] = f;
+  }
+
+  MEM_freeN(edge_loop_fill);
+
+  bm->totvert += me->totvert;
+  bm->totedge += me->totedge;
+  bm->totloop += totloops;
+
+  /* May add to middle of the pool. */
+  bm->elem_index_dirty |= BM_VERT | (me->totedge ? BM_EDGE : 0) |
+                          (bm->totface != totface_prev ? BM_FACE : 0) | (totloops ? BM_LOOP : 0);
+  bm->elem_table_dirty |= BM_VERT | (me->totedge ? BM_EDGE : 0) |
+                          (bm->totface != totface_prev ? BM_FACE : 0);
+  bm->spacearr_dirty |= BM_SPACEARR_DIRTY_ALL;
+
+  return totloops;
+}
+
+static void bm_from_me_vert_fn(void *__restrict userdata,
+                               const int i,
+                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BMFromMeshData *data = userdata;
+  BMesh *bm = data->bm;
+  const Mesh *me = data->me;
+  const MVert *mvert = &me->mvert[i];
+  BMVert *v = data->vtable[i];
+
+  v->head.htype = BM_VERT;
+  /* Transfer flag, selection is applied afterwards so selection counts work properly. */
+  v->head.hflag = BM_vert_flag_from_mflag(mvert->flag & ~SELECT);
+  v->head.api_flag = 0;
+
+  copy_v3_v3(v->co, data->keyco ? data->keyco[i] : mvert->co);
+  normal_short_to_float_v3(v->no, mvert->no);
+  v->e = NULL;
+
+  /* Copy Custom Data */
+  CustomData_to_bmesh_block(&me->vdata, &bm->vdata, i, &v->head.data, true);
+
+  if (data->cd_vert_bweight_offset != -1) {
+    BM_ELEM_CD_SET_FLOAT(v, data->cd_vert_bweight_offset, (float)mvert->bweight / 255.0f);
+  }
+
+  /* Set shape key original index. */
+  if (data->cd_shape_keyindex_offset != -1) {
+    BM_ELEM_CD_SET_INT(v, data->cd_shape_keyindex_offset, i);
+  }
+
+  /* Set shape-key data. */
+  if (data->tot_shape_keys) {
+    float(*co_dst)[3] = BM_ELEM_CD_GET_VOID_P(v, data->cd_shape_key_offset);
+    for (int j = 0; j < data->tot_shape_keys; j++, co_dst++) {
+      copy_v3_v3(*co_dst, data->shape_key_table[j][i]);
+    }
+  }
 }
 
+static void bm_from_me_edge_fn(void *__restrict userdata,
+                               const int i,
+                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BMFromMeshData *data = userdata;
+  BMesh *bm = data->bm;
+  const Mesh *me = data->me;
+  const MEdge *medge = &me->medge[i];
+  BMEdge *e = data->etable[i];
+
+  e->head.htype = BM_EDGE;
+  /* Transfer flags, selection is applied afterwards so selection counts work properly. */
+  e->head.hflag = BM_edge_flag_from_mflag(medge->flag & ~SELECT);
+  e->head.api_flag = 0;
+
+  e->v1 = data->vtable[medge->v1];
+  e->v2 = data->vtable[medge->v2];
+  e->l = NULL;
+  memset(&e->v1_disk_link, 0, sizeof(BMDiskLink[2]));
+
+  /* Copy Custom Data */
+  CustomData_to_bmesh_block(&me->edata, &bm->edata, i, &e->head.data, true);
+
+  if (data->cd_edge_bweight_offset != -1) {
+    BM_ELEM_CD_SET_FLOAT(e, data->cd_edge_bweight_offset, (float)medge->bweight / 255.0f);
+  }
+  if (data->cd_edge_crease_offset != -1) {
+    BM_ELEM_CD_SET_FLOAT(e, data->cd_edge_crease_offset, (float)medge->crease / 255.0f);
+  }
+}
+
+static void bm_from_me_face_fn(void *__restrict userdata,
+                               const int i,
+                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BMFromMeshData *data = userdata;
+  BMesh *bm = data->bm;
+  const Mesh *me = data->me;
+  const MPoly *mp = &me->mpoly[i];
+  BMFace *f = data->ftable[i];
+
+  if (f == NULL) {
+    return;
+  }
+
+  f->head.htype = BM_FACE;
+  /* Transfer flag, selection is applied afterwards so selection counts work properly. */
+  f->head.hflag = BM_face_flag_from_mflag(mp->flag & ~ME_FACE_SEL);
+  f->head.api_flag = 0;
+  f->mat_nr = mp->mat_nr;
+  zero_v3(f->no);
+
+  const MLoop *ml = &me->mloop[mp->loopstart];
+  BMLoop **loops = &data->ltable[BM_elem_index_get(f->l_first)];
+  const int len = f->len;
+  for (int j = 0; j < len; j++) {
+    BMLoop *l = loops[j];
+    l->head.htype = BM_LOOP;
+    l->head.hflag = 0;
+    l->head.api_flag = 0;
+
+    l->v = data->vtable[ml[j].v];
+    l->e = data->etable[ml[j].e];
+    l->f = f;
+    l->next = loops[(j + 1) % len];
+    l->prev = loops[(j + len - 1) % len];
+    /* Linked by #bm_from_me_radial_fn. */
+    l->radial_next = NULL;
+    l->radial_prev = NULL;
+
+    CustomData_to_bmesh_block(&me->ldata, &bm->ldata, mp->loopstart + j, &l->head.data, true);
+  }
+
+  /* Copy Custom Data */
+  CustomData_to_bmesh_block(&me->pdata, &bm->pdata, i, &f->head.data, true);
+
+  if (data->calc_face_normal) {
+    BM_face_normal_update(f);
+  }
+}
+
+/**
+ * Link the disk cycle of each vertex, only touching the links of this vertex.
+ */
+static void bm_from_me_disk_fn(void *__restrict userdata,
+                               const int i,
+                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BMFromMeshData *data = userdata;
+  const MeshElemMap *vert_edges = &data->vert_edge_map[i];
+  BMVert *v = data->vtable[i];
+
+  for (int j = 0; j < vert_edges->count; j++) {
+    bmesh_disk_edge_append(data->etable[vert_edges->indices[j]], v);
+  }
+}
+
+static void bm_from_me_radial_fn(void *__restrict userdata,
+                                 const int i,
+                                 const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BMFromMeshData *data = userdata;
+  BMEdge *e = data->etable[i];
+
+  for (int j = data->edge_loop_offsets[i]; j < data->edge_loop_offsets[i + 1]; j++) {
+    bmesh_radial_loop_append(e, data->edge_loops[j]);
+  }
+}
+
+/** \} */
+
 /**
  * \brief Mesh -> BMesh
  * \param bm: The mesh to write into, while this is typically a newly created BMesh,
@@ -190,16 +479,15 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *me, const struct BMeshFromMeshPar
 {
   const bool is_new = !(bm->totvert || (bm->vdata.totlayer || bm->edata.totlayer ||
                                         bm->pdata.totlayer || bm->ldata.totlayer));
-  MVert *mvert;
-  MEdge *medge;
-  MLoop *mloop;
-  MPoly *mp;
+  const MVert *mvert;
+  const MEdge *medge;
+  const MPoly *mp;
   KeyBlock *actkey, *block;
-  BMVert *v, **vtable = NULL;
-  BMEdge *e, **etable = NULL;
+  BMVert **vtable = NULL;
+  BMEdge **etable = NULL;
   BMFace *f, **ftable = NULL;
   float(*keyco)[3] = NULL;
-  int totloops, i;
+  int i;
   CustomData_MeshMasks mask = CD_MASK_BMESH;
   CustomData_MeshMasks_update(&mask, &params->cd_mask_extra);
 
@@ -321,146 +609,89 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *me, const struct BMeshFromMeshPar
     BM_mesh_cd_flag_apply(bm, me->cd_flag);
   }
 
-  const int cd_vert_bweight_offset = CustomData_get_offset(&bm->vdata, CD_BWEIGHT);
-  const int cd_edge_bweight_offset = CustomData_get_offset(&bm->edata, CD_BWEIGHT);
-  const int cd_edge_crease_offset = CustomData_get_offset(&bm->edata, CD_CREASE);
-  const int cd_shape_key_offset = tot_shape_keys ? CustomData_get_offset(&bm->vdata, CD_SHAPEKEY) :
-                                                   -1;
-  const int cd_shape_keyindex_offset = is_new && (tot_shape_keys || params->add_key_index) ?
-                                           CustomData_get_offset(&bm->vdata, CD_SHAPE_KEYINDEX) :
-                                           -1;
+  BMFromMeshData data = {
+      .bm = bm,
+      .me = me,
+      .keyco = (const float(*)[3])keyco,
+      .shape_key_table = shape_key_table,
+      .tot_shape_keys = tot_shape_keys,
+      .calc_face_normal = params->calc_face_normal,
+      .cd_vert_bweight_offset = CustomData_get_offset(&bm->vdata, CD_BWEIGHT),
+      .cd_edge_bweight_offset = CustomData_get_offset(&bm->edata, CD_BWEIGHT),
+      .cd_edge_crease_offset = CustomData_get_offset(&bm->edata, CD_CREASE),
+      .cd_shape_key_offset = tot_shape_keys ? CustomData_get_offset(&bm->vdata, CD_SHAPEKEY) : -1,
+      .cd_shape_keyindex_offset = is_new && (tot_shape_keys || params->add_key_index) ?
+                                      CustomData_get_offset(&bm->vdata, CD_SHAPE_KEYINDEX) :
+                                      -1,
+  };
 
   vtable = MEM_mallocN(sizeof(BMVert **) * me->totvert, __func__);
+  etable = MEM_mallocN(sizeof(BMEdge **) * max_ii(me->totedge, 1), __func__);
+  ftable = MEM_mallocN(sizeof(BMFace **) * max_ii(me->totpoly, 1), __func__);
+  data.vtable = vtable;
+  data.etable = etable;
+  data.ftable = ftable;
+  data.edge_loop_offsets = MEM_callocN(sizeof(int) * (me->totedge + 1), __func__);
 
-  for (i = 0, mvert = me->mvert; i < me->totvert; i++, mvert++) {
-    v = vtable[i] = BM_vert_create(bm, keyco ? keyco[i] : mvert->co, NULL, BM_CREATE_SKIP_CD);
-    BM_elem_index_set(v, i); /* set_ok */
-
-    /* Transfer flag. */
-    v->head.hflag = BM_vert_flag_from_mflag(mvert->flag & ~SELECT);
-
-    /* This is necessary for selection counts to work properly. */
-    if (mvert->flag & SELECT) {
-      BM_vert_select_set(bm, v, true);
-    }
+  int *vert_edge_mem;
+  BKE_mesh_vert_edge_map_create(
+      &data.vert_edge_map, &vert_edge_mem, me->medge, me->totvert, me->totedge);
 
-    normal_short_to_float_v3(v->no, mvert->no);
+  const int totloops = bm_from_me_elements_alloc(&data);
 
-    /* Copy Custom Data */
-    CustomData_to_bmesh_block(&me->vdata, &bm->vdata, i, &v->head.data, true);
-
-    if (cd_vert_bweight_offset != -1) {
-      BM_ELEM_CD_SET_FLOAT(v, cd_vert_bweight_offset, (float)mvert->bweight / 255.0f);
-    }
-
-    /* Set shape key original index. */
-    if (cd_shape_keyindex_offset != -1) {
-      BM_ELEM_CD_SET_INT(v, cd_shape_keyindex_offset, i);
-    }
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
 
-    /* Set shape-key data. */
-    if (tot_shape_keys) {
-      float(*co_dst)[3] = BM_ELEM_CD_GET_VOID_P(v, cd_shape_key_offset);
-      for (int j = 0; j < tot_shape_keys; j++, co_dst++) {
-        copy_v3_v3(*co_dst, shape_key_table[j][i]);
-      }
-    }
-  }
-  if (is_new) {
-    bm->elem_index_dirty &= ~BM_VERT; /* Added in order, clear dirty flag. */
-  }
+  settings.use_threading = me->totvert >= BM_OMP_LIMIT;
+  BLI_task_parallel_range(0, me->totvert, &data, bm_from_me_vert_fn, &settings);
 
-  etable = MEM_mallocN(sizeof(BMEdge **) * me->totedge, __func__);
+  settings.use_threading = me->totedge >= BM_OMP_LIMIT;
+  BLI_task_parallel_range(0, me->totedge, &data, bm_from_me_edge_fn, &settings);
 
-  medge = me->medge;
-  for (i = 0; i < me->totedge; i++, medge++) {
-    e = etable[i] = BM_edge_create(
-        bm, vtable[medge->v1], vtable[medge->v2], NULL, BM_CREATE_SKIP_CD);
-    BM_elem_index_set(e, i); /* set_ok */
+  /* Vertex coordinates must be set for face normals. */
+  settings.use_threading = totloops >= BM_OMP_LIMIT;
+  BLI_task_parallel_range(0, me->totpoly, &data, bm_from_me_face_fn, &settings);
 
-    /* Transfer flags. */
-    e->head.hflag = BM_edge_flag_from_mflag(medge->flag & ~SELECT);
+  settings.use_threading = me->totvert >= BM_OMP_LIMIT;
+  BLI_task_parallel_range(0, me->totvert, &data, bm_from_me_disk_fn, &settings);
 
-    /* This is necessary for selection counts to work properly. */
-    if (medge->flag & SELECT) {
-      BM_edge_select_set(bm, e, true);
-    }
+  settings.use_threading = me->totedge >= BM_OMP_LIMIT;
+  BLI_task_parallel_range(0, me->totedge, &data, bm_from_me_radial_fn, &settings);
 
-    /* Copy Custom Data */
-    CustomData_to_bmesh_block(&me->edata, &bm->edata, i, &e->head.data, true);
+  MEM_freeN(data.vert_edge_map);
+  MEM_freeN(vert_edge_mem);
+  MEM_freeN(data.edge_loop_offsets);
+  MEM_freeN(data.edge_loops);
+  MEM_freeN(data.ltable);
 
-    if (cd_edge_bweight_offset != -1) {
-      BM_ELEM_CD_SET_FLOAT(e, cd_edge_bweight_offset, (float)medge->bweight / 255.0f);
-    }
-    if (cd_edge_crease_offset != -1) {
-      BM_ELEM_CD_SET_FLOAT(e, cd_edge_crease_offset, (float)medge->crease / 255.0f);
-    }
-  }
   if (is_new) {
-    bm->elem_index_dirty &= ~BM_EDGE; /* Added in order, clear dirty flag. */
+    /* Added in order, clear dirty flag. */
+    bm->elem_index_dirty &= ~(BM_VERT | BM_EDGE | BM_FACE | BM_LOOP);
   }
 
-  /* Only needed for selection. */
-  if (me->mselect && me->totselect != 0) {
-    ftable = MEM_mallocN(sizeof(BMFace **) * me->totpoly, __func__);
+  /* Selection changes flags of connected elements and updates selection counts,
+   * so it's applied once all elements have been created. */
+  for (i = 0, mvert = me->mvert; i < me->totvert; i++, mvert++) {
+    if (mvert->flag & SELECT) {
+      BM_vert_select_set(bm, vtable[i], true);
+    }
   }
-
-  mloop = me->mloop;
-  mp = me->mpoly;
-  for (i = 0, totloops = 0; i < me->totpoly; i++, mp++) {
-    BMLoop *l_iter;
-    BMLoop *l_first;
-
-    f = bm_face_create_from_mpoly(mp, mloop + mp->loopstart, bm, vtable, etable);
-    if (ftable != NULL) {
-      ftable[i] = f;
+  for (i = 0, medge = me->medge; i < me->totedge; i++, medge++) {
+    if (medge->flag & SELECT) {
+      BM_edge_select_set(bm, etable[i], true);
     }
-
-    if (UNLIKELY(f == NULL)) {
-      printf(
-          "%s: Warning! Bad face in mesh"
-          " \"%s\" at index %d!, skipping\n",
-          __func__,
-          me->id.name + 2,
-          i);
+  }
+  for (i = 0, mp = me->mpoly; i < me->totpoly; i++, mp++) {
+    f = ftable[i];
+    if (f == NULL) {
       continue;
     }
-
-    /* Don't use 'i' since we may have skipped the face. */
-    BM_elem_index_set(f, bm->totface - 1); /* set_ok */
-
-    /* Transfer flag. */
-    f->head.hflag = BM_face_flag_from_mflag(mp->flag & ~ME_FACE_SEL);
-
-    /* This is necessary for selection counts to work properly. */
     if (mp->flag & ME_FACE_SEL) {
       BM_face_select_set(bm, f, true);
     }
-
-    f->mat_nr = mp->mat_nr;
     if (i == me->act_face) {
       bm->act_face = f;
     }
-
-    int j = mp->loopstart;
-    l_iter = l_first = BM_FACE_FIRST_LOOP(f);
-    do {
-      /* Don't use 'j' since we may have skipped some faces, hence some loops. */
-      BM_elem_index_set(l_iter, totloops++); /* set_ok */
-
-      /* Save index of corresponding #MLoop. */
-      CustomData_to_bmesh_block(&me->ldata, &bm->ldata, j++, &l_iter->head.data, true);
-    } while ((l_iter = l_iter->next) != l_first);
-
-    /* Copy Custom Data */
-    CustomData_to_bmesh_block(&me->pdata, &bm->pdata, i, &f->head.data, true);
-
-    if (params->calc_face_normal) {
-      BM_face_normal_update(f);
-    }
-  }
-  if (is_new) {
-    bm->elem_index_dirty &= ~(BM_FACE | BM_LOOP); /* Added in order, clear dirty flag. */
   }
 
   /* -------------------------------------------------------------------- */
@@ -499,9 +730,7 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *me, const struct BMeshFromMeshPar
 
   MEM_freeN(vtable);
   MEM_freeN(etable);
-  if (ftable) {
-    MEM_freeN(ftable);
-  }
+  MEM_freeN(ftable);
 }
 
 /**
@@ -582,16 +811,125 @@ BLI_INLINE void bmesh_quick_edgedraw_flag(MEdge *med, BMEdge *e)
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name BMesh -> Mesh Threaded Element Copy
+ * \{ */
+
+typedef struct BMToMeshData {
+  BMesh *bm;
+  Mesh *me;
+  MVert *mvert;
+  MEdge *medge;
+  MLoop *mloop;
+  MPoly *mpoly;
+
+  int cd_vert_bweight_offset;
+  int cd_edge_bweight_offset;
+  int cd_edge_crease_offset;
+} BMToMeshData;
+
+static void bm_to_me_vert_fn(void *__restrict userdata,
+                             const int i,
+                             const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BMToMeshData *data = userdata;
+  BMesh *bm = data->bm;
+  BMVert *v = bm->vtable[i];
+  MVert *mvert = &data->mvert[i];
+
+  copy_v3_v3(mvert->co, v->co);
+  normal_float_to_short_v3(mvert->no, v->no);
+
+  mvert->flag = BM_vert_flag_to_mflag(v);
+
+  /* Copy over custom-data. */
+  CustomData_from_bmesh_block(&bm->vdata, &data->me->vdata, v->head.data, i);
+
+  if (data->cd_vert_bweight_offset != -1) {
+    mvert->bweight = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(v, data->cd_vert_bweight_offset);
+  }
+
+  BM_CHECK_ELEMENT(v);
+}
+
+static void bm_to_me_edge_fn(void *__restrict userdata,
+                             const int i,
+                             const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BMToMeshData *data = userdata;
+  BMesh *bm = data->bm;
+  BMEdge *e = bm->etable[i];
+  MEdge *med = &data->medge[i];
+
+  med->v1 = BM_elem_index_get(e->v1);
+  med->v2 = BM_elem_index_get(e->v2);
+
+  med->flag = BM_edge_flag_to_mflag(e);
+
+  /* Copy over custom-data. */
+  CustomData_from_bmesh_block(&bm->edata, &data->me->edata, e->head.data, i);
+
+  bmesh_quick_edgedraw_flag(med, e);
+
+  if (data->cd_edge_crease_offset != -1) {
+    med->crease = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(e, data->cd_edge_crease_offset);
+  }
+  if (data->cd_edge_bweight_offset != -1) {
+    med->bweight = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(e, data->cd_edge_bweight_offset);
+  }
+
+  BM_CHECK_ELEMENT(e);
+}
+
+/**
+ * \note #MPoly.loopstart is expected to be set.
+ */
+static void bm_to_me_face_fn(void *__restrict userdata,
+                             const int i,
+                             const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BMToMeshData *data = userdata;
+  BMesh *bm = data->bm;
+  BMFace *f = bm->ftable[i];
+  MPoly *mpoly = &data->mpoly[i];
+  BMLoop *l_iter, *l_first;
+
+  mpoly->totloop = f->len;
+  mpoly->mat_nr = f->mat_nr;
+  mpoly->flag = BM_face_flag_to_mflag(f);
+
+  int j = mpoly->loopstart;
+  MLoop *mloop = &data->mloop[j];
+  l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+  do {
+    mloop->e = BM_elem_index_get(l_iter->e);
+    mloop->v = BM_elem_index_get(l_iter->v);
+
+    /* Copy over custom-data. */
+    CustomData_from_bmesh_block(&bm->ldata, &data->me->ldata, l_iter->head.data, j);
+
+    j++;
+    mloop++;
+    BM_CHECK_ELEMENT(l_iter);
+    BM_CHECK_ELEMENT(l_iter->e);
+    BM_CHECK_ELEMENT(l_iter->v);
+  } while ((l_iter = l_iter->next) != l_first);
+
+  /* Copy over custom-data. */
+  CustomData_from_bmesh_block(&bm->pdata, &data->me->pdata, f->head.data, i);
+
+  BM_CHECK_ELEMENT(f);
+}
+
+/** \} */
+
 /**
  *
  * \param bmain: May be NULL in case \a calc_object_remap parameter option is not set.
  */
 void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMeshParams *params)
 {
-  MEdge *med;
-  BMVert *v, *eve;
-  BMEdge *e;
-  BMFace *f;
+  BMVert *eve;
   BMIter iter;
   int i, j;
 
@@ -658,91 +996,42 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
   /* This is called again, 'dotess' arg is used there. */
   BKE_mesh_update_customdata_pointers(me, 0);
 
-  i = 0;
-  BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
-    copy_v3_v3(mvert->co, v->co);
-    normal_float_to_short_v3(mvert->no, v->no);
-
-    mvert->flag = BM_vert_flag_to_mflag(v);
-
-    BM_elem_index_set(v, i); /* set_inline */
-
-    /* Copy over custom-data. */
-    CustomData_from_bmesh_block(&bm->vdata, &me->vdata, v->head.data, i);
-
-    if (cd_vert_bweight_offset != -1) {
-      mvert->bweight = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(v, cd_vert_bweight_offset);
-    }
-
-    i++;
-    mvert++;
-
-    BM_CHECK_ELEMENT(v);
-  }
-  bm->elem_index_dirty &= ~BM_VERT;
-
-  med = medge;
-  i = 0;
-  BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
-    med->v1 = BM_elem_index_get(e->v1);
-    med->v2 = BM_elem_index_get(e->v2);
-
-    med->flag = BM_edge_flag_to_mflag(e);
-
-    BM_elem_index_set(e, i); /* set_inline */
-
-    /* Copy over custom-data. */
-    CustomData_from_bmesh_block(&bm->edata, &me->edata, e->head.data, i);
-
-    bmesh_quick_edgedraw_flag(med, e);
-
-    if (cd_edge_crease_offset != -1) {
-      med->crease = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(e, cd_edge_crease_offset);
-    }
-    if (cd_edge_bweight_offset != -1) {
-      med->bweight = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(e, cd_edge_bweight_offset);
-    }
+  /* Vertex and edge indices are used for the edges and loops. */
+  BM_mesh_elem_index_ensure(bm, BM_VERT | BM_EDGE | BM_FACE);
+  BM_mesh_elem_table_ensure(bm, BM_VERT | BM_EDGE | BM_FACE);
 
-    i++;
-    med++;
-    BM_CHECK_ELEMENT(e);
+  /* Loop offsets of the faces, needed to fill in the loops in parallel. */
+  for (i = 0, j = 0; i < bm->totface; i++) {
+    mpoly[i].loopstart = j;
+    j += bm->ftable[i]->len;
   }
-  bm->elem_index_dirty &= ~BM_EDGE;
 
-  i = 0;
-  j = 0;
-  BM_ITER_MESH (f, &iter, bm, BM_FACES_OF_MESH) {
-    BMLoop *l_iter, *l_first;
-    mpoly->loopstart = j;
-    mpoly->totloop = f->len;
-    mpoly->mat_nr = f->mat_nr;
-    mpoly->flag = BM_face_flag_to_mflag(f);
-
-    l_iter = l_first = BM_FACE_FIRST_LOOP(f);
-    do {
-      mloop->e = BM_elem_index_get(l_iter->e);
-      mloop->v = BM_elem_index_get(l_iter->v);
+  BMToMeshData data = {
+      .bm = bm,
+      .me = me,
+      .mvert = mvert,
+      .medge = medge,
+      .mloop = mloop,
+      .mpoly = mpoly,
+      .cd_vert_bweight_offset = cd_vert_bweight_offset,
+      .cd_edge_bweight_offset = cd_edge_bweight_offset,
+      .cd_edge_crease_offset = cd_edge_crease_offset,
+  };
 
-      /* Copy over custom-data. */
-      CustomData_from_bmesh_block(&bm->ldata, &me->ldata, l_iter->head.data, j);
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
 
-      j++;
-      mloop++;
-      BM_CHECK_ELEMENT(l_iter);
-      BM_CHECK_ELEMENT(l_iter->e);
-      BM_CHECK_ELEMENT(l_iter->v);
-    } while ((l_iter = l_iter->next) != l_first);
+  settings.use_threading = bm->totvert >= BM_OMP_LIMIT;
+  BLI_task_parallel_range(0, bm->totvert, &data, bm_to_me_vert_fn, &settings);
 
-    if (f == bm->act_face) {
-      me->act_face = i;
-    }
+  settings.use_threading = bm->totedge >= BM_OMP_LIMIT;
+  BLI_task_parallel_range(0, bm->totedge, &data, bm_to_me_edge_fn, &settings);
 
-    /* Copy over custom-data. */
-    CustomData_from_bmesh_block(&bm->pdata, &me->pdata, f->head.data, i);
+  settings.use_threading = bm->totloop >= BM_OMP_LIMIT;
+  BLI_task_parallel_range(0, bm->totface, &data, bm_to_me_face_fn, &settings);
 
-    i++;
-    mpoly++;
-    BM_CHECK_ELEMENT(f);
+  if (bm->act_face) {
+    me->act_face = BM_elem_index_get(bm->act_face);
   }
 
   /* Patch hook indices and vertex parents. */
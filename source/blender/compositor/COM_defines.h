@@ -113,6 +113,9 @@ constexpr float COM_PREVIEW_SIZE = 140.f;
 constexpr float COM_RULE_OF_THIRDS_DIVIDER = 100.0f;
 constexpr float COM_BLUR_BOKEH_PIXELS = 512;
 
+/** Memory limit of buffers kept between executions to avoid rendering unchanged operations. */
+constexpr size_t COM_BUFFERS_CACHE_MAX_MEMORY = 1024ull * 1024ull * 1024ull;
+
 constexpr IndexRange XRange(const rcti &area)
 {
   return IndexRange(area.xmin, area.xmax - area.xmin);
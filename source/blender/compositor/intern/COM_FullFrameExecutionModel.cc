@@ -23,6 +23,8 @@
 #include "COM_ViewerOperation.h"
 #include "COM_WorkScheduler.h"
 
+#include "BLI_hash_mm2a.h"
+
 #include "BLT_translation.h"
 
 #ifdef WITH_CXX_GUARDEDALLOC
@@ -36,7 +38,8 @@ FullFrameExecutionModel::FullFrameExecutionModel(CompositorContext &context,
                                                  Span<NodeOperation *> operations)
     : ExecutionModel(context, operations),
       active_buffers_(shared_buffers),
-      num_operations_finished_(0)
+      num_operations_finished_(0),
+      use_buffers_cache_(!context.isRendering())
 {
   priorities_.append(eCompositorPriority::High);
   if (!context.isFastCalculation()) {
@@ -52,8 +55,10 @@ void FullFrameExecutionModel::execute(ExecutionSystem &exec_system)
 
   DebugInfo::graphviz(&exec_system, "compositor_prior_rendering");
 
+  WorkScheduler::start(this->context_);
   determine_areas_to_render_and_reads();
   render_operations();
+  WorkScheduler::stop();
 }
 
 void FullFrameExecutionModel::determine_areas_to_render_and_reads()
@@ -68,12 +73,106 @@ void FullFrameExecutionModel::determine_areas_to_render_and_reads()
       if (op->isOutputOperation(is_rendering) && op->getRenderPriority() == priority) {
         get_output_render_area(op, area);
         determine_areas_to_render(op, area);
+      }
+    }
+  }
+
+  if (use_buffers_cache_) {
+    determine_cached_operations();
+  }
+
+  for (eCompositorPriority priority : priorities_) {
+    for (NodeOperation *op : operations_) {
+      if (op->isOutputOperation(is_rendering) && op->getRenderPriority() == priority) {
         determine_reads(op);
       }
     }
   }
 }
 
+/**
+ * Generates operations cache keys, finding which operations have their buffer cached from previous
+ * executions. Source operations are rendered first as their key is the hash of their buffer.
+ */
+void FullFrameExecutionModel::determine_cached_operations()
+{
+  Map<NodeOperation *, std::optional<size_t>> keys;
+  for (NodeOperation *op : operations_) {
+    const std::optional<size_t> key = generate_cache_key(op, keys);
+    if (key && op->getNumberOfInputSockets() > 0) {
+      active_buffers_.set_cache_key(op, *key);
+    }
+  }
+}
+
+/**
+ * Key of given operation output, derived from its parameters and the keys of its inputs. Returns
+ * nothing if any operation it depends on doesn't hash its parameters.
+ */
+std::optional<size_t> FullFrameExecutionModel::generate_cache_key(
+    NodeOperation *op, Map<NodeOperation *, std::optional<size_t>> &keys)
+{
+  if (const std::optional<size_t> *key = keys.lookup_ptr(op)) {
+    return *key;
+  }
+
+  std::optional<size_t> key;
+  if (op->getNumberOfOutputSockets() == 0 || active_buffers_.get_areas_to_render(op).is_empty()) {
+    key = std::nullopt;
+  }
+  else if (op->getNumberOfInputSockets() == 0) {
+    render_operation(op);
+    key = hash_rendered_buffer(op);
+  }
+  else {
+    key = op->generate_params_hash();
+    if (key) {
+      /* Some operations execute differently depending on context. */
+      *key = BLI_ghashutil_combine_hash(*key, static_cast<int>(context_.getQuality()));
+      *key = BLI_ghashutil_combine_hash(*key, context_.isFastCalculation());
+    }
+    for (int i = 0; key && i < op->getNumberOfInputSockets(); i++) {
+      const std::optional<size_t> input_key = generate_cache_key(op->get_input_operation(i), keys);
+      key = input_key ? std::optional<size_t>(BLI_ghashutil_combine_hash(*key, *input_key)) :
+                        std::nullopt;
+    }
+  }
+
+  keys.add_new(op, key);
+  return key;
+}
+
+/**
+ * Hashes the rendered areas of given operation buffer.
+ */
+size_t FullFrameExecutionModel::hash_rendered_buffer(NodeOperation *op)
+{
+  MemoryBuffer *buf = active_buffers_.get_rendered_buffer(op);
+  const int elem_size = buf->get_num_channels() * sizeof(float);
+
+  BLI_HashMurmur2A mm2;
+  BLI_hash_mm2a_init(&mm2, 0);
+  BLI_hash_mm2a_add_int(&mm2, buf->getWidth());
+  BLI_hash_mm2a_add_int(&mm2, buf->getHeight());
+  BLI_hash_mm2a_add_int(&mm2, buf->get_num_channels());
+  if (buf->is_a_single_elem()) {
+    BLI_hash_mm2a_add(&mm2, (const unsigned char *)buf->getBuffer(), elem_size);
+  }
+  else {
+    for (const rcti &area : active_buffers_.get_areas_to_render(op)) {
+      BLI_hash_mm2a_add(&mm2, (const unsigned char *)&area, sizeof(rcti));
+      const int row_size = BLI_rcti_size_x(&area) * elem_size;
+      for (const int y : YRange(area)) {
+        BLI_hash_mm2a_add(&mm2, (const unsigned char *)buf->get_elem(area.xmin, y), row_size);
+      }
+    }
+  }
+
+  /* Constant and non-constant buffers with the same value have different outputs. */
+  const bool is_constant = op->get_flags().is_constant_operation;
+  return BLI_ghashutil_combine_hash(BLI_hash_mm2a_end(&mm2), is_constant);
+}
+
 Vector<MemoryBuffer *> FullFrameExecutionModel::get_input_buffers(NodeOperation *op)
 {
   const int num_inputs = op->getNumberOfInputSockets();
@@ -97,6 +196,12 @@ MemoryBuffer *FullFrameExecutionModel::create_operation_buffer(NodeOperation *op
 
 void FullFrameExecutionModel::render_operation(NodeOperation *op)
 {
+  if (active_buffers_.is_operation_cached(op)) {
+    active_buffers_.set_cached_buffer(op);
+    operation_finished(op);
+    return;
+  }
+
   Vector<MemoryBuffer *> input_bufs = get_input_buffers(op);
 
   const bool has_outputs = op->getNumberOfOutputSockets() > 0;
@@ -110,6 +215,11 @@ void FullFrameExecutionModel::render_operation(NodeOperation *op)
    * TranslateOperation from convert resolutions if linked to an operation with resolution. */
   active_buffers_.set_rendered_buffer(op, std::unique_ptr<MemoryBuffer>(op_buf));
 
+  const bNodeTree *tree = context_.getbNodeTree();
+  if (use_buffers_cache_ && !tree->test_break(tree->tbh)) {
+    active_buffers_.cache_rendered_buffer(op);
+  }
+
   operation_finished(op);
 }
 
@@ -120,7 +230,6 @@ void FullFrameExecutionModel::render_operations()
 {
   const bool is_rendering = context_.isRendering();
 
-  WorkScheduler::start(this->context_);
   for (eCompositorPriority priority : priorities_) {
     for (NodeOperation *op : operations_) {
       const bool has_size = op->getWidth() > 0 && op->getHeight() > 0;
@@ -135,14 +244,14 @@ void FullFrameExecutionModel::render_operations()
       }
     }
   }
-  WorkScheduler::stop();
 }
 
 /**
  * Returns all dependencies from inputs to outputs. A dependency may be repeated when
  * several operations depend on it.
  */
-static Vector<NodeOperation *> get_operation_dependencies(NodeOperation *operation)
+static Vector<NodeOperation *> get_operation_dependencies(NodeOperation *operation,
+                                                          SharedOperationBuffers &active_buffers)
 {
   /* Get dependencies from outputs to inputs. */
   Vector<NodeOperation *> dependencies;
@@ -152,6 +261,10 @@ static Vector<NodeOperation *> get_operation_dependencies(NodeOperation *operati
     Vector<NodeOperation *> outputs(next_outputs);
     next_outputs.clear();
     for (NodeOperation *output : outputs) {
+      /* Cached operations don't read their inputs. */
+      if (active_buffers.is_operation_cached(output)) {
+        continue;
+      }
       for (int i = 0; i < output->getNumberOfInputSockets(); i++) {
         next_outputs.append(output->get_input_operation(i));
       }
@@ -168,7 +281,7 @@ static Vector<NodeOperation *> get_operation_dependencies(NodeOperation *operati
 void FullFrameExecutionModel::render_output_dependencies(NodeOperation *output_op)
 {
   BLI_assert(output_op->isOutputOperation(context_.isRendering()));
-  Vector<NodeOperation *> dependencies = get_operation_dependencies(output_op);
+  Vector<NodeOperation *> dependencies = get_operation_dependencies(output_op, active_buffers_);
   for (NodeOperation *op : dependencies) {
     if (!active_buffers_.is_operation_rendered(op)) {
       render_operation(op);
@@ -223,6 +336,9 @@ void FullFrameExecutionModel::determine_reads(NodeOperation *output_op)
   stack.append(output_op);
   while (stack.size() > 0) {
     NodeOperation *operation = stack.pop_last();
+    if (active_buffers_.is_operation_cached(operation)) {
+      continue;
+    }
     const int num_inputs = operation->getNumberOfInputSockets();
     for (int i = 0; i < num_inputs; i++) {
       NodeOperation *input_op = operation->get_input_operation(i);
@@ -266,10 +382,12 @@ void FullFrameExecutionModel::get_output_render_area(NodeOperation *output_op, r
 
 void FullFrameExecutionModel::operation_finished(NodeOperation *operation)
 {
-  /* Report inputs reads so that buffers may be freed/reused. */
-  const int num_inputs = operation->getNumberOfInputSockets();
-  for (int i = 0; i < num_inputs; i++) {
-    active_buffers_.read_finished(operation->get_input_operation(i));
+  /* Report inputs reads so that buffers may be freed/reused. Cached operations read none. */
+  if (!active_buffers_.is_operation_cached(operation)) {
+    const int num_inputs = operation->getNumberOfInputSockets();
+    for (int i = 0; i < num_inputs; i++) {
+      active_buffers_.read_finished(operation->get_input_operation(i));
+    }
   }
 
   num_operations_finished_++;
@@ -18,8 +18,12 @@
 
 #pragma once
 
+#include "BLI_map.hh"
+
 #include "COM_ExecutionModel.h"
 
+#include <optional>
+
 #ifdef WITH_CXX_GUARDEDALLOC
 #  include "MEM_guardedalloc.h"
 #endif
@@ -50,6 +54,12 @@ class FullFrameExecutionModel : public ExecutionModel {
    */
   Vector<eCompositorPriority> priorities_;
 
+  /**
+   * Whether operations buffers are kept between executions. Only done when editing, as every
+   * render usually has different inputs.
+   */
+  bool use_buffers_cache_;
+
  public:
   FullFrameExecutionModel(CompositorContext &context,
                           SharedOperationBuffers &shared_buffers,
@@ -59,6 +69,10 @@ class FullFrameExecutionModel : public ExecutionModel {
 
  private:
   void determine_areas_to_render_and_reads();
+  void determine_cached_operations();
+  std::optional<size_t> generate_cache_key(NodeOperation *op,
+                                           Map<NodeOperation *, std::optional<size_t>> &keys);
+  size_t hash_rendered_buffer(NodeOperation *op);
   void render_operations();
   void render_output_dependencies(NodeOperation *output_op);
   Vector<MemoryBuffer *> get_input_buffers(NodeOperation *op);
@@ -101,6 +101,35 @@ void NodeOperation::setResolutionInputSocketIndex(unsigned int index)
   this->m_resolutionInputSocketIndex = index;
 }
 
+/**
+ * Operations without outputs are never cached, they always write their result somewhere else.
+ */
+std::optional<size_t> NodeOperation::generate_params_hash()
+{
+  if (m_outputs.is_empty()) {
+    return std::nullopt;
+  }
+
+  params_hash_ = get_default_hash_2(m_width, m_height);
+
+  /* Hash subclasses params. */
+  is_hash_output_params_implemented_ = true;
+  hash_output_params();
+  if (!is_hash_output_params_implemented_) {
+    return std::nullopt;
+  }
+
+  hash_param(typeid(*this).hash_code());
+  for (NodeOperationInput &input : m_inputs) {
+    hash_param(static_cast<int>(input.getDataType()));
+  }
+  for (NodeOperationOutput &output : m_outputs) {
+    hash_param(static_cast<int>(output.getDataType()));
+  }
+
+  return params_hash_;
+}
+
 void NodeOperation::init_data()
 {
   /* Pass. */
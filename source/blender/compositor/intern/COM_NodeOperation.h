@@ -19,9 +19,12 @@
 #pragma once
 
 #include <list>
+#include <optional>
 #include <sstream>
 #include <string>
 
+#include "BLI_ghash.h"
+#include "BLI_hash.hh"
 #include "BLI_math_color.h"
 #include "BLI_math_vector.h"
 #include "BLI_threads.h"
@@ -303,6 +306,12 @@ class NodeOperation {
    */
   const bNodeTree *m_btree;
 
+  /**
+   * Hash of the parameters being built by #generate_params_hash.
+   */
+  size_t params_hash_;
+  bool is_hash_output_params_implemented_;
+
  protected:
   /**
    * Compositor execution model.
@@ -608,6 +617,13 @@ class NodeOperation {
   virtual void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area);
   void get_area_of_interest(NodeOperation *input_op, const rcti &output_area, rcti &r_input_area);
 
+  /**
+   * Hash of the operation type, resolution, sockets and parameters. Together with the hashes of
+   * the input operations it identifies the operation output between executions. Returns nothing
+   * when the operation doesn't hash its parameters.
+   */
+  std::optional<size_t> generate_params_hash();
+
   /** \} */
 
  protected:
@@ -629,6 +645,33 @@ class NodeOperation {
   SocketReader *getInputSocketReader(unsigned int inputSocketindex);
   NodeOperation *getInputOperation(unsigned int inputSocketindex);
 
+  /**
+   * Hashes with #hash_param every parameter the output depends on other than the inputs.
+   * Operations not overriding it are never cached.
+   */
+  virtual void hash_output_params()
+  {
+    is_hash_output_params_implemented_ = false;
+  }
+
+  template<typename T> void hash_param(const T &param)
+  {
+    params_hash_ = BLI_ghashutil_combine_hash(params_hash_, get_default_hash(param));
+  }
+
+  template<typename T1, typename T2> void hash_params(const T1 &param1, const T2 &param2)
+  {
+    hash_param(param1);
+    hash_param(param2);
+  }
+
+  template<typename T> void hash_param_array(const T *params, const int num_params)
+  {
+    for (int i = 0; i < num_params; i++) {
+      hash_param(params[i]);
+    }
+  }
+
   void deinitMutex();
   void initMutex();
   void lockMutex();
@@ -19,11 +19,86 @@
 #include "COM_SharedOperationBuffers.h"
 #include "BLI_rect.h"
 #include "COM_NodeOperation.h"
+#include "COM_defines.h"
 
 namespace blender::compositor {
 
+/**
+ * Buffer rendered in a previous execution.
+ */
+struct CachedBuffer {
+  std::unique_ptr<MemoryBuffer> buffer;
+  DataType data_type;
+  blender::Vector<rcti> areas;
+  size_t memory_size;
+  uint64_t last_use;
+};
+
+/**
+ * Buffers kept between executions by their operations cache key. Compositor executions are
+ * serialized, there is no need to lock it.
+ */
+static struct {
+  blender::Map<size_t, CachedBuffer> buffers;
+  size_t memory_used = 0;
+  uint64_t use_count = 0;
+} g_buffers_cache;
+
+static size_t get_buffer_memory_size(const MemoryBuffer &buffer)
+{
+  return sizeof(float) * buffer.get_num_channels() * buffer.get_memory_width() *
+         buffer.get_memory_height();
+}
+
+static std::unique_ptr<MemoryBuffer> duplicate_buffer(MemoryBuffer &src, const DataType data_type)
+{
+  std::unique_ptr<MemoryBuffer> dst = std::make_unique<MemoryBuffer>(
+      data_type, src.get_rect(), src.is_a_single_elem());
+  memcpy(dst->getBuffer(), src.getBuffer(), get_buffer_memory_size(src));
+  return dst;
+}
+
+static bool is_area_cached(const CachedBuffer &cached, const rcti &area)
+{
+  for (const rcti &cached_area : cached.areas) {
+    if (BLI_rcti_inside_rcti(&cached_area, &area)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void remove_cached_buffer(const size_t key)
+{
+  CachedBuffer *cached = g_buffers_cache.buffers.lookup_ptr(key);
+  if (cached) {
+    g_buffers_cache.memory_used -= cached->memory_size;
+    g_buffers_cache.buffers.remove(key);
+  }
+}
+
+static void remove_least_recently_used_buffer()
+{
+  std::optional<size_t> lru_key;
+  uint64_t lru_use = UINT64_MAX;
+  for (auto item : g_buffers_cache.buffers.items()) {
+    if (item.value.last_use < lru_use) {
+      lru_key = item.key;
+      lru_use = item.value.last_use;
+    }
+  }
+  if (lru_key) {
+    remove_cached_buffer(*lru_key);
+  }
+}
+
 SharedOperationBuffers::BufferData::BufferData()
-    : buffer(nullptr), registered_reads(0), received_reads(0), is_rendered(false)
+    : buffer(nullptr),
+      registered_reads(0),
+      received_reads(0),
+      is_rendered(false),
+      cache_key(std::nullopt),
+      is_cached(false)
 {
 }
 
@@ -126,4 +201,90 @@ void SharedOperationBuffers::read_finished(NodeOperation *read_op)
   }
 }
 
+/**
+ * Sets the key identifying given operation output between executions. Must be called once its
+ * areas to render are registered and before registering reads, as a cached operation doesn't
+ * read its inputs.
+ */
+void SharedOperationBuffers::set_cache_key(NodeOperation *op, const size_t key)
+{
+  BufferData &buf_data = get_buffer_data(op);
+  buf_data.cache_key = key;
+
+  CachedBuffer *cached = g_buffers_cache.buffers.lookup_ptr(key);
+  buf_data.is_cached = cached != nullptr;
+  for (const rcti &area : buf_data.render_areas) {
+    if (!buf_data.is_cached) {
+      break;
+    }
+    buf_data.is_cached = is_area_cached(*cached, area);
+  }
+
+  if (buf_data.is_cached) {
+    cached->last_use = ++g_buffers_cache.use_count;
+  }
+}
+
+/**
+ * Whether given operation buffer was found in the cache, in which case it doesn't need to be
+ * rendered.
+ */
+bool SharedOperationBuffers::is_operation_cached(NodeOperation *op)
+{
+  return get_buffer_data(op).is_cached;
+}
+
+/**
+ * Sets a copy of given operation cached buffer as its rendered buffer.
+ */
+void SharedOperationBuffers::set_cached_buffer(NodeOperation *op)
+{
+  BufferData &buf_data = get_buffer_data(op);
+  BLI_assert(buf_data.is_cached);
+  CachedBuffer &cached = g_buffers_cache.buffers.lookup(*buf_data.cache_key);
+  set_rendered_buffer(op, duplicate_buffer(*cached.buffer, cached.data_type));
+}
+
+/**
+ * Stores a copy of given operation rendered buffer in the cache if it has a cache key, freeing
+ * least recently used buffers when going over the memory limit.
+ */
+void SharedOperationBuffers::cache_rendered_buffer(NodeOperation *op)
+{
+  BufferData &buf_data = get_buffer_data(op);
+  if (!buf_data.cache_key || buf_data.is_cached || buf_data.buffer == nullptr) {
+    return;
+  }
+
+  const size_t memory_size = get_buffer_memory_size(*buf_data.buffer);
+  if (memory_size > COM_BUFFERS_CACHE_MAX_MEMORY) {
+    return;
+  }
+
+  /* A buffer with the same key has been rendered for other areas. */
+  remove_cached_buffer(*buf_data.cache_key);
+
+  while (g_buffers_cache.memory_used + memory_size > COM_BUFFERS_CACHE_MAX_MEMORY) {
+    remove_least_recently_used_buffer();
+  }
+
+  CachedBuffer cached;
+  cached.data_type = op->getOutputSocket()->getDataType();
+  cached.buffer = duplicate_buffer(*buf_data.buffer, cached.data_type);
+  cached.areas = buf_data.render_areas;
+  cached.memory_size = memory_size;
+  cached.last_use = ++g_buffers_cache.use_count;
+  g_buffers_cache.buffers.add_new(*buf_data.cache_key, std::move(cached));
+  g_buffers_cache.memory_used += memory_size;
+}
+
+/**
+ * Frees all buffers kept between executions.
+ */
+void SharedOperationBuffers::free_cache()
+{
+  g_buffers_cache.buffers.clear();
+  g_buffers_cache.memory_used = 0;
+}
+
 }  // namespace blender::compositor
@@ -26,12 +26,18 @@
 #  include "MEM_guardedalloc.h"
 #endif
 #include <memory>
+#include <optional>
 
 namespace blender::compositor {
 
 /**
  * Stores and shares operations rendered buffers including render data. Buffers are
  * disposed once all dependent operations have finished reading them.
+ *
+ * Operations with a cache key may also keep a copy of their buffer in a cache shared between
+ * executions. It's limited to #COM_BUFFERS_CACHE_MAX_MEMORY, least recently used buffers are
+ * freed first. When an operation key and areas to render match a cached buffer, the operation
+ * is not rendered nor are its inputs, unless other operations read them.
  */
 class SharedOperationBuffers {
  private:
@@ -43,6 +49,8 @@ class SharedOperationBuffers {
     int registered_reads;
     int received_reads;
     bool is_rendered;
+    std::optional<size_t> cache_key;
+    bool is_cached;
   } BufferData;
   blender::Map<NodeOperation *, BufferData> buffers_;
 
@@ -60,6 +68,13 @@ class SharedOperationBuffers {
 
   void read_finished(NodeOperation *read_op);
 
+  void set_cache_key(NodeOperation *op, size_t key);
+  bool is_operation_cached(NodeOperation *op);
+  void set_cached_buffer(NodeOperation *op);
+  void cache_rendered_buffer(NodeOperation *op);
+
+  static void free_cache();
+
  private:
   BufferData &get_buffer_data(NodeOperation *op);
 
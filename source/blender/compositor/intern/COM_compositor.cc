@@ -114,11 +114,21 @@ void COM_execute(RenderData *render_data,
   BLI_mutex_unlock(&g_compositor.mutex);
 }
 
+void COM_clearCaches()
+{
+  if (g_compositor.is_initialized) {
+    BLI_mutex_lock(&g_compositor.mutex);
+    blender::compositor::SharedOperationBuffers::free_cache();
+    BLI_mutex_unlock(&g_compositor.mutex);
+  }
+}
+
 void COM_deinitialize()
 {
   if (g_compositor.is_initialized) {
     BLI_mutex_lock(&g_compositor.mutex);
     blender::compositor::WorkScheduler::deinitialize();
+    blender::compositor::SharedOperationBuffers::free_cache();
     g_compositor.is_initialized = false;
     BLI_mutex_unlock(&g_compositor.mutex);
     BLI_mutex_end(&g_compositor.mutex);
@@ -37,6 +37,20 @@ BlurBaseOperation::BlurBaseOperation(DataType data_type)
   this->m_sizeavailable = false;
   this->m_extend_bounds = false;
 }
+
+void BlurBaseOperation::hash_output_params()
+{
+  hash_params(m_data.sizex, m_data.sizey);
+  hash_params(m_data.samples, m_data.relative);
+  hash_params(m_data.aspect, m_data.curved);
+  hash_params(m_data.fac, m_data.filtertype);
+  hash_params(m_data.percentx, m_data.percenty);
+  hash_params(static_cast<int>(m_data.bokeh), static_cast<int>(m_data.gamma));
+  hash_params(m_data.image_in_width, m_data.image_in_height);
+  hash_params(m_size, m_sizeavailable);
+  hash_param(m_extend_bounds);
+}
+
 void BlurBaseOperation::initExecution()
 {
   this->m_inputProgram = this->getInputSocketReader(0);
@@ -45,26 +59,40 @@ void BlurBaseOperation::initExecution()
   this->m_data.image_in_height = this->getHeight();
   if (this->m_data.relative) {
     int sizex, sizey;
-    switch (this->m_data.aspect) {
-      case CMP_NODE_BLUR_ASPECT_Y:
-        sizex = sizey = this->m_data.image_in_width;
-        break;
-      case CMP_NODE_BLUR_ASPECT_X:
-        sizex = sizey = this->m_data.image_in_height;
-        break;
-      default:
-        BLI_assert(this->m_data.aspect == CMP_NODE_BLUR_ASPECT_NONE);
-        sizex = this->m_data.image_in_width;
-        sizey = this->m_data.image_in_height;
-        break;
-    }
-    this->m_data.sizex = round_fl_to_int(this->m_data.percentx * 0.01f * sizex);
-    this->m_data.sizey = round_fl_to_int(this->m_data.percenty * 0.01f * sizey);
+    get_pixel_size(sizex, sizey);
+    this->m_data.sizex = sizex;
+    this->m_data.sizey = sizey;
   }
 
   QualityStepHelper::initExecution(COM_QH_MULTIPLY);
 }
 
+void BlurBaseOperation::get_pixel_size(int &r_sizex, int &r_sizey) const
+{
+  if (!this->m_data.relative) {
+    r_sizex = this->m_data.sizex;
+    r_sizey = this->m_data.sizey;
+    return;
+  }
+
+  int sizex, sizey;
+  switch (this->m_data.aspect) {
+    case CMP_NODE_BLUR_ASPECT_Y:
+      sizex = sizey = this->getWidth();
+      break;
+    case CMP_NODE_BLUR_ASPECT_X:
+      sizex = sizey = this->getHeight();
+      break;
+    default:
+      BLI_assert(this->m_data.aspect == CMP_NODE_BLUR_ASPECT_NONE);
+      sizex = this->getWidth();
+      sizey = this->getHeight();
+      break;
+  }
+  r_sizex = round_fl_to_int(this->m_data.percentx * 0.01f * sizex);
+  r_sizey = round_fl_to_int(this->m_data.percenty * 0.01f * sizey);
+}
+
 float *BlurBaseOperation::make_gausstab(float rad, int size)
 {
   float *gausstab, sum, val;
@@ -185,4 +213,69 @@ void BlurBaseOperation::determineResolution(unsigned int resolution[2],
   }
 }
 
+void BlurBaseOperation::get_gauss_area_of_interest(const bool vertical,
+                                                   const rcti &output_area,
+                                                   rcti &r_input_area) const
+{
+  r_input_area = output_area;
+
+  int sizex, sizey;
+  get_pixel_size(sizex, sizey);
+  const float rad = max_ff(this->m_size * (vertical ? sizey : sizex), 0.0f);
+  if (!this->m_sizeavailable || use_iir_gauss(rad)) {
+    if (vertical) {
+      r_input_area.ymin = 0;
+      r_input_area.ymax = this->getHeight();
+    }
+    else {
+      r_input_area.xmin = 0;
+      r_input_area.xmax = this->getWidth();
+    }
+    return;
+  }
+
+  const int filter_size = min_ii(ceil(rad), MAX_GAUSSTAB_RADIUS);
+  if (vertical) {
+    r_input_area.ymin = output_area.ymin - filter_size - 1;
+    r_input_area.ymax = output_area.ymax + filter_size + 1;
+  }
+  else {
+    r_input_area.xmin = output_area.xmin - filter_size - 1;
+    r_input_area.xmax = output_area.xmax + filter_size + 1;
+  }
+}
+
+bool BlurBaseOperation::use_iir_gauss(const float rad) const
+{
+  /* The recursive gaussian has the same standard deviation as #R_FILTER_GAUSS, `rad / 3`. */
+  return this->m_data.filtertype == R_FILTER_GAUSS && rad >= MIN_IIR_GAUSS_RADIUS;
+}
+
+void BlurBaseOperation::get_area_of_interest(const int input_idx,
+                                             const rcti &output_area,
+                                             rcti &r_input_area)
+{
+  switch (input_idx) {
+    case IMAGE_INPUT_INDEX:
+      r_input_area = output_area;
+      break;
+    case SIZE_INPUT_INDEX: {
+      /* Only the first pixel of the size input is used, see #updateSize. */
+      BLI_rcti_init(&r_input_area, 0, 1, 0, 1);
+      break;
+    }
+  }
+}
+
+void BlurBaseOperation::update_memory_buffer_started(MemoryBuffer *UNUSED(output),
+                                                     const rcti &UNUSED(area),
+                                                     Span<MemoryBuffer *> inputs)
+{
+  if (!this->m_sizeavailable) {
+    const MemoryBuffer *size_input = inputs[SIZE_INPUT_INDEX];
+    this->m_size = *size_input->get_elem(0, 0);
+    this->m_sizeavailable = true;
+  }
+}
+
 }  // namespace blender::compositor
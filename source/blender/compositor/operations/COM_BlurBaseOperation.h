@@ -18,18 +18,22 @@
 
 #pragma once
 
-#include "COM_NodeOperation.h"
+#include "COM_MultiThreadedOperation.h"
 #include "COM_QualityStepHelper.h"
 
 #define MAX_GAUSSTAB_RADIUS 30000
+/* Gauss filters from this radius use a recursive gaussian in full frame execution. */
+#define MIN_IIR_GAUSS_RADIUS 32.0f
 
 #include "BLI_simd.h"
 
 namespace blender::compositor {
 
-class BlurBaseOperation : public NodeOperation, public QualityStepHelper {
- private:
+class BlurBaseOperation : public MultiThreadedOperation, public QualityStepHelper {
  protected:
+  static constexpr int IMAGE_INPUT_INDEX = 0;
+  static constexpr int SIZE_INPUT_INDEX = 1;
+
   BlurBaseOperation(DataType data_type);
   float *make_gausstab(float rad, int size);
 #ifdef BLI_HAVE_SSE2
@@ -39,6 +43,27 @@ class BlurBaseOperation : public NodeOperation, public QualityStepHelper {
 
   void updateSize();
 
+  /**
+   * Blur size in pixels on each axis, resolving relative sizes against the operation resolution.
+   */
+  void get_pixel_size(int &r_sizex, int &r_sizey) const;
+
+  /**
+   * Input area read by a separable gauss filter along one axis. The whole axis is used when the
+   * size comes from the size input, as it's only known once execution has started.
+   */
+  void get_gauss_area_of_interest(bool vertical,
+                                  const rcti &output_area,
+                                  rcti &r_input_area) const;
+
+  /**
+   * Whether a gauss filter of given radius is approximated with a recursive gaussian, which cost
+   * doesn't depend on the radius.
+   */
+  bool use_iir_gauss(float rad) const;
+
+  void hash_output_params() override;
+
   /**
    * Cached reference to the inputProgram
    */
@@ -77,6 +102,11 @@ class BlurBaseOperation : public NodeOperation, public QualityStepHelper {
 
   void determineResolution(unsigned int resolution[2],
                            unsigned int preferredResolution[2]) override;
+
+  void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area) override;
+  void update_memory_buffer_started(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override;
 };
 
 }  // namespace blender::compositor
@@ -18,12 +18,16 @@
 
 #include "COM_BokehBlurOperation.h"
 #include "BLI_math.h"
+#include "COM_FFTConvolution.h"
 #include "COM_OpenCLDevice.h"
 
 #include "RE_pipeline.h"
 
 namespace blender::compositor {
 
+/* Smallest kernel size in pixels that is convolved in the frequency domain. */
+#define MIN_FFT_KERNEL_SIZE 32
+
 BokehBlurOperation::BokehBlurOperation()
 {
   this->addInputSocket(DataType::Color);
@@ -42,6 +46,8 @@ BokehBlurOperation::BokehBlurOperation()
   this->m_inputBoundingBoxReader = nullptr;
 
   this->m_extend_bounds = false;
+  use_fft_ = false;
+  kernel_size_ = 0;
 }
 
 void *BokehBlurOperation::initializeTileData(rcti * /*rect*/)
@@ -140,6 +146,9 @@ void BokehBlurOperation::deinitExecution()
   this->m_inputProgram = nullptr;
   this->m_inputBokehProgram = nullptr;
   this->m_inputBoundingBoxReader = nullptr;
+  use_fft_ = false;
+  fft_convolution_.reset();
+  kernel_sums_.reinitialize(0);
 }
 
 bool BokehBlurOperation::determineDependingAreaOfInterest(rcti *input,
@@ -245,4 +254,206 @@ void BokehBlurOperation::determineResolution(unsigned int resolution[2],
   }
 }
 
+void BokehBlurOperation::get_area_of_interest(const int input_idx,
+                                              const rcti &output_area,
+                                              rcti &r_input_area)
+{
+  switch (input_idx) {
+    case IMAGE_INPUT_INDEX: {
+      const float max_dim = MAX2(this->getWidth(), this->getHeight());
+      const float add_size = (this->m_sizeavailable ? this->m_size : 10.0f) * max_dim / 100.0f;
+      r_input_area.xmin = output_area.xmin - add_size;
+      r_input_area.xmax = output_area.xmax + add_size;
+      r_input_area.ymin = output_area.ymin - add_size;
+      r_input_area.ymax = output_area.ymax + add_size;
+      break;
+    }
+    case BOKEH_INPUT_INDEX: {
+      NodeOperation *bokeh_input = getInputOperation(BOKEH_INPUT_INDEX);
+      BLI_rcti_init(&r_input_area, 0, bokeh_input->getWidth(), 0, bokeh_input->getHeight());
+      break;
+    }
+    case BOUNDING_BOX_INPUT_INDEX:
+      r_input_area = output_area;
+      break;
+    case SIZE_INPUT_INDEX: {
+      /* Only the first pixel of the size input is used, see #updateSize. */
+      BLI_rcti_init(&r_input_area, 0, 1, 0, 1);
+      break;
+    }
+  }
+}
+
+bool BokehBlurOperation::use_fft_convolution(const int pixel_size)
+{
+  /* The per pixel convolution is cheaper for small kernels. A lower quality skips offsets
+   * starting from the image borders, which a convolution with a single kernel can't match. */
+  return getStep() == 1 && 2 * pixel_size >= MIN_FFT_KERNEL_SIZE;
+}
+
+void BokehBlurOperation::init_fft_convolution(Span<MemoryBuffer *> inputs, const int pixel_size)
+{
+  /* Sample the bokeh at every offset of the per pixel convolution. */
+  const float m = this->m_bokehDimension / pixel_size;
+  kernel_size_ = 2 * pixel_size;
+  rcti kernel_rect;
+  BLI_rcti_init(&kernel_rect, 0, kernel_size_, 0, kernel_size_);
+  MemoryBuffer kernel(DataType::Color, kernel_rect);
+  MemoryBuffer *bokeh_input = inputs[BOKEH_INPUT_INDEX];
+  for (int j = 0; j < kernel_size_; j++) {
+    for (int i = 0; i < kernel_size_; i++) {
+      const float u = this->m_bokehMidX - (i - pixel_size) * m;
+      const float v = this->m_bokehMidY - (j - pixel_size) * m;
+      bokeh_input->read(kernel.get_elem(i, j), u, v);
+    }
+  }
+
+  const MemoryBuffer *image_input = inputs[IMAGE_INPUT_INDEX];
+  fft_convolution_ = std::make_unique<FFTConvolution>(&kernel,
+                                                      pixel_size,
+                                                      pixel_size,
+                                                      IndexRange(COM_DATA_TYPE_COLOR_CHANNELS),
+                                                      image_input->getWidth(),
+                                                      image_input->getHeight());
+
+  /* The per pixel convolution only sums the bokeh of the offsets inside the image, so a summed
+   * area table is used to get the same weights. */
+  const int sums_width = kernel_size_ + 1;
+  kernel_sums_.reinitialize(sums_width * sums_width * COM_DATA_TYPE_COLOR_CHANNELS);
+  for (int j = 0; j <= kernel_size_; j++) {
+    for (int i = 0; i <= kernel_size_; i++) {
+      double *sum = &kernel_sums_[(j * sums_width + i) * COM_DATA_TYPE_COLOR_CHANNELS];
+      for (int c = 0; c < COM_DATA_TYPE_COLOR_CHANNELS; c++) {
+        if (i == 0 || j == 0) {
+          sum[c] = 0.0;
+          continue;
+        }
+        const double *sum_left = sum - COM_DATA_TYPE_COLOR_CHANNELS;
+        const double *sum_up = sum - sums_width * COM_DATA_TYPE_COLOR_CHANNELS;
+        const double *sum_up_left = sum_up - COM_DATA_TYPE_COLOR_CHANNELS;
+        sum[c] = kernel.get_elem(i - 1, j - 1)[c] + sum_left[c] + sum_up[c] - sum_up_left[c];
+      }
+    }
+  }
+}
+
+void BokehBlurOperation::execute_fft_convolution(MemoryBuffer *output,
+                                                 const rcti &area,
+                                                 Span<MemoryBuffer *> inputs,
+                                                 const int pixel_size)
+{
+  if (!fft_convolution_) {
+    init_fft_convolution(inputs, pixel_size);
+  }
+
+  /* Input buffers are only rendered in the areas of interest, only convolve the pixels that are
+   * read for this area. */
+  const MemoryBuffer *image_input = inputs[IMAGE_INPUT_INDEX];
+  rcti image_area = area;
+  BLI_rcti_pad(&image_area, pixel_size, pixel_size);
+  BLI_rcti_isect(&image_area, &image_input->get_rect(), &image_area);
+  fft_convolution_->execute(image_input, image_area, output, area);
+}
+
+void BokehBlurOperation::update_memory_buffer_started(MemoryBuffer *output,
+                                                      const rcti &area,
+                                                      Span<MemoryBuffer *> inputs)
+{
+  if (!this->m_sizeavailable) {
+    this->m_size = *inputs[SIZE_INPUT_INDEX]->get_elem(0, 0);
+    CLAMP(this->m_size, 0.0f, 10.0f);
+    this->m_sizeavailable = true;
+  }
+
+  const float max_dim = MAX2(this->getWidth(), this->getHeight());
+  const int pixel_size = this->m_size * max_dim / 100.0f;
+  use_fft_ = use_fft_convolution(pixel_size);
+  if (use_fft_) {
+    execute_fft_convolution(output, area, inputs, pixel_size);
+  }
+}
+
+void BokehBlurOperation::update_memory_buffer_partial(MemoryBuffer *output,
+                                                      const rcti &area,
+                                                      Span<MemoryBuffer *> inputs)
+{
+  const float max_dim = MAX2(this->getWidth(), this->getHeight());
+  const int pixel_size = this->m_size * max_dim / 100.0f;
+  const float m = this->m_bokehDimension / pixel_size;
+  const int step = getStep();
+
+  const MemoryBuffer *image_input = inputs[IMAGE_INPUT_INDEX];
+  MemoryBuffer *bokeh_input = inputs[BOKEH_INPUT_INDEX];
+  MemoryBuffer *bounding_input = inputs[BOUNDING_BOX_INPUT_INDEX];
+  const rcti &image_rect = image_input->get_rect();
+  if (use_fft_) {
+    /* Output already has the convolution, only normalize it. */
+    const int sums_width = kernel_size_ + 1;
+    for (BuffersIterator<float> it = output->iterate_with({bounding_input}, area); !it.is_end();
+         ++it) {
+      const int x = it.x;
+      const int y = it.y;
+      if (*it.in(0) <= 0.0f) {
+        image_input->read_elem(x, y, it.out);
+        continue;
+      }
+
+      const int min_i = clamp_i(image_rect.xmin - x + pixel_size, 0, kernel_size_);
+      const int max_i = clamp_i(image_rect.xmax - x + pixel_size, min_i, kernel_size_);
+      const int min_j = clamp_i(image_rect.ymin - y + pixel_size, 0, kernel_size_);
+      const int max_j = clamp_i(image_rect.ymax - y + pixel_size, min_j, kernel_size_);
+      const int stride = COM_DATA_TYPE_COLOR_CHANNELS;
+      const double *sum_min_min = &kernel_sums_[(min_j * sums_width + min_i) * stride];
+      const double *sum_min_max = &kernel_sums_[(min_j * sums_width + max_i) * stride];
+      const double *sum_max_min = &kernel_sums_[(max_j * sums_width + min_i) * stride];
+      const double *sum_max_max = &kernel_sums_[(max_j * sums_width + max_i) * stride];
+      for (int c = 0; c < COM_DATA_TYPE_COLOR_CHANNELS; c++) {
+        const float multiplier = sum_max_max[c] - sum_max_min[c] - sum_min_max[c] +
+                                 sum_min_min[c];
+        it.out[c] *= 1.0f / multiplier;
+      }
+    }
+    return;
+  }
+
+  const int elem_step = step * image_input->elem_stride;
+  for (BuffersIterator<float> it = output->iterate_with({bounding_input}, area); !it.is_end();
+       ++it) {
+    const int x = it.x;
+    const int y = it.y;
+    const float bounding_box = *it.in(0);
+    if (bounding_box <= 0.0f) {
+      image_input->read_elem(x, y, it.out);
+      continue;
+    }
+
+    float color_accum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    float multiplier_accum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    if (pixel_size < 2) {
+      image_input->read_elem(x, y, color_accum);
+      copy_v4_fl(multiplier_accum, 1.0f);
+    }
+    const int miny = MAX2(y - pixel_size, image_rect.ymin);
+    const int maxy = MIN2(y + pixel_size, image_rect.ymax);
+    const int minx = MAX2(x - pixel_size, image_rect.xmin);
+    const int maxx = MIN2(x + pixel_size, image_rect.xmax);
+
+    float bokeh[4];
+    for (int ny = miny; ny < maxy; ny += step) {
+      const float *color = image_input->get_elem(minx, ny);
+      for (int nx = minx; nx < maxx; nx += step, color += elem_step) {
+        const float u = this->m_bokehMidX - (nx - x) * m;
+        const float v = this->m_bokehMidY - (ny - y) * m;
+        bokeh_input->read(bokeh, u, v);
+        madd_v4_v4v4(color_accum, bokeh, color);
+        add_v4_v4(multiplier_accum, bokeh);
+      }
+    }
+    it.out[0] = color_accum[0] * (1.0f / multiplier_accum[0]);
+    it.out[1] = color_accum[1] * (1.0f / multiplier_accum[1]);
+    it.out[2] = color_accum[2] * (1.0f / multiplier_accum[2]);
+    it.out[3] = color_accum[3] * (1.0f / multiplier_accum[3]);
+  }
+}
+
 }  // namespace blender::compositor
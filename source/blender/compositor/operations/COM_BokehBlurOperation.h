@@ -18,13 +18,23 @@
 
 #pragma once
 
-#include "COM_NodeOperation.h"
+#include <memory>
+
+#include "BLI_array.hh"
+
+#include "COM_FFTConvolution.h"
+#include "COM_MultiThreadedOperation.h"
 #include "COM_QualityStepHelper.h"
 
 namespace blender::compositor {
 
-class BokehBlurOperation : public NodeOperation, public QualityStepHelper {
+class BokehBlurOperation : public MultiThreadedOperation, public QualityStepHelper {
  private:
+  static constexpr int IMAGE_INPUT_INDEX = 0;
+  static constexpr int BOKEH_INPUT_INDEX = 1;
+  static constexpr int BOUNDING_BOX_INPUT_INDEX = 2;
+  static constexpr int SIZE_INPUT_INDEX = 3;
+
   SocketReader *m_inputProgram;
   SocketReader *m_inputBokehProgram;
   SocketReader *m_inputBoundingBoxReader;
@@ -36,6 +46,21 @@ class BokehBlurOperation : public NodeOperation, public QualityStepHelper {
   float m_bokehDimension;
   bool m_extend_bounds;
 
+  /** Large blurs are convolved in the frequency domain, see #use_fft_convolution. */
+  bool use_fft_;
+  /** Transformed bokeh kernel, created once per execution. */
+  std::unique_ptr<FFTConvolution> fft_convolution_;
+  /** Summed area table of the bokeh kernel, to normalize the FFT convolution at image borders. */
+  Array<double> kernel_sums_;
+  int kernel_size_;
+
+  bool use_fft_convolution(int pixel_size);
+  void init_fft_convolution(Span<MemoryBuffer *> inputs, int pixel_size);
+  void execute_fft_convolution(MemoryBuffer *output,
+                               const rcti &area,
+                               Span<MemoryBuffer *> inputs,
+                               int pixel_size);
+
  public:
   BokehBlurOperation();
 
@@ -79,6 +104,13 @@ class BokehBlurOperation : public NodeOperation, public QualityStepHelper {
 
   void determineResolution(unsigned int resolution[2],
                            unsigned int preferredResolution[2]) override;
+  void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area) override;
+  void update_memory_buffer_started(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override;
+  void update_memory_buffer_partial(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override;
 };
 
 }  // namespace blender::compositor
@@ -31,6 +31,11 @@ BrightnessOperation::BrightnessOperation()
   flags.can_be_constant = true;
 }
 
+void BrightnessOperation::hash_output_params()
+{
+  hash_param(m_use_premultiply);
+}
+
 void BrightnessOperation::setUsePremultiply(bool use_premultiply)
 {
   this->m_use_premultiply = use_premultiply;
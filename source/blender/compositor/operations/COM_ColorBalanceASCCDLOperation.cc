@@ -44,6 +44,13 @@ ColorBalanceASCCDLOperation::ColorBalanceASCCDLOperation()
   flags.can_be_constant = true;
 }
 
+void ColorBalanceASCCDLOperation::hash_output_params()
+{
+  hash_param_array(m_offset, 3);
+  hash_param_array(m_power, 3);
+  hash_param_array(m_slope, 3);
+}
+
 void ColorBalanceASCCDLOperation::initExecution()
 {
   this->m_inputValueOperation = this->getInputSocketReader(0);
@@ -73,6 +73,9 @@ class ColorBalanceASCCDLOperation : public MultiThreadedRowOperation {
   }
 
   void update_memory_buffer_row(PixelCursor &p) override;
+
+ protected:
+  void hash_output_params() override;
 };
 
 }  // namespace blender::compositor
@@ -49,6 +49,13 @@ ColorBalanceLGGOperation::ColorBalanceLGGOperation()
   flags.can_be_constant = true;
 }
 
+void ColorBalanceLGGOperation::hash_output_params()
+{
+  hash_param_array(m_gain, 3);
+  hash_param_array(m_lift, 3);
+  hash_param_array(m_gamma_inv, 3);
+}
+
 void ColorBalanceLGGOperation::initExecution()
 {
   this->m_inputValueOperation = this->getInputSocketReader(0);
@@ -29,6 +29,11 @@ ConvertBaseOperation::ConvertBaseOperation()
   this->m_inputOperation = nullptr;
 }
 
+void ConvertBaseOperation::hash_output_params()
+{
+  /* Pass. */
+}
+
 void ConvertBaseOperation::initExecution()
 {
   this->m_inputOperation = this->getInputSocketReader(0);
@@ -173,6 +178,11 @@ ConvertRGBToYCCOperation::ConvertRGBToYCCOperation() : ConvertBaseOperation()
   this->addOutputSocket(DataType::Color);
 }
 
+void ConvertRGBToYCCOperation::hash_output_params()
+{
+  hash_param(m_mode);
+}
+
 void ConvertRGBToYCCOperation::setMode(int mode)
 {
   switch (mode) {
@@ -215,6 +225,11 @@ ConvertYCCToRGBOperation::ConvertYCCToRGBOperation() : ConvertBaseOperation()
   this->addOutputSocket(DataType::Color);
 }
 
+void ConvertYCCToRGBOperation::hash_output_params()
+{
+  hash_param(m_mode);
+}
+
 void ConvertYCCToRGBOperation::setMode(int mode)
 {
   switch (mode) {
@@ -390,6 +405,12 @@ SeparateChannelOperation::SeparateChannelOperation()
   this->addOutputSocket(DataType::Value);
   this->m_inputOperation = nullptr;
 }
+
+void SeparateChannelOperation::hash_output_params()
+{
+  hash_param(m_channel);
+}
+
 void SeparateChannelOperation::initExecution()
 {
   this->m_inputOperation = this->getInputSocketReader(0);
@@ -426,6 +447,11 @@ CombineChannelsOperation::CombineChannelsOperation()
   this->m_inputChannel4Operation = nullptr;
 }
 
+void CombineChannelsOperation::hash_output_params()
+{
+  /* Pass. */
+}
+
 void CombineChannelsOperation::initExecution()
 {
   this->m_inputChannel1Operation = this->getInputSocketReader(0);
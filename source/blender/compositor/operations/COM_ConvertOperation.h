@@ -31,6 +31,9 @@ class ConvertBaseOperation : public NodeOperation {
 
   void initExecution() override;
   void deinitExecution() override;
+
+ protected:
+  void hash_output_params() override;
 };
 
 class ConvertValueToColorOperation : public ConvertBaseOperation {
@@ -94,6 +97,9 @@ class ConvertRGBToYCCOperation : public ConvertBaseOperation {
 
   /** Set the YCC mode */
   void setMode(int mode);
+
+ protected:
+  void hash_output_params() override;
 };
 
 class ConvertYCCToRGBOperation : public ConvertBaseOperation {
@@ -108,6 +114,9 @@ class ConvertYCCToRGBOperation : public ConvertBaseOperation {
 
   /** Set the YCC mode */
   void setMode(int mode);
+
+ protected:
+  void hash_output_params() override;
 };
 
 class ConvertRGBToYUVOperation : public ConvertBaseOperation {
@@ -168,6 +177,9 @@ class SeparateChannelOperation : public NodeOperation {
   {
     this->m_channel = channel;
   }
+
+ protected:
+  void hash_output_params() override;
 };
 
 class CombineChannelsOperation : public NodeOperation {
@@ -183,6 +195,9 @@ class CombineChannelsOperation : public NodeOperation {
 
   void initExecution() override;
   void deinitExecution() override;
+
+ protected:
+  void hash_output_params() override;
 };
 
 }  // namespace blender::compositor
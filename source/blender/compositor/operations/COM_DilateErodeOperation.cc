@@ -35,23 +35,27 @@ DilateErodeThresholdOperation::DilateErodeThresholdOperation()
   this->m__switch = 0.5f;
   this->m_distance = 0.0f;
 }
-void DilateErodeThresholdOperation::initExecution()
+int DilateErodeThresholdOperation::get_scope() const
 {
-  this->m_inputProgram = this->getInputSocketReader(0);
+  int scope;
   if (this->m_distance < 0.0f) {
-    this->m_scope = -this->m_distance + this->m_inset;
+    scope = -this->m_distance + this->m_inset;
   }
   else {
     if (this->m_inset * 2 > this->m_distance) {
-      this->m_scope = MAX2(this->m_inset * 2 - this->m_distance, this->m_distance);
+      scope = MAX2(this->m_inset * 2 - this->m_distance, this->m_distance);
     }
     else {
-      this->m_scope = this->m_distance;
+      scope = this->m_distance;
     }
   }
-  if (this->m_scope < 3) {
-    this->m_scope = 3;
-  }
+  return MAX2(scope, 3);
+}
+
+void DilateErodeThresholdOperation::initExecution()
+{
+  this->m_inputProgram = this->getInputSocketReader(0);
+  this->m_scope = get_scope();
 }
 
 void *DilateErodeThresholdOperation::initializeTileData(rcti * /*rect*/)
@@ -160,6 +164,75 @@ bool DilateErodeThresholdOperation::determineDependingAreaOfInterest(
   return NodeOperation::determineDependingAreaOfInterest(&newInput, readOperation, output);
 }
 
+void DilateErodeThresholdOperation::get_area_of_interest(const int input_idx,
+                                                         const rcti &output_area,
+                                                         rcti &r_input_area)
+{
+  BLI_assert(input_idx == 0);
+  UNUSED_VARS_NDEBUG(input_idx);
+  const int scope = get_scope();
+  r_input_area.xmin = output_area.xmin - scope;
+  r_input_area.xmax = output_area.xmax + scope;
+  r_input_area.ymin = output_area.ymin - scope;
+  r_input_area.ymax = output_area.ymax + scope;
+}
+
+void DilateErodeThresholdOperation::update_memory_buffer_partial(MemoryBuffer *output,
+                                                                 const rcti &area,
+                                                                 Span<MemoryBuffer *> inputs)
+{
+  const MemoryBuffer *input = inputs[0];
+  const rcti &input_rect = input->get_rect();
+  const float sw = this->m__switch;
+  const float distance = this->m_distance;
+  const float rd = this->m_scope * this->m_scope;
+  const float inset = this->m_inset;
+
+  for (BuffersIterator<float> it = output->iterate_with({}, area); !it.is_end(); ++it) {
+    const int x = it.x;
+    const int y = it.y;
+    const int minx = MAX2(x - this->m_scope, input_rect.xmin);
+    const int miny = MAX2(y - this->m_scope, input_rect.ymin);
+    const int maxx = MIN2(x + this->m_scope, input_rect.xmax);
+    const int maxy = MIN2(y + this->m_scope, input_rect.ymax);
+
+    /* Distance to the nearest pixel on the other side of the switch value. */
+    const bool is_inside = *input->get_elem(x, y) > sw;
+    float mindist = rd * 2;
+    for (int yi = miny; yi < maxy; yi++) {
+      const float dy = yi - y;
+      const float *value = input->get_elem(minx, yi);
+      for (int xi = minx; xi < maxx; xi++, value += input->elem_stride) {
+        if (is_inside ? (*value < sw) : (*value > sw)) {
+          const float dx = xi - x;
+          const float dis = dx * dx + dy * dy;
+          mindist = MIN2(mindist, dis);
+        }
+      }
+    }
+    const float pixelvalue = is_inside ? -sqrtf(mindist) : sqrtf(mindist);
+
+    if (distance > 0.0f) {
+      const float delta = distance - pixelvalue;
+      if (delta >= 0.0f) {
+        *it.out = delta >= inset ? 1.0f : delta / inset;
+      }
+      else {
+        *it.out = 0.0f;
+      }
+    }
+    else {
+      const float delta = -distance + pixelvalue;
+      if (delta < 0.0f) {
+        *it.out = delta < -inset ? 1.0f : (-delta) / inset;
+      }
+      else {
+        *it.out = 0.0f;
+      }
+    }
+  }
+}
+
 // Dilate Distance
 DilateDistanceOperation::DilateDistanceOperation()
 {
@@ -170,13 +243,16 @@ DilateDistanceOperation::DilateDistanceOperation()
   flags.complex = true;
   flags.open_cl = true;
 }
+int DilateDistanceOperation::get_scope() const
+{
+  const int scope = this->m_distance;
+  return MAX2(scope, 3);
+}
+
 void DilateDistanceOperation::initExecution()
 {
   this->m_inputProgram = this->getInputSocketReader(0);
-  this->m_scope = this->m_distance;
-  if (this->m_scope < 3) {
-    this->m_scope = 3;
-  }
+  this->m_scope = get_scope();
 }
 
 void *DilateDistanceOperation::initializeTileData(rcti * /*rect*/)
@@ -258,6 +334,79 @@ void DilateDistanceOperation::executeOpenCL(OpenCLDevice *device,
   device->COM_clEnqueueRange(dilateKernel, outputMemoryBuffer, 7, this);
 }
 
+void DilateDistanceOperation::get_area_of_interest(const int input_idx,
+                                                   const rcti &output_area,
+                                                   rcti &r_input_area)
+{
+  BLI_assert(input_idx == 0);
+  UNUSED_VARS_NDEBUG(input_idx);
+  const int scope = get_scope();
+  r_input_area.xmin = output_area.xmin - scope;
+  r_input_area.xmax = output_area.xmax + scope;
+  r_input_area.ymin = output_area.ymin - scope;
+  r_input_area.ymax = output_area.ymax + scope;
+}
+
+/**
+ * Reduce the input values within the distance of each output pixel, starting from \a init_value.
+ */
+template<typename TCompareSelector>
+static void distance_update_memory_buffer(MemoryBuffer *output,
+                                          const MemoryBuffer *input,
+                                          const rcti &area,
+                                          const float distance,
+                                          const int scope,
+                                          const float init_value)
+{
+  TCompareSelector selector;
+  const rcti &input_rect = input->get_rect();
+  const float mindist = distance * distance;
+  for (BuffersIterator<float> it = output->iterate_with({}, area); !it.is_end(); ++it) {
+    const int x = it.x;
+    const int y = it.y;
+    const int minx = MAX2(x - scope, input_rect.xmin);
+    const int miny = MAX2(y - scope, input_rect.ymin);
+    const int maxx = MIN2(x + scope, input_rect.xmax);
+    const int maxy = MIN2(y + scope, input_rect.ymax);
+
+    float value = init_value;
+    for (int yi = miny; yi < maxy; yi++) {
+      const float dy = yi - y;
+      const float *elem = input->get_elem(minx, yi);
+      for (int xi = minx; xi < maxx; xi++, elem += input->elem_stride) {
+        const float dx = xi - x;
+        const float dis = dx * dx + dy * dy;
+        if (dis <= mindist) {
+          value = selector(*elem, value);
+        }
+      }
+    }
+    *it.out = value;
+  }
+}
+
+struct Max2Selector {
+  float operator()(float f1, float f2) const
+  {
+    return MAX2(f1, f2);
+  }
+};
+
+struct Min2Selector {
+  float operator()(float f1, float f2) const
+  {
+    return MIN2(f1, f2);
+  }
+};
+
+void DilateDistanceOperation::update_memory_buffer_partial(MemoryBuffer *output,
+                                                           const rcti &area,
+                                                           Span<MemoryBuffer *> inputs)
+{
+  distance_update_memory_buffer<Max2Selector>(
+      output, inputs[0], area, this->m_distance, this->m_scope, 0.0f);
+}
+
 // Erode Distance
 ErodeDistanceOperation::ErodeDistanceOperation() : DilateDistanceOperation()
 {
@@ -318,6 +467,14 @@ void ErodeDistanceOperation::executeOpenCL(OpenCLDevice *device,
   device->COM_clEnqueueRange(erodeKernel, outputMemoryBuffer, 7, this);
 }
 
+void ErodeDistanceOperation::update_memory_buffer_partial(MemoryBuffer *output,
+                                                          const rcti &area,
+                                                          Span<MemoryBuffer *> inputs)
+{
+  distance_update_memory_buffer<Min2Selector>(
+      output, inputs[0], area, this->m_distance, this->m_scope, 1.0f);
+}
+
 // Dilate step
 DilateStepOperation::DilateStepOperation()
 {
@@ -475,6 +632,124 @@ bool DilateStepOperation::determineDependingAreaOfInterest(rcti *input,
   return NodeOperation::determineDependingAreaOfInterest(&newInput, readOperation, output);
 }
 
+void DilateStepOperation::get_area_of_interest(const int input_idx,
+                                               const rcti &output_area,
+                                               rcti &r_input_area)
+{
+  BLI_assert(input_idx == 0);
+  UNUSED_VARS_NDEBUG(input_idx);
+  r_input_area.xmin = output_area.xmin - this->m_iterations;
+  r_input_area.xmax = output_area.xmax + this->m_iterations;
+  r_input_area.ymin = output_area.ymin - this->m_iterations;
+  r_input_area.ymax = output_area.ymax + this->m_iterations;
+}
+
+/**
+ * Same van Herk/Gil-Werman algorithm as the tiled implementation, run over the given area of a
+ * full input buffer. \a compare_min_value pads the rows and columns outside the input.
+ */
+template<typename TCompareSelector>
+static void step_update_memory_buffer(MemoryBuffer *output,
+                                      const MemoryBuffer *input,
+                                      const rcti &area,
+                                      const int num_iterations,
+                                      const float compare_min_value)
+{
+  TCompareSelector selector;
+  const rcti &input_rect = input->get_rect();
+
+  const int half_window = num_iterations;
+  const int window = half_window * 2 + 1;
+
+  const int xmin = MAX2(input_rect.xmin, area.xmin - half_window);
+  const int ymin = MAX2(input_rect.ymin, area.ymin - half_window);
+  const int xmax = MIN2(input_rect.xmax, area.xmax + half_window);
+  const int ymax = MIN2(input_rect.ymax, area.ymax + half_window);
+
+  const int bwidth = area.xmax - area.xmin;
+  const int bheight = area.ymax - area.ymin;
+
+  /* NOTE: Result buffer has the area width, but extended height. The additional rows are
+   * calculated in the first pass, to have valid data available for the second pass. */
+  float *rectf = (float *)MEM_callocN(sizeof(float) * (ymax - ymin) * bwidth,
+                                      "dilate erode cache");
+
+  /* #temp holds maxima for every step in the algorithm, #buf holds a
+   * single row or column of input values, padded with #compare_min_value to
+   * simplify the logic. */
+  float *temp = (float *)MEM_mallocN(sizeof(float) * (2 * window - 1), "dilate erode temp");
+  float *buf = (float *)MEM_mallocN(sizeof(float) * (MAX2(bwidth, bheight) + 5 * half_window),
+                                    "dilate erode buf");
+
+  /* First pass, horizontal dilate/erode. */
+  for (int y = ymin; y < ymax; y++) {
+    for (int x = 0; x < bwidth + 5 * half_window; x++) {
+      buf[x] = compare_min_value;
+    }
+    const float *in = input->get_elem(xmin, y);
+    for (int x = xmin; x < xmax; x++, in += input->elem_stride) {
+      buf[x - area.xmin + window - 1] = *in;
+    }
+
+    for (int i = 0; i < (bwidth + 3 * half_window) / window; i++) {
+      int start = (i + 1) * window - 1;
+
+      temp[window - 1] = buf[start];
+      for (int x = 1; x < window; x++) {
+        temp[window - 1 - x] = selector(temp[window - x], buf[start - x]);
+        temp[window - 1 + x] = selector(temp[window + x - 2], buf[start + x]);
+      }
+
+      start = half_window + (i - 1) * window + 1;
+      for (int x = -MIN2(0, start); x < window - MAX2(0, start + window - bwidth); x++) {
+        rectf[bwidth * (y - ymin) + (start + x)] = selector(temp[x], temp[x + window - 1]);
+      }
+    }
+  }
+
+  /* Second pass, vertical dilate/erode. */
+  for (int x = 0; x < bwidth; x++) {
+    for (int y = 0; y < bheight + 5 * half_window; y++) {
+      buf[y] = compare_min_value;
+    }
+    for (int y = ymin; y < ymax; y++) {
+      buf[y - area.ymin + window - 1] = rectf[(y - ymin) * bwidth + x];
+    }
+
+    for (int i = 0; i < (bheight + 3 * half_window) / window; i++) {
+      int start = (i + 1) * window - 1;
+
+      temp[window - 1] = buf[start];
+      for (int y = 1; y < window; y++) {
+        temp[window - 1 - y] = selector(temp[window - y], buf[start - y]);
+        temp[window - 1 + y] = selector(temp[window + y - 2], buf[start + y]);
+      }
+
+      start = half_window + (i - 1) * window + 1;
+      for (int y = -MIN2(0, start); y < window - MAX2(0, start + window - bheight); y++) {
+        rectf[bwidth * (y + start + (area.ymin - ymin)) + x] = selector(temp[y],
+                                                                        temp[y + window - 1]);
+      }
+    }
+  }
+
+  MEM_freeN(temp);
+  MEM_freeN(buf);
+
+  for (int y = area.ymin; y < area.ymax; y++) {
+    memcpy(output->get_elem(area.xmin, y), &rectf[bwidth * (y - ymin)], sizeof(float) * bwidth);
+  }
+
+  MEM_freeN(rectf);
+}
+
+void DilateStepOperation::update_memory_buffer_partial(MemoryBuffer *output,
+                                                       const rcti &area,
+                                                       Span<MemoryBuffer *> inputs)
+{
+  step_update_memory_buffer<Max2Selector>(output, inputs[0], area, this->m_iterations, -FLT_MAX);
+}
+
 // Erode step
 ErodeStepOperation::ErodeStepOperation() : DilateStepOperation()
 {
@@ -571,4 +846,11 @@ void *ErodeStepOperation::initializeTileData(rcti *rect)
   return result;
 }
 
+void ErodeStepOperation::update_memory_buffer_partial(MemoryBuffer *output,
+                                                      const rcti &area,
+                                                      Span<MemoryBuffer *> inputs)
+{
+  step_update_memory_buffer<Min2Selector>(output, inputs[0], area, this->m_iterations, FLT_MAX);
+}
+
 }  // namespace blender::compositor
@@ -0,0 +1,338 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include "COM_FFTConvolution.h"
+
+#include "BLI_math_base.h"
+#include "BLI_task.hh"
+
+namespace blender::compositor {
+
+/* Images are split in blocks so the FFT size doesn't exceed this, unless the kernel needs a
+ * larger size. */
+#define FFT_CONVOLUTION_MAX_SIZE 2048
+
+using Complex = FFTConvolution::Complex;
+
+BLI_INLINE Complex complex_mul(const Complex a, const Complex b)
+{
+  return {a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re};
+}
+
+/* Power of two FFT size along an axis, large enough for a linear convolution of a block. */
+static int fft_size(const int image_size, const int kernel_size)
+{
+  const int linear_size = power_of_2_max_i(image_size + kernel_size - 1);
+  const int min_size = power_of_2_max_i(2 * kernel_size - 1);
+  return MAX2(2, MIN2(linear_size, MAX2(min_size, FFT_CONVOLUTION_MAX_SIZE)));
+}
+
+FFTConvolution::Plan::Plan(const int size) : size(size), twiddles(size / 2), bit_reversal(size)
+{
+  int log2_size = 0;
+  while ((1 << log2_size) < size) {
+    log2_size++;
+  }
+
+  for (int i = 0; i < size; i++) {
+    int reversed = 0;
+    for (int bit = 0; bit < log2_size; bit++) {
+      if (i & (1 << bit)) {
+        reversed |= 1 << (log2_size - 1 - bit);
+      }
+    }
+    bit_reversal[i] = reversed;
+  }
+
+  for (int k = 0; k < size / 2; k++) {
+    const double angle = -2.0 * M_PI * k / size;
+    twiddles[k] = {(float)cos(angle), (float)sin(angle)};
+  }
+}
+
+/* In place radix-2 FFT, not normalized. */
+static void fft(Complex *data,
+                const int size,
+                const Complex *twiddles,
+                const int *bit_reversal,
+                const bool inverse)
+{
+  for (int i = 0; i < size; i++) {
+    const int j = bit_reversal[i];
+    if (j > i) {
+      std::swap(data[i], data[j]);
+    }
+  }
+
+  for (int len = 2; len <= size; len <<= 1) {
+    const int half = len >> 1;
+    const int step = size / len;
+    for (int k = 0; k < half; k++) {
+      Complex w = twiddles[k * step];
+      if (inverse) {
+        w.im = -w.im;
+      }
+      for (int i = k; i < size; i += len) {
+        const Complex a = data[i];
+        const Complex b = complex_mul(data[i + half], w);
+        data[i] = {a.re + b.re, a.im + b.im};
+        data[i + half] = {a.re - b.re, a.im - b.im};
+      }
+    }
+  }
+}
+
+FFTConvolution::FFTConvolution(const MemoryBuffer *kernel,
+                               const int center_x,
+                               const int center_y,
+                               const IndexRange channels,
+                               const int image_width,
+                               const int image_height)
+    : kernel_width_(kernel->getWidth()),
+      kernel_height_(kernel->getHeight()),
+      center_x_(center_x),
+      center_y_(center_y),
+      channels_(channels),
+      fft_width_(fft_size(image_width, kernel_width_)),
+      fft_height_(fft_size(image_height, kernel_height_)),
+      spectrum_width_(fft_width_ / 2 + 1),
+      block_width_(fft_width_ - kernel_width_ + 1),
+      block_height_(fft_height_ - kernel_height_ + 1),
+      plan_x_(fft_width_),
+      plan_y_(fft_height_),
+      kernel_spectra_(channels.size() * spectrum_width_ * fft_height_),
+      spectrum_(spectrum_width_ * fft_height_)
+{
+  BLI_assert(kernel->get_num_channels() >= channels.one_after_last());
+  BLI_assert(center_x >= 0 && center_x < kernel_width_);
+  BLI_assert(center_y >= 0 && center_y < kernel_height_);
+
+  const rcti &kernel_rect = kernel->get_rect();
+  const float scale = 1.0f / ((float)fft_width_ * fft_height_);
+  for (const int channel_index : IndexRange(channels.size())) {
+    const int channel = channels[channel_index];
+    /* Mirror the kernel around its center, which is placed at the origin, so the convolution
+     * result needs no offset. */
+    forward_rows(
+        [&](const int row, float *r_values) {
+          int j = center_y_ - row;
+          if (j < 0) {
+            j += fft_height_;
+          }
+          for (int s = 0; s < fft_width_; s++) {
+            int i = center_x_ - s;
+            if (i < 0) {
+              i += fft_width_;
+            }
+            if (i < kernel_width_ && j < kernel_height_) {
+              const float *elem = kernel->get_elem(kernel_rect.xmin + i, kernel_rect.ymin + j);
+              r_values[s] = elem[channel] * scale;
+            }
+            else {
+              r_values[s] = 0.0f;
+            }
+          }
+        },
+        fft_height_);
+    transform_columns(nullptr);
+    std::copy(spectrum_.begin(),
+              spectrum_.end(),
+              &kernel_spectra_[channel_index * spectrum_width_ * fft_height_]);
+  }
+}
+
+void FFTConvolution::forward_rows(FunctionRef<void(int row, float *r_values)> fill_row,
+                                  const int num_rows)
+{
+  const int size = fft_width_;
+  threading::parallel_for(IndexRange(fft_height_ / 2), 8, [&](const IndexRange pairs) {
+    Array<Complex> row(size);
+    Array<float> values(size);
+    for (const int64_t pair : pairs) {
+      const int row0 = pair * 2;
+      const int row1 = row0 + 1;
+      if (row0 >= num_rows) {
+        for (int k = 0; k < spectrum_width_; k++) {
+          spectrum_[k * fft_height_ + row0] = {0.0f, 0.0f};
+          spectrum_[k * fft_height_ + row1] = {0.0f, 0.0f};
+        }
+        continue;
+      }
+
+      /* Transform two real rows at once as the real and imaginary part of a complex row. */
+      fill_row(row0, values.data());
+      for (int i = 0; i < size; i++) {
+        row[i] = {values[i], 0.0f};
+      }
+      if (row1 < num_rows) {
+        fill_row(row1, values.data());
+        for (int i = 0; i < size; i++) {
+          row[i].im = values[i];
+        }
+      }
+      fft(row.data(), size, plan_x_.twiddles.data(), plan_x_.bit_reversal.data(), false);
+
+      /* Separate the spectra of both rows using their conjugate symmetry. */
+      for (int k = 0; k < spectrum_width_; k++) {
+        const Complex a = row[k];
+        const Complex b = row[(size - k) & (size - 1)];
+        spectrum_[k * fft_height_ + row0] = {0.5f * (a.re + b.re), 0.5f * (a.im - b.im)};
+        spectrum_[k * fft_height_ + row1] = {0.5f * (a.im + b.im), 0.5f * (b.re - a.re)};
+      }
+    }
+  });
+}
+
+void FFTConvolution::transform_columns(const Complex *kernel_spectrum)
+{
+  threading::parallel_for(IndexRange(spectrum_width_), 8, [&](const IndexRange columns) {
+    for (const int64_t k : columns) {
+      Complex *column = &spectrum_[k * fft_height_];
+      fft(column, fft_height_, plan_y_.twiddles.data(), plan_y_.bit_reversal.data(), false);
+      if (kernel_spectrum == nullptr) {
+        continue;
+      }
+
+      const Complex *kernel_column = &kernel_spectrum[k * fft_height_];
+      for (int t = 0; t < fft_height_; t++) {
+        column[t] = complex_mul(column[t], kernel_column[t]);
+      }
+      fft(column, fft_height_, plan_y_.twiddles.data(), plan_y_.bit_reversal.data(), true);
+    }
+  });
+}
+
+void FFTConvolution::inverse_rows(FunctionRef<bool(int row)> is_row_used,
+                                  FunctionRef<void(int row, const float *values)> read_row)
+{
+  const int size = fft_width_;
+  threading::parallel_for(IndexRange(fft_height_ / 2), 8, [&](const IndexRange pairs) {
+    Array<Complex> row(size);
+    Array<float> values(size);
+    for (const int64_t pair : pairs) {
+      const int row0 = pair * 2;
+      const int row1 = row0 + 1;
+      const bool use_row0 = is_row_used(row0);
+      const bool use_row1 = is_row_used(row1);
+      if (!use_row0 && !use_row1) {
+        continue;
+      }
+
+      /* Combine both half spectra into one complex row, the other half follows from the
+       * conjugate symmetry of real rows. */
+      for (int k = 0; k < size; k++) {
+        const bool is_mirrored = k >= spectrum_width_;
+        const int column = is_mirrored ? size - k : k;
+        Complex s0 = spectrum_[column * fft_height_ + row0];
+        Complex s1 = spectrum_[column * fft_height_ + row1];
+        if (is_mirrored) {
+          s0.im = -s0.im;
+          s1.im = -s1.im;
+        }
+        row[k] = {s0.re - s1.im, s0.im + s1.re};
+      }
+      fft(row.data(), size, plan_x_.twiddles.data(), plan_x_.bit_reversal.data(), true);
+
+      if (use_row0) {
+        for (int i = 0; i < size; i++) {
+          values[i] = row[i].re;
+        }
+        read_row(row0, values.data());
+      }
+      if (use_row1) {
+        for (int i = 0; i < size; i++) {
+          values[i] = row[i].im;
+        }
+        read_row(row1, values.data());
+      }
+    }
+  });
+}
+
+void FFTConvolution::execute(const MemoryBuffer *image,
+                             const rcti &image_area,
+                             MemoryBuffer *output,
+                             const rcti &area)
+{
+  BLI_assert(BLI_rcti_inside_rcti(&image->get_rect(), &image_area));
+
+  threading::parallel_for(IndexRange(BLI_rcti_size_y(&area)), 32, [&](IndexRange rows) {
+    for (const int64_t row : rows) {
+      const int y = area.ymin + row;
+      for (int x = area.xmin; x < area.xmax; x++) {
+        float *out = output->get_elem(x, y);
+        for (const int64_t channel : channels_) {
+          out[channel] = 0.0f;
+        }
+      }
+    }
+  });
+
+  const size_t kernel_spectrum_size = (size_t)spectrum_width_ * fft_height_;
+  for (int block_y = image_area.ymin; block_y < image_area.ymax; block_y += block_height_) {
+    const int block_rows = MIN2(block_height_, image_area.ymax - block_y);
+    /* Offsets from the block origin of the result rows. Lower offsets wrap around. */
+    const int min_offset_y = center_y_ - kernel_height_ + 1;
+    const int max_offset_y = block_rows + center_y_;
+
+    for (int block_x = image_area.xmin; block_x < image_area.xmax; block_x += block_width_) {
+      const int block_cols = MIN2(block_width_, image_area.xmax - block_x);
+      const int min_offset_x = center_x_ - kernel_width_ + 1;
+      const int max_offset_x = block_cols + center_x_;
+
+      auto row_to_y = [&](const int row) {
+        return block_y + (row < max_offset_y ? row : row - fft_height_);
+      };
+      auto is_row_used = [&](const int row) {
+        const int y = row_to_y(row);
+        return y >= block_y + min_offset_y && y < area.ymax && y >= area.ymin;
+      };
+
+      for (const int channel_index : IndexRange(channels_.size())) {
+        const int channel = channels_[channel_index];
+        forward_rows(
+            [&](const int row, float *r_values) {
+              const float *elem = image->get_elem(block_x, block_y + row) + channel;
+              for (int s = 0; s < block_cols; s++, elem += image->elem_stride) {
+                r_values[s] = *elem;
+              }
+              for (int s = block_cols; s < fft_width_; s++) {
+                r_values[s] = 0.0f;
+              }
+            },
+            block_rows);
+
+        transform_columns(&kernel_spectra_[channel_index * kernel_spectrum_size]);
+
+        /* Blocks are added sequentially, rows of a block are disjoint. */
+        inverse_rows(is_row_used, [&](const int row, const float *values) {
+          const int y = row_to_y(row);
+          for (int s = 0; s < fft_width_; s++) {
+            const int offset_x = s < max_offset_x ? s : s - fft_width_;
+            const int x = block_x + offset_x;
+            if (offset_x >= min_offset_x && x >= area.xmin && x < area.xmax) {
+              output->get_elem(x, y)[channel] += values[s];
+            }
+          }
+        });
+      }
+    }
+  }
+}
+
+}  // namespace blender::compositor
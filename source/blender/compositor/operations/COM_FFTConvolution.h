@@ -0,0 +1,120 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#pragma once
+
+#include "BLI_array.hh"
+#include "BLI_function_ref.hh"
+#include "BLI_index_range.hh"
+
+#include "COM_MemoryBuffer.h"
+
+namespace blender::compositor {
+
+/**
+ * Convolution of image channels with a kernel in the frequency domain, for kernels too large
+ * to convolve per pixel.
+ *
+ * For every output pixel and channel `c`:
+ * `output(x, y) = sum(kernel(i, j) * image(x + i - center_x, y + j - center_y))`,
+ * where pixels outside of the convolved image area are zero.
+ *
+ * Rows are transformed with a real-to-complex FFT, two rows at a time, and columns with a
+ * complex FFT. Both passes are multi-threaded. Images larger than the FFT size are split into
+ * blocks that are convolved one by one and overlap-added into the output, so memory usage is
+ * bounded for huge images.
+ */
+class FFTConvolution {
+ public:
+  struct Complex {
+    float re;
+    float im;
+  };
+
+ private:
+  /** Twiddle factors and bit reversal permutation of a power of two FFT size. */
+  struct Plan {
+    int size;
+    Array<Complex> twiddles;
+    Array<int> bit_reversal;
+
+    Plan(int size);
+  };
+
+  int kernel_width_;
+  int kernel_height_;
+  int center_x_;
+  int center_y_;
+  IndexRange channels_;
+
+  int fft_width_;
+  int fft_height_;
+  /** Number of complex values of the spectrum of a real row. */
+  int spectrum_width_;
+  /** Size of the image blocks convolved at once. */
+  int block_width_;
+  int block_height_;
+
+  Plan plan_x_;
+  Plan plan_y_;
+
+  /** Spectra of the kernel channels, scaled by the inverse FFT normalization. */
+  Array<Complex> kernel_spectra_;
+  /** Spectrum being convolved, stored column by column. */
+  Array<Complex> spectrum_;
+
+ public:
+  /**
+   * \param kernel: Kernel with the channels that are convolved.
+   * \param center_x, center_y: Kernel element that is aligned with the output pixel.
+   * \param channels: Channels of the kernel, image and output that are convolved.
+   * \param image_width, image_height: Size of the images that will be convolved.
+   */
+  FFTConvolution(const MemoryBuffer *kernel,
+                 int center_x,
+                 int center_y,
+                 IndexRange channels,
+                 int image_width,
+                 int image_height);
+
+  /**
+   * Write the convolution of the image to the channels of the output in the given area. Other
+   * channels of the output are left untouched. Only pixels of the image inside `image_area` are
+   * read, which must be inside the image rect.
+   */
+  void execute(const MemoryBuffer *image,
+               const rcti &image_area,
+               MemoryBuffer *output,
+               const rcti &area);
+
+ private:
+  /**
+   * Transform `num_rows` real rows given by `fill_row` into #spectrum_. Remaining rows are zero.
+   */
+  void forward_rows(FunctionRef<void(int row, float *r_values)> fill_row, int num_rows);
+  /**
+   * Transform the columns of #spectrum_, and when a kernel spectrum is given multiply by it and
+   * transform back.
+   */
+  void transform_columns(const Complex *kernel_spectrum);
+  /** Transform #spectrum_ back to real rows, passing the rows that are used to `read_row`. */
+  void inverse_rows(FunctionRef<bool(int row)> is_row_used,
+                    FunctionRef<void(int row, const float *values)> read_row);
+};
+
+}  // namespace blender::compositor
@@ -16,8 +16,7 @@
  * Copyright 2011, Blender Foundation.
  */
 
-#include <climits>
-
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 #include "COM_FastGaussianBlurOperation.h"
 #include "MEM_guardedalloc.h"
@@ -84,72 +83,170 @@ void *FastGaussianBlurOperation::initializeTileData(rcti *rect)
     MemoryBuffer *newBuf = (MemoryBuffer *)this->m_inputProgram->initializeTileData(rect);
     MemoryBuffer *copy = new MemoryBuffer(*newBuf);
     updateSize();
-
-    int c;
-    this->m_sx = this->m_data.sizex * this->m_size / 2.0f;
-    this->m_sy = this->m_data.sizey * this->m_size / 2.0f;
-
-    if ((this->m_sx == this->m_sy) && (this->m_sx > 0.0f)) {
-      for (c = 0; c < COM_DATA_TYPE_COLOR_CHANNELS; c++) {
-        IIR_gauss(copy, this->m_sx, c, 3);
-      }
-    }
-    else {
-      if (this->m_sx > 0.0f) {
-        for (c = 0; c < COM_DATA_TYPE_COLOR_CHANNELS; c++) {
-          IIR_gauss(copy, this->m_sx, c, 1);
-        }
-      }
-      if (this->m_sy > 0.0f) {
-        for (c = 0; c < COM_DATA_TYPE_COLOR_CHANNELS; c++) {
-          IIR_gauss(copy, this->m_sy, c, 2);
-        }
-      }
-    }
+    blur_buffer(copy);
     this->m_iirgaus = copy;
   }
   unlockMutex();
   return this->m_iirgaus;
 }
 
-void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src,
-                                          float sigma,
-                                          unsigned int chan,
-                                          unsigned int xy)
+void FastGaussianBlurOperation::blur_buffer(MemoryBuffer *copy)
 {
-  double q, q2, sc, cf[4], tsM[9], tsu[3], tsv[3];
-  double *X, *Y, *W;
-  const unsigned int src_width = src->getWidth();
-  const unsigned int src_height = src->getHeight();
-  unsigned int x, y, sz;
-  unsigned int i;
-  float *buffer = src->getBuffer();
-  const uint8_t num_channels = src->get_num_channels();
+  this->m_sx = this->m_data.sizex * this->m_size / 2.0f;
+  this->m_sy = this->m_data.sizey * this->m_size / 2.0f;
 
-  /* <0.5 not valid, though can have a possibly useful sort of sharpening effect. */
-  if (sigma < 0.5f) {
+  const IndexRange channels(COM_DATA_TYPE_COLOR_CHANNELS);
+  if ((this->m_sx == this->m_sy) && (this->m_sx > 0.0f)) {
+    IIR_gauss(copy, this->m_sx, channels, 3);
+  }
+  else {
+    if (this->m_sx > 0.0f) {
+      IIR_gauss(copy, this->m_sx, channels, 1);
+    }
+    if (this->m_sy > 0.0f) {
+      IIR_gauss(copy, this->m_sy, channels, 2);
+    }
+  }
+}
+
+void FastGaussianBlurOperation::get_area_of_interest(const int input_idx,
+                                                     const rcti &output_area,
+                                                     rcti &r_input_area)
+{
+  if (input_idx != IMAGE_INPUT_INDEX) {
+    BlurBaseOperation::get_area_of_interest(input_idx, output_area, r_input_area);
     return;
   }
 
-  if ((xy < 1) || (xy > 3)) {
-    xy = 3;
+  /* The IIR filter is run over the whole image. */
+  BLI_rcti_init(&r_input_area, 0, this->getWidth(), 0, this->getHeight());
+}
+
+void FastGaussianBlurOperation::update_memory_buffer_started(MemoryBuffer *output,
+                                                             const rcti &area,
+                                                             Span<MemoryBuffer *> inputs)
+{
+  BlurBaseOperation::update_memory_buffer_started(output, area, inputs);
+
+  if (!this->m_iirgaus) {
+    /* #IIR_gauss filters whole lines, the image is blurred here once and copied to the output
+     * areas. */
+    const MemoryBuffer *input = inputs[IMAGE_INPUT_INDEX];
+    MemoryBuffer *copy = input->is_a_single_elem() ? input->inflate() : new MemoryBuffer(*input);
+    blur_buffer(copy);
+    this->m_iirgaus = copy;
+  }
+}
+
+void FastGaussianBlurOperation::update_memory_buffer_partial(MemoryBuffer *output,
+                                                             const rcti &area,
+                                                             Span<MemoryBuffer *> UNUSED(inputs))
+{
+  output->copy_from(this->m_iirgaus, area);
+}
+
+/* -------------------------------------------------------------------- */
+/** \name Recursive Gaussian
+ *
+ * See "Recursive Gabor Filtering" by Young/VanVliet. Lines are filtered in parallel, each line
+ * filtering all channels of a pixel at once with SIMD, or the same channel of several lines when
+ * filtering a single channel.
+ * \{ */
+
+/* Number of values filtered at once. */
+#define IIR_GAUSS_LANES 4
+
+struct IIRGaussCoefficients {
+  double cf[4];
+  double tsM[9];
+};
+
+struct IIRGaussLanes {
+#ifdef BLI_HAVE_SSE2
+  __m128d v[2];
+#else
+  double v[IIR_GAUSS_LANES];
+#endif
+};
+
+BLI_INLINE IIRGaussLanes iir_lanes_load(const double values[IIR_GAUSS_LANES])
+{
+  IIRGaussLanes r;
+#ifdef BLI_HAVE_SSE2
+  r.v[0] = _mm_loadu_pd(values);
+  r.v[1] = _mm_loadu_pd(values + 2);
+#else
+  memcpy(r.v, values, sizeof(r.v));
+#endif
+  return r;
+}
+
+BLI_INLINE void iir_lanes_store(const IIRGaussLanes &a, double r_values[IIR_GAUSS_LANES])
+{
+#ifdef BLI_HAVE_SSE2
+  _mm_storeu_pd(r_values, a.v[0]);
+  _mm_storeu_pd(r_values + 2, a.v[1]);
+#else
+  memcpy(r_values, a.v, sizeof(a.v));
+#endif
+}
+
+BLI_INLINE IIRGaussLanes iir_lanes_sub(const IIRGaussLanes &a, const IIRGaussLanes &b)
+{
+  IIRGaussLanes r;
+#ifdef BLI_HAVE_SSE2
+  r.v[0] = _mm_sub_pd(a.v[0], b.v[0]);
+  r.v[1] = _mm_sub_pd(a.v[1], b.v[1]);
+#else
+  for (int i = 0; i < IIR_GAUSS_LANES; i++) {
+    r.v[i] = a.v[i] - b.v[i];
   }
+#endif
+  return r;
+}
 
-  /* XXX The YVV macro defined below explicitly expects sources of at least 3x3 pixels,
-   *     so just skipping blur along faulty direction if src's def is below that limit! */
-  if (src_width < 3) {
-    xy &= ~1;
+/**
+ * Weighted sum `w[0] * a + w[1] * b + w[2] * c + w[3] * d`.
+ */
+BLI_INLINE IIRGaussLanes iir_lanes_madd4(const double w[4],
+                                         const IIRGaussLanes &a,
+                                         const IIRGaussLanes &b,
+                                         const IIRGaussLanes &c,
+                                         const IIRGaussLanes &d)
+{
+  IIRGaussLanes r;
+#ifdef BLI_HAVE_SSE2
+  const __m128d w0 = _mm_set1_pd(w[0]);
+  const __m128d w1 = _mm_set1_pd(w[1]);
+  const __m128d w2 = _mm_set1_pd(w[2]);
+  const __m128d w3 = _mm_set1_pd(w[3]);
+  for (int i = 0; i < 2; i++) {
+    r.v[i] = _mm_add_pd(_mm_add_pd(_mm_mul_pd(w0, a.v[i]), _mm_mul_pd(w1, b.v[i])),
+                        _mm_add_pd(_mm_mul_pd(w2, c.v[i]), _mm_mul_pd(w3, d.v[i])));
   }
-  if (src_height < 3) {
-    xy &= ~2;
+#else
+  for (int i = 0; i < IIR_GAUSS_LANES; i++) {
+    r.v[i] = w[0] * a.v[i] + w[1] * b.v[i] + w[2] * c.v[i] + w[3] * d.v[i];
   }
-  if (xy < 1) {
-    return;
+#endif
+  return r;
+}
+
+/**
+ * All factors are in double-precision. Required, because for single-precision floating point
+ * seems to blow up if `sigma > ~200`. Returns false when sigma is too small to be filtered.
+ */
+static bool iir_gauss_coefficients(const float sigma, IIRGaussCoefficients &r_coefs)
+{
+  double q, q2, sc;
+  double *cf = r_coefs.cf;
+  double *tsM = r_coefs.tsM;
+
+  /* <0.5 not valid, though can have a possibly useful sort of sharpening effect. */
+  if (sigma < 0.5f) {
+    return false;
   }
 
-  /* See "Recursive Gabor Filtering" by Young/VanVliet
-   * all factors here in double-precision.
-   * Required, because for single-precision floating point seems to blow up if `sigma > ~200`. */
   if (sigma >= 3.556f) {
     q = 0.9804f * (sigma - 3.556f) + 2.5091f;
   }
@@ -185,78 +282,162 @@ void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src,
   tsM[7] = sc * (cf[1] * cf[2] + cf[3] * cf[2] * cf[2] - cf[1] * cf[3] * cf[3] -
                  cf[3] * cf[3] * cf[3] - cf[3] * cf[2] + cf[3]);
   tsM[8] = sc * (cf[3] * (cf[1] + cf[3] * cf[2]));
+  return true;
+}
 
-#define YVV(L) \
-  { \
-    W[0] = cf[0] * X[0] + cf[1] * X[0] + cf[2] * X[0] + cf[3] * X[0]; \
-    W[1] = cf[0] * X[1] + cf[1] * W[0] + cf[2] * X[0] + cf[3] * X[0]; \
-    W[2] = cf[0] * X[2] + cf[1] * W[1] + cf[2] * W[0] + cf[3] * X[0]; \
-    for (i = 3; i < L; i++) { \
-      W[i] = cf[0] * X[i] + cf[1] * W[i - 1] + cf[2] * W[i - 2] + cf[3] * W[i - 3]; \
-    } \
-    tsu[0] = W[L - 1] - X[L - 1]; \
-    tsu[1] = W[L - 2] - X[L - 1]; \
-    tsu[2] = W[L - 3] - X[L - 1]; \
-    tsv[0] = tsM[0] * tsu[0] + tsM[1] * tsu[1] + tsM[2] * tsu[2] + X[L - 1]; \
-    tsv[1] = tsM[3] * tsu[0] + tsM[4] * tsu[1] + tsM[5] * tsu[2] + X[L - 1]; \
-    tsv[2] = tsM[6] * tsu[0] + tsM[7] * tsu[1] + tsM[8] * tsu[2] + X[L - 1]; \
-    Y[L - 1] = cf[0] * W[L - 1] + cf[1] * tsv[0] + cf[2] * tsv[1] + cf[3] * tsv[2]; \
-    Y[L - 2] = cf[0] * W[L - 2] + cf[1] * Y[L - 1] + cf[2] * tsv[0] + cf[3] * tsv[1]; \
-    Y[L - 3] = cf[0] * W[L - 3] + cf[1] * Y[L - 2] + cf[2] * Y[L - 1] + cf[3] * tsv[0]; \
-    /* 'i != UINT_MAX' is really 'i >= 0', but necessary for unsigned int wrapping */ \
-    for (i = L - 4; i != UINT_MAX; i--) { \
-      Y[i] = cf[0] * W[i] + cf[1] * Y[i + 1] + cf[2] * Y[i + 2] + cf[3] * Y[i + 3]; \
-    } \
-  } \
-  (void)0
-
-  /* Intermediate buffers. */
-  sz = MAX2(src_width, src_height);
-  X = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss X buf");
-  Y = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss Y buf");
-  W = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss W buf");
-  if (xy & 1) { /* H. */
-    int offset;
-    for (y = 0; y < src_height; y++) {
-      const int yx = y * src_width;
-      offset = yx * num_channels + chan;
-      for (x = 0; x < src_width; x++) {
-        X[x] = buffer[offset];
-        offset += num_channels;
+/**
+ * Filters a line of at least 3 elements in place, `W` is a temporary line of the same length.
+ */
+static void iir_gauss_line(const IIRGaussCoefficients &coefs,
+                           IIRGaussLanes *X,
+                           IIRGaussLanes *W,
+                           const int len)
+{
+  const double *cf = coefs.cf;
+  const double *tsM = coefs.tsM;
+  /* The backward pass only reads `X` before overwriting it. */
+  IIRGaussLanes *Y = X;
+
+  /* Forward pass. */
+  W[0] = iir_lanes_madd4(cf, X[0], X[0], X[0], X[0]);
+  W[1] = iir_lanes_madd4(cf, X[1], W[0], X[0], X[0]);
+  W[2] = iir_lanes_madd4(cf, X[2], W[1], W[0], X[0]);
+  for (int i = 3; i < len; i++) {
+    W[i] = iir_lanes_madd4(cf, X[i], W[i - 1], W[i - 2], W[i - 3]);
+  }
+
+  /* Border corrections. */
+  const IIRGaussLanes last = X[len - 1];
+  const IIRGaussLanes tsu0 = iir_lanes_sub(W[len - 1], last);
+  const IIRGaussLanes tsu1 = iir_lanes_sub(W[len - 2], last);
+  const IIRGaussLanes tsu2 = iir_lanes_sub(W[len - 3], last);
+  const double tsM0[4] = {tsM[0], tsM[1], tsM[2], 1.0};
+  const double tsM1[4] = {tsM[3], tsM[4], tsM[5], 1.0};
+  const double tsM2[4] = {tsM[6], tsM[7], tsM[8], 1.0};
+  const IIRGaussLanes tsv0 = iir_lanes_madd4(tsM0, tsu0, tsu1, tsu2, last);
+  const IIRGaussLanes tsv1 = iir_lanes_madd4(tsM1, tsu0, tsu1, tsu2, last);
+  const IIRGaussLanes tsv2 = iir_lanes_madd4(tsM2, tsu0, tsu1, tsu2, last);
+
+  /* Backward pass. */
+  Y[len - 1] = iir_lanes_madd4(cf, W[len - 1], tsv0, tsv1, tsv2);
+  Y[len - 2] = iir_lanes_madd4(cf, W[len - 2], Y[len - 1], tsv0, tsv1);
+  Y[len - 3] = iir_lanes_madd4(cf, W[len - 3], Y[len - 2], Y[len - 1], tsv0);
+  for (int i = len - 4; i >= 0; i--) {
+    Y[i] = iir_lanes_madd4(cf, W[i], Y[i + 1], Y[i + 2], Y[i + 3]);
+  }
+}
+
+/**
+ * Filters channels `[channel, channel + num_channels)` of all lines along one axis.
+ */
+static void iir_gauss_axis(MemoryBuffer *src,
+                           const IIRGaussCoefficients &coefs,
+                           const int channel,
+                           const int num_channels,
+                           const bool vertical)
+{
+  BLI_assert(!src->is_a_single_elem());
+  BLI_assert(num_channels <= IIR_GAUSS_LANES);
+  const int len = vertical ? src->getHeight() : src->getWidth();
+  const int num_lines = vertical ? src->getWidth() : src->getHeight();
+  const int elem_stride = vertical ? src->row_stride : src->elem_stride;
+  const int line_stride = vertical ? src->elem_stride : src->row_stride;
+  float *buffer = src->getBuffer() + channel;
+
+  /* Pack several lines when filtering less channels than lanes. */
+  const int lines_per_packet = max_ii(1, IIR_GAUSS_LANES / num_channels);
+  const int num_packets = divide_ceil_u(num_lines, lines_per_packet);
+
+  threading::parallel_for(IndexRange(num_packets), 8, [&](const IndexRange packets) {
+    IIRGaussLanes *X = (IIRGaussLanes *)MEM_mallocN_aligned(
+        sizeof(IIRGaussLanes) * len, 16, "IIR_gauss X buf");
+    IIRGaussLanes *W = (IIRGaussLanes *)MEM_mallocN_aligned(
+        sizeof(IIRGaussLanes) * len, 16, "IIR_gauss W buf");
+
+    for (const int packet : packets) {
+      const int first_line = packet * lines_per_packet;
+      const int packet_lines = min_ii(lines_per_packet, num_lines - first_line);
+      float *line_start = buffer + first_line * line_stride;
+
+      double values[IIR_GAUSS_LANES] = {0.0};
+      for (int i = 0; i < len; i++) {
+        const float *elem = line_start + i * elem_stride;
+        for (int line = 0; line < packet_lines; line++, elem += line_stride) {
+          for (int c = 0; c < num_channels; c++) {
+            values[line * num_channels + c] = elem[c];
+          }
+        }
+        X[i] = iir_lanes_load(values);
       }
-      YVV(src_width);
-      offset = yx * num_channels + chan;
-      for (x = 0; x < src_width; x++) {
-        buffer[offset] = Y[x];
-        offset += num_channels;
+
+      iir_gauss_line(coefs, X, W, len);
+
+      for (int i = 0; i < len; i++) {
+        iir_lanes_store(X[i], values);
+        float *elem = line_start + i * elem_stride;
+        for (int line = 0; line < packet_lines; line++, elem += line_stride) {
+          for (int c = 0; c < num_channels; c++) {
+            elem[c] = values[line * num_channels + c];
+          }
+        }
       }
     }
+
+    MEM_freeN(X);
+    MEM_freeN(W);
+  });
+}
+
+static void iir_gauss(MemoryBuffer *src,
+                      const float sigma,
+                      const int channel,
+                      const int num_channels,
+                      unsigned int xy)
+{
+  IIRGaussCoefficients coefs;
+  if (!iir_gauss_coefficients(sigma, coefs)) {
+    return;
+  }
+
+  if ((xy < 1) || (xy > 3)) {
+    xy = 3;
+  }
+
+  /* XXX The border corrections explicitly expect sources of at least 3x3 pixels,
+   *     so just skipping blur along faulty direction if src's def is below that limit! */
+  if (src->getWidth() < 3) {
+    xy &= ~1;
+  }
+  if (src->getHeight() < 3) {
+    xy &= ~2;
+  }
+
+  if (xy & 1) { /* H. */
+    iir_gauss_axis(src, coefs, channel, num_channels, false);
   }
   if (xy & 2) { /* V. */
-    int offset;
-    const int add = src_width * num_channels;
-
-    for (x = 0; x < src_width; x++) {
-      offset = x * num_channels + chan;
-      for (y = 0; y < src_height; y++) {
-        X[y] = buffer[offset];
-        offset += add;
-      }
-      YVV(src_height);
-      offset = x * num_channels + chan;
-      for (y = 0; y < src_height; y++) {
-        buffer[offset] = Y[y];
-        offset += add;
-      }
-    }
+    iir_gauss_axis(src, coefs, channel, num_channels, true);
   }
+}
+
+void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src,
+                                          float sigma,
+                                          unsigned int chan,
+                                          unsigned int xy)
+{
+  iir_gauss(src, sigma, chan, 1, xy);
+}
 
-  MEM_freeN(X);
-  MEM_freeN(W);
-  MEM_freeN(Y);
-#undef YVV
+void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src,
+                                          float sigma,
+                                          IndexRange channels,
+                                          unsigned int xy)
+{
+  iir_gauss(src, sigma, channels.start(), channels.size(), xy);
 }
 
+/** \} */
+
 FastGaussianBlurValueOperation::FastGaussianBlurValueOperation()
 {
   this->addInputSocket(DataType::Value);
@@ -341,4 +522,48 @@ void *FastGaussianBlurValueOperation::initializeTileData(rcti *rect)
   return this->m_iirgaus;
 }
 
+void FastGaussianBlurValueOperation::get_area_of_interest(const int UNUSED(input_idx),
+                                                          const rcti &UNUSED(output_area),
+                                                          rcti &r_input_area)
+{
+  BLI_rcti_init(&r_input_area, 0, this->getWidth(), 0, this->getHeight());
+}
+
+void FastGaussianBlurValueOperation::update_memory_buffer_started(MemoryBuffer *UNUSED(output),
+                                                                  const rcti &UNUSED(area),
+                                                                  Span<MemoryBuffer *> inputs)
+{
+  if (this->m_iirgaus) {
+    return;
+  }
+
+  const MemoryBuffer *image = inputs[0];
+  MemoryBuffer *gauss = image->is_a_single_elem() ? image->inflate() : new MemoryBuffer(*image);
+  FastGaussianBlurOperation::IIR_gauss(gauss, this->m_sigma, 0, 3);
+  this->m_iirgaus = gauss;
+}
+
+void FastGaussianBlurValueOperation::update_memory_buffer_partial(MemoryBuffer *output,
+                                                                  const rcti &area,
+                                                                  Span<MemoryBuffer *> inputs)
+{
+  MemoryBuffer *image = inputs[0];
+  BuffersIterator<float> it = output->iterate_with({image, this->m_iirgaus}, area);
+  if (this->m_overlay == FAST_GAUSS_OVERLAY_MIN) {
+    for (; !it.is_end(); ++it) {
+      *it.out = MIN2(*it.in(0), *it.in(1));
+    }
+  }
+  else if (this->m_overlay == FAST_GAUSS_OVERLAY_MAX) {
+    for (; !it.is_end(); ++it) {
+      *it.out = MAX2(*it.in(0), *it.in(1));
+    }
+  }
+  else {
+    for (; !it.is_end(); ++it) {
+      *it.out = *it.in(1);
+    }
+  }
+}
+
 }  // namespace blender::compositor
@@ -29,6 +29,8 @@ class FastGaussianBlurOperation : public BlurBaseOperation {
   float m_sy;
   MemoryBuffer *m_iirgaus;
 
+  void blur_buffer(MemoryBuffer *copy);
+
  public:
   FastGaussianBlurOperation();
   bool determineDependingAreaOfInterest(rcti *input,
@@ -36,10 +38,24 @@ class FastGaussianBlurOperation : public BlurBaseOperation {
                                         rcti *output) override;
   void executePixel(float output[4], int x, int y, void *data) override;
 
+  /**
+   * Recursive gaussian blur of up to 4 channels along the X (`xy = 1`), Y (`xy = 2`) or both axes
+   * (`xy = 3`). Its cost doesn't depend on sigma, lines are filtered in parallel using SIMD.
+   */
+  static void IIR_gauss(MemoryBuffer *src, float sigma, IndexRange channels, unsigned int xy);
+  /** Recursive gaussian blur of a single channel. */
   static void IIR_gauss(MemoryBuffer *src, float sigma, unsigned int channel, unsigned int xy);
   void *initializeTileData(rcti *rect) override;
   void deinitExecution() override;
   void initExecution() override;
+
+  void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area) override;
+  void update_memory_buffer_started(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override;
+  void update_memory_buffer_partial(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override;
 };
 
 enum {
@@ -48,7 +64,7 @@ enum {
   FAST_GAUSS_OVERLAY_MAX = 1,
 };
 
-class FastGaussianBlurValueOperation : public NodeOperation {
+class FastGaussianBlurValueOperation : public MultiThreadedOperation {
  private:
   float m_sigma;
   MemoryBuffer *m_iirgaus;
@@ -80,6 +96,14 @@ class FastGaussianBlurValueOperation : public NodeOperation {
   {
     this->m_overlay = overlay;
   }
+
+  void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area) override;
+  void update_memory_buffer_started(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override;
+  void update_memory_buffer_partial(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override;
 };
 
 }  // namespace blender::compositor
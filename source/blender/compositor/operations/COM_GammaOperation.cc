@@ -30,6 +30,12 @@ GammaOperation::GammaOperation()
   this->m_inputGammaProgram = nullptr;
   flags.can_be_constant = true;
 }
+
+void GammaOperation::hash_output_params()
+{
+  /* Pass. */
+}
+
 void GammaOperation::initExecution()
 {
   this->m_inputProgram = this->getInputSocketReader(0);
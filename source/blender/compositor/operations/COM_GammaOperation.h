@@ -49,6 +49,9 @@ class GammaOperation : public MultiThreadedRowOperation {
   void deinitExecution() override;
 
   void update_memory_buffer_row(PixelCursor &p) override;
+
+ protected:
+  void hash_output_params() override;
 };
 
 }  // namespace blender::compositor
@@ -31,6 +31,12 @@ GaussianAlphaXBlurOperation::GaussianAlphaXBlurOperation() : BlurBaseOperation(D
   this->m_falloff = -1; /* intentionally invalid, so we can detect uninitialized values */
 }
 
+void GaussianAlphaXBlurOperation::hash_output_params()
+{
+  BlurBaseOperation::hash_output_params();
+  hash_params(m_falloff, m_do_subtract);
+}
+
 void *GaussianAlphaXBlurOperation::initializeTileData(rcti * /*rect*/)
 {
   lockMutex();
@@ -193,4 +199,76 @@ bool GaussianAlphaXBlurOperation::determineDependingAreaOfInterest(
   }
 }
 
+void GaussianAlphaXBlurOperation::get_area_of_interest(const int input_idx,
+                                                       const rcti &output_area,
+                                                       rcti &r_input_area)
+{
+  if (input_idx != IMAGE_INPUT_INDEX) {
+    BlurBaseOperation::get_area_of_interest(input_idx, output_area, r_input_area);
+    return;
+  }
+
+  get_gauss_area_of_interest(false, output_area, r_input_area);
+}
+
+void GaussianAlphaXBlurOperation::update_memory_buffer_started(MemoryBuffer *output,
+                                                               const rcti &area,
+                                                               Span<MemoryBuffer *> inputs)
+{
+  BlurBaseOperation::update_memory_buffer_started(output, area, inputs);
+  updateGauss();
+}
+
+void GaussianAlphaXBlurOperation::update_memory_buffer_partial(MemoryBuffer *output,
+                                                               const rcti &area,
+                                                               Span<MemoryBuffer *> inputs)
+{
+  const bool do_invert = this->m_do_subtract;
+  const MemoryBuffer *input = inputs[IMAGE_INPUT_INDEX];
+  const rcti &input_rect = input->get_rect();
+  const int step = getStep();
+  for (BuffersIterator<float> it = output->iterate_with({}, area); !it.is_end(); ++it) {
+    const int x = it.x;
+    const int y = it.y;
+    const int xmin = max_ii(x - m_filtersize, input_rect.xmin);
+    const int xmax = min_ii(x + m_filtersize + 1, input_rect.xmax);
+    const float *in = input->get_elem(xmin, y);
+    const int in_step = step * input->elem_stride;
+
+    /* Gauss. */
+    float alpha_accum = 0.0f;
+    float multiplier_accum = 0.0f;
+
+    /* Dilate, init with the current color to avoid unneeded lookups. */
+    float value_max = finv_test(*input->get_elem(x, y), do_invert);
+    float distfacinv_max = 1.0f; /* 0 to 1 */
+
+    for (int nx = xmin, index = (xmin - x) + this->m_filtersize; nx < xmax;
+         nx += step, index += step, in += in_step) {
+      float value = finv_test(*in, do_invert);
+
+      /* Gauss. */
+      float multiplier = this->m_gausstab[index];
+      alpha_accum += value * multiplier;
+      multiplier_accum += multiplier;
+
+      /* Dilate - find most extreme color. */
+      if (value > value_max) {
+        multiplier = this->m_distbuf_inv[index];
+        value *= multiplier;
+        if (value > value_max) {
+          value_max = value;
+          distfacinv_max = multiplier;
+        }
+      }
+    }
+
+    /* Blend between the max value and gauss blur - gives nice feather. */
+    const float value_blur = alpha_accum / multiplier_accum;
+    const float value_final = (value_max * distfacinv_max) +
+                              (value_blur * (1.0f - distfacinv_max));
+    *it.out = finv_test(value_final, do_invert);
+  }
+}
+
 }  // namespace blender::compositor
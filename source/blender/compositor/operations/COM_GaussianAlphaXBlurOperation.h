@@ -55,6 +55,14 @@ class GaussianAlphaXBlurOperation : public BlurBaseOperation {
                                         ReadBufferOperation *readOperation,
                                         rcti *output) override;
 
+  void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area) override;
+  void update_memory_buffer_started(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override;
+  void update_memory_buffer_partial(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override;
+
   /**
    * Set subtract for Dilate/Erode functionality
    */
@@ -66,6 +74,9 @@ class GaussianAlphaXBlurOperation : public BlurBaseOperation {
   {
     this->m_falloff = falloff;
   }
+
+ protected:
+  void hash_output_params() override;
 };
 
 }  // namespace blender::compositor
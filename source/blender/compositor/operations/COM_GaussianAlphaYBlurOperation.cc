@@ -31,6 +31,12 @@ GaussianAlphaYBlurOperation::GaussianAlphaYBlurOperation() : BlurBaseOperation(D
   this->m_falloff = -1; /* intentionally invalid, so we can detect uninitialized values */
 }
 
+void GaussianAlphaYBlurOperation::hash_output_params()
+{
+  BlurBaseOperation::hash_output_params();
+  hash_params(m_falloff, m_do_subtract);
+}
+
 void *GaussianAlphaYBlurOperation::initializeTileData(rcti * /*rect*/)
 {
   lockMutex();
@@ -192,4 +198,76 @@ bool GaussianAlphaYBlurOperation::determineDependingAreaOfInterest(
   }
 }
 
+void GaussianAlphaYBlurOperation::get_area_of_interest(const int input_idx,
+                                                       const rcti &output_area,
+                                                       rcti &r_input_area)
+{
+  if (input_idx != IMAGE_INPUT_INDEX) {
+    BlurBaseOperation::get_area_of_interest(input_idx, output_area, r_input_area);
+    return;
+  }
+
+  get_gauss_area_of_interest(true, output_area, r_input_area);
+}
+
+void GaussianAlphaYBlurOperation::update_memory_buffer_started(MemoryBuffer *output,
+                                                               const rcti &area,
+                                                               Span<MemoryBuffer *> inputs)
+{
+  BlurBaseOperation::update_memory_buffer_started(output, area, inputs);
+  updateGauss();
+}
+
+void GaussianAlphaYBlurOperation::update_memory_buffer_partial(MemoryBuffer *output,
+                                                               const rcti &area,
+                                                               Span<MemoryBuffer *> inputs)
+{
+  const bool do_invert = this->m_do_subtract;
+  const MemoryBuffer *input = inputs[IMAGE_INPUT_INDEX];
+  const rcti &input_rect = input->get_rect();
+  const int step = getStep();
+  for (BuffersIterator<float> it = output->iterate_with({}, area); !it.is_end(); ++it) {
+    const int x = it.x;
+    const int y = it.y;
+    const int ymin = max_ii(y - m_filtersize, input_rect.ymin);
+    const int ymax = min_ii(y + m_filtersize + 1, input_rect.ymax);
+    const float *in = input->get_elem(x, ymin);
+    const int in_step = step * input->row_stride;
+
+    /* Gauss. */
+    float alpha_accum = 0.0f;
+    float multiplier_accum = 0.0f;
+
+    /* Dilate, init with the current color to avoid unneeded lookups. */
+    float value_max = finv_test(*input->get_elem(x, y), do_invert);
+    float distfacinv_max = 1.0f; /* 0 to 1 */
+
+    for (int ny = ymin, index = (ymin - y) + this->m_filtersize; ny < ymax;
+         ny += step, index += step, in += in_step) {
+      float value = finv_test(*in, do_invert);
+
+      /* Gauss. */
+      float multiplier = this->m_gausstab[index];
+      alpha_accum += value * multiplier;
+      multiplier_accum += multiplier;
+
+      /* Dilate - find most extreme color. */
+      if (value > value_max) {
+        multiplier = this->m_distbuf_inv[index];
+        value *= multiplier;
+        if (value > value_max) {
+          value_max = value;
+          distfacinv_max = multiplier;
+        }
+      }
+    }
+
+    /* Blend between the max value and gauss blur - gives nice feather. */
+    const float value_blur = alpha_accum / multiplier_accum;
+    const float value_final = (value_max * distfacinv_max) +
+                              (value_blur * (1.0f - distfacinv_max));
+    *it.out = finv_test(value_final, do_invert);
+  }
+}
+
 }  // namespace blender::compositor
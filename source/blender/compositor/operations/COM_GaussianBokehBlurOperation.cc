@@ -196,6 +196,72 @@ bool GaussianBokehBlurOperation::determineDependingAreaOfInterest(
   return BlurBaseOperation::determineDependingAreaOfInterest(&newInput, readOperation, output);
 }
 
+void GaussianBokehBlurOperation::get_area_of_interest(const int input_idx,
+                                                      const rcti &output_area,
+                                                      rcti &r_input_area)
+{
+  if (input_idx != IMAGE_INPUT_INDEX) {
+    BlurBaseOperation::get_area_of_interest(input_idx, output_area, r_input_area);
+    return;
+  }
+
+  if (!this->m_sizeavailable) {
+    BLI_rcti_init(&r_input_area, 0, this->getWidth(), 0, this->getHeight());
+    return;
+  }
+
+  int sizex, sizey;
+  get_pixel_size(sizex, sizey);
+  const int addx = ceil(clamp_f(this->m_size * sizex, 0.0f, this->getWidth() / 2.0f));
+  const int addy = ceil(clamp_f(this->m_size * sizey, 0.0f, this->getHeight() / 2.0f));
+  r_input_area.xmin = output_area.xmin - addx;
+  r_input_area.xmax = output_area.xmax + addx;
+  r_input_area.ymin = output_area.ymin - addy;
+  r_input_area.ymax = output_area.ymax + addy;
+}
+
+void GaussianBokehBlurOperation::update_memory_buffer_started(MemoryBuffer *output,
+                                                              const rcti &area,
+                                                              Span<MemoryBuffer *> inputs)
+{
+  BlurBaseOperation::update_memory_buffer_started(output, area, inputs);
+  updateGauss();
+}
+
+void GaussianBokehBlurOperation::update_memory_buffer_partial(MemoryBuffer *output,
+                                                              const rcti &area,
+                                                              Span<MemoryBuffer *> inputs)
+{
+  const MemoryBuffer *input = inputs[IMAGE_INPUT_INDEX];
+  const rcti &input_rect = input->get_rect();
+  const int step = QualityStepHelper::getStep();
+  const int elem_step = step * input->elem_stride;
+  const int mul_const = (this->m_radx * 2 + 1);
+  for (BuffersIterator<float> it = output->iterate_with({}, area); !it.is_end(); ++it) {
+    const int x = it.x;
+    const int y = it.y;
+    const int ymin = max_ii(y - this->m_rady, input_rect.ymin);
+    const int ymax = min_ii(y + this->m_rady + 1, input_rect.ymax);
+    const int xmin = max_ii(x - this->m_radx, input_rect.xmin);
+    const int xmax = min_ii(x + this->m_radx + 1, input_rect.xmax);
+    const int add_const = (xmin - x + this->m_radx);
+
+    float temp_color[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    float multiplier_accum = 0.0f;
+    for (int ny = ymin; ny < ymax; ny += step) {
+      int index = ((ny - y) + this->m_rady) * mul_const + add_const;
+      const float *color = input->get_elem(xmin, ny);
+      for (int nx = xmin; nx < xmax; nx += step, index += step, color += elem_step) {
+        const float multiplier = this->m_gausstab[index];
+        madd_v4_v4fl(temp_color, color, multiplier);
+        multiplier_accum += multiplier;
+      }
+    }
+
+    mul_v4_v4fl(it.out, temp_color, 1.0f / multiplier_accum);
+  }
+}
+
 // reference image
 GaussianBlurReferenceOperation::GaussianBlurReferenceOperation()
     : BlurBaseOperation(DataType::Color)
@@ -363,4 +429,69 @@ bool GaussianBlurReferenceOperation::determineDependingAreaOfInterest(
   return NodeOperation::determineDependingAreaOfInterest(&newInput, readOperation, output);
 }
 
+void GaussianBlurReferenceOperation::get_area_of_interest(const int input_idx,
+                                                          const rcti &output_area,
+                                                          rcti &r_input_area)
+{
+  if (input_idx != IMAGE_INPUT_INDEX) {
+    /* The size is read per pixel. */
+    r_input_area = output_area;
+    return;
+  }
+
+  int sizex, sizey;
+  get_pixel_size(sizex, sizey);
+  const int addx = sizex + 2;
+  const int addy = sizey + 2;
+  r_input_area.xmin = output_area.xmin - addx;
+  r_input_area.xmax = output_area.xmax + addx;
+  r_input_area.ymin = output_area.ymin - addy;
+  r_input_area.ymax = output_area.ymax + addy;
+}
+
+void GaussianBlurReferenceOperation::update_memory_buffer_partial(MemoryBuffer *output,
+                                                                  const rcti &area,
+                                                                  Span<MemoryBuffer *> inputs)
+{
+  const MemoryBuffer *image_input = inputs[IMAGE_INPUT_INDEX];
+  MemoryBuffer *size_input = inputs[SIZE_INPUT_INDEX];
+  const int imgx = getWidth();
+  const int imgy = getHeight();
+  for (BuffersIterator<float> it = output->iterate_with({size_input}, area); !it.is_end(); ++it) {
+    const int x = it.x;
+    const int y = it.y;
+    const float ref_size = *it.in(0);
+    int ref_radx = (int)(ref_size * m_radx);
+    int ref_rady = (int)(ref_size * m_rady);
+    ref_radx = clamp_i(ref_radx, 1, m_filtersizex);
+    ref_rady = clamp_i(ref_rady, 1, m_filtersizey);
+
+    if (ref_radx == 1 && ref_rady == 1) {
+      image_input->read_elem(x, y, it.out);
+      continue;
+    }
+
+    const int minxr = x - ref_radx < 0 ? -x : -ref_radx;
+    const int maxxr = x + ref_radx > imgx ? imgx - x : ref_radx;
+    const int minyr = y - ref_rady < 0 ? -y : -ref_rady;
+    const int maxyr = y + ref_rady > imgy ? imgy - y : ref_rady;
+
+    const float *gausstabcentx = m_maintabs[ref_radx - 1] + ref_radx;
+    const float *gausstabcenty = m_maintabs[ref_rady - 1] + ref_rady;
+
+    float gauss_sum = 0.0f;
+    float color_sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    const float *row_color = image_input->get_elem(x + minxr, y + minyr);
+    for (int i = minyr; i < maxyr; i++, row_color += image_input->row_stride) {
+      const float *color = row_color;
+      for (int j = minxr; j < maxxr; j++, color += image_input->elem_stride) {
+        const float val = gausstabcenty[i] * gausstabcentx[j];
+        gauss_sum += val;
+        madd_v4_v4fl(color_sum, color, val);
+      }
+    }
+    mul_v4_v4fl(it.out, color_sum, 1.0f / gauss_sum);
+  }
+}
+
 }  // namespace blender::compositor
@@ -18,6 +18,7 @@
 
 #include "COM_GaussianXBlurOperation.h"
 #include "BLI_math.h"
+#include "COM_FastGaussianBlurOperation.h"
 #include "COM_OpenCLDevice.h"
 #include "MEM_guardedalloc.h"
 
@@ -32,6 +33,7 @@ GaussianXBlurOperation::GaussianXBlurOperation() : BlurBaseOperation(DataType::C
   this->m_gausstab_sse = nullptr;
 #endif
   this->m_filtersize = 0;
+  this->iir_buffer_ = nullptr;
 }
 
 void *GaussianXBlurOperation::initializeTileData(rcti * /*rect*/)
@@ -171,6 +173,11 @@ void GaussianXBlurOperation::deinitExecution()
   }
 #endif
 
+  if (this->iir_buffer_) {
+    delete this->iir_buffer_;
+    this->iir_buffer_ = nullptr;
+  }
+
   deinitMutex();
 }
 
@@ -208,4 +215,77 @@ bool GaussianXBlurOperation::determineDependingAreaOfInterest(rcti *input,
   }
 }
 
+void GaussianXBlurOperation::get_area_of_interest(const int input_idx,
+                                                  const rcti &output_area,
+                                                  rcti &r_input_area)
+{
+  if (input_idx != IMAGE_INPUT_INDEX) {
+    BlurBaseOperation::get_area_of_interest(input_idx, output_area, r_input_area);
+    return;
+  }
+
+  get_gauss_area_of_interest(false, output_area, r_input_area);
+}
+
+void GaussianXBlurOperation::update_memory_buffer_started(MemoryBuffer *output,
+                                                          const rcti &area,
+                                                          Span<MemoryBuffer *> inputs)
+{
+  BlurBaseOperation::update_memory_buffer_started(output, area, inputs);
+
+  const float rad = max_ff(m_size * m_data.sizex, 0.0f);
+  if (!use_iir_gauss(rad)) {
+    updateGauss();
+  }
+  else if (iir_buffer_ == nullptr) {
+    const MemoryBuffer *input = inputs[IMAGE_INPUT_INDEX];
+    iir_buffer_ = input->is_a_single_elem() ? input->inflate() : new MemoryBuffer(*input);
+    FastGaussianBlurOperation::IIR_gauss(
+        iir_buffer_, rad / 3.0f, IndexRange(iir_buffer_->get_num_channels()), 1);
+  }
+}
+
+void GaussianXBlurOperation::update_memory_buffer_partial(MemoryBuffer *output,
+                                                          const rcti &area,
+                                                          Span<MemoryBuffer *> inputs)
+{
+  if (iir_buffer_) {
+    output->copy_from(iir_buffer_, area);
+    return;
+  }
+
+  const MemoryBuffer *input = inputs[IMAGE_INPUT_INDEX];
+  const rcti &input_rect = input->get_rect();
+  const int step = getStep();
+  for (BuffersIterator<float> it = output->iterate_with({}, area); !it.is_end(); ++it) {
+    const int x = it.x;
+    const int y = it.y;
+    const int xmin = max_ii(x - m_filtersize, input_rect.xmin);
+    const int xmax = min_ii(x + m_filtersize + 1, input_rect.xmax);
+    const float *in = input->get_elem(xmin, y);
+    const int in_step = step * input->elem_stride;
+    float ATTR_ALIGN(16) color_accum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    float multiplier_accum = 0.0f;
+#ifdef BLI_HAVE_SSE2
+    __m128 accum_r = _mm_load_ps(color_accum);
+    for (int nx = xmin, index = (xmin - x) + this->m_filtersize; nx < xmax;
+         nx += step, index += step, in += in_step) {
+      __m128 reg_a = _mm_loadu_ps(in);
+      reg_a = _mm_mul_ps(reg_a, this->m_gausstab_sse[index]);
+      accum_r = _mm_add_ps(accum_r, reg_a);
+      multiplier_accum += this->m_gausstab[index];
+    }
+    _mm_store_ps(color_accum, accum_r);
+#else
+    for (int nx = xmin, index = (xmin - x) + this->m_filtersize; nx < xmax;
+         nx += step, index += step, in += in_step) {
+      const float multiplier = this->m_gausstab[index];
+      madd_v4_v4fl(color_accum, in, multiplier);
+      multiplier_accum += multiplier;
+    }
+#endif
+    mul_v4_v4fl(it.out, color_accum, 1.0f / multiplier_accum);
+  }
+}
+
 }  // namespace blender::compositor
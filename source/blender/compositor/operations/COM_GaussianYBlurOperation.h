@@ -30,6 +30,8 @@ class GaussianYBlurOperation : public BlurBaseOperation {
   __m128 *m_gausstab_sse;
 #endif
   int m_filtersize;
+  /** Input blurred with a recursive gaussian for large radius. */
+  MemoryBuffer *iir_buffer_;
   void updateGauss();
 
  public:
@@ -62,6 +64,14 @@ class GaussianYBlurOperation : public BlurBaseOperation {
                                         ReadBufferOperation *readOperation,
                                         rcti *output) override;
 
+  void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area) override;
+  void update_memory_buffer_started(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override;
+  void update_memory_buffer_partial(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override;
+
   void checkOpenCL()
   {
     flags.open_cl = (m_data.sizex >= 128);
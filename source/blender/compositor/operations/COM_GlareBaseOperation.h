@@ -49,6 +49,8 @@ class GlareBaseOperation : public SingleThreadedOperation {
    */
   NodeGlare *m_settings;
 
+  bool is_output_rendered_;
+
  public:
   /**
    * Initialize the execution
@@ -68,6 +70,11 @@ class GlareBaseOperation : public SingleThreadedOperation {
                                         ReadBufferOperation *readOperation,
                                         rcti *output) override;
 
+  void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area) override;
+  void update_memory_buffer(MemoryBuffer *output,
+                            const rcti &area,
+                            Span<MemoryBuffer *> inputs) override;
+
  protected:
   GlareBaseOperation();
 
@@ -48,16 +48,9 @@ void GlareGhostOperation::generateGlare(float *data, MemoryBuffer *inputTile, No
 
   bool breaked = false;
 
-  FastGaussianBlurOperation::IIR_gauss(&tbuf1, s1, 0, 3);
-  if (!breaked) {
-    FastGaussianBlurOperation::IIR_gauss(&tbuf1, s1, 1, 3);
-  }
-  if (isBraked()) {
-    breaked = true;
-  }
-  if (!breaked) {
-    FastGaussianBlurOperation::IIR_gauss(&tbuf1, s1, 2, 3);
-  }
+  /* Blur color channels only. */
+  const IndexRange rgb(3);
+  FastGaussianBlurOperation::IIR_gauss(&tbuf1, s1, rgb, 3);
 
   MemoryBuffer tbuf2(tbuf1);
 
@@ -65,19 +58,7 @@ void GlareGhostOperation::generateGlare(float *data, MemoryBuffer *inputTile, No
     breaked = true;
   }
   if (!breaked) {
-    FastGaussianBlurOperation::IIR_gauss(&tbuf2, s2, 0, 3);
-  }
-  if (isBraked()) {
-    breaked = true;
-  }
-  if (!breaked) {
-    FastGaussianBlurOperation::IIR_gauss(&tbuf2, s2, 1, 3);
-  }
-  if (isBraked()) {
-    breaked = true;
-  }
-  if (!breaked) {
-    FastGaussianBlurOperation::IIR_gauss(&tbuf2, s2, 2, 3);
+    FastGaussianBlurOperation::IIR_gauss(&tbuf2, s2, rgb, 3);
   }
 
   ofs = (settings->iter & 1) ? 0.5f : 0.0f;
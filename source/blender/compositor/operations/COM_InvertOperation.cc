@@ -31,6 +31,12 @@ InvertOperation::InvertOperation()
   this->m_alpha = false;
   setResolutionInputSocketIndex(1);
 }
+
+void InvertOperation::hash_output_params()
+{
+  hash_params(m_alpha, m_color);
+}
+
 void InvertOperation::initExecution()
 {
   this->m_inputValueProgram = this->getInputSocketReader(0);
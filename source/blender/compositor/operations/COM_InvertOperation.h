@@ -59,6 +59,9 @@ class InvertOperation : public NodeOperation {
   {
     this->m_alpha = alpha;
   }
+
+ protected:
+  void hash_output_params() override;
 };
 
 }  // namespace blender::compositor
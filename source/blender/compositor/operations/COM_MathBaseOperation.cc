@@ -34,6 +34,11 @@ MathBaseOperation::MathBaseOperation()
   this->m_useClamp = false;
 }
 
+void MathBaseOperation::hash_output_params()
+{
+  hash_param(m_useClamp);
+}
+
 void MathBaseOperation::initExecution()
 {
   this->m_inputValue1Operation = this->getInputSocketReader(0);
@@ -66,6 +66,9 @@ class MathBaseOperation : public NodeOperation {
   {
     this->m_useClamp = value;
   }
+
+ protected:
+  void hash_output_params() override;
 };
 
 class MathAddOperation : public MathBaseOperation {
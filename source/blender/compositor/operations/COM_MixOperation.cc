@@ -38,6 +38,11 @@ MixBaseOperation::MixBaseOperation()
   flags.can_be_constant = true;
 }
 
+void MixBaseOperation::hash_output_params()
+{
+  hash_params(m_valueAlphaMultiply, m_useClamp);
+}
+
 void MixBaseOperation::initExecution()
 {
   this->m_inputValueOperation = this->getInputSocketReader(0);
@@ -109,6 +109,7 @@ class MixBaseOperation : public MultiThreadedOperation {
 
  protected:
   virtual void update_memory_buffer_row(PixelCursor &p);
+  void hash_output_params() override;
 };
 
 class MixAddOperation : public MixBaseOperation {
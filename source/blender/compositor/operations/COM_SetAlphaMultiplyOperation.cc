@@ -30,6 +30,11 @@ SetAlphaMultiplyOperation::SetAlphaMultiplyOperation()
   this->m_inputAlpha = nullptr;
 }
 
+void SetAlphaMultiplyOperation::hash_output_params()
+{
+  /* Pass. */
+}
+
 void SetAlphaMultiplyOperation::initExecution()
 {
   this->m_inputColor = getInputSocketReader(0);
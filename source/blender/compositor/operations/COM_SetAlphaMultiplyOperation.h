@@ -39,6 +39,9 @@ class SetAlphaMultiplyOperation : public NodeOperation {
 
   void initExecution() override;
   void deinitExecution() override;
+
+ protected:
+  void hash_output_params() override;
 };
 
 }  // namespace blender::compositor
@@ -30,6 +30,11 @@ SetAlphaReplaceOperation::SetAlphaReplaceOperation()
   this->m_inputAlpha = nullptr;
 }
 
+void SetAlphaReplaceOperation::hash_output_params()
+{
+  /* Pass. */
+}
+
 void SetAlphaReplaceOperation::initExecution()
 {
   this->m_inputColor = getInputSocketReader(0);
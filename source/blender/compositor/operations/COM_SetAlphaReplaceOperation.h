@@ -44,6 +44,9 @@ class SetAlphaReplaceOperation : public NodeOperation {
 
   void initExecution() override;
   void deinitExecution() override;
+
+ protected:
+  void hash_output_params() override;
 };
 
 }  // namespace blender::compositor
@@ -39,6 +39,13 @@ TranslateOperation::TranslateOperation(DataType data_type)
   this->x_extend_mode_ = MemoryBufferExtend::Clip;
   this->y_extend_mode_ = MemoryBufferExtend::Clip;
 }
+
+void TranslateOperation::hash_output_params()
+{
+  hash_params(m_factorX, m_factorY);
+  hash_params(static_cast<int>(x_extend_mode_), static_cast<int>(y_extend_mode_));
+}
+
 void TranslateOperation::initExecution()
 {
   this->m_inputOperation = this->getInputSocketReader(0);
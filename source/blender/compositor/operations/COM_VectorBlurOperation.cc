@@ -57,6 +57,7 @@ VectorBlurOperation::VectorBlurOperation()
   this->m_inputSpeedProgram = nullptr;
   this->m_inputZProgram = nullptr;
   flags.complex = true;
+  flags.is_fullframe_operation = true;
 }
 void VectorBlurOperation::initExecution()
 {
@@ -121,6 +122,46 @@ bool VectorBlurOperation::determineDependingAreaOfInterest(rcti * /*input*/,
   return false;
 }
 
+void VectorBlurOperation::get_area_of_interest(const int UNUSED(input_idx),
+                                               const rcti &UNUSED(output_area),
+                                               rcti &r_input_area)
+{
+  r_input_area.xmin = 0;
+  r_input_area.xmax = this->getWidth();
+  r_input_area.ymin = 0;
+  r_input_area.ymax = this->getHeight();
+}
+
+void VectorBlurOperation::update_memory_buffer(MemoryBuffer *output,
+                                               const rcti &area,
+                                               Span<MemoryBuffer *> inputs)
+{
+  if (this->m_cachedInstance == nullptr) {
+    /* Ensure full buffers to work with no strides. */
+    Vector<MemoryBuffer *> full_inputs;
+    for (MemoryBuffer *input : inputs) {
+      full_inputs.append(input->is_a_single_elem() ? input->inflate() : input);
+    }
+
+    MemoryBuffer *image = full_inputs[0];
+    MemoryBuffer *z = full_inputs[1];
+    MemoryBuffer *speed = full_inputs[2];
+    float *data = (float *)MEM_dupallocN(image->getBuffer());
+    this->generateVectorBlur(data, image, speed, z);
+    this->m_cachedInstance = data;
+
+    for (int i = 0; i < inputs.size(); i++) {
+      if (full_inputs[i] != inputs[i]) {
+        delete full_inputs[i];
+      }
+    }
+  }
+
+  MemoryBuffer buf(
+      this->m_cachedInstance, COM_DATA_TYPE_COLOR_CHANNELS, this->getWidth(), this->getHeight());
+  output->copy_from(&buf, area);
+}
+
 void VectorBlurOperation::generateVectorBlur(float *data,
                                              MemoryBuffer *inputImage,
                                              MemoryBuffer *inputSpeed,
@@ -68,6 +68,11 @@ class VectorBlurOperation : public NodeOperation, public QualityStepHelper {
                                         ReadBufferOperation *readOperation,
                                         rcti *output) override;
 
+  void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area) override;
+  void update_memory_buffer(MemoryBuffer *output,
+                            const rcti &area,
+                            Span<MemoryBuffer *> inputs) override;
+
  protected:
   void generateVectorBlur(float *data,
                           MemoryBuffer *inputImage,
@@ -0,0 +1,149 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "BLI_rand.h"
+#include "BLI_rect.h"
+#include "BLI_vector.hh"
+
+#include "COM_FFTConvolution.h"
+
+namespace blender::compositor::tests {
+
+static constexpr int num_channels = 4;
+
+static Vector<float> create_random_buffer(const rcti &rect, const uint seed)
+{
+  Vector<float> buffer(BLI_rcti_size_x(&rect) * BLI_rcti_size_y(&rect) * num_channels);
+  RNG *rng = BLI_rng_new(seed);
+  for (float &value : buffer) {
+    value = BLI_rng_get_float(rng) * 2.0f - 1.0f;
+  }
+  BLI_rng_free(rng);
+  return buffer;
+}
+
+/* Spatial convolution as documented by #FFTConvolution, in double precision. */
+static float reference_convolution(const MemoryBuffer &image,
+                                   const rcti &image_area,
+                                   const MemoryBuffer &kernel,
+                                   const int center_x,
+                                   const int center_y,
+                                   const int x,
+                                   const int y,
+                                   const int channel)
+{
+  double sum = 0.0;
+  for (int j = 0; j < kernel.getHeight(); j++) {
+    const int image_y = y + j - center_y;
+    if (image_y < image_area.ymin || image_y >= image_area.ymax) {
+      continue;
+    }
+    for (int i = 0; i < kernel.getWidth(); i++) {
+      const int image_x = x + i - center_x;
+      if (image_x < image_area.xmin || image_x >= image_area.xmax) {
+        continue;
+      }
+      sum += (double)kernel.get_value(i, j, channel) *
+             image.get_value(image_x, image_y, channel);
+    }
+  }
+  return (float)sum;
+}
+
+/* Image rect not starting at the origin, to catch mixing up of rect and buffer coordinates. */
+static rcti image_rect_area(const int image_width, const int image_height)
+{
+  rcti rect;
+  BLI_rcti_init(&rect, 3, 3 + image_width, -2, -2 + image_height);
+  return rect;
+}
+
+/**
+ * Convolve a random image with a random kernel and compare the pixels of `output_area` against
+ * the spatial convolution. Other pixels and the last channel, which is not convolved, must be
+ * left untouched.
+ */
+static void test_convolution(const int image_width,
+                             const int image_height,
+                             const int kernel_width,
+                             const int kernel_height,
+                             const int center_x,
+                             const int center_y,
+                             const rcti &image_area,
+                             const rcti &output_area)
+{
+  const rcti image_rect = image_rect_area(image_width, image_height);
+  rcti kernel_rect;
+  BLI_rcti_init(&kernel_rect, 0, kernel_width, 0, kernel_height);
+
+  Vector<float> image_data = create_random_buffer(image_rect, 1);
+  Vector<float> kernel_data = create_random_buffer(kernel_rect, 2);
+  Vector<float> output_data(image_data.size(), -2.0f);
+  MemoryBuffer image(image_data.data(), num_channels, image_rect);
+  MemoryBuffer kernel(kernel_data.data(), num_channels, kernel_rect);
+  MemoryBuffer output(output_data.data(), num_channels, image_rect);
+
+  const IndexRange channels(num_channels - 1);
+  FFTConvolution convolution(&kernel, center_x, center_y, channels, image_width, image_height);
+  convolution.execute(&image, image_area, &output, output_area);
+
+  for (int y = image_rect.ymin; y < image_rect.ymax; y++) {
+    for (int x = image_rect.xmin; x < image_rect.xmax; x++) {
+      const bool in_area = x >= output_area.xmin && x < output_area.xmax &&
+                           y >= output_area.ymin && y < output_area.ymax;
+      for (int channel = 0; channel < num_channels; channel++) {
+        const float result = output.get_value(x, y, channel);
+        if (!in_area || channel == num_channels - 1) {
+          EXPECT_EQ(result, -2.0f) << "x=" << x << " y=" << y << " channel=" << channel;
+          continue;
+        }
+        const float expected = reference_convolution(
+            image, image_area, kernel, center_x, center_y, x, y, channel);
+        EXPECT_NEAR(result, expected, 1e-4f) << "x=" << x << " y=" << y << " channel=" << channel;
+      }
+    }
+  }
+}
+
+TEST(fft_convolution, odd_kernel)
+{
+  const rcti area = image_rect_area(37, 23);
+  test_convolution(37, 23, 7, 5, 3, 2, area, area);
+}
+
+TEST(fft_convolution, even_kernel)
+{
+  const rcti area = image_rect_area(29, 42);
+  test_convolution(29, 42, 6, 8, 3, 4, area, area);
+}
+
+TEST(fft_convolution, off_center_kernel)
+{
+  const rcti area = image_rect_area(19, 13);
+  test_convolution(19, 13, 4, 9, 0, 8, area, area);
+}
+
+TEST(fft_convolution, kernel_larger_than_image)
+{
+  const rcti area = image_rect_area(11, 6);
+  test_convolution(11, 6, 15, 15, 7, 7, area, area);
+}
+
+TEST(fft_convolution, partial_areas)
+{
+  rcti image_area;
+  BLI_rcti_init(&image_area, 8, 30, 1, 17);
+  rcti output_area;
+  BLI_rcti_init(&output_area, 5, 21, 4, 18);
+  test_convolution(33, 21, 5, 6, 2, 3, image_area, output_area);
+}
+
+TEST(fft_convolution, multiple_blocks)
+{
+  /* Wider than the largest FFT size, so the image is convolved in several blocks. */
+  const rcti area = image_rect_area(2500, 5);
+  test_convolution(2500, 5, 9, 3, 4, 1, area, area);
+}
+
+}  // namespace blender::compositor::tests
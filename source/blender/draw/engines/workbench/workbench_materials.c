@@ -264,9 +264,13 @@ DRWShadingGroup *workbench_image_setup_ex(WORKBENCH_PrivateData *wpd,
       tex = BKE_image_get_gpu_tiles(ima, iuser, NULL);
       tex_tile_data = BKE_image_get_gpu_tilemap(ima, iuser, NULL);
     }
-    else {
+    else if (DRW_state_is_image_render()) {
       tex = BKE_image_get_gpu_texture(ima, iuser, NULL);
     }
+    else {
+      /* Draw the viewport before the image is loaded. */
+      tex = BKE_image_get_gpu_texture_async(ima, iuser);
+    }
   }
 
   if (tex == NULL) {
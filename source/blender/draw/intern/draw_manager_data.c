@@ -1366,7 +1366,10 @@ void DRW_shgroup_add_material_resources(DRWShadingGroup *grp, struct GPUMaterial
         drw_shgroup_material_texture(grp, gputex, tex->tiled_mapping_name, tex->sampler_state);
       }
       else {
-        gputex = BKE_image_get_gpu_texture(tex->ima, tex->iuser, NULL);
+        /* Renders need the actual image, the viewport can draw before it's loaded. */
+        gputex = DRW_state_is_image_render() ?
+                     BKE_image_get_gpu_texture(tex->ima, tex->iuser, NULL) :
+                     BKE_image_get_gpu_texture_async(tex->ima, tex->iuser);
         drw_shgroup_material_texture(grp, gputex, tex->sampler_name, tex->sampler_state);
       }
     }
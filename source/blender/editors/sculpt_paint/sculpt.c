@@ -3273,23 +3273,31 @@ static void do_draw_brush_task_cb_ex(void *__restrict userdata,
 
   proxy = BKE_pbvh_node_add_proxy(ss->pbvh, data->nodes[n])->co;
 
+  /* Read the vertex data from contiguous arrays when available, indexed like the proxy. */
+  PBVHVertData *vert_data = BKE_pbvh_node_vert_data_ensure(ss->pbvh, data->nodes[n]);
+
   SculptBrushTest test;
   SculptBrushTestFn sculpt_brush_test_sq_fn = SCULPT_brush_test_init_with_falloff_shape(
       ss, &test, data->brush->falloff_shape);
   const int thread_id = BLI_task_parallel_thread_id(tls);
 
   BKE_pbvh_vertex_iter_begin (ss->pbvh, data->nodes[n], vd, PBVH_ITER_UNIQUE) {
-    if (!sculpt_brush_test_sq_fn(&test, vd.co)) {
+    const float *co = vert_data ? vert_data->co[vd.i] : vd.co;
+    if (!sculpt_brush_test_sq_fn(&test, co)) {
       continue;
     }
+    float mask = vd.mask ? *vd.mask : 0.0f;
+    if (vert_data) {
+      mask = vert_data->mask ? vert_data->mask[vd.i] : 0.0f;
+    }
     /* Offset vertex. */
     const float fade = SCULPT_brush_strength_factor(ss,
                                                     brush,
-                                                    vd.co,
+                                                    co,
                                                     sqrtf(test.dist),
-                                                    vd.no,
-                                                    vd.fno,
-                                                    vd.mask ? *vd.mask : 0.0f,
+                                                    vert_data ? NULL : vd.no,
+                                                    vert_data ? vert_data->no[vd.i] : vd.fno,
+                                                    mask,
                                                     vd.index,
                                                     thread_id);
 
@@ -6209,7 +6217,11 @@ static void sculpt_combine_proxies_task_cb(void *__restrict userdata,
 
   BKE_pbvh_node_get_proxies(data->nodes[n], &proxies, &proxy_count);
 
+  /* Apply the proxies to the vertex data when a brush used it, and write it back. */
+  PBVHVertData *vert_data = BKE_pbvh_node_vert_data_get(data->nodes[n]);
+
   BKE_pbvh_vertex_iter_begin (ss->pbvh, data->nodes[n], vd, PBVH_ITER_UNIQUE) {
+    float *co = vert_data ? vert_data->co[vd.i] : vd.co;
     float val[3];
 
     if (use_orco) {
@@ -6221,14 +6233,17 @@ static void sculpt_combine_proxies_task_cb(void *__restrict userdata,
       }
     }
     else {
-      copy_v3_v3(val, vd.co);
+      copy_v3_v3(val, co);
     }
 
     for (int p = 0; p < proxy_count; p++) {
       add_v3_v3(val, proxies[p].co[vd.i]);
     }
 
-    SCULPT_clip(sd, ss, vd.co, val);
+    SCULPT_clip(sd, ss, co, val);
+    if (vert_data) {
+      copy_v3_v3(vd.co, co);
+    }
 
     if (ss->deform_modifiers_active) {
       sculpt_flush_pbvhvert_deform(ob, &vd);
@@ -6237,6 +6252,10 @@ static void sculpt_combine_proxies_task_cb(void *__restrict userdata,
   BKE_pbvh_vertex_iter_end;
 
   BKE_pbvh_node_free_proxies(data->nodes[n]);
+
+  if (vert_data) {
+    BKE_pbvh_node_mark_normals_update(data->nodes[n]);
+  }
 }
 
 static void sculpt_combine_proxies(Sculpt *sd, Object *ob)
@@ -7744,7 +7763,16 @@ void SCULPT_flush_update_step(bContext *C, SculptUpdateType update_flags)
   }
 
   if (mmd != NULL) {
-    multires_mark_as_modified(depsgraph, ob, MULTIRES_COORDS_MODIFIED);
+    if (BKE_pbvh_type(ss->pbvh) == PBVH_GRIDS) {
+      /* Only tag grids touched by this step, so reshape does not process the whole surface. */
+      int *grid_indices, totgrid;
+      BKE_pbvh_get_modified_grids(ss->pbvh, true, &grid_indices, &totgrid);
+      multires_mark_grids_as_modified(depsgraph, ob, grid_indices, totgrid);
+      MEM_SAFE_FREE(grid_indices);
+    }
+    else {
+      multires_mark_as_modified(depsgraph, ob, MULTIRES_COORDS_MODIFIED);
+    }
   }
 
   DEG_id_tag_update(&ob->id, ID_RECALC_SHADING);
@@ -8019,6 +8047,7 @@ static void sculpt_stroke_done(const bContext *C, struct PaintStroke *UNUSED(str
   }
 
   BKE_pbvh_node_color_buffer_free(ss->pbvh);
+  BKE_pbvh_vert_data_free(ss->pbvh);
   SCULPT_cache_free(ss->cache);
   ss->cache = NULL;
 
@@ -334,6 +334,14 @@ typedef enum eIMBInterpolationFilterMode {
   IMB_FILTER_BILINEAR,
 } eIMBInterpolationFilterMode;
 
+typedef enum eIMBScaleFilter {
+  /** Average of the covered pixels when shrinking, linear interpolation when enlarging. */
+  IMB_SCALE_FILTER_BOX,
+  IMB_SCALE_FILTER_BILINEAR,
+  /** Sharper, but slower. Values may overshoot near edges. */
+  IMB_SCALE_FILTER_LANCZOS,
+} eIMBScaleFilter;
+
 /* Defaults to BL_proxy within the directory of the animation. */
 void IMB_anim_set_index_dir(struct anim *anim, const char *dir);
 void IMB_anim_get_fname(struct anim *anim, char *file, int size);
@@ -461,6 +469,16 @@ struct ImBuf *IMB_onehalf(struct ImBuf *ibuf1);
  */
 bool IMB_scaleImBuf(struct ImBuf *ibuf, unsigned int newx, unsigned int newy);
 
+/**
+ * Scale with the given filter, multi-threaded for large images.
+ *
+ * \attention Defined in scaling.c
+ */
+bool IMB_scaleImBuf_filter(struct ImBuf *ibuf,
+                           unsigned int newx,
+                           unsigned int newy,
+                           eIMBScaleFilter filter);
+
 /**
  *
  * \attention Defined in scaling.c
@@ -82,6 +82,7 @@
 
 struct IDProperty;
 struct _AviMovie;
+struct anim_decoder_pool;
 struct anim_index;
 
 struct anim {
@@ -135,6 +136,9 @@ struct anim {
   int64_t cur_pts;
   int64_t cur_key_frame_pts;
   AVPacket *cur_packet;
+
+  /* Recently decoded frames and decoders reading ahead in other GOPs. */
+  struct anim_decoder_pool *decoder_pool;
 #endif
 
   char index_dir[768];
@@ -106,6 +106,8 @@ uint64_t IMB_indexer_get_pts(struct anim_index *idx, int frame_index);
 int IMB_indexer_get_duration(struct anim_index *idx);
 
 int IMB_indexer_can_scan(struct anim_index *idx, int old_frame_index, int new_frame_index);
+/* First frame index of the GOP that contains the frame index. */
+int IMB_indexer_get_gop_start(struct anim_index *idx, int frame_index);
 
 void IMB_indexer_close(struct anim_index *idx);
 
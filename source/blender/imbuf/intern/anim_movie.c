@@ -55,6 +55,7 @@
 
 #include "BLI_path_util.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
@@ -202,6 +203,7 @@ static void free_anim_avi(struct anim *anim)
 
 #ifdef WITH_FFMPEG
 static void free_anim_ffmpeg(struct anim *anim);
+static struct anim_decoder_pool *ffmpeg_decoder_pool_create(struct anim *anim);
 #endif
 
 void IMB_free_anim(struct anim *anim)
@@ -755,25 +757,22 @@ static int startffmpeg(struct anim *anim)
     fprintf(stderr, "Warning: Could not set libswscale colorspace details.\n");
   }
 
+  anim->decoder_pool = ffmpeg_decoder_pool_create(anim);
+
   return 0;
 }
 
-/* postprocess the image in anim->pFrame and do color conversion
+/* postprocess the decoded frame and do color conversion
  * and deinterlacing stuff.
  *
- * Output is anim->cur_frame_final
+ * Output is ibuf
  */
 
-static void ffmpeg_postprocess(struct anim *anim)
+static void ffmpeg_postprocess(struct anim *anim, AVFrame *frame, ImBuf *ibuf)
 {
-  AVFrame *input = anim->pFrame;
-  ImBuf *ibuf = anim->cur_frame_final;
+  AVFrame *input = frame;
   int filter_y = 0;
 
-  if (!anim->pFrameComplete) {
-    return;
-  }
-
   /* This means the data wasn't read properly,
    * this check stops crashing */
   if (input->data[0] == 0 && input->data[1] == 0 && input->data[2] == 0 && input->data[3] == 0) {
@@ -785,7 +784,7 @@ static void ffmpeg_postprocess(struct anim *anim)
 
   av_log(anim->pFormatCtx,
          AV_LOG_DEBUG,
-         "  POSTPROC: anim->pFrame planes: %p %p %p %p\n",
+         "  POSTPROC: frame planes: %p %p %p %p\n",
          input->data[0],
          input->data[1],
          input->data[2],
@@ -793,7 +792,7 @@ static void ffmpeg_postprocess(struct anim *anim)
 
   if (anim->ib_flags & IB_animdeinterlace) {
     if (av_image_deinterlace(anim->pFrameDeinterlaced,
-                             anim->pFrame,
+                             frame,
                              anim->pCodecCtx->pix_fmt,
                              anim->pCodecCtx->width,
                              anim->pCodecCtx->height) < 0) {
@@ -894,6 +893,180 @@ static void ffmpeg_postprocess(struct anim *anim)
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Decoder Pool
+ *
+ * Seeking to a key frame and decoding up to the requested frame makes random access and
+ * scrubbing backwards slow. Recently decoded frames are kept in a small ring, so frames of the
+ * same GOP don't have to be decoded again. When scrubbing backwards and a timecode index is
+ * available, additional decoders read ahead the previous GOPs in the background, each with
+ * their own demuxer so they can seek independently.
+ * \{ */
+
+/* Memory budget of the decoded frames kept per movie. */
+#  define ANIM_FRAME_RING_MEMORY (128 * 1024 * 1024)
+#  define ANIM_FRAME_RING_MAX_FRAMES 64
+#  define ANIM_READ_AHEAD_DECODERS 2
+
+struct anim_ring_frame {
+  AVFrame *frame;
+  int64_t pts;
+  int64_t duration;
+};
+
+struct anim_decoder {
+  AVFormatContext *format_ctx;
+  AVCodecContext *codec_ctx;
+  AVFrame *frame;
+  AVPacket *packet;
+
+  /* Seek position of the GOP being decoded, only valid when busy. */
+  bool is_busy;
+  int64_t seek_pos;
+};
+
+struct anim_decoder_pool {
+  ThreadMutex mutex;
+
+  struct anim_ring_frame *ring;
+  int ring_size;
+  int ring_len;
+  /* When the ring is full, the frame farthest from this PTS is dropped. */
+  int64_t ring_center_pts;
+
+  struct anim_decoder decoders[ANIM_READ_AHEAD_DECODERS];
+  TaskPool *task_pool;
+  int last_position;
+};
+
+static struct anim_decoder_pool *ffmpeg_decoder_pool_create(struct anim *anim)
+{
+  struct anim_decoder_pool *pool = MEM_callocN(sizeof(*pool), "anim decoder pool");
+  const int frame_size = av_image_get_buffer_size(
+      anim->pCodecCtx->pix_fmt, anim->pCodecCtx->width, anim->pCodecCtx->height, 1);
+
+  BLI_mutex_init(&pool->mutex);
+  pool->ring_size = (frame_size > 0) ? ANIM_FRAME_RING_MEMORY / frame_size :
+                                       ANIM_FRAME_RING_MAX_FRAMES;
+  CLAMP(pool->ring_size, 2, ANIM_FRAME_RING_MAX_FRAMES);
+  pool->ring = MEM_callocN(sizeof(*pool->ring) * pool->ring_size, "anim frame ring");
+  pool->last_position = -1;
+
+  return pool;
+}
+
+static void ffmpeg_decoder_close(struct anim_decoder *decoder)
+{
+  if (decoder->codec_ctx) {
+    avcodec_free_context(&decoder->codec_ctx);
+  }
+  if (decoder->format_ctx) {
+    avformat_close_input(&decoder->format_ctx);
+  }
+  av_packet_free(&decoder->packet);
+  av_frame_free(&decoder->frame);
+}
+
+static void ffmpeg_decoder_pool_free(struct anim_decoder_pool *pool)
+{
+  if (pool == NULL) {
+    return;
+  }
+
+  if (pool->task_pool) {
+    BLI_task_pool_cancel(pool->task_pool);
+    BLI_task_pool_free(pool->task_pool);
+  }
+
+  for (int i = 0; i < ANIM_READ_AHEAD_DECODERS; i++) {
+    ffmpeg_decoder_close(&pool->decoders[i]);
+  }
+  for (int i = 0; i < pool->ring_len; i++) {
+    av_frame_free(&pool->ring[i].frame);
+  }
+
+  BLI_mutex_end(&pool->mutex);
+  MEM_freeN(pool->ring);
+  MEM_freeN(pool);
+}
+
+/* Index of the ring frame that is shown at the given PTS, or -1. Mutex must be locked. */
+static int ffmpeg_frame_ring_find(struct anim_decoder_pool *pool, int64_t pts)
+{
+  for (int i = 0; i < pool->ring_len; i++) {
+    const struct anim_ring_frame *ring_frame = &pool->ring[i];
+    if (pts >= ring_frame->pts && pts < ring_frame->pts + MAX2(ring_frame->duration, 1)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static void ffmpeg_frame_ring_add(struct anim_decoder_pool *pool, AVFrame *frame)
+{
+  const int64_t pts = av_get_pts_from_frame(frame);
+
+  BLI_mutex_lock(&pool->mutex);
+
+  if (ffmpeg_frame_ring_find(pool, pts) == -1) {
+    int index = pool->ring_len;
+
+    if (pool->ring_len == pool->ring_size) {
+      /* Replace the frame farthest from the last requested frame, unless the new frame is even
+       * farther away. */
+      uint64_t max_distance = llabs(pts - pool->ring_center_pts);
+      index = -1;
+      for (int i = 0; i < pool->ring_len; i++) {
+        const uint64_t distance = llabs(pool->ring[i].pts - pool->ring_center_pts);
+        if (distance > max_distance) {
+          max_distance = distance;
+          index = i;
+        }
+      }
+      if (index != -1) {
+        av_frame_free(&pool->ring[index].frame);
+      }
+    }
+    else {
+      pool->ring_len++;
+    }
+
+    if (index != -1) {
+      pool->ring[index].frame = av_frame_clone(frame);
+      pool->ring[index].pts = pts;
+      pool->ring[index].duration = frame->pkt_duration;
+    }
+  }
+
+  BLI_mutex_unlock(&pool->mutex);
+}
+
+static bool ffmpeg_frame_ring_contains(struct anim_decoder_pool *pool, int64_t pts)
+{
+  BLI_mutex_lock(&pool->mutex);
+  const bool found = ffmpeg_frame_ring_find(pool, pts) != -1;
+  BLI_mutex_unlock(&pool->mutex);
+  return found;
+}
+
+/* Get a new reference to the ring frame shown at the given PTS, or NULL. */
+static AVFrame *ffmpeg_frame_ring_get(struct anim_decoder_pool *pool, int64_t pts)
+{
+  AVFrame *frame = NULL;
+
+  BLI_mutex_lock(&pool->mutex);
+  pool->ring_center_pts = pts;
+  const int index = ffmpeg_frame_ring_find(pool, pts);
+  if (index != -1) {
+    frame = av_frame_clone(pool->ring[index].frame);
+  }
+  BLI_mutex_unlock(&pool->mutex);
+
+  return frame;
+}
+
+/** \} */
+
 /* decode one video frame also considering the packet read into cur_packet */
 
 static int ffmpeg_decode_video_frame(struct anim *anim)
@@ -925,6 +1098,7 @@ static int ffmpeg_decode_video_frame(struct anim *anim)
 
       if (anim->pFrameComplete) {
         anim->cur_pts = av_get_pts_from_frame(anim->pFrame);
+        ffmpeg_frame_ring_add(anim->decoder_pool, anim->pFrame);
 
         if (anim->pFrame->key_frame) {
           anim->cur_key_frame_pts = anim->cur_pts;
@@ -950,6 +1124,7 @@ static int ffmpeg_decode_video_frame(struct anim *anim)
 
     if (anim->pFrameComplete) {
       anim->cur_pts = av_get_pts_from_frame(anim->pFrame);
+      ffmpeg_frame_ring_add(anim->decoder_pool, anim->pFrame);
 
       if (anim->pFrame->key_frame) {
         anim->cur_key_frame_pts = anim->cur_pts;
@@ -1340,6 +1515,194 @@ static int ffmpeg_seek_to_key_frame(struct anim *anim,
   return ret;
 }
 
+/* Open a decoder for the video stream with its own demuxer, so it can seek independently. */
+static bool ffmpeg_decoder_open(struct anim *anim, struct anim_decoder *decoder)
+{
+  if (avformat_open_input(&decoder->format_ctx, anim->name, NULL, NULL) != 0) {
+    return false;
+  }
+  if (avformat_find_stream_info(decoder->format_ctx, NULL) < 0 ||
+      anim->videoStream >= decoder->format_ctx->nb_streams) {
+    avformat_close_input(&decoder->format_ctx);
+    return false;
+  }
+
+  AVStream *video_stream = decoder->format_ctx->streams[anim->videoStream];
+  decoder->codec_ctx = avcodec_alloc_context3(NULL);
+  avcodec_parameters_to_context(decoder->codec_ctx, video_stream->codecpar);
+  decoder->codec_ctx->workaround_bugs = FF_BUG_AUTODETECT;
+  decoder->codec_ctx->thread_count = anim->pCodecCtx->thread_count;
+  decoder->codec_ctx->thread_type = anim->pCodecCtx->thread_type;
+
+  if (avcodec_open2(decoder->codec_ctx, anim->pCodec, NULL) < 0 ||
+      decoder->codec_ctx->pix_fmt != anim->pCodecCtx->pix_fmt) {
+    ffmpeg_decoder_close(decoder);
+    return false;
+  }
+
+  decoder->frame = av_frame_alloc();
+  decoder->packet = av_packet_alloc();
+  return true;
+}
+
+typedef struct AnimReadAheadTask {
+  struct anim_decoder *decoder;
+  int64_t seek_pos;
+  int64_t seek_pts;
+  bool seek_by_byte;
+  /* PTS of the last frame of the GOP. */
+  int64_t last_pts;
+} AnimReadAheadTask;
+
+/* Decode a GOP into the frame ring. */
+static void ffmpeg_read_ahead_task(TaskPool *__restrict task_pool, void *taskdata)
+{
+  struct anim *anim = BLI_task_pool_user_data(task_pool);
+  struct anim_decoder_pool *pool = anim->decoder_pool;
+  AnimReadAheadTask *task = taskdata;
+  struct anim_decoder *decoder = task->decoder;
+  int ret;
+
+  if (task->seek_by_byte) {
+    ret = av_seek_frame(decoder->format_ctx, -1, task->seek_pos, AVSEEK_FLAG_BYTE);
+  }
+  else {
+    ret = av_seek_frame(
+        decoder->format_ctx, anim->videoStream, task->seek_pts, AVSEEK_FLAG_BACKWARD);
+  }
+
+  if (ret >= 0) {
+    avcodec_flush_buffers(decoder->codec_ctx);
+
+    bool done = false;
+    while (!done && !BLI_task_pool_current_canceled(task_pool)) {
+      if (av_read_frame(decoder->format_ctx, decoder->packet) < 0) {
+        /* End of file, drain the decoder. */
+        avcodec_send_packet(decoder->codec_ctx, NULL);
+        done = true;
+      }
+      else if (decoder->packet->stream_index == anim->videoStream) {
+        avcodec_send_packet(decoder->codec_ctx, decoder->packet);
+        av_packet_unref(decoder->packet);
+      }
+      else {
+        av_packet_unref(decoder->packet);
+        continue;
+      }
+
+      while (avcodec_receive_frame(decoder->codec_ctx, decoder->frame) >= 0) {
+        if (av_get_pts_from_frame(decoder->frame) > task->last_pts) {
+          done = true;
+        }
+        else {
+          ffmpeg_frame_ring_add(pool, decoder->frame);
+        }
+        av_frame_unref(decoder->frame);
+      }
+    }
+  }
+
+  BLI_mutex_lock(&pool->mutex);
+  decoder->is_busy = false;
+  BLI_mutex_unlock(&pool->mutex);
+}
+
+/* When scrubbing backwards, decode the GOP before the one of the requested frame in the
+ * background, so its frames are in the ring by the time they are requested. This needs the
+ * timecode index to know where GOPs start. */
+static void ffmpeg_schedule_read_ahead(struct anim *anim,
+                                       int position,
+                                       struct anim_index *tc_index)
+{
+  struct anim_decoder_pool *pool = anim->decoder_pool;
+  const bool is_backwards = position < pool->last_position;
+  pool->last_position = position;
+
+  if (tc_index == NULL || !is_backwards) {
+    return;
+  }
+
+  const int frame_index = IMB_indexer_get_frame_index(tc_index, position);
+  const int last_frame_index = IMB_indexer_get_gop_start(tc_index, frame_index) - 1;
+  if (last_frame_index < 0) {
+    return;
+  }
+
+  const int64_t seek_pos = IMB_indexer_get_seek_pos(tc_index, last_frame_index);
+  const int64_t last_pts = IMB_indexer_get_pts(tc_index, last_frame_index);
+  struct anim_decoder *decoder = NULL;
+
+  BLI_mutex_lock(&pool->mutex);
+  bool is_scheduled = ffmpeg_frame_ring_find(pool, last_pts) != -1;
+  for (int i = 0; i < ANIM_READ_AHEAD_DECODERS; i++) {
+    if (pool->decoders[i].is_busy) {
+      is_scheduled |= pool->decoders[i].seek_pos == seek_pos;
+    }
+    else if (decoder == NULL) {
+      decoder = &pool->decoders[i];
+    }
+  }
+  if (!is_scheduled && decoder != NULL) {
+    decoder->is_busy = true;
+    decoder->seek_pos = seek_pos;
+  }
+  BLI_mutex_unlock(&pool->mutex);
+
+  if (is_scheduled || decoder == NULL) {
+    return;
+  }
+
+  if (decoder->format_ctx == NULL && !ffmpeg_decoder_open(anim, decoder)) {
+    BLI_mutex_lock(&pool->mutex);
+    decoder->is_busy = false;
+    BLI_mutex_unlock(&pool->mutex);
+    return;
+  }
+
+  AnimReadAheadTask *task = MEM_callocN(sizeof(*task), "anim read ahead task");
+  task->decoder = decoder;
+  task->seek_pos = seek_pos;
+  task->seek_pts = timestamp_from_pts_or_dts(
+      IMB_indexer_get_seek_pos_pts(tc_index, last_frame_index),
+      IMB_indexer_get_seek_pos_dts(tc_index, last_frame_index));
+  task->seek_by_byte = ffmpeg_seek_by_byte(anim->pFormatCtx);
+  task->last_pts = last_pts;
+
+  if (pool->task_pool == NULL) {
+    pool->task_pool = BLI_task_pool_create(anim, TASK_PRIORITY_LOW);
+  }
+  BLI_task_pool_push(pool->task_pool, ffmpeg_read_ahead_task, task, true, NULL);
+}
+
+/* Certain versions of FFmpeg have a bug in libswscale which ends up in crash
+ * when destination buffer is not properly aligned. For example, this happens
+ * in FFmpeg 4.3.1. It got fixed later on, but for compatibility reasons is
+ * still best to avoid crash.
+ *
+ * This is achieved by using own allocation call rather than relying on
+ * IMB_allocImBuf() to do so since the IMB_allocImBuf() is not guaranteed
+ * to perform aligned allocation.
+ *
+ * In theory this could give better performance, since SIMD operations on
+ * aligned data are usually faster.
+ *
+ * Note that even though sometimes vertical flip is required it does not
+ * affect on alignment of data passed to sws_scale because if the X dimension
+ * is not 32 byte aligned special intermediate buffer is allocated.
+ *
+ * The issue was reported to FFmpeg under ticket #8747 in the FFmpeg tracker
+ * and is fixed in the newer versions than 4.3.1. */
+static ImBuf *ffmpeg_alloc_ibuf(struct anim *anim)
+{
+  ImBuf *ibuf = IMB_allocImBuf(anim->x, anim->y, 32, 0);
+  ibuf->rect = MEM_mallocN_aligned((size_t)4 * anim->x * anim->y, 32, "ffmpeg ibuf");
+  ibuf->mall |= IB_rect;
+
+  ibuf->rect_colorspace = colormanage_colorspace_get_named(anim->colorspace);
+
+  return ibuf;
+}
+
 static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, IMB_Timecode_Type tc)
 {
   if (anim == NULL) {
@@ -1374,6 +1737,21 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, IMB_Timecode_Typ
     return anim->cur_frame_final;
   }
 
+  /* Frames in the ring don't change the state of the decoder, so it can continue where it
+   * stopped when decoding the next frame. */
+  AVFrame *ring_frame = ffmpeg_frame_ring_get(anim->decoder_pool, pts_to_search);
+  if (ring_frame) {
+    av_log(anim->pFormatCtx,
+           AV_LOG_DEBUG,
+           "FETCH: frame ring hit: pts: %" PRId64 "\n",
+           av_get_pts_from_frame(ring_frame));
+    ImBuf *ibuf = ffmpeg_alloc_ibuf(anim);
+    ffmpeg_postprocess(anim, ring_frame, ibuf);
+    av_frame_free(&ring_frame);
+    ffmpeg_schedule_read_ahead(anim, position, tc_index);
+    return ibuf;
+  }
+
   if (position == anim->cur_position + 1 || ffmpeg_is_first_frame_decode(anim, position)) {
     av_log(anim->pFormatCtx, AV_LOG_DEBUG, "FETCH: no seek necessary, just continue...\n");
     ffmpeg_decode_video_frame(anim);
@@ -1383,35 +1761,14 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, IMB_Timecode_Typ
   }
 
   IMB_freeImBuf(anim->cur_frame_final);
+  anim->cur_frame_final = ffmpeg_alloc_ibuf(anim);
 
-  /* Certain versions of FFmpeg have a bug in libswscale which ends up in crash
-   * when destination buffer is not properly aligned. For example, this happens
-   * in FFmpeg 4.3.1. It got fixed later on, but for compatibility reasons is
-   * still best to avoid crash.
-   *
-   * This is achieved by using own allocation call rather than relying on
-   * IMB_allocImBuf() to do so since the IMB_allocImBuf() is not guaranteed
-   * to perform aligned allocation.
-   *
-   * In theory this could give better performance, since SIMD operations on
-   * aligned data are usually faster.
-   *
-   * Note that even though sometimes vertical flip is required it does not
-   * affect on alignment of data passed to sws_scale because if the X dimension
-   * is not 32 byte aligned special intermediate buffer is allocated.
-   *
-   * The issue was reported to FFmpeg under ticket #8747 in the FFmpeg tracker
-   * and is fixed in the newer versions than 4.3.1. */
-  anim->cur_frame_final = IMB_allocImBuf(anim->x, anim->y, 32, 0);
-  anim->cur_frame_final->rect = MEM_mallocN_aligned(
-      (size_t)4 * anim->x * anim->y, 32, "ffmpeg ibuf");
-  anim->cur_frame_final->mall |= IB_rect;
-
-  anim->cur_frame_final->rect_colorspace = colormanage_colorspace_get_named(anim->colorspace);
-
-  ffmpeg_postprocess(anim);
+  if (anim->pFrameComplete) {
+    ffmpeg_postprocess(anim, anim->pFrame, anim->cur_frame_final);
+  }
 
   anim->cur_position = position;
+  ffmpeg_schedule_read_ahead(anim, position, tc_index);
 
   IMB_refImBuf(anim->cur_frame_final);
 
@@ -1425,6 +1782,10 @@ static void free_anim_ffmpeg(struct anim *anim)
   }
 
   if (anim->pCodecCtx) {
+    /* Stop the read-ahead decoders first, they use the codec of the movie. */
+    ffmpeg_decoder_pool_free(anim->decoder_pool);
+    anim->decoder_pool = NULL;
+
     avcodec_free_context(&anim->pCodecCtx);
     avformat_close_input(&anim->pFormatCtx);
     av_packet_free(&anim->cur_packet);
@@ -1602,10 +1963,8 @@ struct ImBuf *IMB_anim_absolute(struct anim *anim,
 #endif
 #ifdef WITH_FFMPEG
     case ANIM_FFMPEG:
+      /* Sets the position of the decoder itself, frames from the frame ring don't move it. */
       ibuf = ffmpeg_fetchibuf(anim, position, tc);
-      if (ibuf) {
-        anim->cur_position = position;
-      }
       filter_y = 0; /* done internally */
       break;
 #endif
@@ -1615,7 +1974,7 @@ struct ImBuf *IMB_anim_absolute(struct anim *anim,
     if (filter_y) {
       IMB_filtery(ibuf);
     }
-    BLI_snprintf(ibuf->name, sizeof(ibuf->name), "%s.%04d", anim->name, anim->cur_position + 1);
+    BLI_snprintf(ibuf->name, sizeof(ibuf->name), "%s.%04d", anim->name, position + 1);
   }
   return ibuf;
 }
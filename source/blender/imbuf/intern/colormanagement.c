@@ -46,7 +46,9 @@
 #include "BLI_math.h"
 #include "BLI_math_color.h"
 #include "BLI_rect.h"
+#include "BLI_simd.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 
 #include "BKE_appdir.h"
@@ -100,10 +102,17 @@ static float imbuf_linear_srgb_to_xyz[3][3] = {{0.0f}};
  */
 static pthread_mutex_t processor_lock = BLI_MUTEX_INITIALIZER;
 
+struct ColormanageLut3D;
+
 typedef struct ColormanageProcessor {
   OCIO_ConstCPUProcessorRcPtr *cpu_processor;
   CurveMapping *curve_mapping;
   bool is_data_result;
+  /* Optional 3D LUT approximations of the display transform, only used for display buffers
+   * which end up in bytes. `lut` replaces cpu_processor for scene linear input, `byte_lut`
+   * goes from the color space of byte buffers directly to the display. */
+  struct ColormanageLut3D *lut;
+  struct ColormanageLut3D *byte_lut;
 } ColormanageProcessor;
 
 static struct global_gpu_state {
@@ -583,11 +592,16 @@ static void colormanage_load_config(OCIO_ConstConfigRcPtr *config)
   invert_m3_m3(imbuf_linear_srgb_to_xyz, imbuf_xyz_to_linear_srgb);
 }
 
+static void colormanage_lut_cache_free(void);
+
 static void colormanage_free_config(void)
 {
   ColorSpace *colorspace;
   ColorManagedDisplay *display;
 
+  /* LUTs are baked from processors of the current config. */
+  colormanage_lut_cache_free();
+
   /* free color spaces */
   colorspace = global_colorspaces.first;
   while (colorspace) {
@@ -1416,6 +1430,443 @@ const float *IMB_colormanagement_get_xyz_to_rgb()
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Display Transform LUT
+ * \{ */
+
+/**
+ * Display transforms are evaluated per pixel by the OCIO CPU processor, which is expensive for
+ * large images that are redrawn often. For display buffers which end up in bytes, the transform
+ * is approximated by a 3D LUT with tetrahedral interpolation instead.
+ *
+ * LUTs are baked lazily from the exact processor and cached for a few view/display/look
+ * combinations, the cache is cleared when the OCIO configuration is freed. After baking a LUT
+ * is compared against the exact processor, and when the error is above COLORMANAGE_LUT_MAX_ERROR
+ * it is not used. Everything which does not end up in a byte display buffer (float display
+ * buffers, images saved with view transform, color space conversions) stays exact.
+ *
+ * Scene linear input goes through a logarithmic shaper so both dark and over-exposed values get
+ * enough resolution. Pixels outside of the shaper range use the exact processor.
+ */
+
+#define COLORMANAGE_LUT_SIZE 65
+/* Upper bound of scene linear values covered by the shaper, enough for Filmic. */
+#define COLORMANAGE_LUT_LINEAR_MAX 16.0f
+/* Slope of the shaper near zero. Together with the upper bound this gives four LUT nodes per
+ * stop and puts scene linear 1.0 on a node, where transforms like Standard clip. */
+#define COLORMANAGE_LUT_SHAPER_SLOPE 4096.0f
+/* Largest allowed difference to the exact processor, in display space. */
+#define COLORMANAGE_LUT_MAX_ERROR (0.5f / 255.0f)
+/* Number of samples per axis used to measure the LUT error. */
+#define COLORMANAGE_LUT_TEST_SIZE 17
+/* Smaller images are cheaper to transform than to bake a LUT for. */
+#define COLORMANAGE_LUT_MIN_PIXELS (1024 * 1024)
+#define COLORMANAGE_LUT_CACHE_LIMIT 8
+
+typedef struct ColormanageLut3D {
+  struct ColormanageLut3D *next, *prev;
+
+  /* Key. */
+  char look[MAX_COLORSPACE_NAME];
+  char view_transform[MAX_COLORSPACE_NAME];
+  char display[MAX_COLORSPACE_NAME];
+  char from_colorspace[MAX_COLORSPACE_NAME];
+  float exposure, gamma;
+  /* Input is scene linear and goes through the shaper, otherwise input is in 0..1 range. */
+  bool use_shaper;
+  /* log2 of the upper shaper input, scaled by the slope. */
+  float shaper_range;
+
+  /* Processors using this LUT, protected by lut_cache_lock. */
+  int users;
+
+  /* Exact processor, used to bake the LUT and for pixels outside of its domain. */
+  OCIO_ConstCPUProcessorRcPtr *cpu_processor;
+  /* COLORMANAGE_LUT_SIZE^3 nodes of RGB and padding, red varying fastest.
+   * NULL when the LUT is not precise enough. */
+  float *table;
+} ColormanageLut3D;
+
+static ListBase lut_cache = {NULL, NULL};
+static pthread_mutex_t lut_cache_lock = BLI_MUTEX_INITIALIZER;
+
+/* Map scene linear value to 0..1 LUT coordinate. */
+BLI_INLINE float colormanage_lut_shaper(float value, float inv_range)
+{
+  return log2f(1.0f + COLORMANAGE_LUT_SHAPER_SLOPE * value) * inv_range;
+}
+
+static float colormanage_lut_shaper_inverse(float co, float range)
+{
+  return (exp2f(co * range) - 1.0f) / COLORMANAGE_LUT_SHAPER_SLOPE;
+}
+
+/* Tetrahedral interpolation of the LUT at 0..1 coordinates. */
+BLI_INLINE void colormanage_lut_interp(const float *table, const float co[3], float r_rgb[3])
+{
+  const int last = COLORMANAGE_LUT_SIZE - 1;
+  const int stride[3] = {
+      4, 4 * COLORMANAGE_LUT_SIZE, 4 * COLORMANAGE_LUT_SIZE * COLORMANAGE_LUT_SIZE};
+  float f[3];
+  int offset = 0;
+
+  for (int i = 0; i < 3; i++) {
+    const float x = co[i] * last;
+    const int xi = min_ii((int)x, last - 1);
+    f[i] = x - xi;
+    offset += xi * stride[i];
+  }
+
+  /* Walk from the lower to the upper corner of the cell along the axes in order of decreasing
+   * fraction, the visited nodes are the corners of the tetrahedron containing the sample. */
+  int a = 0, b = 1, c = 2;
+  if (f[a] < f[b]) {
+    SWAP(int, a, b);
+  }
+  if (f[b] < f[c]) {
+    SWAP(int, b, c);
+  }
+  if (f[a] < f[b]) {
+    SWAP(int, a, b);
+  }
+
+  const float *p0 = table + offset;
+  const float *p1 = p0 + stride[a];
+  const float *p2 = p1 + stride[b];
+  const float *p3 = p2 + stride[c];
+  const float w0 = 1.0f - f[a], w1 = f[a] - f[b], w2 = f[b] - f[c], w3 = f[c];
+
+#ifdef BLI_HAVE_SSE2
+  __m128 result = _mm_mul_ps(_mm_loadu_ps(p0), _mm_set1_ps(w0));
+  result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(p1), _mm_set1_ps(w1)));
+  result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(p2), _mm_set1_ps(w2)));
+  result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(p3), _mm_set1_ps(w3)));
+  float rgba[4];
+  _mm_storeu_ps(rgba, result);
+  copy_v3_v3(r_rgb, rgba);
+#else
+  for (int i = 0; i < 3; i++) {
+    r_rgb[i] = w0 * p0[i] + w1 * p1[i] + w2 * p2[i] + w3 * p3[i];
+  }
+#endif
+}
+
+/* Apply the LUT to a single straight alpha RGB pixel. */
+BLI_INLINE void colormanage_lut_apply_rgb(const ColormanageLut3D *lut, float rgb[3])
+{
+  const float inv_range = 1.0f / lut->shaper_range;
+  float co[3];
+
+  if (lut->use_shaper) {
+    /* Written so NaN fails the test as well. */
+    if (!(rgb[0] >= 0.0f && rgb[0] <= COLORMANAGE_LUT_LINEAR_MAX && rgb[1] >= 0.0f &&
+          rgb[1] <= COLORMANAGE_LUT_LINEAR_MAX && rgb[2] >= 0.0f &&
+          rgb[2] <= COLORMANAGE_LUT_LINEAR_MAX)) {
+      OCIO_cpuProcessorApplyRGB(lut->cpu_processor, rgb);
+      return;
+    }
+    co[0] = colormanage_lut_shaper(rgb[0], inv_range);
+    co[1] = colormanage_lut_shaper(rgb[1], inv_range);
+    co[2] = colormanage_lut_shaper(rgb[2], inv_range);
+  }
+  else {
+    if (!(rgb[0] >= 0.0f && rgb[0] <= 1.0f && rgb[1] >= 0.0f && rgb[1] <= 1.0f &&
+          rgb[2] >= 0.0f && rgb[2] <= 1.0f)) {
+      OCIO_cpuProcessorApplyRGB(lut->cpu_processor, rgb);
+      return;
+    }
+    copy_v3_v3(co, rgb);
+  }
+
+  colormanage_lut_interp(lut->table, co, rgb);
+}
+
+static void colormanage_lut_apply(const ColormanageLut3D *lut,
+                                  float *buffer,
+                                  size_t num_pixels,
+                                  int channels,
+                                  bool predivide)
+{
+  float *pixel = buffer;
+
+  BLI_assert(channels >= 3);
+
+  for (size_t i = 0; i < num_pixels; i++, pixel += channels) {
+    /* Same as OCIO_cpuProcessorApply_predivide(). */
+    if (predivide && channels == 4 && pixel[3] != 1.0f && pixel[3] != 0.0f) {
+      const float alpha = pixel[3];
+      mul_v3_fl(pixel, 1.0f / alpha);
+      colormanage_lut_apply_rgb(lut, pixel);
+      mul_v3_fl(pixel, alpha);
+    }
+    else {
+      colormanage_lut_apply_rgb(lut, pixel);
+    }
+  }
+}
+
+/* Fill RGBA buffer with input values for the given LUT coordinates, then apply the exact
+ * processor to it. */
+static void colormanage_lut_evaluate_exact(const ColormanageLut3D *lut,
+                                           float *rgba,
+                                           const float (*coords)[3],
+                                           int num_pixels)
+{
+  for (int i = 0; i < num_pixels; i++) {
+    for (int c = 0; c < 3; c++) {
+      rgba[i * 4 + c] = lut->use_shaper ?
+                            colormanage_lut_shaper_inverse(coords[i][c], lut->shaper_range) :
+                            coords[i][c];
+    }
+    rgba[i * 4 + 3] = 1.0f;
+  }
+
+  OCIO_PackedImageDesc *img = OCIO_createOCIO_PackedImageDesc(rgba,
+                                                              num_pixels,
+                                                              1,
+                                                              4,
+                                                              sizeof(float),
+                                                              4 * sizeof(float),
+                                                              4 * sizeof(float) * num_pixels);
+  OCIO_cpuProcessorApply(lut->cpu_processor, img);
+  OCIO_PackedImageDescRelease(img);
+}
+
+static void colormanage_lut_bake_slice(void *__restrict userdata,
+                                       const int b,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ColormanageLut3D *lut = (ColormanageLut3D *)userdata;
+  const int size = COLORMANAGE_LUT_SIZE;
+  float(*coords)[3] = MEM_malloc_arrayN(size * size, sizeof(*coords), __func__);
+
+  for (int g = 0; g < size; g++) {
+    for (int r = 0; r < size; r++) {
+      coords[g * size + r][0] = (float)r / (size - 1);
+      coords[g * size + r][1] = (float)g / (size - 1);
+      coords[g * size + r][2] = (float)b / (size - 1);
+    }
+  }
+
+  colormanage_lut_evaluate_exact(
+      lut, lut->table + (size_t)b * size * size * 4, coords, size * size);
+
+  MEM_freeN(coords);
+}
+
+/* Compare the LUT against the exact processor in between the LUT nodes. */
+static bool colormanage_lut_is_precise(const ColormanageLut3D *lut)
+{
+  const int size = COLORMANAGE_LUT_TEST_SIZE;
+  const int num_samples = size * size * size;
+  float(*coords)[3] = MEM_malloc_arrayN(num_samples, sizeof(*coords), __func__);
+  float *exact = MEM_malloc_arrayN(num_samples, 4 * sizeof(float), __func__);
+  bool is_precise = true;
+
+  for (int i = 0; i < num_samples; i++) {
+    coords[i][0] = ((i % size) + 0.5f) / size;
+    coords[i][1] = (((i / size) % size) + 0.5f) / size;
+    coords[i][2] = ((i / (size * size)) + 0.5f) / size;
+  }
+
+  colormanage_lut_evaluate_exact(lut, exact, coords, num_samples);
+
+  for (int i = 0; i < num_samples && is_precise; i++) {
+    float rgb[3];
+    colormanage_lut_interp(lut->table, coords[i], rgb);
+    for (int c = 0; c < 3; c++) {
+      /* Display buffers are clamped to 0..1, differences outside of it do not matter. */
+      const float error = fabsf(clamp_f(rgb[c], 0.0f, 1.0f) -
+                                clamp_f(exact[i * 4 + c], 0.0f, 1.0f));
+      if (!(error <= COLORMANAGE_LUT_MAX_ERROR)) {
+        is_precise = false;
+      }
+    }
+  }
+
+  MEM_freeN(coords);
+  MEM_freeN(exact);
+
+  return is_precise;
+}
+
+static void colormanage_lut_free(ColormanageLut3D *lut)
+{
+  if (lut->cpu_processor) {
+    OCIO_cpuProcessorRelease(lut->cpu_processor);
+  }
+  MEM_SAFE_FREE(lut->table);
+  MEM_freeN(lut);
+}
+
+static ColormanageLut3D *colormanage_lut_new(const ColorManagedViewSettings *view_settings,
+                                             const ColorManagedDisplaySettings *display_settings,
+                                             const char *from_colorspace,
+                                             bool use_shaper)
+{
+  ColormanageLut3D *lut = MEM_callocN(sizeof(ColormanageLut3D), "colormanage LUT");
+  const int size = COLORMANAGE_LUT_SIZE;
+
+  STRNCPY(lut->look, view_settings->look);
+  STRNCPY(lut->view_transform, view_settings->view_transform);
+  STRNCPY(lut->display, display_settings->display_device);
+  STRNCPY(lut->from_colorspace, from_colorspace);
+  lut->exposure = view_settings->exposure;
+  lut->gamma = view_settings->gamma;
+  lut->use_shaper = use_shaper;
+  lut->shaper_range = log2f(1.0f + COLORMANAGE_LUT_SHAPER_SLOPE * COLORMANAGE_LUT_LINEAR_MAX);
+
+  lut->cpu_processor = create_display_buffer_processor(view_settings->look,
+                                                       view_settings->view_transform,
+                                                       display_settings->display_device,
+                                                       view_settings->exposure,
+                                                       view_settings->gamma,
+                                                       from_colorspace);
+  if (lut->cpu_processor == NULL) {
+    return lut;
+  }
+
+  /* Bake one blue slice per task, the OCIO processor is thread safe. */
+  lut->table = MEM_mallocN(sizeof(float[4]) * size * size * size, "colormanage LUT table");
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 4;
+  BLI_task_parallel_range(0, size, lut, colormanage_lut_bake_slice, &settings);
+
+  if (!colormanage_lut_is_precise(lut)) {
+    MEM_SAFE_FREE(lut->table);
+  }
+
+  return lut;
+}
+
+static bool colormanage_lut_matches(const ColormanageLut3D *lut,
+                                    const ColorManagedViewSettings *view_settings,
+                                    const ColorManagedDisplaySettings *display_settings,
+                                    const char *from_colorspace,
+                                    bool use_shaper)
+{
+  return lut->use_shaper == use_shaper && lut->exposure == view_settings->exposure &&
+         lut->gamma == view_settings->gamma && STREQ(lut->look, view_settings->look) &&
+         STREQ(lut->view_transform, view_settings->view_transform) &&
+         STREQ(lut->display, display_settings->display_device) &&
+         STREQ(lut->from_colorspace, from_colorspace);
+}
+
+/**
+ * Get a LUT for the display transform from the given color space, NULL if it is not precise
+ * enough or not baked yet while do_bake is false. Must be released with colormanage_lut_release.
+ */
+static ColormanageLut3D *colormanage_lut_acquire(
+    const ColorManagedViewSettings *view_settings,
+    const ColorManagedDisplaySettings *display_settings,
+    const char *from_colorspace,
+    bool use_shaper,
+    bool do_bake)
+{
+  ColormanageLut3D *lut;
+
+  BLI_mutex_lock(&lut_cache_lock);
+
+  for (lut = lut_cache.first; lut; lut = lut->next) {
+    if (colormanage_lut_matches(
+            lut, view_settings, display_settings, from_colorspace, use_shaper)) {
+      break;
+    }
+  }
+
+  if (lut) {
+    /* Keep recently used LUTs at the front. */
+    BLI_remlink(&lut_cache, lut);
+    BLI_addhead(&lut_cache, lut);
+  }
+  else if (do_bake) {
+    /* Baking is done with the lock held, so concurrent redraws don't bake the same LUT twice. */
+    lut = colormanage_lut_new(view_settings, display_settings, from_colorspace, use_shaper);
+    BLI_addhead(&lut_cache, lut);
+
+    /* Remove least recently used LUTs which are not in use. */
+    int num_luts = BLI_listbase_count(&lut_cache);
+    ColormanageLut3D *lut_iter = lut_cache.last;
+    while (lut_iter && num_luts > COLORMANAGE_LUT_CACHE_LIMIT) {
+      ColormanageLut3D *lut_prev = lut_iter->prev;
+      if (lut_iter->users == 0 && lut_iter != lut) {
+        BLI_remlink(&lut_cache, lut_iter);
+        colormanage_lut_free(lut_iter);
+        num_luts--;
+      }
+      lut_iter = lut_prev;
+    }
+  }
+
+  if (lut && lut->table == NULL) {
+    lut = NULL;
+  }
+  if (lut) {
+    lut->users++;
+  }
+
+  BLI_mutex_unlock(&lut_cache_lock);
+
+  return lut;
+}
+
+static void colormanage_lut_release(ColormanageLut3D *lut)
+{
+  BLI_mutex_lock(&lut_cache_lock);
+  BLI_assert(lut->users > 0);
+  lut->users--;
+  BLI_mutex_unlock(&lut_cache_lock);
+}
+
+static void colormanage_lut_cache_free(void)
+{
+  BLI_mutex_lock(&lut_cache_lock);
+  LISTBASE_FOREACH_MUTABLE (ColormanageLut3D *, lut, &lut_cache) {
+    BLI_assert(lut->users == 0);
+    colormanage_lut_free(lut);
+  }
+  BLI_listbase_clear(&lut_cache);
+  BLI_mutex_unlock(&lut_cache_lock);
+}
+
+/* Set up LUTs for a display processor whose result ends up in a byte buffer. */
+static void colormanage_processor_lut_ensure(ColormanageProcessor *cm_processor,
+                                             const ColorManagedViewSettings *view_settings,
+                                             const ColorManagedDisplaySettings *display_settings,
+                                             const char *byte_colorspace,
+                                             size_t num_pixels)
+{
+  const bool do_bake = num_pixels >= COLORMANAGE_LUT_MIN_PIXELS;
+  ColorManagedViewSettings default_view_settings;
+
+  if (cm_processor->cpu_processor == NULL || cm_processor->is_data_result) {
+    return;
+  }
+
+  if (view_settings == NULL) {
+    /* Same as IMB_colormanagement_display_processor_new(). */
+    IMB_colormanagement_init_default_view_settings(&default_view_settings, display_settings);
+    view_settings = &default_view_settings;
+  }
+
+  if (byte_colorspace == NULL) {
+    cm_processor->lut = colormanage_lut_acquire(
+        view_settings, display_settings, global_role_scene_linear, true, do_bake);
+  }
+  else if (cm_processor->curve_mapping == NULL) {
+    /* Curves are applied in scene linear space, which is skipped by the byte LUT. */
+    ColorSpace *colorspace = colormanage_colorspace_get_named(byte_colorspace);
+    if (colorspace && !colorspace->is_data) {
+      cm_processor->byte_lut = colormanage_lut_acquire(
+          view_settings, display_settings, byte_colorspace, false, do_bake);
+    }
+  }
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Threaded Display Buffer Transform Routines
  * \{ */
@@ -1628,11 +2079,32 @@ static void *do_display_buffer_apply_thread(void *handle_v)
     float *linear_buffer = MEM_mallocN(((size_t)channels) * width * height * sizeof(float),
                                        "color conversion linear buffer");
 
-    display_buffer_apply_get_linear_buffer(handle, height, linear_buffer, &is_straight_alpha);
+    /* #IMB_buffer_float_from_byte always writes four channels. */
+    const bool use_byte_lut = cm_processor->byte_lut && handle->buffer == NULL && !is_data &&
+                              channels == 4;
+
+    if (use_byte_lut) {
+      /* Go from the byte buffer color space to display space in a single LUT lookup. */
+      IMB_buffer_float_from_byte(linear_buffer,
+                                 handle->byte_buffer,
+                                 IB_PROFILE_SRGB,
+                                 IB_PROFILE_SRGB,
+                                 false,
+                                 width,
+                                 height,
+                                 width,
+                                 width);
+      is_straight_alpha = true;
+      colormanage_lut_apply(
+          cm_processor->byte_lut, linear_buffer, (size_t)width * height, channels, false);
+    }
+    else {
+      display_buffer_apply_get_linear_buffer(handle, height, linear_buffer, &is_straight_alpha);
+    }
 
     bool predivide = handle->predivide && (is_straight_alpha == false);
 
-    if (is_data) {
+    if (is_data || use_byte_lut) {
       /* special case for data buffers - no color space conversions,
        * only generate byte buffers
        */
@@ -1763,6 +2235,20 @@ static void colormanage_display_buffer_process_ex(
 
   if (skip_transform == false) {
     cm_processor = IMB_colormanagement_display_processor_new(view_settings, display_settings);
+
+    if (display_buffer == NULL) {
+      /* Only byte display buffers are computed with LUTs, float ones stay exact. */
+      const char *byte_colorspace = NULL;
+      if (ibuf->rect_float == NULL) {
+        byte_colorspace = (ibuf->rect_colorspace) ? ibuf->rect_colorspace->name :
+                                                    global_role_default_byte;
+      }
+      colormanage_processor_lut_ensure(cm_processor,
+                                       view_settings,
+                                       display_settings,
+                                       byte_colorspace,
+                                       (size_t)ibuf->x * ibuf->y);
+    }
   }
 
   display_buffer_apply_threaded(ibuf,
@@ -2761,6 +3247,8 @@ void IMB_display_buffer_transform_apply(unsigned char *display_buffer,
   float *buffer;
   ColormanageProcessor *cm_processor = IMB_colormanagement_display_processor_new(view_settings,
                                                                                  display_settings);
+  colormanage_processor_lut_ensure(
+      cm_processor, view_settings, display_settings, NULL, (size_t)width * height);
 
   buffer = MEM_mallocN((size_t)channels * width * height * sizeof(float),
                        "display transform temp buffer");
@@ -3626,6 +4114,14 @@ static void imb_partial_display_buffer_update_ex(
 
     if (!skip_transform) {
       cm_processor = IMB_colormanagement_display_processor_new(view_settings, display_settings);
+
+      if (linear_buffer != NULL) {
+        colormanage_processor_lut_ensure(cm_processor,
+                                         view_settings,
+                                         display_settings,
+                                         NULL,
+                                         (size_t)(xmax - xmin) * (ymax - ymin));
+      }
     }
 
     if (do_threads) {
@@ -3814,7 +4310,10 @@ void IMB_colormanagement_processor_apply_v4(ColormanageProcessor *cm_processor,
     BKE_curvemapping_evaluate_premulRGBF(cm_processor->curve_mapping, pixel, pixel);
   }
 
-  if (cm_processor->cpu_processor) {
+  if (cm_processor->lut) {
+    colormanage_lut_apply(cm_processor->lut, pixel, 1, 4, false);
+  }
+  else if (cm_processor->cpu_processor) {
     OCIO_cpuProcessorApplyRGBA(cm_processor->cpu_processor, pixel);
   }
 }
@@ -3826,7 +4325,10 @@ void IMB_colormanagement_processor_apply_v4_predivide(ColormanageProcessor *cm_p
     BKE_curvemapping_evaluate_premulRGBF(cm_processor->curve_mapping, pixel, pixel);
   }
 
-  if (cm_processor->cpu_processor) {
+  if (cm_processor->lut) {
+    colormanage_lut_apply(cm_processor->lut, pixel, 1, 4, true);
+  }
+  else if (cm_processor->cpu_processor) {
     OCIO_cpuProcessorApplyRGBA_predivide(cm_processor->cpu_processor, pixel);
   }
 }
@@ -3837,7 +4339,10 @@ void IMB_colormanagement_processor_apply_v3(ColormanageProcessor *cm_processor,
     BKE_curvemapping_evaluate_premulRGBF(cm_processor->curve_mapping, pixel, pixel);
   }
 
-  if (cm_processor->cpu_processor) {
+  if (cm_processor->lut) {
+    colormanage_lut_apply(cm_processor->lut, pixel, 1, 3, false);
+  }
+  else if (cm_processor->cpu_processor) {
     OCIO_cpuProcessorApplyRGB(cm_processor->cpu_processor, pixel);
   }
 }
@@ -3883,7 +4388,11 @@ void IMB_colormanagement_processor_apply(ColormanageProcessor *cm_processor,
     }
   }
 
-  if (cm_processor->cpu_processor && channels >= 3) {
+  if (cm_processor->lut && channels >= 3) {
+    colormanage_lut_apply(
+        cm_processor->lut, buffer, (size_t)width * height, channels, predivide);
+  }
+  else if (cm_processor->cpu_processor && channels >= 3) {
     OCIO_PackedImageDesc *img;
 
     /* apply OCIO processor */
@@ -3932,6 +4441,12 @@ void IMB_colormanagement_processor_free(ColormanageProcessor *cm_processor)
   if (cm_processor->cpu_processor) {
     OCIO_cpuProcessorRelease(cm_processor->cpu_processor);
   }
+  if (cm_processor->lut) {
+    colormanage_lut_release(cm_processor->lut);
+  }
+  if (cm_processor->byte_lut) {
+    colormanage_lut_release(cm_processor->byte_lut);
+  }
 
   MEM_freeN(cm_processor);
 }
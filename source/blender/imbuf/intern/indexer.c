@@ -337,6 +337,18 @@ int IMB_indexer_can_scan(struct anim_index *idx, int old_frame_index, int new_fr
           old_frame_index < new_frame_index);
 }
 
+int IMB_indexer_get_gop_start(struct anim_index *idx, int frame_index)
+{
+  /* All frames of a GOP share the seek position of its key frame. */
+  const uint64_t seek_pos = IMB_indexer_get_seek_pos(idx, frame_index);
+
+  frame_index = min_ii(frame_index, idx->num_entries - 1);
+  while (frame_index > 0 && IMB_indexer_get_seek_pos(idx, frame_index - 1) == seek_pos) {
+    frame_index--;
+  }
+  return frame_index;
+}
+
 void IMB_indexer_close(struct anim_index *idx)
 {
   MEM_freeN(idx->entries);
@@ -0,0 +1,239 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "BLI_rand.h"
+#include "BLI_timeit.hh"
+#include "BLI_vector.hh"
+
+#include "IMB_imbuf.h"
+#include "IMB_imbuf_types.h"
+
+namespace blender::imbuf::tests {
+
+static ImBuf *create_random_float_image(int width, int height, int channels, uint seed)
+{
+  ImBuf *ibuf = IMB_allocImBuf(width, height, 32, IB_rectfloat);
+  ibuf->channels = channels;
+  RNG *rng = BLI_rng_new(seed);
+  for (size_t i = 0; i < (size_t)width * height * channels; i++) {
+    ibuf->rect_float[i] = BLI_rng_get_float(rng);
+  }
+  BLI_rng_free(rng);
+  return ibuf;
+}
+
+static ImBuf *create_random_byte_image(int width, int height, uint seed)
+{
+  ImBuf *ibuf = IMB_allocImBuf(width, height, 32, IB_rect);
+  uchar *rect = (uchar *)ibuf->rect;
+  RNG *rng = BLI_rng_new(seed);
+  for (size_t i = 0; i < (size_t)width * height * 4; i++) {
+    rect[i] = (uchar)(BLI_rng_get_uint(rng) & 0xff);
+  }
+  BLI_rng_free(rng);
+  return ibuf;
+}
+
+/* Area average of the source pixels covered by each destination pixel. */
+static Vector<double> reference_box_scale(
+    const float *src, int src_x, int src_y, int channels, int dst_x, int dst_y)
+{
+  Vector<double> dst(dst_x * dst_y * channels, 0.0);
+  const double scale_x = (double)src_x / dst_x;
+  const double scale_y = (double)src_y / dst_y;
+  for (int j = 0; j < dst_y; j++) {
+    for (int i = 0; i < dst_x; i++) {
+      double weight_sum = 0.0;
+      const int y_end = std::min(src_y, (int)std::ceil((j + 1) * scale_y));
+      for (int y = (int)(j * scale_y); y < y_end; y++) {
+        const double wy = std::min(j * scale_y + scale_y, y + 1.0) -
+                          std::max(j * scale_y, (double)y);
+        const int x_end = std::min(src_x, (int)std::ceil((i + 1) * scale_x));
+        for (int x = (int)(i * scale_x); x < x_end; x++) {
+          const double wx = std::min(i * scale_x + scale_x, x + 1.0) -
+                            std::max(i * scale_x, (double)x);
+          if (wx <= 0.0 || wy <= 0.0) {
+            continue;
+          }
+          for (int c = 0; c < channels; c++) {
+            dst[(j * dst_x + i) * channels + c] += wx * wy * src[(y * src_x + x) * channels + c];
+          }
+          weight_sum += wx * wy;
+        }
+      }
+      for (int c = 0; c < channels; c++) {
+        dst[(j * dst_x + i) * channels + c] /= weight_sum;
+      }
+    }
+  }
+  return dst;
+}
+
+static void expect_box_scale_matches_reference(int src_x, int src_y, int dst_x, int dst_y)
+{
+  ImBuf *ibuf = create_random_float_image(src_x, src_y, 4, 42);
+  Vector<float> src(ibuf->rect_float, ibuf->rect_float + src_x * src_y * 4);
+
+  EXPECT_TRUE(IMB_scaleImBuf(ibuf, dst_x, dst_y));
+  EXPECT_EQ(ibuf->x, dst_x);
+  EXPECT_EQ(ibuf->y, dst_y);
+
+  Vector<double> expected = reference_box_scale(src.data(), src_x, src_y, 4, dst_x, dst_y);
+  for (int i = 0; i < dst_x * dst_y * 4; i++) {
+    EXPECT_NEAR(ibuf->rect_float[i], expected[i], 1e-5);
+  }
+
+  IMB_freeImBuf(ibuf);
+}
+
+TEST(imbuf_scaling, box_shrink_byte_half)
+{
+  ImBuf *ibuf = create_random_byte_image(8, 6, 1);
+  Vector<uchar> src((uchar *)ibuf->rect, (uchar *)ibuf->rect + 8 * 6 * 4);
+
+  EXPECT_TRUE(IMB_scaleImBuf(ibuf, 4, 3));
+
+  const uchar *rect = (const uchar *)ibuf->rect;
+  for (int y = 0; y < 3; y++) {
+    for (int x = 0; x < 4; x++) {
+      for (int c = 0; c < 4; c++) {
+        const int sum = src[((y * 2) * 8 + x * 2) * 4 + c] +
+                        src[((y * 2) * 8 + x * 2 + 1) * 4 + c] +
+                        src[((y * 2 + 1) * 8 + x * 2) * 4 + c] +
+                        src[((y * 2 + 1) * 8 + x * 2 + 1) * 4 + c];
+        EXPECT_NEAR(rect[(y * 4 + x) * 4 + c], sum / 4.0f, 0.5f + 1e-3f);
+      }
+    }
+  }
+
+  IMB_freeImBuf(ibuf);
+}
+
+TEST(imbuf_scaling, box_shrink_float_fractional)
+{
+  expect_box_scale_matches_reference(7, 5, 3, 2);
+  expect_box_scale_matches_reference(13, 11, 12, 4);
+}
+
+TEST(imbuf_scaling, box_shrink_float_large)
+{
+  /* Large enough to be multi-threaded. */
+  expect_box_scale_matches_reference(640, 360, 200, 150);
+}
+
+TEST(imbuf_scaling, box_enlarge_linear)
+{
+  ImBuf *ibuf = IMB_allocImBuf(5, 1, 32, IB_rectfloat);
+  for (int x = 0; x < 5; x++) {
+    for (int c = 0; c < 4; c++) {
+      ibuf->rect_float[x * 4 + c] = x;
+    }
+  }
+
+  EXPECT_TRUE(IMB_scaleImBuf(ibuf, 9, 3));
+
+  /* Corner pixels are mapped onto each other. */
+  for (int y = 0; y < 3; y++) {
+    for (int x = 0; x < 9; x++) {
+      EXPECT_NEAR(ibuf->rect_float[(y * 9 + x) * 4], x * 0.5f, 1e-5f);
+    }
+  }
+
+  IMB_freeImBuf(ibuf);
+}
+
+TEST(imbuf_scaling, single_pixel)
+{
+  ImBuf *ibuf = IMB_allocImBuf(1, 1, 32, IB_rect | IB_rectfloat);
+  const uchar color[4] = {10, 20, 30, 40};
+  memcpy(ibuf->rect, color, sizeof(color));
+  const float color_float[4] = {0.1f, 0.2f, 0.3f, 0.4f};
+  memcpy(ibuf->rect_float, color_float, sizeof(color_float));
+
+  EXPECT_TRUE(IMB_scaleImBuf(ibuf, 5, 3));
+
+  for (int i = 0; i < 5 * 3; i++) {
+    for (int c = 0; c < 4; c++) {
+      EXPECT_EQ(((uchar *)ibuf->rect)[i * 4 + c], color[c]);
+      EXPECT_NEAR(ibuf->rect_float[i * 4 + c], color_float[c], 1e-6f);
+    }
+  }
+
+  IMB_freeImBuf(ibuf);
+}
+
+TEST(imbuf_scaling, bilinear_channels)
+{
+  ImBuf *ibuf = IMB_allocImBuf(4, 4, 32, IB_rectfloat);
+  ibuf->channels = 3;
+  for (int i = 0; i < 4 * 4 * 3; i++) {
+    ibuf->rect_float[i] = (i % 3) * 0.25f;
+  }
+
+  IMB_scaleImBuf_threaded(ibuf, 7, 2);
+
+  EXPECT_EQ(ibuf->x, 7);
+  EXPECT_EQ(ibuf->y, 2);
+  EXPECT_EQ(ibuf->channels, 3);
+  for (int i = 0; i < 7 * 2 * 3; i++) {
+    EXPECT_NEAR(ibuf->rect_float[i], (i % 3) * 0.25f, 1e-6f);
+  }
+
+  IMB_freeImBuf(ibuf);
+}
+
+TEST(imbuf_scaling, lanczos)
+{
+  /* Constant images stay constant. */
+  ImBuf *ibuf = IMB_allocImBuf(37, 23, 32, IB_rect);
+  memset(ibuf->rect, 200, sizeof(uint) * 37 * 23);
+  EXPECT_TRUE(IMB_scaleImBuf_filter(ibuf, 10, 51, IMB_SCALE_FILTER_LANCZOS));
+  for (int i = 0; i < 10 * 51 * 4; i++) {
+    EXPECT_EQ(((uchar *)ibuf->rect)[i], 200);
+  }
+  IMB_freeImBuf(ibuf);
+
+  /* Linear gradients are reproduced away from the borders. */
+  ibuf = IMB_allocImBuf(64, 1, 32, IB_rectfloat);
+  for (int x = 0; x < 64; x++) {
+    for (int c = 0; c < 4; c++) {
+      ibuf->rect_float[x * 4 + c] = x;
+    }
+  }
+  EXPECT_TRUE(IMB_scaleImBuf_filter(ibuf, 16, 1, IMB_SCALE_FILTER_LANCZOS));
+  for (int x = 3; x < 13; x++) {
+    EXPECT_NEAR(ibuf->rect_float[x * 4], x * 4.0f + 1.5f, 1e-3f);
+  }
+  IMB_freeImBuf(ibuf);
+}
+
+/**
+ * Set this to 1 to activate the benchmark. It is disabled by default, because it takes a while.
+ */
+#if 0
+TEST(imbuf_scaling, benchmark)
+{
+  for (const eIMBScaleFilter filter :
+       {IMB_SCALE_FILTER_BOX, IMB_SCALE_FILTER_BILINEAR, IMB_SCALE_FILTER_LANCZOS}) {
+    ImBuf *ibuf = create_random_byte_image(3840, 2160, 0);
+    {
+      SCOPED_TIMER("byte 3840x2160 to 960x540, filter " + std::to_string(filter));
+      IMB_scaleImBuf_filter(ibuf, 960, 540, filter);
+    }
+    IMB_freeImBuf(ibuf);
+
+    ibuf = create_random_float_image(3840, 2160, 4, 0);
+    {
+      SCOPED_TIMER("float 3840x2160 to 1920x1080, filter " + std::to_string(filter));
+      IMB_scaleImBuf_filter(ibuf, 1920, 1080, filter);
+    }
+    IMB_freeImBuf(ibuf);
+  }
+}
+#endif
+
+}  // namespace blender::imbuf::tests
@@ -235,6 +235,8 @@ enum {
   IMA_GPU_MIPMAP_COMPLETE = (1 << 2),
   /** Current texture resolution won't be limited by the GL Texture Limit user preference. */
   IMA_GPU_MAX_RESOLUTION = (1 << 3),
+  /** GPU texture is a placeholder while the image is loaded in the background. */
+  IMA_GPU_PLACEHOLDER = (1 << 4),
 };
 
 /* Image.source, where the image comes from */
@@ -103,6 +103,9 @@ typedef struct Mesh_Runtime {
   /** Non-manifold boundary data for Shrinkwrap Target Project. */
   struct ShrinkwrapBoundaryData *shrinkwrap_data;
 
+  /** Last computed split normals, see #BKE_mesh_normals_loop_split_cached. */
+  struct MeshLoopNormalsCache *loop_normals_cache;
+
   /** Set by modifier stack if only deformed from original. */
   char deformed_only;
   /**
@@ -1767,6 +1767,16 @@ static void rna_def_modifier_subsurf(BlenderRNA *brna)
                            "levels of subdivision (smoothest possible shape)");
   RNA_def_property_update(prop, 0, "rna_Modifier_update");
 
+  prop = RNA_def_property(srna, "use_deform_cache", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flags", eSubsurfModifierFlag_UseDeformCache);
+  RNA_def_property_ui_text(prop,
+                           "Deform Cache",
+                           "Keep the subdivided mesh while the topology does not change, and "
+                           "only update vertex positions when the input mesh is deformed "
+                           "(faster playback of animated meshes, other attributes are not "
+                           "updated and normals are calculated from faces)");
+  RNA_def_property_update(prop, 0, "rna_Modifier_update");
+
   RNA_define_lib_overridable(false);
 }
 
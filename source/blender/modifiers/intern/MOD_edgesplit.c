@@ -47,9 +47,6 @@
 
 #include "RNA_access.h"
 
-#include "bmesh.h"
-#include "bmesh_tools.h"
-
 #include "MOD_modifiertypes.h"
 #include "MOD_ui_common.h"
 
@@ -58,62 +55,10 @@ Mesh *doEdgeSplit(const Mesh *mesh, EdgeSplitModifierData *emd);
 
 Mesh *doEdgeSplit(const Mesh *mesh, EdgeSplitModifierData *emd)
 {
-  Mesh *result;
-  BMesh *bm;
-  BMIter iter;
-  BMEdge *e;
-  const float threshold = cosf(emd->split_angle + 0.000000175f);
-  const bool do_split_angle = (emd->flags & MOD_EDGESPLIT_FROMANGLE) != 0 &&
-                              emd->split_angle < (float)M_PI;
-  const bool do_split_all = do_split_angle && emd->split_angle < FLT_EPSILON;
-  const bool calc_face_normals = do_split_angle && !do_split_all;
-
-  bm = BKE_mesh_to_bmesh_ex(mesh,
-                            &(struct BMeshCreateParams){0},
-                            &(struct BMeshFromMeshParams){
-                                .calc_face_normal = calc_face_normals,
-                                .add_key_index = false,
-                                .use_shapekey = false,
-                                .active_shapekey = 0,
-                                .cd_mask_extra = {.vmask = CD_MASK_ORIGINDEX,
-                                                  .emask = CD_MASK_ORIGINDEX,
-                                                  .pmask = CD_MASK_ORIGINDEX},
-                            });
-
-  if (do_split_angle) {
-    BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
-      /* check for 1 edge having 2 face users */
-      BMLoop *l1, *l2;
-      if ((l1 = e->l) && (l2 = e->l->radial_next) != l1) {
-        if (/* 3+ faces on this edge, always split */
-            UNLIKELY(l1 != l2->radial_next) ||
-            /* O° angle setting, we want to split on all edges. */
-            do_split_all ||
-            /* 2 face edge - check angle. */
-            (dot_v3v3(l1->f->no, l2->f->no) < threshold)) {
-          BM_elem_flag_enable(e, BM_ELEM_TAG);
-        }
-      }
-    }
-  }
-
-  if (emd->flags & MOD_EDGESPLIT_FROMFLAG) {
-    BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
-      /* check for 2 or more edge users */
-      if ((e->l) && (e->l->next != e->l)) {
-        if (!BM_elem_flag_test(e, BM_ELEM_SMOOTH)) {
-          BM_elem_flag_enable(e, BM_ELEM_TAG);
-        }
-      }
-    }
-  }
-
-  BM_mesh_edgesplit(bm, false, true, false);
-
-  /* BM_mesh_validate(bm); */ /* for troubleshooting */
-
-  result = BKE_mesh_from_bmesh_for_eval_nomain(bm, NULL, mesh);
-  BM_mesh_free(bm);
+  Mesh *result = BKE_mesh_edge_split(mesh,
+                                     (emd->flags & MOD_EDGESPLIT_FROMANGLE) != 0,
+                                     emd->split_angle,
+                                     (emd->flags & MOD_EDGESPLIT_FROMFLAG) != 0);
 
   result->runtime.cd_dirty_vert |= CD_MASK_NORMAL;
   return result;
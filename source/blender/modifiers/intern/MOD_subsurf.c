@@ -200,7 +200,8 @@ static void subdiv_mesh_settings_init(SubdivToMeshSettings *settings,
 static Mesh *subdiv_as_mesh(SubsurfModifierData *smd,
                             const ModifierEvalContext *ctx,
                             Mesh *mesh,
-                            Subdiv *subdiv)
+                            Subdiv *subdiv,
+                            const bool use_deform_cache)
 {
   Mesh *result = mesh;
   SubdivToMeshSettings mesh_settings;
@@ -208,7 +209,13 @@ static Mesh *subdiv_as_mesh(SubsurfModifierData *smd,
   if (mesh_settings.resolution < 3) {
     return result;
   }
-  result = BKE_subdiv_to_mesh(subdiv, &mesh_settings, mesh);
+  if (use_deform_cache) {
+    result = BKE_subdiv_to_mesh_deform_cached(subdiv, &mesh_settings, mesh);
+  }
+  else {
+    BKE_subdiv_mesh_deform_cache_free(subdiv);
+    result = BKE_subdiv_to_mesh(subdiv, &mesh_settings, mesh);
+  }
   return result;
 }
 
@@ -282,7 +289,10 @@ static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *
   /* TODO(sergey): Decide whether we ever want to use CCG for subsurf,
    * maybe when it is a last modifier in the stack? */
   if (true) {
-    result = subdiv_as_mesh(smd, ctx, mesh, subdiv);
+    /* Custom normals are interpolated from the input mesh, so they can not be cached. */
+    const bool use_deform_cache = (smd->flags & eSubsurfModifierFlag_UseDeformCache) &&
+                                  !use_clnors;
+    result = subdiv_as_mesh(smd, ctx, mesh, subdiv, use_deform_cache);
   }
   else {
     result = subdiv_as_ccg(smd, ctx, mesh, subdiv);
@@ -473,6 +483,7 @@ static void advanced_panel_draw(const bContext *C, Panel *panel)
   uiItemR(layout, ptr, "boundary_smooth", 0, NULL, ICON_NONE);
   uiItemR(layout, ptr, "use_creases", 0, NULL, ICON_NONE);
   uiItemR(layout, ptr, "use_custom_normals", 0, NULL, ICON_NONE);
+  uiItemR(layout, ptr, "use_deform_cache", 0, NULL, ICON_NONE);
 }
 
 static void panelRegister(ARegionType *region_type)
@@ -54,6 +54,34 @@ Mesh *triangulate_mesh(Mesh *mesh,
                        const int min_vertices,
                        const int flag);
 
+/**
+ * Multi-resolution displacements need to be interpolated for the new faces,
+ * which is only supported by #BM_mesh_triangulate.
+ */
+static Mesh *triangulate_mesh_bmesh(Mesh *mesh,
+                                    const int quad_method,
+                                    const int ngon_method,
+                                    const int min_vertices,
+                                    const CustomData_MeshMasks *cd_mask_extra)
+{
+  Mesh *result;
+  BMesh *bm;
+
+  bm = BKE_mesh_to_bmesh_ex(mesh,
+                            &((struct BMeshCreateParams){0}),
+                            &((struct BMeshFromMeshParams){
+                                .calc_face_normal = true,
+                                .cd_mask_extra = *cd_mask_extra,
+                            }));
+
+  BM_mesh_triangulate(bm, quad_method, ngon_method, min_vertices, false, NULL, NULL, NULL);
+
+  result = BKE_mesh_from_bmesh_for_eval_nomain(bm, cd_mask_extra, mesh);
+  BM_mesh_free(bm);
+
+  return result;
+}
+
 Mesh *triangulate_mesh(Mesh *mesh,
                        const int quad_method,
                        const int ngon_method,
@@ -61,7 +89,6 @@ Mesh *triangulate_mesh(Mesh *mesh,
                        const int flag)
 {
   Mesh *result;
-  BMesh *bm;
   int total_edges, i;
   MEdge *me;
   CustomData_MeshMasks cd_mask_extra = {
@@ -76,17 +103,20 @@ Mesh *triangulate_mesh(Mesh *mesh,
     cd_mask_extra.lmask |= CD_MASK_NORMAL;
   }
 
-  bm = BKE_mesh_to_bmesh_ex(mesh,
-                            &((struct BMeshCreateParams){0}),
-                            &((struct BMeshFromMeshParams){
-                                .calc_face_normal = true,
-                                .cd_mask_extra = cd_mask_extra,
-                            }));
-
-  BM_mesh_triangulate(bm, quad_method, ngon_method, min_vertices, false, NULL, NULL, NULL);
+  if (CustomData_has_layer(&mesh->ldata, CD_MDISPS)) {
+    result = triangulate_mesh_bmesh(mesh, quad_method, ngon_method, min_vertices, &cd_mask_extra);
+  }
+  else {
+    result = BKE_mesh_triangulate(mesh, quad_method, ngon_method, min_vertices);
+  }
 
-  result = BKE_mesh_from_bmesh_for_eval_nomain(bm, &cd_mask_extra, mesh);
-  BM_mesh_free(bm);
+  if (result == NULL) {
+    /* Nothing to triangulate. */
+    if (keep_clnors) {
+      CustomData_set_layer_flag(&mesh->ldata, CD_NORMAL, CD_FLAG_TEMPORARY);
+    }
+    return NULL;
+  }
 
   if (keep_clnors) {
     float(*lnors)[3] = CustomData_get_layer(&result->ldata, CD_NORMAL);
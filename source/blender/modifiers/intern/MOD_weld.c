@@ -37,8 +37,8 @@
 
 #include "BLI_alloca.h"
 #include "BLI_bitmap.h"
-#include "BLI_kdtree.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 
 #include "BLT_translation.h"
 
@@ -68,9 +68,8 @@
 
 #include "MOD_modifiertypes.h"
 #include "MOD_ui_common.h"
+#include "MOD_weld_util.h"
 
-/* Indicates when the element was not computed. */
-#define OUT_OF_CONTEXT (uint)(-1)
 /* Indicates if the edge or face will be collapsed. */
 #define ELEM_COLLAPSED (uint)(-2)
 /* indicates whether an edge or vertex in groups_map will be merged. */
@@ -1567,6 +1566,170 @@ static bool bvhtree_weld_overlap_cb(void *userdata, int index_a, int index_b, in
 }
 #endif
 
+/**
+ * The vertices and edges of the result are written in chunks in parallel: the destination index
+ * of every chunk is known upfront, since every element except the merged ones is written.
+ */
+#define WELD_RESULT_CHUNK_SIZE 4096
+
+typedef struct WeldResultData {
+  const Mesh *mesh;
+  Mesh *result;
+  const WeldMesh *weld_mesh;
+  /** Destination index of every vertex, filled by the vertex chunks. */
+  uint *vert_final;
+  /** Destination index of every edge, filled by the edge chunks. */
+  uint *edge_final;
+
+  /** Map of the elements processed by the current pass, see #weld_result_chunks_run. */
+  const uint *elem_map;
+  uint elem_len;
+  /** Destination index of the first element of every chunk. */
+  int *chunk_dest_index;
+} WeldResultData;
+
+static void weld_result_chunk_count_cb(void *__restrict userdata,
+                                       const int chunk,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  WeldResultData *data = userdata;
+  const uint start = (uint)chunk * WELD_RESULT_CHUNK_SIZE;
+  const uint end = min_uu(start + WELD_RESULT_CHUNK_SIZE, data->elem_len);
+  int count = 0;
+  for (uint i = start; i < end; i++) {
+    if (data->elem_map[i] != ELEM_MERGED) {
+      count++;
+    }
+  }
+  data->chunk_dest_index[chunk + 1] = count;
+}
+
+static void weld_result_verts_chunk_cb(void *__restrict userdata,
+                                       const int chunk,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  WeldResultData *data = userdata;
+  const Mesh *mesh = data->mesh;
+  Mesh *result = data->result;
+  const WeldMesh *weld_mesh = data->weld_mesh;
+
+  const uint start = (uint)chunk * WELD_RESULT_CHUNK_SIZE;
+  const uint end = min_uu(start + WELD_RESULT_CHUNK_SIZE, data->elem_len);
+  uint *index_iter = &data->vert_final[start];
+  int dest_index = data->chunk_dest_index[chunk];
+  for (uint i = start; i < end; i++, index_iter++) {
+    int source_index = i;
+    int count = 0;
+    while (i < end && *index_iter == OUT_OF_CONTEXT) {
+      *index_iter = dest_index + count;
+      index_iter++;
+      count++;
+      i++;
+    }
+    if (count) {
+      CustomData_copy_data(&mesh->vdata, &result->vdata, source_index, dest_index, count);
+      dest_index += count;
+    }
+    if (i == end) {
+      break;
+    }
+    if (*index_iter != ELEM_MERGED) {
+      struct WeldGroup *wgroup = &weld_mesh->vert_groups[*index_iter];
+      customdata_weld(&mesh->vdata,
+                      &result->vdata,
+                      &weld_mesh->vert_groups_buffer[wgroup->ofs],
+                      wgroup->len,
+                      dest_index);
+      *index_iter = dest_index;
+      dest_index++;
+    }
+  }
+}
+
+static void weld_result_edges_chunk_cb(void *__restrict userdata,
+                                       const int chunk,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  WeldResultData *data = userdata;
+  const Mesh *mesh = data->mesh;
+  Mesh *result = data->result;
+  const WeldMesh *weld_mesh = data->weld_mesh;
+  const uint *vert_final = data->vert_final;
+
+  const uint start = (uint)chunk * WELD_RESULT_CHUNK_SIZE;
+  const uint end = min_uu(start + WELD_RESULT_CHUNK_SIZE, data->elem_len);
+  uint *index_iter = &data->edge_final[start];
+  int dest_index = data->chunk_dest_index[chunk];
+  for (uint i = start; i < end; i++, index_iter++) {
+    int source_index = i;
+    int count = 0;
+    while (i < end && *index_iter == OUT_OF_CONTEXT) {
+      *index_iter = dest_index + count;
+      index_iter++;
+      count++;
+      i++;
+    }
+    if (count) {
+      CustomData_copy_data(&mesh->edata, &result->edata, source_index, dest_index, count);
+      MEdge *me = &result->medge[dest_index];
+      dest_index += count;
+      for (; count--; me++) {
+        me->v1 = vert_final[me->v1];
+        me->v2 = vert_final[me->v2];
+      }
+    }
+    if (i == end) {
+      break;
+    }
+    if (*index_iter != ELEM_MERGED) {
+      struct WeldGroupEdge *wegrp = &weld_mesh->edge_groups[*index_iter];
+      customdata_weld(&mesh->edata,
+                      &result->edata,
+                      &weld_mesh->edge_groups_buffer[wegrp->group.ofs],
+                      wegrp->group.len,
+                      dest_index);
+      MEdge *me = &result->medge[dest_index];
+      me->v1 = vert_final[wegrp->v1];
+      me->v2 = vert_final[wegrp->v2];
+      me->flag |= ME_LOOSEEDGE;
+
+      *index_iter = dest_index;
+      dest_index++;
+    }
+  }
+}
+
+/**
+ * Run \a chunk_fn over all chunks of \a elem_map in parallel.
+ * \return the number of elements written.
+ */
+static int weld_result_chunks_run(WeldResultData *data,
+                                  const uint elem_len,
+                                  const uint *elem_map,
+                                  TaskParallelRangeFunc chunk_fn)
+{
+  const int chunks_len = (int)((elem_len + WELD_RESULT_CHUNK_SIZE - 1) / WELD_RESULT_CHUNK_SIZE);
+  data->elem_map = elem_map;
+  data->elem_len = elem_len;
+  data->chunk_dest_index = MEM_malloc_arrayN(chunks_len + 1, sizeof(int), __func__);
+  data->chunk_dest_index[0] = 0;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+
+  BLI_task_parallel_range(0, chunks_len, data, weld_result_chunk_count_cb, &settings);
+  for (int chunk = 0; chunk < chunks_len; chunk++) {
+    data->chunk_dest_index[chunk + 1] += data->chunk_dest_index[chunk];
+  }
+  BLI_task_parallel_range(0, chunks_len, data, chunk_fn, &settings);
+
+  const int dest_len = data->chunk_dest_index[chunks_len];
+  MEM_freeN(data->chunk_dest_index);
+  data->chunk_dest_index = NULL;
+  return dest_len;
+}
+
 /** Use for #MOD_WELD_MODE_CONNECTED calculation. */
 struct WeldVertexCluster {
   float co[3];
@@ -1695,18 +1858,8 @@ static Mesh *weldModifier_doWeld(WeldModifierData *wmd,
   }
 #else
   {
-    KDTree_3d *tree = BLI_kdtree_3d_new(v_mask ? v_mask_act : totvert);
-    for (uint i = 0; i < totvert; i++) {
-      if (!v_mask || BLI_BITMAP_TEST(v_mask, i)) {
-        BLI_kdtree_3d_insert(tree, i, mvert[i].co);
-      }
-      vert_dest_map[i] = OUT_OF_CONTEXT;
-    }
-
-    BLI_kdtree_3d_balance(tree);
-    vert_kill_len = BLI_kdtree_3d_calc_duplicates_fast(
-        tree, wmd->merge_dist, false, (int *)vert_dest_map);
-    BLI_kdtree_3d_free(tree);
+    vert_kill_len = MOD_weld_vert_duplicates_find(
+        mvert, totvert, v_mask, (uint)v_mask_act, wmd->merge_dist, vert_dest_map);
   }
 #endif
   else {
@@ -1810,83 +1963,27 @@ static Mesh *weldModifier_doWeld(WeldModifierData *wmd,
     result = BKE_mesh_new_nomain_from_template(
         mesh, result_nverts, result_nedges, 0, result_nloops, result_npolys);
 
+    WeldResultData result_data = {
+        .mesh = mesh,
+        .result = result,
+        .weld_mesh = &weld_mesh,
+        .vert_final = vert_dest_map,
+        .edge_final = weld_mesh.edge_groups_map,
+    };
+
     /* Vertices */
 
     uint *vert_final = vert_dest_map;
-    uint *index_iter = &vert_final[0];
-    int dest_index = 0;
-    for (uint i = 0; i < totvert; i++, index_iter++) {
-      int source_index = i;
-      int count = 0;
-      while (i < totvert && *index_iter == OUT_OF_CONTEXT) {
-        *index_iter = dest_index + count;
-        index_iter++;
-        count++;
-        i++;
-      }
-      if (count) {
-        CustomData_copy_data(&mesh->vdata, &result->vdata, source_index, dest_index, count);
-        dest_index += count;
-      }
-      if (i == totvert) {
-        break;
-      }
-      if (*index_iter != ELEM_MERGED) {
-        struct WeldGroup *wgroup = &weld_mesh.vert_groups[*index_iter];
-        customdata_weld(&mesh->vdata,
-                        &result->vdata,
-                        &weld_mesh.vert_groups_buffer[wgroup->ofs],
-                        wgroup->len,
-                        dest_index);
-        *index_iter = dest_index;
-        dest_index++;
-      }
-    }
+    int dest_index = weld_result_chunks_run(
+        &result_data, totvert, vert_final, weld_result_verts_chunk_cb);
 
     BLI_assert(dest_index == result_nverts);
 
     /* Edges */
 
     uint *edge_final = weld_mesh.edge_groups_map;
-    index_iter = &edge_final[0];
-    dest_index = 0;
-    for (uint i = 0; i < totedge; i++, index_iter++) {
-      int source_index = i;
-      int count = 0;
-      while (i < totedge && *index_iter == OUT_OF_CONTEXT) {
-        *index_iter = dest_index + count;
-        index_iter++;
-        count++;
-        i++;
-      }
-      if (count) {
-        CustomData_copy_data(&mesh->edata, &result->edata, source_index, dest_index, count);
-        MEdge *me = &result->medge[dest_index];
-        dest_index += count;
-        for (; count--; me++) {
-          me->v1 = vert_final[me->v1];
-          me->v2 = vert_final[me->v2];
-        }
-      }
-      if (i == totedge) {
-        break;
-      }
-      if (*index_iter != ELEM_MERGED) {
-        struct WeldGroupEdge *wegrp = &weld_mesh.edge_groups[*index_iter];
-        customdata_weld(&mesh->edata,
-                        &result->edata,
-                        &weld_mesh.edge_groups_buffer[wegrp->group.ofs],
-                        wegrp->group.len,
-                        dest_index);
-        MEdge *me = &result->medge[dest_index];
-        me->v1 = vert_final[wegrp->v1];
-        me->v2 = vert_final[wegrp->v2];
-        me->flag |= ME_LOOSEEDGE;
-
-        *index_iter = dest_index;
-        dest_index++;
-      }
-    }
+    dest_index = weld_result_chunks_run(
+        &result_data, totedge, edge_final, weld_result_edges_chunk_cb);
 
     BLI_assert(dest_index == result_nedges);
 
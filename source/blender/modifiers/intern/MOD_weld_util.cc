@@ -0,0 +1,313 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2005 by the Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup modifiers
+ *
+ * Weld modifier: search of the vertices within the merge distance of each other.
+ */
+
+#include <algorithm>
+#include <atomic>
+
+#include "BLI_utildefines.h"
+
+#include "BLI_array.hh"
+#include "BLI_bitmap.h"
+#include "BLI_disjoint_set.hh"
+#include "BLI_hash.h"
+#include "BLI_math.h"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
+
+#include "DNA_meshdata_types.h"
+
+#include "MOD_weld_util.h"
+
+using blender::Array;
+using blender::DisjointSet;
+using blender::IndexRange;
+using blender::Vector;
+
+/* -------------------------------------------------------------------- */
+/** \name Weld Vertex Duplicates
+ *
+ * Finds vertices within the merge distance of each other using a uniform grid with cells twice
+ * the merge distance, so usually only the 8 cells overlapping the merge distance around a vertex
+ * are to be searched, and one for a zero merge distance.
+ * The cells are hashed into as many buckets as there are vertices, so memory usage doesn't
+ * depend on the extent of the mesh. Buckets are sorted by vertex index so the results do not
+ * depend on threading.
+ * \{ */
+
+/**
+ * Cells are not smaller than the bounding box divided by this, so cell coordinates stay in the
+ * range of an int for small (or zero) merge distances.
+ */
+#define WELD_CELLS_PER_AXIS_MAX (1 << 20)
+
+/** Number of vertices searched at once by a thread. */
+#define WELD_DUPLICATES_CHUNK_SIZE 1024
+/** Above this average, duplicates are joined during the search instead of collecting them. */
+#define WELD_DUPLICATES_PER_VERT_MAX 8
+
+struct WeldDuplicatesGrid {
+  const MVert *mvert;
+  /** Minimum of the bounding box of the vertices in context, cells are relative to it. */
+  float origin[3];
+  float cell_size_inv;
+  float merge_dist;
+  float merge_dist_sq;
+
+  uint buckets_mask;
+  /** Bucket of every vertex, #OUT_OF_CONTEXT for vertices excluded by the mask. */
+  Array<uint> vert_buckets;
+  /** Start of every bucket in #bucket_verts, `buckets_mask + 2` long. */
+  Array<uint> bucket_offsets;
+  /** Vertex indices grouped by bucket, in increasing order within a bucket. */
+  Array<uint> bucket_verts;
+
+  int cell_get(const float co, const int axis) const
+  {
+    return (int)floorf((co - origin[axis]) * cell_size_inv);
+  }
+
+  uint bucket_get(const int cell[3]) const
+  {
+    return BLI_hash_int_3d((uint)cell[0], (uint)cell[1], (uint)cell[2]) & buckets_mask;
+  }
+
+  bool is_duplicate(const uint v, const uint v_other) const
+  {
+    return len_squared_v3v3(mvert[v].co, mvert[v_other].co) <= merge_dist_sq;
+  }
+
+  /**
+   * Call \a fn for the vertices with a higher index than \a v in the cells within the merge
+   * distance of it. They still need a distance test.
+   */
+  template<typename Fn> void foreach_candidate(const uint v, const Fn &fn) const
+  {
+    if (vert_buckets[v] == OUT_OF_CONTEXT) {
+      return;
+    }
+
+    /* Cells are at least twice the merge distance, so these ranges are one or two cells, or three
+     * when rounding the bounds. */
+    const float *co = mvert[v].co;
+    int cell_min[3], cell_max[3];
+    for (int i = 0; i < 3; i++) {
+      cell_min[i] = cell_get(co[i] - merge_dist, i);
+      cell_max[i] = cell_get(co[i] + merge_dist, i);
+    }
+
+    /* Different cells may share a bucket, each bucket is only to be visited once. */
+    uint buckets[27];
+    uint buckets_len = 0;
+    for (int x = cell_min[0]; x <= cell_max[0]; x++) {
+      for (int y = cell_min[1]; y <= cell_max[1]; y++) {
+        for (int z = cell_min[2]; z <= cell_max[2]; z++) {
+          const int cell[3] = {x, y, z};
+          const uint bucket = bucket_get(cell);
+          uint i = 0;
+          while (i < buckets_len && buckets[i] != bucket) {
+            i++;
+          }
+          if (i == buckets_len) {
+            buckets[buckets_len++] = bucket;
+          }
+        }
+      }
+    }
+
+    for (uint i = 0; i < buckets_len; i++) {
+      const uint bucket = buckets[i];
+      for (uint j = bucket_offsets[bucket]; j < bucket_offsets[bucket + 1]; j++) {
+        const uint v_other = bucket_verts[j];
+        if (v_other > v) {
+          fn(v_other);
+        }
+      }
+    }
+  }
+};
+
+/**
+ * Vertices within \a merge_dist of each other are merged, and so are chains of them: every
+ * group of vertices connected by such distances is merged into its lowest index vertex, like the
+ * overlap search of `USE_BVHTREEKDOP` in `MOD_weld.c`. Vertices in a chain may be further apart
+ * than the merge distance. The result does not depend on threading.
+ *
+ * \param r_vert_dest_map: Filled with the target of merged vertices, the target itself for the
+ * targets, and #OUT_OF_CONTEXT for vertices which are kept unchanged.
+ * \return the number of merged vertices.
+ */
+uint MOD_weld_vert_duplicates_find(const MVert *mvert,
+                                   const uint totvert,
+                                   const BLI_bitmap *v_mask,
+                                   const uint v_mask_act,
+                                   const float merge_dist,
+                                   uint *r_vert_dest_map)
+{
+  for (uint i = 0; i < totvert; i++) {
+    r_vert_dest_map[i] = OUT_OF_CONTEXT;
+  }
+
+  const uint active_len = v_mask ? v_mask_act : totvert;
+  if (active_len < 2) {
+    return 0;
+  }
+
+  WeldDuplicatesGrid grid;
+  grid.mvert = mvert;
+
+  float min[3], max[3];
+  INIT_MINMAX(min, max);
+  for (uint i = 0; i < totvert; i++) {
+    if (!v_mask || BLI_BITMAP_TEST(v_mask, i)) {
+      minmax_v3v3_v3(min, max, mvert[i].co);
+    }
+  }
+  const float extent_max = max_fff(max[0] - min[0], max[1] - min[1], max[2] - min[2]);
+  /* A zero merge distance still merges vertices at the exact same location. */
+  const float cell_size = max_fff(
+      2.0f * merge_dist, extent_max / WELD_CELLS_PER_AXIS_MAX, FLT_MIN);
+  copy_v3_v3(grid.origin, min);
+  grid.cell_size_inv = 1.0f / cell_size;
+  grid.merge_dist = merge_dist;
+  grid.merge_dist_sq = square_f(merge_dist);
+
+  const uint buckets_len = power_of_2_max_u(active_len);
+  grid.buckets_mask = buckets_len - 1;
+  grid.vert_buckets.reinitialize(totvert);
+  grid.bucket_offsets = Array<uint>(buckets_len + 1, 0);
+  grid.bucket_verts.reinitialize(active_len);
+
+  blender::threading::parallel_for(IndexRange(totvert), 1024, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      if (v_mask && !BLI_BITMAP_TEST(v_mask, i)) {
+        grid.vert_buckets[i] = OUT_OF_CONTEXT;
+        continue;
+      }
+      const float *co = mvert[i].co;
+      const int cell[3] = {
+          grid.cell_get(co[0], 0), grid.cell_get(co[1], 1), grid.cell_get(co[2], 2)};
+      grid.vert_buckets[i] = grid.bucket_get(cell);
+    }
+  });
+
+  /* Counting sort into the buckets, keeping the vertices ordered within a bucket. */
+  for (uint i = 0; i < totvert; i++) {
+    if (grid.vert_buckets[i] != OUT_OF_CONTEXT) {
+      grid.bucket_offsets[grid.vert_buckets[i] + 1]++;
+    }
+  }
+  for (uint i = 0; i < buckets_len; i++) {
+    grid.bucket_offsets[i + 1] += grid.bucket_offsets[i];
+  }
+  Array<uint> bucket_fill = grid.bucket_offsets;
+  for (uint i = 0; i < totvert; i++) {
+    if (grid.vert_buckets[i] != OUT_OF_CONTEXT) {
+      grid.bucket_verts[bucket_fill[grid.vert_buckets[i]]++] = i;
+    }
+  }
+
+  /* Chunks collect the duplicates of their vertices, joining them is done serially as the
+   * disjoint set isn't thread safe. Chunks have a fixed size so the result doesn't depend on
+   * threading. */
+  const int64_t chunks_len = ((int64_t)totvert + WELD_DUPLICATES_CHUNK_SIZE - 1) /
+                             WELD_DUPLICATES_CHUNK_SIZE;
+  Array<Vector<std::pair<uint, uint>>> chunk_duplicates(chunks_len);
+  std::atomic<bool> is_dense = false;
+  blender::threading::parallel_for(IndexRange(chunks_len), 1, [&](const IndexRange chunks) {
+    for (const int64_t chunk : chunks) {
+      Vector<std::pair<uint, uint>> &duplicates = chunk_duplicates[chunk];
+      const uint v_start = (uint)chunk * WELD_DUPLICATES_CHUNK_SIZE;
+      const uint v_end = min_uu(v_start + WELD_DUPLICATES_CHUNK_SIZE, totvert);
+      for (uint v = v_start; v < v_end; v++) {
+        if (is_dense) {
+          return;
+        }
+        grid.foreach_candidate(v, [&](const uint v_other) {
+          if (grid.is_duplicate(v, v_other)) {
+            duplicates.append({v, v_other});
+          }
+        });
+        if (duplicates.size() > WELD_DUPLICATES_CHUNK_SIZE * WELD_DUPLICATES_PER_VERT_MAX) {
+          is_dense = true;
+        }
+      }
+    }
+  });
+
+  if (!is_dense && std::all_of(chunk_duplicates.begin(),
+                               chunk_duplicates.end(),
+                               [](const Vector<std::pair<uint, uint>> &duplicates) {
+                                 return duplicates.is_empty();
+                               })) {
+    return 0;
+  }
+
+  DisjointSet clusters(totvert);
+  if (is_dense) {
+    /* Dense clusters (a large merge distance) would take quadratic memory to store all
+     * duplicates, join while searching instead. Vertices which are joined already don't need
+     * the distance test. */
+    chunk_duplicates.reinitialize(0);
+    for (uint v = 0; v < totvert; v++) {
+      int64_t root = clusters.find_root(v);
+      grid.foreach_candidate(v, [&](const uint v_other) {
+        if (clusters.find_root(v_other) != root && grid.is_duplicate(v, v_other)) {
+          clusters.join(v, v_other);
+          root = clusters.find_root(v);
+        }
+      });
+    }
+  }
+  else {
+    for (const Vector<std::pair<uint, uint>> &duplicates : chunk_duplicates) {
+      for (const std::pair<uint, uint> &duplicate : duplicates) {
+        clusters.join(duplicate.first, duplicate.second);
+      }
+    }
+  }
+
+  /* The lowest index vertex of every cluster is kept, so the targets don't depend on the order
+   * of the joins. Vertices are visited by index, so the first one of a root is the lowest. */
+  Array<uint> root_targets(totvert, OUT_OF_CONTEXT);
+  uint vert_kill_len = 0;
+  for (uint v = 0; v < totvert; v++) {
+    if (grid.vert_buckets[v] == OUT_OF_CONTEXT) {
+      continue;
+    }
+    const int64_t root = clusters.find_root(v);
+    const uint target = root_targets[root];
+    if (target == OUT_OF_CONTEXT) {
+      root_targets[root] = v;
+      continue;
+    }
+    r_vert_dest_map[target] = target;
+    r_vert_dest_map[v] = target;
+    vert_kill_len++;
+  }
+
+  return vert_kill_len;
+}
+
+/** \} */
@@ -0,0 +1,47 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2005 by the Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup modifiers
+ */
+
+#pragma once
+
+#include "BLI_bitmap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct MVert;
+
+/* Indicates when the element was not computed. */
+#define OUT_OF_CONTEXT (uint)(-1)
+
+/* MOD_weld_util.cc */
+uint MOD_weld_vert_duplicates_find(const struct MVert *mvert,
+                                   const uint totvert,
+                                   const BLI_bitmap *v_mask,
+                                   const uint v_mask_act,
+                                   const float merge_dist,
+                                   uint *r_vert_dest_map);
+
+#ifdef __cplusplus
+}
+#endif
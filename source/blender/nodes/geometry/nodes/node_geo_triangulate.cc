@@ -67,7 +67,10 @@ static void geo_node_triangulate_exec(GeoNodeExecParams params)
   Mesh *mesh_in = geometry_set.get_mesh_for_write();
   if (mesh_in != nullptr) {
     Mesh *mesh_out = triangulate_mesh(mesh_in, quad_method, ngon_method, min_vertices, 0);
-    geometry_set.replace_mesh(mesh_out);
+    /* Nothing was triangulated when there is no new mesh. */
+    if (mesh_out != nullptr) {
+      geometry_set.replace_mesh(mesh_out);
+    }
   }
 
   params.set_output("Geometry", std::move(geometry_set));
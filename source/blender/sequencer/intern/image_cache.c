@@ -30,6 +30,17 @@
 #include "DNA_sequence_types.h"
 #include "DNA_space_types.h" /* for FILE_MAX. */
 
+#ifdef WITH_LZO
+#  ifdef WITH_SYSTEM_LZO
+#    include <lzo/lzo1x.h>
+#  else
+#    include "minilzo.h"
+#  endif
+#  define LZO_HEAP_ALLOC(var, size) \
+    lzo_align_t __LZO_MMODEL var[((size) + (sizeof(lzo_align_t) - 1)) / sizeof(lzo_align_t)]
+#  define LZO_OUT_LEN(size) ((size) + (size) / 16 + 64 + 3)
+#endif
+
 #include "IMB_colormanagement.h"
 #include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
@@ -43,8 +54,10 @@
 #include "BLI_listbase.h"
 #include "BLI_mempool.h"
 #include "BLI_path_util.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 
+#include "BKE_idprop.h"
 #include "BKE_main.h"
 #include "BKE_scene.h"
 
@@ -81,6 +94,20 @@
  *
  * User can exclude caching of some images. Such entries will have is_temp_cache set.
  *
+ * When the cache is full, images of the frame chosen for recycling are compressed in RAM first.
+ * Frames are only removed from the cache once all of them are compressed. Removed frames can
+ * still be read from the disk cache, if it is enabled.
+ *
+ *
+ * Compressed Cache Design Notes
+ * =============================
+ *
+ * Images are compressed losslessly with LZO, which is fast enough to decompress images during
+ * playback. Rows of an image are split into tiles of about CCACHE_TILE_SIZE bytes, that are
+ * compressed and decompressed in parallel. Bytes of each tile are reordered into planes first,
+ * so channels of byte images and bytes of float values that are similar end up next to each
+ * other, which compresses much better.
+ *
  *
  * Disk Cache Design Notes
  * =======================
@@ -150,9 +177,29 @@ typedef struct SeqCache {
   SeqDiskCache *disk_cache;
 } SeqCache;
 
+typedef struct SeqCacheCompressedTile {
+  unsigned char *data;
+  size_t size;
+  /* Tiles that don't compress are stored as is. */
+  bool is_compressed;
+} SeqCacheCompressedTile;
+
+typedef struct SeqCacheCompressedImage {
+  int x, y;
+  unsigned char planes;
+  bool is_float;
+  struct ColorSpace *colorspace;
+  struct IDProperty *metadata;
+  int tile_rows;
+  int tiles_len;
+  SeqCacheCompressedTile *tiles;
+} SeqCacheCompressedImage;
+
 typedef struct SeqCacheItem {
   struct SeqCache *cache_owner;
   struct ImBuf *ibuf;
+  /* Compressed image, when ibuf has been freed to save memory. */
+  struct SeqCacheCompressedImage *compressed;
 } SeqCacheItem;
 
 typedef struct SeqCacheKey {
@@ -717,6 +764,212 @@ static ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *ke
 #undef COLORSPACE_NAME_MAX
 #undef DCACHE_CURRENT_VERSION
 
+/* -------------------------------------------------------------------- */
+/* Compressed cache. */
+
+#define CCACHE_TILE_SIZE (256 * 1024)
+/* Compressed images must be smaller than this fraction of the image, or they are not worth the
+ * time spent for decompressing. */
+#define CCACHE_MAX_RATIO 0.8f
+
+typedef struct SeqCacheCompressData {
+  SeqCacheCompressedImage *image;
+  unsigned char *rect;
+  size_t row_size;
+} SeqCacheCompressData;
+
+#ifdef WITH_LZO
+static size_t seq_cache_compressed_tile_size(const SeqCacheCompressData *data, int tile_index)
+{
+  const SeqCacheCompressedImage *image = data->image;
+  const int rows = min_ii(image->tile_rows, image->y - tile_index * image->tile_rows);
+  return (size_t)rows * data->row_size;
+}
+
+/* Reorder bytes of 4 byte elements into 4 planes. */
+static void seq_cache_shuffle_bytes(const unsigned char *src, unsigned char *dst, size_t size)
+{
+  const size_t len = size / 4;
+  for (size_t i = 0; i < len; i++) {
+    dst[i] = src[i * 4];
+    dst[len + i] = src[i * 4 + 1];
+    dst[len * 2 + i] = src[i * 4 + 2];
+    dst[len * 3 + i] = src[i * 4 + 3];
+  }
+}
+
+static void seq_cache_unshuffle_bytes(const unsigned char *src, unsigned char *dst, size_t size)
+{
+  const size_t len = size / 4;
+  for (size_t i = 0; i < len; i++) {
+    dst[i * 4] = src[i];
+    dst[i * 4 + 1] = src[len + i];
+    dst[i * 4 + 2] = src[len * 2 + i];
+    dst[i * 4 + 3] = src[len * 3 + i];
+  }
+}
+
+static void seq_cache_compress_tile(void *__restrict userdata,
+                                    const int tile_index,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SeqCacheCompressData *data = userdata;
+  SeqCacheCompressedTile *tile = &data->image->tiles[tile_index];
+  const size_t offset = (size_t)tile_index * data->image->tile_rows * data->row_size;
+  const size_t size = seq_cache_compressed_tile_size(data, tile_index);
+
+  unsigned char *shuffled = MEM_mallocN(size, "seq cache shuffled tile");
+  seq_cache_shuffle_bytes(data->rect + offset, shuffled, size);
+
+  lzo_uint out_len = LZO_OUT_LEN(size);
+  unsigned char *out = MEM_mallocN(out_len, "seq cache compressed tile");
+  LZO_HEAP_ALLOC(wrkmem, LZO1X_MEM_COMPRESS);
+
+  const int r = lzo1x_1_compress(shuffled, (lzo_uint)size, out, &out_len, wrkmem);
+  if (r == LZO_E_OK && out_len < size) {
+    tile->data = MEM_reallocN(out, out_len);
+    tile->size = out_len;
+    tile->is_compressed = true;
+    MEM_freeN(shuffled);
+  }
+  else {
+    tile->data = shuffled;
+    tile->size = size;
+    tile->is_compressed = false;
+    MEM_freeN(out);
+  }
+}
+
+static void seq_cache_decompress_tile(void *__restrict userdata,
+                                      const int tile_index,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SeqCacheCompressData *data = userdata;
+  const SeqCacheCompressedTile *tile = &data->image->tiles[tile_index];
+  const size_t offset = (size_t)tile_index * data->image->tile_rows * data->row_size;
+  const size_t size = seq_cache_compressed_tile_size(data, tile_index);
+
+  if (!tile->is_compressed) {
+    seq_cache_unshuffle_bytes(tile->data, data->rect + offset, size);
+    return;
+  }
+
+  unsigned char *shuffled = MEM_mallocN(size, "seq cache shuffled tile");
+  lzo_uint out_len = size;
+  const int r = lzo1x_decompress_safe(tile->data, (lzo_uint)tile->size, shuffled, &out_len, NULL);
+  BLI_assert(r == LZO_E_OK && out_len == size);
+  UNUSED_VARS_NDEBUG(r);
+  seq_cache_unshuffle_bytes(shuffled, data->rect + offset, size);
+  MEM_freeN(shuffled);
+}
+#endif
+
+static void seq_cache_compressed_image_free(SeqCacheCompressedImage *image)
+{
+  for (int i = 0; i < image->tiles_len; i++) {
+    MEM_SAFE_FREE(image->tiles[i].data);
+  }
+  if (image->metadata) {
+    IDP_FreeProperty(image->metadata);
+  }
+  MEM_freeN(image->tiles);
+  MEM_freeN(image);
+}
+
+/* Returns NULL when the image can't be compressed, or compression isn't worth it. */
+static SeqCacheCompressedImage *seq_cache_compress_ibuf(ImBuf *ibuf)
+{
+#ifdef WITH_LZO
+  /* Like the disk cache, only images with either a byte or an RGBA float buffer are
+   * supported. */
+  if ((ibuf->rect == NULL) == (ibuf->rect_float == NULL)) {
+    return NULL;
+  }
+  if (ibuf->rect_float && ibuf->channels != 4) {
+    return NULL;
+  }
+
+  SeqCacheCompressedImage *image = MEM_callocN(sizeof(*image), "SeqCacheCompressedImage");
+  image->x = ibuf->x;
+  image->y = ibuf->y;
+  image->planes = ibuf->planes;
+  image->is_float = ibuf->rect_float != NULL;
+  image->colorspace = image->is_float ? ibuf->float_colorspace : ibuf->rect_colorspace;
+  if (ibuf->metadata) {
+    image->metadata = IDP_CopyProperty(ibuf->metadata);
+  }
+
+  SeqCacheCompressData data;
+  data.image = image;
+  if (image->is_float) {
+    data.rect = (unsigned char *)ibuf->rect_float;
+    data.row_size = sizeof(float[4]) * ibuf->x;
+  }
+  else {
+    data.rect = (unsigned char *)ibuf->rect;
+    data.row_size = sizeof(uint) * ibuf->x;
+  }
+
+  image->tile_rows = max_ii(1, CCACHE_TILE_SIZE / max_ii(data.row_size, 1));
+  image->tiles_len = (ibuf->y + image->tile_rows - 1) / image->tile_rows;
+  image->tiles = MEM_callocN(sizeof(*image->tiles) * image->tiles_len, "SeqCacheCompressedTile");
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  BLI_task_parallel_range(0, image->tiles_len, &data, seq_cache_compress_tile, &settings);
+
+  size_t size_compressed = 0;
+  for (int i = 0; i < image->tiles_len; i++) {
+    size_compressed += image->tiles[i].size;
+  }
+  if (size_compressed > data.row_size * ibuf->y * CCACHE_MAX_RATIO) {
+    seq_cache_compressed_image_free(image);
+    return NULL;
+  }
+
+  return image;
+#else
+  UNUSED_VARS(ibuf);
+  return NULL;
+#endif
+}
+
+static ImBuf *seq_cache_decompress_ibuf(const SeqCacheCompressedImage *image)
+{
+  ImBuf *ibuf = IMB_allocImBuf(
+      image->x, image->y, image->planes, image->is_float ? IB_rectfloat : IB_rect);
+  if (ibuf == NULL) {
+    return NULL;
+  }
+
+#ifdef WITH_LZO
+  SeqCacheCompressData data;
+  data.image = (SeqCacheCompressedImage *)image;
+  if (image->is_float) {
+    ibuf->float_colorspace = image->colorspace;
+    data.rect = (unsigned char *)ibuf->rect_float;
+    data.row_size = sizeof(float[4]) * image->x;
+  }
+  else {
+    ibuf->rect_colorspace = image->colorspace;
+    data.rect = (unsigned char *)ibuf->rect;
+    data.row_size = sizeof(uint) * image->x;
+  }
+  if (image->metadata) {
+    ibuf->metadata = IDP_CopyProperty(image->metadata);
+  }
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  BLI_task_parallel_range(0, image->tiles_len, &data, seq_cache_decompress_tile, &settings);
+#endif
+
+  return ibuf;
+}
+
+#undef CCACHE_TILE_SIZE
+#undef CCACHE_MAX_RATIO
+
 static bool seq_cmp_render_data(const SeqRenderData *a, const SeqRenderData *b)
 {
   return ((a->preview_render_size != b->preview_render_size) || (a->rectx != b->rectx) ||
@@ -823,6 +1076,9 @@ static void seq_cache_valfree(void *val)
   if (item->ibuf) {
     IMB_freeImBuf(item->ibuf);
   }
+  if (item->compressed) {
+    seq_cache_compressed_image_free(item->compressed);
+  }
 
   BLI_mempool_free(item->cache_owner->items_pool, item);
 }
@@ -850,6 +1106,7 @@ static void seq_cache_put_ex(Scene *scene, SeqCacheKey *key, ImBuf *ibuf)
   item = BLI_mempool_alloc(cache->items_pool);
   item->cache_owner = cache;
   item->ibuf = ibuf;
+  item->compressed = NULL;
 
   const int stored_types_flag = get_stored_types_flag(scene, key);
 
@@ -893,6 +1150,10 @@ static ImBuf *seq_cache_get_ex(SeqCache *cache, SeqCacheKey *key)
     return item->ibuf;
   }
 
+  if (item && item->compressed) {
+    return seq_cache_decompress_ibuf(item->compressed);
+  }
+
   return NULL;
 }
 
@@ -1012,7 +1273,53 @@ static void seq_cache_recycle_linked(Scene *scene, SeqCacheKey *base)
   }
 }
 
-static SeqCacheKey *seq_cache_get_item_for_removal(Scene *scene)
+static bool seq_cache_compress_item(SeqCache *cache, SeqCacheKey *key)
+{
+  SeqCacheItem *item = BLI_ghash_lookup(cache->hash, key);
+  if (item->ibuf == NULL) {
+    return item->compressed != NULL;
+  }
+
+  item->compressed = seq_cache_compress_ibuf(item->ibuf);
+  if (item->compressed == NULL) {
+    return false;
+  }
+
+  IMB_freeImBuf(item->ibuf);
+  item->ibuf = NULL;
+  return true;
+}
+
+/* Compress all images of the frame linked to base. Returns false if the image of base could not
+ * be compressed. */
+static bool seq_cache_compress_linked(Scene *scene, SeqCacheKey *base)
+{
+  SeqCache *cache = seq_cache_get_from_scene(scene);
+  if (!cache) {
+    return false;
+  }
+
+  const bool base_compressed = seq_cache_compress_item(cache, base);
+
+  for (SeqCacheKey *key = base, *prev = base->link_prev; prev; key = prev, prev = key->link_prev) {
+    if (!BLI_ghash_haskey(cache->hash, prev) || prev->link_next != key) {
+      break; /* Key doesn't belong to this chain anymore. */
+    }
+    seq_cache_compress_item(cache, prev);
+  }
+
+  for (SeqCacheKey *key = base, *next = base->link_next; next; key = next, next = key->link_next) {
+    if (!BLI_ghash_haskey(cache->hash, next) || next->link_prev != key) {
+      break; /* Key doesn't belong to this chain anymore. */
+    }
+    seq_cache_compress_item(cache, next);
+  }
+
+  return base_compressed;
+}
+
+/* Choose a base key for recycling among the frames that are compressed or not. */
+static SeqCacheKey *seq_cache_get_item_for_removal(Scene *scene, const bool compressed)
 {
   SeqCache *cache = seq_cache_get_from_scene(scene);
   SeqCacheKey *finalkey = NULL;
@@ -1032,7 +1339,7 @@ static SeqCacheKey *seq_cache_get_item_for_removal(Scene *scene)
     BLI_ghashIterator_step(&gh_iter);
 
     /* This shouldn't happen, but better be safe than sorry. */
-    if (!item->ibuf) {
+    if (!item->ibuf && !item->compressed) {
       seq_cache_recycle_linked(scene, key);
       /* Can not continue iterating after linked remove. */
       BLI_ghashIterator_init(&gh_iter, cache->hash);
@@ -1043,6 +1350,10 @@ static SeqCacheKey *seq_cache_get_item_for_removal(Scene *scene)
       continue;
     }
 
+    if ((item->compressed != NULL) != compressed) {
+      continue;
+    }
+
     total_count++;
 
     if (lkey) {
@@ -1070,6 +1381,7 @@ static SeqCacheKey *seq_cache_get_item_for_removal(Scene *scene)
 
 /* Find only "base" keys.
  * Sources(other types) for a frame must be freed all at once.
+ * Frames are compressed first, and only removed once all frames are compressed.
  */
 bool seq_cache_recycle_item(Scene *scene)
 {
@@ -1081,7 +1393,16 @@ bool seq_cache_recycle_item(Scene *scene)
   seq_cache_lock(scene);
 
   while (seq_cache_is_full()) {
-    SeqCacheKey *finalkey = seq_cache_get_item_for_removal(scene);
+    SeqCacheKey *finalkey = seq_cache_get_item_for_removal(scene, false);
+
+    if (finalkey) {
+      if (!seq_cache_compress_linked(scene, finalkey)) {
+        seq_cache_recycle_linked(scene, finalkey);
+      }
+      continue;
+    }
+
+    finalkey = seq_cache_get_item_for_removal(scene, true);
 
     if (finalkey) {
       seq_cache_recycle_linked(scene, finalkey);
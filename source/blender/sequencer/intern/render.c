@@ -38,6 +38,7 @@
 #include "BLI_listbase.h"
 #include "BLI_path_util.h"
 #include "BLI_rect.h"
+#include "BLI_task.h"
 
 #include "BKE_anim_data.h"
 #include "BKE_animsys.h"
@@ -1831,6 +1832,88 @@ static ImBuf *seq_render_strip_stack_apply_effect(
   return out;
 }
 
+/**
+ * Strips that only read their own data can be rendered on other threads. Scene strips use the
+ * render pipeline or draw with OpenGL, while meta-strips, effects and modifier masks render other
+ * strips of the stack.
+ */
+static bool seq_render_strip_is_threadsafe(const Sequence *seq)
+{
+  if (!ELEM(seq->type, SEQ_TYPE_IMAGE, SEQ_TYPE_MOVIE)) {
+    return false;
+  }
+
+  LISTBASE_FOREACH (SequenceModifierData *, smd, &seq->modifiers) {
+    if (smd->mask_sequence || smd->mask_id) {
+      return false;
+    }
+  }
+  return true;
+}
+
+typedef struct RenderStripsThreadData {
+  const SeqRenderData *context;
+  SeqRenderState *state;
+  Sequence **seq_arr;
+  ImBuf **ibuf_arr;
+  const int *indices;
+  float timeline_frame;
+} RenderStripsThreadData;
+
+static void seq_render_strips_thread(void *__restrict userdata,
+                                     const int iter,
+                                     const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RenderStripsThreadData *data = userdata;
+  const int i = data->indices[iter];
+
+  data->ibuf_arr[i] = seq_render_strip(
+      data->context, data->state, data->seq_arr[i], data->timeline_frame);
+}
+
+/**
+ * Render the strips of the stack that are used for blending. Decoding and preprocessing of
+ * independent strips is done in parallel, other strips are rendered on the calling thread.
+ */
+static void seq_render_strips(const SeqRenderData *context,
+                              SeqRenderState *state,
+                              Sequence **seq_arr,
+                              const bool *use_ibuf,
+                              const int count,
+                              float timeline_frame,
+                              ImBuf **r_ibuf_arr)
+{
+  int threaded_indices[MAXSEQ + 1];
+  int threaded_count = 0;
+
+  for (int i = 0; i < count; i++) {
+    r_ibuf_arr[i] = NULL;
+    if (!use_ibuf[i]) {
+      continue;
+    }
+    if (seq_render_strip_is_threadsafe(seq_arr[i])) {
+      threaded_indices[threaded_count++] = i;
+    }
+    else {
+      r_ibuf_arr[i] = seq_render_strip(context, state, seq_arr[i], timeline_frame);
+    }
+  }
+
+  RenderStripsThreadData data = {
+      .context = context,
+      .state = state,
+      .seq_arr = seq_arr,
+      .ibuf_arr = r_ibuf_arr,
+      .indices = threaded_indices,
+      .timeline_frame = timeline_frame,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (threaded_count > 1);
+  BLI_task_parallel_range(0, threaded_count, &data, seq_render_strips_thread, &settings);
+}
+
 static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
                                      SeqRenderState *state,
                                      ListBase *seqbasep,
@@ -1838,8 +1921,11 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
                                      int chanshown)
 {
   Sequence *seq_arr[MAXSEQ + 1];
+  ImBuf *ibuf_arr[MAXSEQ + 1];
+  bool use_ibuf[MAXSEQ + 1];
   int count;
   int i;
+  int early_out = EARLY_NO_INPUT;
   ImBuf *out = NULL;
 
   count = seq_get_shown_sequences(seqbasep, timeline_frame, chanshown, (Sequence **)&seq_arr);
@@ -1848,8 +1934,8 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
     return NULL;
   }
 
+  /* Find the lowest strip of the stack that contributes to the result. */
   for (i = count - 1; i >= 0; i--) {
-    int early_out;
     Sequence *seq = seq_arr[i];
 
     out = seq_cache_get(context, seq, timeline_frame, SEQ_CACHE_STORE_COMPOSITE);
@@ -1858,38 +1944,50 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
       break;
     }
     if (seq->blend_mode == SEQ_BLEND_REPLACE) {
-      out = seq_render_strip(context, state, seq, timeline_frame);
+      early_out = EARLY_NO_INPUT;
       break;
     }
 
     early_out = seq_get_early_out_for_blend_mode(seq);
 
+    if (ELEM(early_out, EARLY_NO_INPUT, EARLY_USE_INPUT_2) || i == 0) {
+      break;
+    }
+  }
+
+  /* Fetch all strips that are blended up front, so they can be rendered concurrently. Blending
+   * is then done from bottom to top. */
+  for (int j = 0; j < count; j++) {
+    use_ibuf[j] = false;
+  }
+  use_ibuf[i] = (out == NULL && early_out != EARLY_USE_INPUT_1);
+  for (int j = i + 1; j < count; j++) {
+    use_ibuf[j] = (seq_get_early_out_for_blend_mode(seq_arr[j]) == EARLY_DO_EFFECT);
+  }
+  seq_render_strips(context, state, seq_arr, use_ibuf, count, timeline_frame, ibuf_arr);
+
+  if (out == NULL) {
     switch (early_out) {
       case EARLY_NO_INPUT:
       case EARLY_USE_INPUT_2:
-        out = seq_render_strip(context, state, seq, timeline_frame);
+        out = ibuf_arr[i];
         break;
       case EARLY_USE_INPUT_1:
-        if (i == 0) {
-          out = IMB_allocImBuf(context->rectx, context->recty, 32, IB_rect);
-        }
+        out = IMB_allocImBuf(context->rectx, context->recty, 32, IB_rect);
         break;
-      case EARLY_DO_EFFECT:
-        if (i == 0) {
-          ImBuf *ibuf1 = IMB_allocImBuf(context->rectx, context->recty, 32, IB_rect);
-          ImBuf *ibuf2 = seq_render_strip(context, state, seq, timeline_frame);
+      case EARLY_DO_EFFECT: {
+        ImBuf *ibuf1 = IMB_allocImBuf(context->rectx, context->recty, 32, IB_rect);
+        ImBuf *ibuf2 = ibuf_arr[i];
 
-          out = seq_render_strip_stack_apply_effect(context, seq, timeline_frame, ibuf1, ibuf2);
+        out = seq_render_strip_stack_apply_effect(
+            context, seq_arr[i], timeline_frame, ibuf1, ibuf2);
 
-          seq_cache_put(context, seq_arr[i], timeline_frame, SEQ_CACHE_STORE_COMPOSITE, out);
+        seq_cache_put(context, seq_arr[i], timeline_frame, SEQ_CACHE_STORE_COMPOSITE, out);
 
-          IMB_freeImBuf(ibuf1);
-          IMB_freeImBuf(ibuf2);
-        }
+        IMB_freeImBuf(ibuf1);
+        IMB_freeImBuf(ibuf2);
         break;
-    }
-    if (out) {
-      break;
+      }
     }
   }
 
@@ -1897,9 +1995,9 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
   for (; i < count; i++) {
     Sequence *seq = seq_arr[i];
 
-    if (seq_get_early_out_for_blend_mode(seq) == EARLY_DO_EFFECT) {
+    if (use_ibuf[i]) {
       ImBuf *ibuf1 = out;
-      ImBuf *ibuf2 = seq_render_strip(context, state, seq, timeline_frame);
+      ImBuf *ibuf2 = ibuf_arr[i];
 
       out = seq_render_strip_stack_apply_effect(context, seq, timeline_frame, ibuf1, ibuf2);
 
@@ -51,6 +51,7 @@
 #include "BKE_customdata.h"
 #include "BKE_global.h"
 #include "BKE_idprop.h"
+#include "BKE_image.h"
 #include "BKE_main.h"
 #include "BKE_report.h"
 #include "BKE_scene.h"
@@ -441,6 +442,12 @@ void wm_event_do_notifiers(bContext *C)
     return;
   }
 
+  /* Redraw images which finished loading in the background. */
+  struct Image *ima;
+  while ((ima = BKE_image_load_async_pop_finished())) {
+    WM_event_add_notifier_ex(wm, NULL, NC_IMAGE | NA_EDITED, ima);
+  }
+
   /* Disable? - Keep for now since its used for window level notifiers. */
 #if 1
   /* Cache & catch WM level notifiers, such as frame change, scene/screen set. */